@@ -31,7 +31,7 @@ function Normalize-Path {
 function Resolve-Files {
     param (
         [Parameter(ValueFromPipeline)][string]$parent = $PSScriptRoot,
-        [string[]]$range = @('include', 'src', 'test')
+        [string[]]$range = @('include', 'src')
     )
     
     process {
@@ -0,0 +1,93 @@
+#include "Audio/AcmDecoder.h"
+
+#pragma comment(lib, "Msacm32.lib")
+
+namespace Audio
+{
+	bool AcmDecoder::Open(const Mp3FrameHeader& InHeader)
+	{
+		Close();
+
+		MPEGLAYER3WAVEFORMAT source{};
+		source.wfx.wFormatTag = WAVE_FORMAT_MPEGLAYER3;
+		source.wfx.nChannels = InHeader.Channels;
+		source.wfx.nSamplesPerSec = InHeader.SampleRate;
+		source.wfx.nAvgBytesPerSec = InHeader.Bitrate * 1000 / 8;
+		source.wfx.nBlockAlign = 1;
+		source.wfx.wBitsPerSample = 0;
+		source.wfx.cbSize = MPEGLAYER3_WFX_EXTRA_BYTES;
+		source.wID = MPEGLAYER3_ID_MPEG;
+		source.fdwFlags = MPEGLAYER3_FLAG_PADDING_OFF;
+		source.nBlockSize = InHeader.FrameBytes;
+		source.nFramesPerBlock = 1;
+		source.nCodecDelay = 0;
+
+		WAVEFORMATEX pcm{};
+		pcm.wFormatTag = WAVE_FORMAT_PCM;
+		pcm.nChannels = InHeader.Channels;
+		pcm.nSamplesPerSec = InHeader.SampleRate;
+		pcm.wBitsPerSample = 16;
+		pcm.nBlockAlign = pcm.nChannels * pcm.wBitsPerSample / 8;
+		pcm.nAvgBytesPerSec = pcm.nSamplesPerSec * pcm.nBlockAlign;
+
+		if (const auto result = acmStreamOpen(&Stream, nullptr, &source.wfx, &pcm, nullptr, 0, 0, 0); result != MMSYSERR_NOERROR) {
+			INFO("{} - acmStreamOpen failed with code: {}", Plugin::NAME, result);
+			Stream = nullptr;
+			return false;
+		}
+
+		DWORD outputBytes = 0;
+		acmStreamSize(Stream, static_cast<DWORD>(kMaxFrameBytes), &outputBytes, ACM_STREAMSIZEF_SOURCE);
+		Input.resize(kMaxFrameBytes);
+		Output.resize(std::max<std::size_t>(outputBytes, kMaxFrameSamples * 2 * sizeof(int16_t)));
+
+		Header = {};
+		Header.cbStruct = sizeof(Header);
+		Header.pbSrc = Input.data();
+		Header.cbSrcLength = static_cast<DWORD>(Input.size());
+		Header.pbDst = Output.data();
+		Header.cbDstLength = static_cast<DWORD>(Output.size());
+		if (acmStreamPrepareHeader(Stream, &Header, 0) != MMSYSERR_NOERROR) {
+			acmStreamClose(Stream, 0);
+			Stream = nullptr;
+			return false;
+		}
+
+		NeedsStart = true;
+		return true;
+	}
+
+	std::size_t AcmDecoder::Decode(std::span<const uint8_t> InFrame, std::span<float> OutSamples)
+	{
+		if (!Stream || InFrame.size() > Input.size())
+			return 0;
+
+		std::memcpy(Input.data(), InFrame.data(), InFrame.size());
+		Header.cbSrcLength = static_cast<DWORD>(InFrame.size());
+
+		const DWORD flags = ACM_STREAMCONVERTF_BLOCKALIGN | (NeedsStart ? ACM_STREAMCONVERTF_START : 0);
+		NeedsStart = false;
+		if (acmStreamConvert(Stream, &Header, flags) != MMSYSERR_NOERROR)
+			return 0;
+
+		const auto* pcm = reinterpret_cast<const int16_t*>(Output.data());
+		const auto  count = std::min<std::size_t>(Header.cbDstLengthUsed / sizeof(int16_t), OutSamples.size());
+		for (std::size_t i = 0; i < count; ++i)
+			OutSamples[i] = pcm[i] * (1.0f / 32768.0f);
+
+		return count;
+	}
+
+	void AcmDecoder::Close()
+	{
+		if (!Stream)
+			return;
+
+		// Unprepare expects the lengths the header was prepared with.
+		Header.cbSrcLength = static_cast<DWORD>(Input.size());
+		Header.cbDstLength = static_cast<DWORD>(Output.size());
+		acmStreamUnprepareHeader(Stream, &Header, 0);
+		acmStreamClose(Stream, 0);
+		Stream = nullptr;
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Audio/Decoder.h"
+
+#include <Mmsystem.h>
+#include <mmreg.h>
+#include <msacm.h>
+
+namespace Audio
+{
+	// MP3 decoding through the Layer III ACM codec that ships with Windows.
+	class AcmDecoder final : public Decoder
+	{
+	public:
+		~AcmDecoder() override { Close(); }
+
+		bool        Open(const Mp3FrameHeader& InHeader) override;
+		std::size_t Decode(std::span<const uint8_t> InFrame, std::span<float> OutSamples) override;
+		void        Reset() override { NeedsStart = true; }
+
+	private:
+		void Close();
+
+		HACMSTREAM           Stream = nullptr;
+		ACMSTREAMHEADER      Header{};
+		std::vector<uint8_t> Input;
+		std::vector<uint8_t> Output;
+		bool                 NeedsStart = true;
+	};
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Audio/SpatialDsp.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string_view>
+
+namespace Audio
+{
+	// What the game is doing, as far as playback is concerned.
+	enum class GameState : uint8_t
+	{
+		Playing,
+		Menu,     // a full-screen menu is up; the output is ducked
+		Paused,   // the output fades out and holds its place
+		Loading,  // as Paused; streams keep buffering so playback resumes without reconnecting
+	};
+
+	// Health of the decoded-audio queue between the decoder and the output, for diagnostics.
+	// Counts are since the backend was created; sample counts are interleaved samples.
+	struct PlaybackStats
+	{
+		uint64_t    Underruns = 0;  // output blocks the queue could not fill
+		uint64_t    Overruns = 0;   // decoded blocks that did not fit
+		std::size_t Buffered = 0;
+		std::size_t HighWater = 0;
+		std::size_t Capacity = 0;
+		uint32_t    SampleRate = 0;
+		uint32_t    Channels = 0;
+	};
+
+	// Playback engine used by the RadioPlayer. One open source at a time; by default playback
+	// loops at end of track like the old "play ... repeat". All controls are cheap state changes
+	// except Open, which may block while a remote source connects.
+	class AudioBackend
+	{
+	public:
+		virtual ~AudioBackend() = default;
+
+		// InSource is a local path or an http(s):// URL.
+		virtual bool Open(std::string_view InSource) = 0;
+		virtual void Close() = 0;
+		virtual bool IsOpen() const = 0;
+
+		virtual void Play() = 0;
+		virtual void PlayFrom(uint32_t InPositionMs) = 0;
+		virtual void Stop() = 0;
+
+		// Linear gain, 0..1. Changes are ramped, so this is also the way to mute.
+		virtual void SetVolume(float InVolume) = 0;
+
+		// Length of the crossfade when Open switches away from a playing source; 0 cuts.
+		virtual void SetCrossfade(uint32_t InMs) { (void)InMs; }
+
+		// Places the output in the game world. Changes are smoothed.
+		virtual void SetSpatialization(const SpatialParams& InParams) { (void)InParams; }
+
+		// Safe to call from any thread.
+		virtual void SetGameState(GameState InState) { (void)InState; }
+
+		// Whether a track starts over when it ends (the default) or stops.
+		virtual void SetLooping(bool InLooping) { (void)InLooping; }
+
+		// Called on a backend thread once a track that does not loop has finished playing.
+		virtual void SetTrackEndHandler(std::function<void()> InHandler) { (void)InHandler; }
+
+		virtual PlaybackStats GetStats() const { return {}; }
+
+		// 0 when unknown (live streams).
+		virtual uint32_t GetLengthMs() const = 0;
+		virtual uint32_t GetPositionMs() const = 0;
+
+		// Sources likely to be opened next, most likely first, so they can be connected ahead
+		// of time within InBudgetBytes. An empty list releases them.
+		virtual void Prefetch(std::span<const std::string_view> InSources, std::size_t InBudgetBytes)
+		{
+			(void)InSources;
+			(void)InBudgetBytes;
+		}
+	};
+}
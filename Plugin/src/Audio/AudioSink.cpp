@@ -0,0 +1,45 @@
+#include "Audio/AudioSink.h"
+
+#include "Control/ThreadRuntime.h"
+
+#include <chrono>
+
+namespace Audio
+{
+	bool NullSink::Start(uint32_t InSampleRate, uint32_t InChannels, RenderCallback InCallback)
+	{
+		Stop();
+
+		SampleRate = InSampleRate;
+		Channels = InChannels;
+		Quit = false;
+		Thread = std::thread(&NullSink::RenderLoop, this, std::move(InCallback));
+		return true;
+	}
+
+	void NullSink::Stop()
+	{
+		Quit = true;
+		if (Thread.joinable())
+			Thread.join();
+
+		SampleRate = 0;
+		Channels = 0;
+	}
+
+	void NullSink::RenderLoop(RenderCallback InCallback)
+	{
+		Control::EnterThread("Radio Output", Control::ThreadRole::Render);
+
+		// 10 ms blocks, paced against a steady clock so the consumer runs at the nominal rate.
+		const auto         blockFrames = SampleRate / 100;
+		std::vector<float> block(std::size_t(blockFrames) * Channels);
+		auto               deadline = std::chrono::steady_clock::now();
+
+		while (!Quit) {
+			InCallback(block);
+			deadline += std::chrono::milliseconds(10);
+			std::this_thread::sleep_until(deadline);
+		}
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace Audio
+{
+	// Output device. The sink owns the real-time thread and pulls interleaved float PCM
+	// through the render callback; it never blocks on the decoder.
+	class AudioSink
+	{
+	public:
+		using RenderCallback = std::function<void(std::span<float>)>;
+
+		virtual ~AudioSink() = default;
+
+		virtual bool Start(uint32_t InSampleRate, uint32_t InChannels, RenderCallback InCallback) = 0;
+		virtual void Stop() = 0;
+
+		uint32_t GetSampleRate() const { return SampleRate; }
+		uint32_t GetChannels() const { return Channels; }
+		bool     IsRunning() const { return SampleRate != 0; }
+
+	protected:
+		uint32_t SampleRate = 0;
+		uint32_t Channels = 0;
+	};
+
+	// Headless sink: consumes audio in real time and discards it.
+	class NullSink final : public AudioSink
+	{
+	public:
+		~NullSink() override { Stop(); }
+
+		bool Start(uint32_t InSampleRate, uint32_t InChannels, RenderCallback InCallback) override;
+		void Stop() override;
+
+	private:
+		void RenderLoop(RenderCallback InCallback);
+
+		std::thread       Thread;
+		std::atomic<bool> Quit = false;
+	};
+}
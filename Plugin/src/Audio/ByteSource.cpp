@@ -0,0 +1,87 @@
+#include "Audio/ByteSource.h"
+
+#include <algorithm>
+
+namespace Audio
+{
+	namespace
+	{
+		thread_local ConnectGroup* CurrentGroup = nullptr;
+	}
+
+	ConnectGroup::Scope::Scope(ConnectGroup& InGroup) :
+		Previous(CurrentGroup)
+	{
+		CurrentGroup = &InGroup;
+	}
+
+	ConnectGroup::Scope::~Scope()
+	{
+		CurrentGroup = Previous;
+	}
+
+	ConnectGroup::Member::Member(ByteSource& InSource) :
+		Group(CurrentGroup),
+		Source(&InSource)
+	{
+		if (!Group)
+			return;
+
+		std::lock_guard lock(Group->Mutex);
+		Cancelled = Group->Cancelled;
+		if (!Cancelled)
+			Group->Members.push_back(Source);
+	}
+
+	ConnectGroup::Member::~Member()
+	{
+		// Cancel holds the lock while it calls into members, so once this returns the source
+		// is no longer in use by it.
+		if (Group && !Cancelled) {
+			std::lock_guard lock(Group->Mutex);
+			std::erase(Group->Members, Source);
+		}
+	}
+
+	void ConnectGroup::Cancel()
+	{
+		std::lock_guard lock(Mutex);
+		Cancelled = true;
+		for (auto* source : Members)
+			source->Cancel();
+	}
+
+	bool FileSource::Open(const std::filesystem::path& InPath)
+	{
+		std::error_code ec;
+		FileSize = std::filesystem::file_size(InPath, ec);
+		if (ec)
+			return false;
+
+		File.open(InPath, std::ios::binary);
+		Position = 0;
+		return File.is_open();
+	}
+
+	std::size_t FileSource::Read(std::span<uint8_t> OutBytes)
+	{
+		if (!File.is_open() || OutBytes.empty())
+			return 0;
+
+		File.read(reinterpret_cast<char*>(OutBytes.data()), static_cast<std::streamsize>(OutBytes.size()));
+		const auto count = static_cast<std::size_t>(File.gcount());
+		Position += count;
+		return count;
+	}
+
+	bool FileSource::Seek(uint64_t InOffset)
+	{
+		if (!File.is_open() || InOffset > FileSize)
+			return false;
+
+		File.clear();
+		File.seekg(static_cast<std::streamoff>(InOffset));
+		Position = InOffset;
+		return !File.fail();
+	}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace Audio
+{
+	// Sequential, seekable stream of encoded bytes (local file, HTTP body, ...).
+	// Read blocks until at least one byte is available and returns 0 only at end of stream or on error.
+	class ByteSource
+	{
+	public:
+		virtual ~ByteSource() = default;
+
+		virtual std::size_t Read(std::span<uint8_t> OutBytes) = 0;
+		virtual bool        Seek(uint64_t InOffset) = 0;
+		virtual uint64_t    Tell() const = 0;
+
+		// Total size in bytes, 0 when unknown.
+		virtual uint64_t Size() const = 0;
+		virtual bool     IsRemote() const { return false; }
+
+		// The whole content when it is addressable in memory (mapped files), otherwise empty.
+		// Readers may slice it directly instead of copying through Read.
+		virtual std::span<const uint8_t> GetMapping() const { return {}; }
+
+		// Unblocks a pending Read from another thread; the source is unusable afterwards.
+		virtual void Cancel() {}
+	};
+
+	// Connections still being opened for one owner that may give up on them: the warm pool,
+	// a network source reconnecting. The owner opens sources inside a Scope; a source that
+	// blocks while it connects joins the group of its thread for that long, and Cancel reaches
+	// it there. Once cancelled, joining fails, so later connects give up before they start.
+	class ConnectGroup
+	{
+	public:
+		// Makes InGroup the group of this thread until it goes out of scope.
+		class Scope
+		{
+		public:
+			explicit Scope(ConnectGroup& InGroup);
+			~Scope();
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		private:
+			ConnectGroup* Previous;
+		};
+
+		// Joins InSource to the group of this thread, if there is one, until it goes out of scope.
+		class Member
+		{
+		public:
+			explicit Member(ByteSource& InSource);
+			~Member();
+
+			Member(const Member&) = delete;
+			Member& operator=(const Member&) = delete;
+
+			// The group gave up before the source joined; it should not connect.
+			bool IsCancelled() const { return Cancelled; }
+
+		private:
+			ConnectGroup* Group;
+			ByteSource*   Source;
+			bool          Cancelled = false;
+		};
+
+		// Cancels every source in the group, and any that tries to join later.
+		void Cancel();
+
+	private:
+		std::mutex               Mutex;
+		std::vector<ByteSource*> Members;
+		bool                     Cancelled = false;
+	};
+
+	class FileSource final : public ByteSource
+	{
+	public:
+		bool Open(const std::filesystem::path& InPath);
+
+		std::size_t Read(std::span<uint8_t> OutBytes) override;
+		bool        Seek(uint64_t InOffset) override;
+		uint64_t    Tell() const override { return Position; }
+		uint64_t    Size() const override { return FileSize; }
+
+	private:
+		std::ifstream File;
+		uint64_t      FileSize = 0;
+		uint64_t      Position = 0;
+	};
+}
@@ -0,0 +1,341 @@
+#include "Audio/CachedSource.h"
+
+#include "Config/Hash.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Audio
+{
+	namespace
+	{
+		constexpr uint32_t kIndexMagic = 0x49524753;  // "SGRI"
+		constexpr uint32_t kIndexFormat = 1;
+		constexpr uint32_t kChunkBytes = 64 * 1024;
+
+		struct IndexHeader
+		{
+			uint32_t Magic = kIndexMagic;
+			uint32_t Format = kIndexFormat;
+			uint64_t UrlHash = 0;
+			uint64_t TotalSize = 0;
+			uint32_t ChunkBytes = kChunkBytes;
+			uint32_t StoredChunks = 0;
+		};
+
+		bool ReadIndexHeader(std::ifstream& InFile, IndexHeader& OutHeader)
+		{
+			InFile.read(reinterpret_cast<char*>(&OutHeader), sizeof(OutHeader));
+			return InFile.good() && OutHeader.Magic == kIndexMagic && OutHeader.Format == kIndexFormat && OutHeader.ChunkBytes == kChunkBytes;
+		}
+
+		// False if the entry is still there, as a file another station has open may be.
+		bool RemoveEntry(const std::filesystem::path& InIndexPath)
+		{
+			std::error_code ec;
+			std::filesystem::remove(InIndexPath, ec);
+			std::filesystem::remove(std::filesystem::path(InIndexPath).replace_extension(".data"), ec);
+			return !std::filesystem::exists(InIndexPath, ec);
+		}
+
+		// Deletes least recently used entries until the cache fits in InBudgetBytes, and returns
+		// the bytes left. InKeep is in use and is never deleted, so it may stay over budget.
+		uint64_t TrimCache(const std::filesystem::path& InDirectory, uint64_t InBudgetBytes, const std::filesystem::path& InKeep)
+		{
+			struct Entry
+			{
+				std::filesystem::path           IndexPath;
+				std::filesystem::file_time_type LastUsed;
+				uint64_t                        Bytes;
+			};
+
+			std::vector<Entry> entries;
+			uint64_t           total = 0;
+
+			std::error_code ec;
+			for (const auto& file : std::filesystem::directory_iterator(InDirectory, ec)) {
+				if (file.path().extension() != ".index")
+					continue;
+
+				std::ifstream stream(file.path(), std::ios::binary);
+				IndexHeader   header;
+				if (!ReadIndexHeader(stream, header)) {
+					stream.close();
+					RemoveEntry(file.path());
+					continue;
+				}
+
+				const uint64_t bytes = uint64_t(header.StoredChunks) * kChunkBytes + file.file_size(ec);
+				entries.push_back({ file.path(), file.last_write_time(ec), bytes });
+				total += bytes;
+			}
+
+			if (total <= InBudgetBytes)
+				return total;
+
+			std::ranges::sort(entries, {}, &Entry::LastUsed);
+			for (const auto& entry : entries) {
+				if (total <= InBudgetBytes)
+					break;
+				if (entry.IndexPath == InKeep)
+					continue;
+
+				if (RemoveEntry(entry.IndexPath))
+					total -= entry.Bytes;
+			}
+			return total;
+		}
+	}
+
+	std::unique_ptr<ByteSource> OpenCachedSource(const std::filesystem::path& InDirectory, uint64_t InBudgetBytes, std::string_view InUrl, CachedSource::RemoteFactory InConnect)
+	{
+		if (InBudgetBytes == 0)
+			return InConnect();
+
+		std::error_code ec;
+		std::filesystem::create_directories(InDirectory, ec);
+
+		auto source = std::make_unique<CachedSource>();
+		source->UrlHash = Fnv1a64(InUrl);
+
+		source->IndexPath = InDirectory / (ToHexString(source->UrlHash) + ".index");
+		source->DataPath = std::filesystem::path(source->IndexPath).replace_extension(".data");
+		source->ConnectRemote = std::move(InConnect);
+		source->Directory = InDirectory;
+		source->BudgetBytes = InBudgetBytes;
+
+		if (source->LoadIndex()) {
+			// Mark as recently used for eviction.
+			std::filesystem::last_write_time(source->IndexPath, std::filesystem::file_time_type::clock::now(), ec);
+		} else {
+			// Nothing usable on disk; connect now to learn the size. A rejected index may have
+			// been read in part, so none of it is kept.
+			source->ResetIndex(0);
+			if (!source->Connect())
+				return nullptr;
+			if (source->TotalSize == 0)
+				return std::move(source->Remote);
+		}
+
+		// Trimmed once the index is on disk, so the count includes it.
+		source->CacheBytes = TrimCache(InDirectory, InBudgetBytes, source->IndexPath);
+
+		// The data file is created on first use and only ever grows.
+		if (!std::filesystem::exists(source->DataPath, ec))
+			std::ofstream(source->DataPath, std::ios::binary);
+		source->Data.open(source->DataPath, std::ios::in | std::ios::out | std::ios::binary);
+		if (!source->Data.is_open()) {
+			INFO("{} - Unable to open disk cache, streaming uncached", Plugin::NAME);
+			if (!source->Remote && !source->Connect())
+				return nullptr;
+			return std::move(source->Remote);
+		}
+
+		source->Chunk.resize(kChunkBytes);
+		return source;
+	}
+
+	std::size_t CachedSource::Read(std::span<uint8_t> OutBytes)
+	{
+		if (Position >= TotalSize || OutBytes.empty() || Cancelled)
+			return 0;
+
+		const auto chunk = static_cast<uint32_t>(Position / kChunkBytes);
+		if (!LoadChunk(chunk) || Position >= TotalSize)
+			return 0;  // the remote may have shrunk under the read position while connecting
+
+		const std::size_t offset = static_cast<std::size_t>(Position % kChunkBytes);
+		const std::size_t count = std::min<std::size_t>(OutBytes.size(), GetChunkBytes(chunk) - offset);
+		std::memcpy(OutBytes.data(), Chunk.data() + offset, count);
+		Position += count;
+		return count;
+	}
+
+	bool CachedSource::Seek(uint64_t InOffset)
+	{
+		if (InOffset > TotalSize)
+			return false;
+
+		// Only moves the read position; the remote is repositioned when a missing chunk is fetched.
+		Position = InOffset;
+		return true;
+	}
+
+	void CachedSource::Cancel()
+	{
+		Cancelled = true;
+
+		std::lock_guard lock(RemoteMutex);
+		if (Remote)
+			Remote->Cancel();
+	}
+
+	bool CachedSource::LoadIndex()
+	{
+		std::ifstream file(IndexPath, std::ios::binary);
+		IndexHeader   header;
+		if (!file.is_open() || !ReadIndexHeader(file, header) || header.UrlHash != UrlHash || header.TotalSize == 0)
+			return false;
+
+		TotalSize = header.TotalSize;
+		StoredChunks = header.StoredChunks;
+		Slots.resize(static_cast<std::size_t>((TotalSize + kChunkBytes - 1) / kChunkBytes));
+		file.read(reinterpret_cast<char*>(Slots.data()), static_cast<std::streamsize>(Slots.size() * sizeof(uint32_t)));
+		if (!file.good())
+			return false;
+
+		// A slot past the stored count means the index outlived its data.
+		return std::ranges::all_of(Slots, [this](uint32_t InSlot) { return InSlot == kMissing || InSlot < StoredChunks; });
+	}
+
+	void CachedSource::WriteIndex()
+	{
+		IndexHeader header;
+		header.UrlHash = UrlHash;
+		header.TotalSize = TotalSize;
+		header.StoredChunks = StoredChunks;
+
+		Index.close();
+		Index.open(IndexPath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+		Index.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		Index.write(reinterpret_cast<const char*>(Slots.data()), static_cast<std::streamsize>(Slots.size() * sizeof(uint32_t)));
+		Index.flush();
+		if (!Index.good())
+			INFO("{} - Unable to write disk cache index", Plugin::NAME);
+	}
+
+	void CachedSource::WriteSlot(uint32_t InChunk)
+	{
+		if (!Index.is_open())
+			Index.open(IndexPath, std::ios::in | std::ios::out | std::ios::binary);
+
+		IndexHeader header;
+		header.UrlHash = UrlHash;
+		header.TotalSize = TotalSize;
+		header.StoredChunks = StoredChunks;
+
+		// The stored count first, then the slot: a crash in between leaves a chunk nothing
+		// points at, never a slot past the count, which would discard the whole index.
+		Index.clear();
+		Index.seekp(0);
+		Index.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		Index.seekp(std::streamoff(sizeof(header)) + std::streamoff(InChunk) * std::streamoff(sizeof(uint32_t)));
+		Index.write(reinterpret_cast<const char*>(&Slots[InChunk]), sizeof(uint32_t));
+		Index.flush();
+		if (!Index.good())
+			INFO("{} - Unable to write disk cache index", Plugin::NAME);
+	}
+
+	void CachedSource::ResetIndex(uint64_t InTotalSize)
+	{
+		TotalSize = InTotalSize;
+		StoredChunks = 0;
+		ChunkIndex = kMissing;
+		Slots.assign(static_cast<std::size_t>((TotalSize + kChunkBytes - 1) / kChunkBytes), kMissing);
+	}
+
+	bool CachedSource::Connect()
+	{
+		auto remote = ConnectRemote();
+		if (!remote)
+			return false;
+
+		{
+			std::lock_guard lock(RemoteMutex);
+			if (Cancelled)
+				return false;
+			Remote = std::move(remote);
+		}
+
+		if (Remote->Size() != TotalSize) {
+			if (TotalSize != 0)
+				INFO("{} - Cached copy is out of date, fetching again", Plugin::NAME);
+			ResetIndex(Remote->Size());
+			if (TotalSize != 0)
+				WriteIndex();
+		}
+		return true;
+	}
+
+	bool CachedSource::LoadChunk(uint32_t InChunk)
+	{
+		if (ChunkIndex == InChunk)
+			return true;
+
+		const auto chunkData = reinterpret_cast<char*>(Chunk.data());
+
+		if (Slots[InChunk] != kMissing) {
+			Data.clear();
+			Data.seekg(std::streamoff(Slots[InChunk]) * kChunkBytes);
+			if (Data.read(chunkData, GetChunkBytes(InChunk))) {
+				ChunkIndex = InChunk;
+				return true;
+			}
+		}
+
+		if (!Remote && !Connect())
+			return false;
+
+		// Connecting may have found the remote changed and reset the index, so the chunk count
+		// and the length of this chunk are only known now.
+		if (InChunk >= Slots.size())
+			return false;
+		const uint32_t bytes = GetChunkBytes(InChunk);
+
+		const uint64_t offset = uint64_t(InChunk) * kChunkBytes;
+		if (Remote->Tell() != offset && !Remote->Seek(offset))
+			return false;
+
+		for (uint32_t filled = 0; filled < bytes;) {
+			const auto count = Remote->Read({ Chunk.data() + filled, bytes - filled });
+			if (count == 0)
+				return false;
+			filled += static_cast<uint32_t>(count);
+		}
+
+		// A new slot grows the cache, which makes room for it first. When even the other entries
+		// going is not enough, this station plays on uncached from here.
+		const bool grows = Slots[InChunk] == kMissing;
+		if (grows && !MakeRoom()) {
+			ChunkIndex = InChunk;
+			return true;
+		}
+
+		// Data first, then the index that points at it.
+		const uint32_t slot = grows ? StoredChunks++ : Slots[InChunk];
+		Data.clear();
+		Data.seekp(std::streamoff(slot) * kChunkBytes);
+		Data.write(chunkData, bytes);
+		Data.flush();
+		if (Data.good()) {
+			Slots[InChunk] = slot;
+			WriteSlot(InChunk);
+			if (grows)
+				CacheBytes += kChunkBytes;
+		}
+
+		ChunkIndex = InChunk;
+		return true;
+	}
+
+	bool CachedSource::MakeRoom()
+	{
+		if (CacheFull)
+			return false;
+		if (CacheBytes + kChunkBytes <= BudgetBytes)
+			return true;
+
+		// Other stations may have grown the cache too, so the running count is only trusted
+		// while it is under budget; past that the directory is counted again.
+		CacheBytes = TrimCache(Directory, BudgetBytes > kChunkBytes ? BudgetBytes - kChunkBytes : 0, IndexPath);
+		CacheFull = CacheBytes + kChunkBytes > BudgetBytes;
+		if (CacheFull)
+			INFO("{} - Disk cache is full, streaming the rest uncached", Plugin::NAME);
+		return !CacheFull;
+	}
+
+	uint32_t CachedSource::GetChunkBytes(uint32_t InChunk) const
+	{
+		return static_cast<uint32_t>(std::min<uint64_t>(kChunkBytes, TotalSize - uint64_t(InChunk) * kChunkBytes));
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Audio/ByteSource.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace Audio
+{
+	// Remote file mirrored chunk by chunk into a disk cache. Chunks already on disk are served
+	// from there; missing ones are fetched through the remote source (one range request per
+	// seek, sequential reads continue the same response) and stored as they arrive. The remote
+	// source is only connected once a missing chunk is needed, so a fully cached station
+	// starts without touching the network.
+	//
+	// On disk, <hash>.data holds the chunks in arrival order and <hash>.index maps chunk
+	// numbers to their slot in it, so a partly cached file only takes the space it uses.
+	class CachedSource final : public ByteSource
+	{
+	public:
+		using RemoteFactory = std::function<std::unique_ptr<ByteSource>()>;
+
+		std::size_t Read(std::span<uint8_t> OutBytes) override;
+		bool        Seek(uint64_t InOffset) override;
+		uint64_t    Tell() const override { return Position; }
+		uint64_t    Size() const override { return TotalSize; }
+		bool        IsRemote() const override { return true; }
+		void        Cancel() override;
+
+		// Opens InUrl through the cache in InDirectory, trimming the cache to InBudgetBytes. Chunks
+		// fetched later trim it again before they are stored, or are not stored once this file
+		// alone fills the budget. Sources of unknown size (live streams) cannot be cached and are
+		// returned uncached.
+		friend std::unique_ptr<ByteSource> OpenCachedSource(const std::filesystem::path& InDirectory, uint64_t InBudgetBytes, std::string_view InUrl, RemoteFactory InConnect);
+
+	private:
+		static constexpr uint32_t kMissing = ~uint32_t(0);
+
+		bool     LoadIndex();
+		void     WriteIndex();
+		void     WriteSlot(uint32_t InChunk);
+		void     ResetIndex(uint64_t InTotalSize);
+		bool     Connect();
+		bool     LoadChunk(uint32_t InChunk);
+		bool     MakeRoom();
+		uint32_t GetChunkBytes(uint32_t InChunk) const;
+
+		std::filesystem::path Directory;
+		std::filesystem::path DataPath;
+		std::filesystem::path IndexPath;
+		uint64_t              UrlHash = 0;
+		std::fstream          Data;
+		std::fstream          Index;  // opened on the first write, then updated in place
+
+		uint64_t BudgetBytes = 0;
+		uint64_t CacheBytes = 0;     // the whole cache directory, as last counted plus chunks stored since
+		bool     CacheFull = false;  // nothing more is stored
+
+		RemoteFactory               ConnectRemote;
+		std::unique_ptr<ByteSource> Remote;
+		std::mutex                  RemoteMutex;
+		std::atomic<bool>           Cancelled = false;
+
+		uint64_t              TotalSize = 0;
+		uint64_t              Position = 0;
+		std::vector<uint32_t> Slots;  // per chunk, slot in the data file or kMissing
+		uint32_t              StoredChunks = 0;
+
+		std::vector<uint8_t> Chunk;
+		uint32_t             ChunkIndex = kMissing;  // chunk currently held in Chunk
+	};
+
+	std::unique_ptr<ByteSource> OpenCachedSource(const std::filesystem::path& InDirectory, uint64_t InBudgetBytes, std::string_view InUrl, CachedSource::RemoteFactory InConnect);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Audio/Mp3.h"
+
+#include <algorithm>
+#include <span>
+
+namespace Audio
+{
+	// Turns one compressed frame into interleaved float PCM.
+	class Decoder
+	{
+	public:
+		virtual ~Decoder() = default;
+
+		// Prepares the decoder for a stream whose first frame is InHeader.
+		virtual bool Open(const Mp3FrameHeader& InHeader) = 0;
+
+		// Decodes a single frame. Returns the number of interleaved samples written to OutSamples.
+		virtual std::size_t Decode(std::span<const uint8_t> InFrame, std::span<float> OutSamples) = 0;
+
+		// Drops any inter-frame state (bit reservoir, overlap), called after a seek.
+		virtual void Reset() = 0;
+	};
+
+	// Emits one frame worth of silence per input frame. Keeps timing exact without a codec,
+	// which is what headless runs of the engine need.
+	class SilentDecoder final : public Decoder
+	{
+	public:
+		bool Open(const Mp3FrameHeader& InHeader) override
+		{
+			Header = InHeader;
+			return true;
+		}
+
+		std::size_t Decode(std::span<const uint8_t>, std::span<float> OutSamples) override
+		{
+			const auto count = std::min<std::size_t>(OutSamples.size(), std::size_t(Header.SamplesPerFrame) * Header.Channels);
+			std::fill_n(OutSamples.data(), count, 0.0f);
+			return count;
+		}
+
+		void Reset() override {}
+
+	private:
+		Mp3FrameHeader Header;
+	};
+}
@@ -0,0 +1,93 @@
+#include "Audio/FolderSpec.h"
+
+#include <cctype>
+
+namespace Audio
+{
+	namespace
+	{
+		bool IsSeparator(char InChar)
+		{
+			return InChar == '/' || InChar == '\\';
+		}
+
+		bool EqualNoCase(char InLeft, char InRight)
+		{
+			return std::tolower(static_cast<unsigned char>(InLeft)) == std::tolower(static_cast<unsigned char>(InRight));
+		}
+
+		// A pattern without "**". On a mismatch only the last '*' takes one more character:
+		// no '*' reaches past a '/', so growing an earlier one can never line up better. That
+		// keeps it linear where trying every split is exponential in the number of stars.
+		bool MatchStars(std::string_view InPattern, std::string_view InPath)
+		{
+			std::size_t pattern = 0;
+			std::size_t path = 0;
+			std::size_t starPattern = std::string_view::npos;
+			std::size_t starPath = 0;
+			while (path < InPath.size()) {
+				if (pattern < InPattern.size() && InPattern[pattern] == '*') {
+					starPattern = ++pattern;
+					starPath = path;
+				} else if (pattern < InPattern.size() && (InPattern[pattern] == '?' ? InPath[path] != '/' : EqualNoCase(InPattern[pattern], InPath[path]))) {
+					++pattern;
+					++path;
+				} else if (starPattern != std::string_view::npos && InPath[starPath] != '/') {
+					pattern = starPattern;
+					path = ++starPath;
+				} else {
+					return false;
+				}
+			}
+			while (pattern < InPattern.size() && InPattern[pattern] == '*')
+				++pattern;
+			return pattern == InPattern.size();
+		}
+	}
+
+	FolderSpec ParseFolderSpec(std::string_view InSource)
+	{
+		const auto wildcard = InSource.find_first_of("*?");
+		if (wildcard == std::string_view::npos)
+			return { std::filesystem::path(std::u8string_view(reinterpret_cast<const char8_t*>(InSource.data()), InSource.size())), "**/*.mp3", true };
+
+		// The root ends at the separator before the component holding the first wildcard.
+		std::size_t split = wildcard;
+		while (split > 0 && !IsSeparator(InSource[split - 1]))
+			--split;
+
+		const auto root = InSource.substr(0, split);
+
+		FolderSpec spec;
+		spec.Root = std::filesystem::path(std::u8string_view(reinterpret_cast<const char8_t*>(root.data()), root.size()));
+		spec.Pattern = InSource.substr(split);
+		for (auto& c : spec.Pattern) {
+			if (c == '\\')
+				c = '/';
+		}
+		spec.Recursive = spec.Pattern.contains('/') || spec.Pattern.contains("**");
+		return spec;
+	}
+
+	bool MatchGlob(std::string_view InPattern, std::string_view InPath)
+	{
+		const auto globstar = InPattern.find("**");
+		if (globstar == std::string_view::npos)
+			return MatchStars(InPattern, InPath);
+
+		// What comes before the "**" matches a prefix; "**/" then skips to any later directory.
+		const auto head = InPattern.substr(0, globstar);
+		auto       rest = InPattern.substr(globstar + 2);
+		if (rest.starts_with('/'))
+			rest.remove_prefix(1);
+
+		bool headMatched = false;
+		for (std::size_t i = 0; i <= InPath.size(); ++i) {
+			const bool here = MatchStars(head, InPath.substr(0, i));
+			if ((here || (headMatched && InPath[i - 1] == '/')) && MatchGlob(rest, InPath.substr(i)))
+				return true;
+			headMatched = headMatched || here;
+		}
+		return false;
+	}
+}
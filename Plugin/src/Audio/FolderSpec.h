@@ -0,0 +1,24 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace Audio
+{
+	// A folder station's source, "C:\...\tracks\Chill\**\*.mp3": the directory to walk and the
+	// pattern the files below it must match, relative to it with '/' separators.
+	struct FolderSpec
+	{
+		std::filesystem::path Root;
+		std::string           Pattern;
+		bool                  Recursive = false;  // the pattern reaches into subdirectories
+	};
+
+	// Splits InSource at its first component with a wildcard.
+	FolderSpec ParseFolderSpec(std::string_view InSource);
+
+	// Glob match of a relative path: '*' and '?' stay within one component, "**/" spans any
+	// number of directories, including none. Case-insensitive, like the Windows file system.
+	bool MatchGlob(std::string_view InPattern, std::string_view InPath);
+}
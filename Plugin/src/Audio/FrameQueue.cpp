@@ -0,0 +1,63 @@
+#include "Audio/FrameQueue.h"
+
+#include <cstring>
+
+namespace Audio
+{
+	void FrameQueue::Reserve(std::size_t InBytes)
+	{
+		Buffer.assign(InBytes, 0);
+		Clear();
+	}
+
+	bool FrameQueue::Push(std::span<const uint8_t> InFrame)
+	{
+		if (InFrame.size() > kMaxFrameBytes || InFrame.size() > Buffer.size() - Used)
+			return false;
+
+		const std::size_t tail = (Head + Used) % Buffer.size();
+		const std::size_t first = std::min(InFrame.size(), Buffer.size() - tail);
+		std::memcpy(Buffer.data() + tail, InFrame.data(), first);
+		std::memcpy(Buffer.data(), InFrame.data() + first, InFrame.size() - first);
+
+		Sizes.push_back(static_cast<uint16_t>(InFrame.size()));
+		Used += InFrame.size();
+		return true;
+	}
+
+	std::span<const uint8_t> FrameQueue::Pop()
+	{
+		if (Sizes.empty())
+			return {};
+
+		const std::size_t size = Sizes.front();
+		const std::size_t first = std::min(size, Buffer.size() - Head);
+
+		std::span<const uint8_t> frame{ Buffer.data() + Head, size };
+		if (first < size) {
+			std::memcpy(Wrapped.data(), Buffer.data() + Head, first);
+			std::memcpy(Wrapped.data() + first, Buffer.data(), size - first);
+			frame = { Wrapped.data(), size };
+		}
+
+		DropOldest();
+		return frame;
+	}
+
+	void FrameQueue::DropOldest()
+	{
+		if (Sizes.empty())
+			return;
+
+		Head = (Head + Sizes.front()) % Buffer.size();
+		Used -= Sizes.front();
+		Sizes.pop_front();
+	}
+
+	void FrameQueue::Clear()
+	{
+		Sizes.clear();
+		Head = 0;
+		Used = 0;
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Audio/Mp3.h"
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <vector>
+
+namespace Audio
+{
+	// FIFO of compressed frames in one fixed byte ring. Holds the read-ahead of a warm live
+	// station; owned by one thread at a time, no locking.
+	class FrameQueue
+	{
+	public:
+		// Allocates InBytes of storage and drops anything queued.
+		void Reserve(std::size_t InBytes);
+
+		// Returns false, queueing nothing, when the frame does not fit.
+		bool Push(std::span<const uint8_t> InFrame);
+
+		// Returns the oldest frame, or an empty span. The span stays valid until the next call.
+		std::span<const uint8_t> Pop();
+
+		void DropOldest();
+		void Clear();
+
+		bool        IsEmpty() const { return Sizes.empty(); }
+		std::size_t GetBytes() const { return Used; }
+		std::size_t GetCapacity() const { return Buffer.size(); }
+
+	private:
+		std::vector<uint8_t>                 Buffer;
+		std::deque<uint16_t>                 Sizes;
+		std::size_t                          Head = 0;  // oldest byte
+		std::size_t                          Used = 0;
+		std::array<uint8_t, kMaxFrameBytes> Wrapped;   // contiguous copy of a frame that wraps
+	};
+}
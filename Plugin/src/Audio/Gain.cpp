@@ -0,0 +1,48 @@
+#include "Audio/Gain.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Audio
+{
+	float DbToGain(float InDb)
+	{
+		return InDb <= kSilenceDb ? 0.0f : std::pow(10.0f, InDb / 20.0f);
+	}
+
+	float GainToDb(float InGain)
+	{
+		return InGain <= DbToGain(kSilenceDb) ? kSilenceDb : 20.0f * std::log10(InGain);
+	}
+
+	float VolumeToGain(float InVolume)
+	{
+		const float volume = std::clamp(InVolume, 0.0f, 1.0f);
+		return volume > 0.0f ? DbToGain(kVolumeRangeDb * (volume - 1.0f)) : 0.0f;
+	}
+
+	void GainRamp::Process(std::span<float> InOutSamples, uint32_t InChannels, uint32_t InSampleRate, const MixKernels& InKernels)
+	{
+		const float target = Target.load(std::memory_order_relaxed) * Scale.load(std::memory_order_relaxed);
+		if (Current == target) {
+			if (target != 1.0f)
+				InKernels.Scale(InOutSamples, target);
+			return;
+		}
+
+		const std::size_t frames = InOutSamples.size() / InChannels;
+		if (frames == 0)
+			return;
+
+		// Silence sits at kSilenceDb on the ramp, so fades to and from zero take the same time.
+		const float fromDb = GainToDb(Current);
+		const float toDb = GainToDb(target);
+		const float maxDb = kDbPerSecond * static_cast<float>(frames) / static_cast<float>(InSampleRate);
+		const float endDb = fromDb < toDb ? std::min(fromDb + maxDb, toDb) : std::max(fromDb - maxDb, toDb);
+		const float end = endDb == toDb ? target : DbToGain(endDb);
+
+		// Reaches end on the first frame of the next block, so consecutive blocks join up.
+		InKernels.Ramp(InOutSamples, InChannels, Current, (end - Current) / static_cast<float>(frames));
+		Current = end;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Audio/MixKernels.h"
+
+#include <atomic>
+#include <cstdint>
+#include <span>
+
+namespace Audio
+{
+	// Below this a gain is treated as silence.
+	inline constexpr float kSilenceDb = -60.0f;
+
+	float DbToGain(float InDb);
+	float GainToDb(float InGain);  // kSilenceDb for anything at or below it
+
+	// Volume control position (0..1) to linear gain. The control is linear in decibels over
+	// kVolumeRangeDb, so every step sounds like the same change; 0 is silence.
+	inline constexpr float kVolumeRangeDb = 40.0f;
+	float VolumeToGain(float InVolume);
+
+	// Output gain that never steps. SetTarget may be called from any thread; Process runs on
+	// the render thread and moves the applied gain toward the target at kDbPerSecond, linear
+	// in decibels from block to block and linear in amplitude within a block. A one-step
+	// volume change ramps over a few milliseconds, muting takes about 200 ms.
+	class GainRamp
+	{
+	public:
+		static constexpr float kDbPerSecond = 300.0f;
+
+		void  SetTarget(float InGain) { Target.store(InGain, std::memory_order_relaxed); }
+		float GetTarget() const { return Target.load(std::memory_order_relaxed); }
+
+		// Applied on top of the target, for ducking; ramped the same way.
+		void SetScale(float InScale) { Scale.store(InScale, std::memory_order_relaxed); }
+
+		// Render thread only: the last block ended at zero gain.
+		bool IsSilent() const { return Current == 0.0f; }
+
+		void Process(std::span<float> InOutSamples, uint32_t InChannels, uint32_t InSampleRate, const MixKernels& InKernels);
+
+	private:
+		std::atomic<float> Target = 1.0f;
+		std::atomic<float> Scale = 1.0f;
+		float              Current = 1.0f;  // render thread only
+	};
+}
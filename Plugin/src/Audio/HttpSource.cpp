@@ -0,0 +1,177 @@
+#include "Audio/HttpSource.h"
+
+#pragma comment(lib, "Winhttp.lib")
+
+namespace Audio
+{
+	namespace
+	{
+		std::wstring Widen(std::string_view InText)
+		{
+			const int    length = MultiByteToWideChar(CP_UTF8, 0, InText.data(), static_cast<int>(InText.size()), nullptr, 0);
+			std::wstring wide(length, L'\0');
+			MultiByteToWideChar(CP_UTF8, 0, InText.data(), static_cast<int>(InText.size()), wide.data(), length);
+			return wide;
+		}
+
+		uint64_t QueryContentLength(HINTERNET InRequest)
+		{
+			wchar_t buffer[32]{};
+			DWORD   bytes = sizeof(buffer);
+			if (!WinHttpQueryHeaders(InRequest, WINHTTP_QUERY_CONTENT_LENGTH, WINHTTP_HEADER_NAME_BY_INDEX, buffer, &bytes, WINHTTP_NO_HEADER_INDEX))
+				return 0;
+			return std::wcstoull(buffer, nullptr, 10);
+		}
+
+		uint32_t QueryMetaInterval(HINTERNET InRequest)
+		{
+			wchar_t buffer[32]{};
+			DWORD   bytes = sizeof(buffer);
+			if (!WinHttpQueryHeaders(InRequest, WINHTTP_QUERY_CUSTOM, L"icy-metaint", buffer, &bytes, WINHTTP_NO_HEADER_INDEX))
+				return 0;
+			return static_cast<uint32_t>(std::wcstoul(buffer, nullptr, 10));
+		}
+	}
+
+	bool HttpSource::Open(std::string_view InUrl, uint64_t InOffset)
+	{
+		// Connecting can block for as long as the server takes to answer; whoever is opening
+		// this source may give up sooner.
+		const ConnectGroup::Member member(*this);
+		if (member.IsCancelled())
+			return false;
+
+		const auto url = Widen(InUrl);
+
+		URL_COMPONENTS components{};
+		components.dwStructSize = sizeof(components);
+		components.dwHostNameLength = static_cast<DWORD>(-1);
+		components.dwUrlPathLength = static_cast<DWORD>(-1);
+		components.dwExtraInfoLength = static_cast<DWORD>(-1);
+		if (!WinHttpCrackUrl(url.c_str(), static_cast<DWORD>(url.size()), 0, &components)) {
+			INFO("{} - Invalid station URL: {}", Plugin::NAME, InUrl);
+			return false;
+		}
+
+		Host.assign(components.lpszHostName, components.dwHostNameLength);
+		Path.assign(components.lpszUrlPath, components.dwUrlPathLength);
+		Path.append(components.lpszExtraInfo, components.dwExtraInfoLength);
+		Port = components.nPort;
+		Secure = components.nScheme == INTERNET_SCHEME_HTTPS;
+
+		Session = WinHttpOpen(L"StarfieldRadio", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY, WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+		if (!Session)
+			return false;
+
+		Connection = WinHttpConnect(Session, Host.c_str(), Port, 0);
+		if (!Connection)
+			return false;
+
+		return Request(InOffset);
+	}
+
+	std::size_t HttpSource::Read(std::span<uint8_t> OutBytes)
+	{
+		HINTERNET request = nullptr;
+		{
+			std::lock_guard lock(HandleMutex);
+			request = RequestHandle;
+		}
+
+		DWORD count = 0;
+		if (!request || Cancelled || !WinHttpReadData(request, OutBytes.data(), static_cast<DWORD>(OutBytes.size()), &count))
+			return 0;
+
+		Position += count;
+		return count;
+	}
+
+	bool HttpSource::Seek(uint64_t InOffset)
+	{
+		if (InOffset == Position)
+			return true;
+		if (TotalSize > 0 && InOffset > TotalSize)
+			return false;
+
+		return Request(InOffset);
+	}
+
+	void HttpSource::Cancel()
+	{
+		Cancelled = true;
+
+		// Closing the request handle is how a blocking WinHttpReadData is aborted.
+		std::lock_guard lock(HandleMutex);
+		if (RequestHandle) {
+			WinHttpCloseHandle(RequestHandle);
+			RequestHandle = nullptr;
+		}
+	}
+
+	bool HttpSource::Request(uint64_t InOffset)
+	{
+		HINTERNET request = WinHttpOpenRequest(Connection, L"GET", Path.c_str(), nullptr, WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES, Secure ? WINHTTP_FLAG_SECURE : 0);
+		if (!request)
+			return false;
+
+		{
+			std::lock_guard lock(HandleMutex);
+			if (Cancelled) {
+				WinHttpCloseHandle(request);
+				return false;
+			}
+			if (RequestHandle)
+				WinHttpCloseHandle(RequestHandle);
+			RequestHandle = request;
+		}
+
+		// Icecast and SHOUTcast only interleave "now playing" metadata when asked to.
+		std::wstring headers = L"Icy-MetaData: 1";
+		if (InOffset > 0)
+			headers += std::format(L"\r\nRange: bytes={}-", InOffset);
+		if (!WinHttpSendRequest(request, headers.c_str(), static_cast<DWORD>(-1L), WINHTTP_NO_REQUEST_DATA, 0, 0, 0) ||
+			!WinHttpReceiveResponse(request, nullptr)) {
+			INFO("{} - HTTP request failed with code: {}", Plugin::NAME, GetLastError());
+			return false;
+		}
+
+		DWORD status = 0;
+		DWORD statusBytes = sizeof(status);
+		WinHttpQueryHeaders(request, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER, WINHTTP_HEADER_NAME_BY_INDEX, &status, &statusBytes, WINHTTP_NO_HEADER_INDEX);
+
+		const auto contentLength = QueryContentLength(request);
+		MetaInterval = QueryMetaInterval(request);
+		if (status == 206) {
+			Position = InOffset;
+			TotalSize = contentLength > 0 ? InOffset + contentLength : 0;
+			return true;
+		}
+
+		if (status != 200) {
+			INFO("{} - HTTP request returned status: {}", Plugin::NAME, status);
+			return false;
+		}
+
+		// Server ignored the Range header: read forward to the requested offset.
+		Position = 0;
+		TotalSize = contentLength;
+
+		uint8_t discard[16 * 1024];
+		while (Position < InOffset) {
+			if (Read({ discard, static_cast<std::size_t>(std::min<uint64_t>(sizeof(discard), InOffset - Position)) }) == 0)
+				return false;
+		}
+		return true;
+	}
+
+	void HttpSource::CloseHandles()
+	{
+		Cancel();
+		if (Connection)
+			WinHttpCloseHandle(Connection);
+		if (Session)
+			WinHttpCloseHandle(Session);
+		Connection = nullptr;
+		Session = nullptr;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Audio/ByteSource.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include <winhttp.h>
+
+namespace Audio
+{
+	// HTTP(S) body as a ByteSource. Seeking reissues the request with a Range header.
+	class HttpSource final : public ByteSource
+	{
+	public:
+		~HttpSource() override { CloseHandles(); }
+
+		// Starts the body at InOffset (a Range request) when it is not 0.
+		bool Open(std::string_view InUrl, uint64_t InOffset = 0);
+
+		std::size_t Read(std::span<uint8_t> OutBytes) override;
+		bool        Seek(uint64_t InOffset) override;
+		uint64_t    Tell() const override { return Position; }
+		uint64_t    Size() const override { return TotalSize; }
+		bool        IsRemote() const override { return true; }
+		void        Cancel() override;
+
+		// Audio bytes between ICY metadata blocks, 0 when the server does not interleave them.
+		uint32_t GetMetaInterval() const { return MetaInterval; }
+
+	private:
+		bool Request(uint64_t InOffset);
+		void CloseHandles();
+
+		std::wstring Host;
+		std::wstring Path;
+		INTERNET_PORT Port = 0;
+		bool          Secure = false;
+
+		HINTERNET         Session = nullptr;
+		HINTERNET         Connection = nullptr;
+		HINTERNET         RequestHandle = nullptr;
+		std::mutex        HandleMutex;
+		std::atomic<bool> Cancelled = false;
+
+		uint64_t Position = 0;
+		uint64_t TotalSize = 0;
+		uint32_t MetaInterval = 0;
+	};
+}
@@ -0,0 +1,107 @@
+#include "Audio/IcySource.h"
+
+namespace Audio
+{
+	namespace
+	{
+		bool IsValidUtf8(std::string_view InText)
+		{
+			for (std::size_t i = 0; i < InText.size();) {
+				const auto        lead = static_cast<uint8_t>(InText[i]);
+				const std::size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+				if (length == 0 || i + length > InText.size())
+					return false;
+				for (std::size_t k = 1; k < length; ++k) {
+					if ((static_cast<uint8_t>(InText[i + k]) & 0xC0) != 0x80)
+						return false;
+				}
+				i += length;
+			}
+			return true;
+		}
+
+		std::string Latin1ToUtf8(std::string_view InText)
+		{
+			std::string text;
+			text.reserve(InText.size() * 2);
+			for (const char c : InText) {
+				const auto byte = static_cast<uint8_t>(c);
+				if (byte < 0x80) {
+					text += c;
+				} else {
+					text += static_cast<char>(0xC0 | (byte >> 6));
+					text += static_cast<char>(0x80 | (byte & 0x3F));
+				}
+			}
+			return text;
+		}
+	}
+
+	std::optional<std::string> ParseStreamTitle(std::string_view InMetadata)
+	{
+		constexpr std::string_view key = "StreamTitle='";
+		const auto                 start = InMetadata.find(key);
+		if (start == std::string_view::npos)
+			return std::nullopt;
+
+		// Titles may contain quotes themselves; the value ends at the quote before the ';'.
+		auto value = InMetadata.substr(start + key.size());
+		if (const auto end = value.find("';"); end != std::string_view::npos)
+			value = value.substr(0, end);
+		else if (const auto quote = value.rfind('\''); quote != std::string_view::npos)
+			value = value.substr(0, quote);
+
+		return IsValidUtf8(value) ? std::string(value) : Latin1ToUtf8(value);
+	}
+
+	IcySource::IcySource(std::unique_ptr<ByteSource> InBody, uint32_t InInterval, TitleHandler InOnTitle) :
+		Body(std::move(InBody)),
+		Interval(InInterval),
+		AudioLeft(InInterval),
+		OnTitle(std::move(InOnTitle))
+	{
+	}
+
+	std::size_t IcySource::Read(std::span<uint8_t> OutBytes)
+	{
+		if (AudioLeft == 0) {
+			if (!ReadMetadata())
+				return 0;
+			AudioLeft = Interval;
+		}
+
+		const auto count = Body->Read(OutBytes.first(std::min<std::size_t>(OutBytes.size(), AudioLeft)));
+		AudioLeft -= static_cast<uint32_t>(count);
+		Position += count;
+		return count;
+	}
+
+	bool IcySource::ReadMetadata()
+	{
+		uint8_t blocks = 0;
+		if (Body->Read({ &blocks, 1 }) == 0)
+			return false;
+
+		// Most blocks are empty: the title only comes again when it changes.
+		const std::size_t size = std::size_t(blocks) * 16;
+		for (std::size_t filled = 0; filled < size;) {
+			const auto count = Body->Read(std::span(Metadata).subspan(filled, size - filled));
+			if (count == 0)
+				return false;
+			filled += count;
+		}
+		if (size == 0)
+			return true;
+
+		// Blocks are padded with zeros.
+		std::string_view text(reinterpret_cast<const char*>(Metadata.data()), size);
+		text = text.substr(0, text.find('\0'));
+
+		if (auto title = ParseStreamTitle(text); title && *title != Title) {
+			Title = std::move(*title);
+			if (OnTitle && !Title.empty())
+				OnTitle(Title);
+		}
+		return true;
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Audio/ByteSource.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Audio
+{
+	// The title in an ICY metadata block (StreamTitle='Artist - Title';...), converted to UTF-8
+	// if the server sent Latin-1; nullopt when the block has no StreamTitle.
+	std::optional<std::string> ParseStreamTitle(std::string_view InMetadata);
+
+	// Icecast/SHOUTcast body with interleaved metadata: InInterval audio bytes, one length byte
+	// (in 16-byte units), that many bytes of metadata, and again. Read never hands out more than
+	// the audio left before the next block, so audio lands in the caller's buffer straight from
+	// the connection; only the metadata goes through a fixed 4 KB block of its own.
+	class IcySource final : public ByteSource
+	{
+	public:
+		using TitleHandler = std::function<void(std::string_view InTitle)>;
+
+		// InOnTitle runs on the reading thread whenever the stream title changes.
+		IcySource(std::unique_ptr<ByteSource> InBody, uint32_t InInterval, TitleHandler InOnTitle);
+
+		std::size_t Read(std::span<uint8_t> OutBytes) override;
+		bool        Seek(uint64_t InOffset) override { return InOffset == Position; }
+		uint64_t    Tell() const override { return Position; }
+		uint64_t    Size() const override { return 0; }
+		bool        IsRemote() const override { return true; }
+		void        Cancel() override { Body->Cancel(); }
+
+	private:
+		static constexpr std::size_t kMaxMetadata = 255 * 16;
+
+		bool ReadMetadata();
+
+		std::unique_ptr<ByteSource>        Body;
+		uint32_t                           Interval;
+		uint32_t                           AudioLeft;  // before the next metadata block
+		uint64_t                           Position = 0;
+		TitleHandler                       OnTitle;
+		std::string                        Title;
+		std::array<uint8_t, kMaxMetadata> Metadata;
+	};
+}
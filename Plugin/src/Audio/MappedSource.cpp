@@ -0,0 +1,65 @@
+#include "Audio/MappedSource.h"
+
+#include <cstring>
+
+namespace Audio
+{
+	bool MappedSource::Open(const std::filesystem::path& InPath)
+	{
+		Close();
+
+		// Playback reads front to back; let the cache manager read ahead aggressively.
+		File = CreateFileW(InPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (File == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(File, &size) || size.QuadPart == 0) {
+			Close();
+			return false;
+		}
+
+		Mapping = CreateFileMappingW(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const auto* base = Mapping ? static_cast<const uint8_t*>(MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+		if (!base) {
+			INFO("{} - Unable to map {}, error {}", Plugin::NAME, InPath.string(), GetLastError());
+			Close();
+			return false;
+		}
+
+		View = { base, static_cast<std::size_t>(size.QuadPart) };
+		Position = 0;
+		return true;
+	}
+
+	std::size_t MappedSource::Read(std::span<uint8_t> OutBytes)
+	{
+		const auto count = static_cast<std::size_t>(std::min<uint64_t>(OutBytes.size(), View.size() - Position));
+		std::memcpy(OutBytes.data(), View.data() + Position, count);
+		Position += count;
+		return count;
+	}
+
+	bool MappedSource::Seek(uint64_t InOffset)
+	{
+		if (InOffset > View.size())
+			return false;
+
+		Position = InOffset;
+		return true;
+	}
+
+	void MappedSource::Close()
+	{
+		if (!View.empty())
+			UnmapViewOfFile(View.data());
+		if (Mapping)
+			CloseHandle(Mapping);
+		if (File != INVALID_HANDLE_VALUE)
+			CloseHandle(File);
+
+		View = {};
+		Mapping = nullptr;
+		File = INVALID_HANDLE_VALUE;
+	}
+}
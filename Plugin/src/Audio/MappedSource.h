@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Audio/ByteSource.h"
+
+namespace Audio
+{
+	// Local file mapped read-only into memory. Mp3Stream slices frames straight out of the
+	// mapping, so local playback makes no copies before the decoder and a seek is only a new
+	// offset. Pages are file-backed: the OS reads them on first touch and may drop them again
+	// under memory pressure, so even multi-hour mixes cost little resident memory.
+	class MappedSource final : public ByteSource
+	{
+	public:
+		~MappedSource() override { Close(); }
+
+		bool Open(const std::filesystem::path& InPath);
+
+		std::size_t Read(std::span<uint8_t> OutBytes) override;
+		bool        Seek(uint64_t InOffset) override;
+		uint64_t    Tell() const override { return Position; }
+		uint64_t    Size() const override { return View.size(); }
+
+		std::span<const uint8_t> GetMapping() const override { return View; }
+
+	private:
+		void Close();
+
+		HANDLE                   File = INVALID_HANDLE_VALUE;
+		HANDLE                   Mapping = nullptr;
+		std::span<const uint8_t> View;
+		uint64_t                 Position = 0;
+	};
+}
@@ -0,0 +1,426 @@
+#include "Audio/MetadataStore.h"
+
+#include "Audio/FolderSpec.h"
+#include "Config/Hash.h"
+#include "Control/ThreadRuntime.h"
+
+#include <algorithm>
+#include <cstring>
+#include <execution>
+#include <fstream>
+#include <unordered_set>
+
+namespace Audio
+{
+	namespace
+	{
+		constexpr uint32_t kStoreMagic = 0x4D524753;  // "SGRM"
+		constexpr uint32_t kStoreFormat = 2;
+
+		// Files are read whole; anything this large is not a metadata store. A library of 50k
+		// tracks takes about 10 MB.
+		constexpr uint64_t kMaxStoreBytes = 64ull << 20;
+
+		template <class T>
+		void Put(std::string& OutData, const T& InValue)
+		{
+			OutData.append(reinterpret_cast<const char*>(&InValue), sizeof(T));
+		}
+
+		void PutString(std::string& OutData, std::string_view InText)
+		{
+			Put(OutData, static_cast<uint32_t>(InText.size()));
+			OutData.append(InText);
+		}
+
+		template <class T>
+		bool Get(std::string_view& InOutData, T& OutValue)
+		{
+			if (InOutData.size() < sizeof(T))
+				return false;
+			std::memcpy(&OutValue, InOutData.data(), sizeof(T));
+			InOutData.remove_prefix(sizeof(T));
+			return true;
+		}
+
+		bool GetString(std::string_view& InOutData, std::string& OutText)
+		{
+			uint32_t size = 0;
+			if (!Get(InOutData, size) || InOutData.size() < size)
+				return false;
+			OutText.assign(InOutData.data(), size);
+			InOutData.remove_prefix(size);
+			return true;
+		}
+
+		std::filesystem::path ToPath(std::string_view InUtf8)
+		{
+			return std::u8string_view(reinterpret_cast<const char8_t*>(InUtf8.data()), InUtf8.size());
+		}
+
+		std::string ToUtf8(const std::filesystem::path& InPath)
+		{
+			const auto text = InPath.u8string();
+			return std::string(reinterpret_cast<const char*>(text.data()), text.size());
+		}
+
+		template <class Time>
+		int64_t TimeStamp(const Time& InTime)
+		{
+			return InTime.time_since_epoch().count();
+		}
+	}
+
+	const TrackMetadata* MetadataTable::Find(std::string_view InSource) const
+	{
+		const auto found = Entries.find(Fnv1a64(InSource));
+		return found != Entries.end() ? &found->second.Metadata : nullptr;
+	}
+
+	std::span<const std::string> MetadataTable::GetFolder(std::string_view InSpec) const
+	{
+		const auto found = Folders.find(Fnv1a64(InSpec));
+		return found != Folders.end() ? std::span<const std::string>(found->second) : std::span<const std::string>();
+	}
+
+	MetadataStore::MetadataStore(SourceFactory InOpenSource, std::filesystem::path InFile) :
+		OpenSource(std::move(InOpenSource)),
+		File(std::move(InFile))
+	{
+		// What was stored last session is usable right away, folder stations included; scans
+		// only fill in the gaps.
+		auto loaded = std::make_shared<MetadataTable>();
+		Load(*loaded);
+		Table.store(std::move(loaded));
+		Worker = std::thread(&MetadataStore::Run, this);
+	}
+
+	MetadataStore::~MetadataStore()
+	{
+		{
+			std::lock_guard lock(Mutex);
+			Quit = true;
+		}
+		Wake.notify_all();
+		Worker.join();
+	}
+
+	void MetadataStore::Scan(std::span<const std::string_view> InTracks, std::span<const std::string_view> InFolders)
+	{
+		{
+			std::lock_guard lock(Mutex);
+			PendingTracks.clear();
+			for (const auto source : InTracks) {
+				if (!source.contains("://"))
+					PendingTracks.emplace_back(source);
+			}
+			PendingFolders.assign(InFolders.begin(), InFolders.end());
+			HasPending = true;
+		}
+		Wake.notify_one();
+	}
+
+	void MetadataStore::Run()
+	{
+		Control::EnterThread("Radio Metadata", Control::ThreadRole::Io);
+
+		for (;;) {
+			std::vector<std::string> tracks;
+			std::vector<std::string> folders;
+			{
+				std::unique_lock lock(Mutex);
+				Wake.wait(lock, [&] { return Quit || HasPending; });
+				if (Quit)
+					return;
+				tracks.swap(PendingTracks);
+				folders.swap(PendingFolders);
+				HasPending = false;
+			}
+
+			// Tracks listed one by one are checked directly; folder tracks come from the
+			// directory listings.
+			std::vector<Candidate> candidates;
+			for (const auto& source : tracks) {
+				std::error_code sizeError;
+				std::error_code timeError;
+				const auto      path = ToPath(source);
+				const auto      size = std::filesystem::file_size(path, sizeError);
+				const auto      modified = TimeStamp(std::filesystem::last_write_time(path, timeError));
+				if (!sizeError && !timeError)
+					candidates.push_back({ source, size, modified });
+			}
+
+			DirectoryMap                                     directories;
+			std::vector<std::pair<std::size_t, std::size_t>> folderFiles;  // range of candidates per folder
+			uint32_t                                         listed = 0;
+			for (const auto& folder : folders) {
+				const auto first = candidates.size();
+				ScanFolder(folder, directories, candidates, listed);
+				folderFiles.emplace_back(first, candidates.size());
+			}
+			if (Quit)
+				return;
+
+			const auto current = GetTable();
+			auto       next = std::make_shared<MetadataTable>();
+
+			// Unchanged tracks keep their entries; the rest are parsed in parallel, each job
+			// opening its own source.
+			struct Job
+			{
+				uint64_t             Key = 0;
+				const Candidate*     File = nullptr;
+				MetadataTable::Entry Entry;
+				bool                 Parsed = false;
+			};
+
+			std::vector<Job>             jobs;
+			std::unordered_set<uint64_t> queued;
+			for (const auto& candidate : candidates) {
+				const uint64_t key = Fnv1a64(candidate.Source);
+				if (next->Entries.contains(key))
+					continue;
+
+				if (const auto found = current->Entries.find(key); found != current->Entries.end() &&
+																	 found->second.FileSize == candidate.FileSize && found->second.ModifiedTime == candidate.ModifiedTime) {
+					next->Entries.emplace(key, found->second);
+					continue;
+				}
+
+				if (queued.insert(key).second)
+					jobs.push_back({ key, &candidate, { candidate.FileSize, candidate.ModifiedTime, {} } });
+			}
+
+			std::for_each(std::execution::par, jobs.begin(), jobs.end(), [this](Job& InOutJob) {
+				if (Quit)
+					return;
+				const auto stream = OpenSource(InOutJob.File->Source);
+				InOutJob.Parsed = stream && ReadTrackMetadata(*stream, InOutJob.Entry.Metadata);
+			});
+			if (Quit)
+				return;
+
+			uint32_t parsed = 0;
+			for (auto& job : jobs) {
+				if (!job.Parsed) {
+					INFO("{} - Could not read track metadata: {}", Plugin::NAME, job.File->Source);
+					continue;
+				}
+				next->Entries.emplace(job.Key, std::move(job.Entry));
+				++parsed;
+			}
+
+			// A folder plays the tracks that could be read, in path order.
+			for (std::size_t i = 0; i < folders.size(); ++i) {
+				auto& paths = next->Folders[Fnv1a64(folders[i])];
+				for (std::size_t file = folderFiles[i].first; file < folderFiles[i].second; ++file) {
+					if (next->Entries.contains(Fnv1a64(candidates[file].Source)))
+						paths.push_back(candidates[file].Source);
+				}
+				std::ranges::sort(paths);
+				paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+			}
+
+			// Directories no folder reaches any more are dropped with the rest.
+			const bool listingsChanged = listed > 0 || directories.size() != Directories.size();
+			Directories = std::move(directories);
+
+			if (parsed == 0 && !listingsChanged && next->Entries.size() == current->Entries.size() && next->Folders == current->Folders)
+				continue;
+
+			Save(*next);
+			Table.store(std::move(next), std::memory_order_release);
+			INFO("{} - Library updated, {} track(s) parsed, {} folder(s) listed", Plugin::NAME, parsed, listed);
+		}
+	}
+
+	void MetadataStore::ScanFolder(std::string_view InSpec, DirectoryMap& OutDirectories, std::vector<Candidate>& OutFiles, uint32_t& OutListed)
+	{
+		const auto spec = ParseFolderSpec(InSpec);
+
+		// Directories still to visit, with their paths relative to the root ("Live/2023/").
+		std::vector<std::pair<std::filesystem::path, std::string>> pending;
+		pending.emplace_back(spec.Root, std::string());
+
+		while (!pending.empty() && !Quit) {
+			auto [path, relative] = std::move(pending.back());
+			pending.pop_back();
+
+			std::error_code ec;
+			const auto      modified = TimeStamp(std::filesystem::last_write_time(path, ec));
+			if (ec)
+				continue;
+
+			// Listed once per scan even when several folders share it, and only when it changed
+			// since the last one.
+			auto key = ToUtf8(path);
+			auto visited = OutDirectories.find(key);
+			if (visited == OutDirectories.end()) {
+				Directory directory;
+				if (const auto cached = Directories.find(key); cached != Directories.end() && cached->second.ModifiedTime == modified) {
+					directory = std::move(cached->second);
+				} else {
+					directory.ModifiedTime = modified;
+
+					std::filesystem::directory_iterator entries(path, std::filesystem::directory_options::skip_permission_denied, ec);
+					for (; !ec && entries != std::filesystem::directory_iterator(); entries.increment(ec)) {
+						const auto&     entry = *entries;
+						std::error_code entryError;
+
+						// Linked directories are not followed; they may lead back up the tree.
+						if (entry.is_directory(entryError)) {
+							if (!entry.is_symlink(entryError))
+								directory.Subdirectories.push_back(ToUtf8(entry.path().filename()));
+						} else if (entry.is_regular_file(entryError)) {
+							FileEntry file{ ToUtf8(entry.path().filename()), entry.file_size(entryError), TimeStamp(entry.last_write_time(entryError)) };
+							if (!entryError)
+								directory.Files.push_back(std::move(file));
+						}
+					}
+					++OutListed;
+				}
+				visited = OutDirectories.emplace(std::move(key), std::move(directory)).first;
+			}
+
+			const Directory& directory = visited->second;
+			for (const auto& file : directory.Files) {
+				if (MatchGlob(spec.Pattern, relative + file.Name))
+					OutFiles.push_back({ ToUtf8(path / ToPath(file.Name)), file.FileSize, file.ModifiedTime });
+			}
+
+			if (spec.Recursive) {
+				for (const auto& name : directory.Subdirectories)
+					pending.emplace_back(path / ToPath(name), relative + name + '/');
+			}
+		}
+	}
+
+	void MetadataStore::Load(MetadataTable& OutTable)
+	{
+		std::error_code ec;
+		const auto      size = std::filesystem::file_size(File, ec);
+		if (ec || size > kMaxStoreBytes)
+			return;
+
+		std::string   bytes(static_cast<std::size_t>(size), '\0');
+		std::ifstream file(File, std::ios::binary);
+		if (!file.read(bytes.data(), static_cast<std::streamsize>(size)))
+			return;
+
+		std::string_view data = bytes;
+		uint32_t         magic = 0;
+		uint32_t         format = 0;
+		uint32_t         count = 0;
+		if (!Get(data, magic) || !Get(data, format) || !Get(data, count) || magic != kStoreMagic || format != kStoreFormat)
+			return;
+
+		// Anything truncated or corrupt discards the whole store; the next scan rebuilds it.
+		const auto fail = [&] {
+			OutTable.Entries.clear();
+			OutTable.Folders.clear();
+			Directories.clear();
+		};
+
+		for (uint32_t i = 0; i < count; ++i) {
+			uint64_t             key = 0;
+			MetadataTable::Entry entry;
+			auto&                metadata = entry.Metadata;
+			if (!Get(data, key) || !Get(data, entry.FileSize) || !Get(data, entry.ModifiedTime) ||
+				!Get(data, metadata.DurationMs) || !Get(data, metadata.Bitrate) || !Get(data, metadata.SampleRate) || !Get(data, metadata.Channels) ||
+				!GetString(data, metadata.Title) || !GetString(data, metadata.Artist)) {
+				return fail();
+			}
+			OutTable.Entries.emplace(key, std::move(entry));
+		}
+
+		if (!Get(data, count))
+			return fail();
+		for (uint32_t i = 0; i < count; ++i) {
+			uint64_t key = 0;
+			uint32_t paths = 0;
+			if (!Get(data, key) || !Get(data, paths) || paths > data.size() / sizeof(uint32_t))
+				return fail();
+			auto& folder = OutTable.Folders[key];
+			folder.resize(paths);
+			for (auto& path : folder) {
+				if (!GetString(data, path))
+					return fail();
+			}
+		}
+
+		if (!Get(data, count))
+			return fail();
+		for (uint32_t i = 0; i < count; ++i) {
+			std::string path;
+			Directory   directory;
+			uint32_t    files = 0;
+			uint32_t    subdirectories = 0;
+			if (!GetString(data, path) || !Get(data, directory.ModifiedTime) || !Get(data, files))
+				return fail();
+			for (uint32_t j = 0; j < files; ++j) {
+				FileEntry entry;
+				if (!GetString(data, entry.Name) || !Get(data, entry.FileSize) || !Get(data, entry.ModifiedTime))
+					return fail();
+				directory.Files.push_back(std::move(entry));
+			}
+			if (!Get(data, subdirectories))
+				return fail();
+			for (uint32_t j = 0; j < subdirectories; ++j) {
+				if (!GetString(data, directory.Subdirectories.emplace_back()))
+					return fail();
+			}
+			Directories.emplace(std::move(path), std::move(directory));
+		}
+	}
+
+	void MetadataStore::Save(const MetadataTable& InTable) const
+	{
+		std::string data;
+		Put(data, kStoreMagic);
+		Put(data, kStoreFormat);
+		Put(data, static_cast<uint32_t>(InTable.Entries.size()));
+		for (const auto& [key, entry] : InTable.Entries) {
+			const auto& metadata = entry.Metadata;
+			Put(data, key);
+			Put(data, entry.FileSize);
+			Put(data, entry.ModifiedTime);
+			Put(data, metadata.DurationMs);
+			Put(data, metadata.Bitrate);
+			Put(data, metadata.SampleRate);
+			Put(data, metadata.Channels);
+			PutString(data, metadata.Title);
+			PutString(data, metadata.Artist);
+		}
+
+		Put(data, static_cast<uint32_t>(InTable.Folders.size()));
+		for (const auto& [key, paths] : InTable.Folders) {
+			Put(data, key);
+			Put(data, static_cast<uint32_t>(paths.size()));
+			for (const auto& path : paths)
+				PutString(data, path);
+		}
+
+		Put(data, static_cast<uint32_t>(Directories.size()));
+		for (const auto& [path, directory] : Directories) {
+			PutString(data, path);
+			Put(data, directory.ModifiedTime);
+			Put(data, static_cast<uint32_t>(directory.Files.size()));
+			for (const auto& file : directory.Files) {
+				PutString(data, file.Name);
+				Put(data, file.FileSize);
+				Put(data, file.ModifiedTime);
+			}
+			Put(data, static_cast<uint32_t>(directory.Subdirectories.size()));
+			for (const auto& name : directory.Subdirectories)
+				PutString(data, name);
+		}
+
+		std::error_code ec;
+		std::filesystem::create_directories(File.parent_path(), ec);
+
+		std::ofstream file(File, std::ios::binary | std::ios::trunc);
+		file.write(data.data(), static_cast<std::streamsize>(data.size()));
+		if (!file.good())
+			INFO("{} - Could not write the library index", Plugin::NAME);
+	}
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Audio/PreparedStream.h"
+#include "Audio/TrackMetadata.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Audio
+{
+	// Immutable set of scanned tracks. A new table is published after every scan.
+	class MetadataTable
+	{
+	public:
+		// Metadata of a track by its path, or nullptr if it has not been scanned.
+		const TrackMetadata* Find(std::string_view InSource) const;
+
+		// Tracks of a folder station, by their paths in order; empty until the folder is scanned.
+		std::span<const std::string> GetFolder(std::string_view InSpec) const;
+
+	private:
+		friend class MetadataStore;
+
+		struct Entry
+		{
+			uint64_t      FileSize = 0;
+			int64_t       ModifiedTime = 0;
+			TrackMetadata Metadata;
+		};
+
+		std::unordered_map<uint64_t, Entry>                    Entries;  // by Fnv1a64 of the path
+		std::unordered_map<uint64_t, std::vector<std::string>> Folders;  // by Fnv1a64 of the spec
+	};
+
+	// Library index of the local stations: track metadata read from the MP3 headers on a
+	// background thread and kept on disk, stamped with each file's size and modification time,
+	// plus the listing of every directory under a folder station. A track is only parsed again
+	// after it changes, and a directory is only listed again after its own modification time
+	// changes, so a scan of an unchanged library costs one stat per directory. New tracks are
+	// parsed in parallel. Readers get the current table with a single atomic load.
+	//
+	// A file rewritten in place keeps its directory's time, so a folder track edited that way is
+	// only parsed again once something is added to, removed from or renamed in its directory.
+	class MetadataStore
+	{
+	public:
+		MetadataStore(SourceFactory InOpenSource, std::filesystem::path InFile);
+		~MetadataStore();
+
+		MetadataStore(const MetadataStore&) = delete;
+		MetadataStore& operator=(const MetadataStore&) = delete;
+
+		// Scans the local tracks among InTracks and the folder stations in InFolders (see
+		// FolderSpec), replacing any scan still pending. Tracks found by neither are dropped.
+		void Scan(std::span<const std::string_view> InTracks, std::span<const std::string_view> InFolders);
+
+		std::shared_ptr<const MetadataTable> GetTable() const { return Table.load(std::memory_order_acquire); }
+
+	private:
+		struct FileEntry
+		{
+			std::string Name;
+			uint64_t    FileSize = 0;
+			int64_t     ModifiedTime = 0;
+		};
+
+		struct Directory
+		{
+			int64_t                  ModifiedTime = 0;
+			std::vector<FileEntry>   Files;
+			std::vector<std::string> Subdirectories;
+		};
+
+		// A file found by a scan, with what the file system says about it.
+		struct Candidate
+		{
+			std::string Source;
+			uint64_t    FileSize = 0;
+			int64_t     ModifiedTime = 0;
+		};
+
+		using DirectoryMap = std::unordered_map<std::string, Directory>;  // by UTF-8 path
+
+		void Run();
+		void ScanFolder(std::string_view InSpec, DirectoryMap& OutDirectories, std::vector<Candidate>& OutFiles, uint32_t& OutListed);
+		void Load(MetadataTable& OutTable);
+		void Save(const MetadataTable& InTable) const;
+
+		SourceFactory         OpenSource;
+		std::filesystem::path File;
+
+		std::atomic<std::shared_ptr<const MetadataTable>> Table;
+
+		DirectoryMap Directories;  // worker thread only, once it runs
+
+		std::mutex               Mutex;
+		std::condition_variable  Wake;
+		std::vector<std::string> PendingTracks;
+		std::vector<std::string> PendingFolders;
+		bool                     HasPending = false;
+		std::atomic<bool>        Quit = false;
+		std::thread              Worker;
+	};
+}
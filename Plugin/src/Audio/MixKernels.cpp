@@ -0,0 +1,206 @@
+#include "Audio/MixKernels.h"
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#	define MIX_TARGET_AVX2
+#else
+#	define MIX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace Audio
+{
+	namespace
+	{
+		// Frame offsets of the lanes in one vector: mono advances a frame per lane, stereo
+		// every second lane. Other layouts take the scalar path.
+		constexpr float kMonoLanes[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+		constexpr float kStereoLanes[8] = { 0, 0, 1, 1, 2, 2, 3, 3 };
+
+		bool HasVectorLayout(uint32_t InChannels)
+		{
+			return InChannels == 1 || InChannels == 2;
+		}
+
+		// Scalar tails and reference kernels. InFirstFrame is the frame number of InOutSamples[0]
+		// within the ramp, so a vector loop can hand over its remainder.
+
+		void ScaleScalar(std::span<float> InOutSamples, float InGain)
+		{
+			for (float& sample : InOutSamples)
+				sample *= InGain;
+		}
+
+		void RampFrom(std::span<float> InOutSamples, uint32_t InChannels, float InGain, float InStep, std::size_t InFirstFrame)
+		{
+			for (std::size_t i = 0; i < InOutSamples.size(); ++i)
+				InOutSamples[i] *= InGain + InStep * static_cast<float>(InFirstFrame + i / InChannels);
+		}
+
+		void MixRampFrom(std::span<float> InOutSamples, const float* InSamples, uint32_t InChannels, float InGain, float InStep, std::size_t InFirstFrame)
+		{
+			for (std::size_t i = 0; i < InOutSamples.size(); ++i)
+				InOutSamples[i] += InSamples[i] * (InGain + InStep * static_cast<float>(InFirstFrame + i / InChannels));
+		}
+
+		void RampScalar(std::span<float> InOutSamples, uint32_t InChannels, float InGain, float InStep)
+		{
+			RampFrom(InOutSamples, InChannels, InGain, InStep, 0);
+		}
+
+		void MixRampScalar(std::span<float> InOutSamples, std::span<const float> InSamples, uint32_t InChannels, float InGain, float InStep)
+		{
+			MixRampFrom(InOutSamples, InSamples.data(), InChannels, InGain, InStep, 0);
+		}
+
+		// SSE2 is part of x64, so these need no CPU check. The gain of each vector is rebuilt
+		// from an exact frame counter rather than accumulated, so long ramps do not drift.
+
+		void ScaleSse2(std::span<float> InOutSamples, float InGain)
+		{
+			float*     data = InOutSamples.data();
+			const auto gain = _mm_set1_ps(InGain);
+			const auto vectorEnd = InOutSamples.size() & ~std::size_t(3);
+			for (std::size_t i = 0; i < vectorEnd; i += 4)
+				_mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), gain));
+			ScaleScalar(InOutSamples.subspan(vectorEnd), InGain);
+		}
+
+		void RampSse2(std::span<float> InOutSamples, uint32_t InChannels, float InGain, float InStep)
+		{
+			if (!HasVectorLayout(InChannels)) {
+				RampFrom(InOutSamples, InChannels, InGain, InStep, 0);
+				return;
+			}
+
+			float*      data = InOutSamples.data();
+			const auto  lanes = _mm_loadu_ps(InChannels == 1 ? kMonoLanes : kStereoLanes);
+			const auto  start = _mm_set1_ps(InGain);
+			const auto  step = _mm_set1_ps(InStep);
+			const auto  framesPerVector = 4 / InChannels;
+			const auto  vectorEnd = InOutSamples.size() & ~std::size_t(3);
+			std::size_t frame = 0;
+			for (std::size_t i = 0; i < vectorEnd; i += 4, frame += framesPerVector) {
+				const auto gain = _mm_add_ps(start, _mm_mul_ps(step, _mm_add_ps(_mm_set1_ps(static_cast<float>(frame)), lanes)));
+				_mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), gain));
+			}
+			RampFrom(InOutSamples.subspan(vectorEnd), InChannels, InGain, InStep, frame);
+		}
+
+		void MixRampSse2(std::span<float> InOutSamples, std::span<const float> InSamples, uint32_t InChannels, float InGain, float InStep)
+		{
+			if (!HasVectorLayout(InChannels)) {
+				MixRampFrom(InOutSamples, InSamples.data(), InChannels, InGain, InStep, 0);
+				return;
+			}
+
+			float*       data = InOutSamples.data();
+			const float* source = InSamples.data();
+			const auto   lanes = _mm_loadu_ps(InChannels == 1 ? kMonoLanes : kStereoLanes);
+			const auto   start = _mm_set1_ps(InGain);
+			const auto   step = _mm_set1_ps(InStep);
+			const auto   framesPerVector = 4 / InChannels;
+			const auto   vectorEnd = InOutSamples.size() & ~std::size_t(3);
+			std::size_t  frame = 0;
+			for (std::size_t i = 0; i < vectorEnd; i += 4, frame += framesPerVector) {
+				const auto gain = _mm_add_ps(start, _mm_mul_ps(step, _mm_add_ps(_mm_set1_ps(static_cast<float>(frame)), lanes)));
+				_mm_storeu_ps(data + i, _mm_add_ps(_mm_loadu_ps(data + i), _mm_mul_ps(_mm_loadu_ps(source + i), gain)));
+			}
+			MixRampFrom(InOutSamples.subspan(vectorEnd), source + vectorEnd, InChannels, InGain, InStep, frame);
+		}
+
+		MIX_TARGET_AVX2 void ScaleAvx2(std::span<float> InOutSamples, float InGain)
+		{
+			float*     data = InOutSamples.data();
+			const auto gain = _mm256_set1_ps(InGain);
+			const auto vectorEnd = InOutSamples.size() & ~std::size_t(7);
+			for (std::size_t i = 0; i < vectorEnd; i += 8)
+				_mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), gain));
+			ScaleScalar(InOutSamples.subspan(vectorEnd), InGain);
+		}
+
+		MIX_TARGET_AVX2 void RampAvx2(std::span<float> InOutSamples, uint32_t InChannels, float InGain, float InStep)
+		{
+			if (!HasVectorLayout(InChannels)) {
+				RampFrom(InOutSamples, InChannels, InGain, InStep, 0);
+				return;
+			}
+
+			float*      data = InOutSamples.data();
+			const auto  lanes = _mm256_loadu_ps(InChannels == 1 ? kMonoLanes : kStereoLanes);
+			const auto  start = _mm256_set1_ps(InGain);
+			const auto  step = _mm256_set1_ps(InStep);
+			const auto  framesPerVector = 8 / InChannels;
+			const auto  vectorEnd = InOutSamples.size() & ~std::size_t(7);
+			std::size_t frame = 0;
+			for (std::size_t i = 0; i < vectorEnd; i += 8, frame += framesPerVector) {
+				const auto gain = _mm256_add_ps(start, _mm256_mul_ps(step, _mm256_add_ps(_mm256_set1_ps(static_cast<float>(frame)), lanes)));
+				_mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), gain));
+			}
+			RampFrom(InOutSamples.subspan(vectorEnd), InChannels, InGain, InStep, frame);
+		}
+
+		MIX_TARGET_AVX2 void MixRampAvx2(std::span<float> InOutSamples, std::span<const float> InSamples, uint32_t InChannels, float InGain, float InStep)
+		{
+			if (!HasVectorLayout(InChannels)) {
+				MixRampFrom(InOutSamples, InSamples.data(), InChannels, InGain, InStep, 0);
+				return;
+			}
+
+			float*       data = InOutSamples.data();
+			const float* source = InSamples.data();
+			const auto   lanes = _mm256_loadu_ps(InChannels == 1 ? kMonoLanes : kStereoLanes);
+			const auto   start = _mm256_set1_ps(InGain);
+			const auto   step = _mm256_set1_ps(InStep);
+			const auto   framesPerVector = 8 / InChannels;
+			const auto   vectorEnd = InOutSamples.size() & ~std::size_t(7);
+			std::size_t  frame = 0;
+			for (std::size_t i = 0; i < vectorEnd; i += 8, frame += framesPerVector) {
+				const auto gain = _mm256_add_ps(start, _mm256_mul_ps(step, _mm256_add_ps(_mm256_set1_ps(static_cast<float>(frame)), lanes)));
+				_mm256_storeu_ps(data + i, _mm256_add_ps(_mm256_loadu_ps(data + i), _mm256_mul_ps(_mm256_loadu_ps(source + i), gain)));
+			}
+			MixRampFrom(InOutSamples.subspan(vectorEnd), source + vectorEnd, InChannels, InGain, InStep, frame);
+		}
+
+		bool HasAvx2()
+		{
+#if defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7)
+				return false;
+
+			// AVX2 in hardware, and the OS saves the YMM registers.
+			__cpuid(info, 1);
+			const bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+			__cpuidex(info, 7, 0);
+			return osSavesYmm && (info[1] & (1 << 5));
+#else
+			return __builtin_cpu_supports("avx2");
+#endif
+		}
+
+		constexpr MixKernels kScalarKernels{ "scalar", ScaleScalar, RampScalar, MixRampScalar };
+		constexpr MixKernels kSse2Kernels{ "SSE2", ScaleSse2, RampSse2, MixRampSse2 };
+		constexpr MixKernels kAvx2Kernels{ "AVX2", ScaleAvx2, RampAvx2, MixRampAvx2 };
+	}
+
+	const MixKernels& GetMixKernels()
+	{
+		static const MixKernels& kernels = HasAvx2() ? kAvx2Kernels : kSse2Kernels;
+		return kernels;
+	}
+
+	const MixKernels& GetScalarMixKernels()
+	{
+		return kScalarKernels;
+	}
+
+	std::span<const MixKernels* const> GetSupportedMixKernels()
+	{
+		static constexpr const MixKernels* kAll[] = { &kScalarKernels, &kSse2Kernels, &kAvx2Kernels };
+		static const std::size_t           count = HasAvx2() ? 3 : 2;
+		return { kAll, count };
+	}
+}
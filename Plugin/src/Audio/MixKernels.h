@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace Audio
+{
+	// Gain and mix kernels on interleaved float PCM. Ramps start at InGain on the first frame
+	// and change by InStep per frame; all channels of a frame get the same gain. None of them
+	// allocate, so they are safe on the render thread.
+	struct MixKernels
+	{
+		const char* Name;
+
+		// Samples *= InGain.
+		void (*Scale)(std::span<float> InOutSamples, float InGain);
+
+		// Samples *= ramp.
+		void (*Ramp)(std::span<float> InOutSamples, uint32_t InChannels, float InGain, float InStep);
+
+		// Samples += InSamples * ramp. InSamples is at least as long as InOutSamples.
+		void (*MixRamp)(std::span<float> InOutSamples, std::span<const float> InSamples, uint32_t InChannels, float InGain, float InStep);
+	};
+
+	// Fastest kernels the CPU supports (AVX2, SSE2), picked on first use.
+	const MixKernels& GetMixKernels();
+
+	// Plain C++ kernels, the reference the SIMD ones are measured against.
+	const MixKernels& GetScalarMixKernels();
+
+	// Every set the CPU can run, scalar first, for tests and benchmarks.
+	std::span<const MixKernels* const> GetSupportedMixKernels();
+}
@@ -0,0 +1,290 @@
+#include "Audio/Mp3.h"
+
+#include "Audio/ByteSource.h"
+#include "Audio/SeekIndex.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Audio
+{
+	namespace
+	{
+		constexpr std::size_t kBufferBytes = 64 * 1024;
+
+		// Layer III frames borrow bits from up to ~511 bytes of their predecessors; decoding
+		// this many frames before a seek target gives the decoder what it needs.
+		constexpr uint32_t kPrerollFrames = 2;
+
+		constexpr uint16_t kBitratesV1[16] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 };
+		constexpr uint16_t kBitratesV2[16] = { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 };
+		constexpr uint32_t kSampleRates[3] = { 44100, 48000, 32000 };
+
+		uint32_t ReadBigEndian32(const uint8_t* InBytes)
+		{
+			return (uint32_t(InBytes[0]) << 24) | (uint32_t(InBytes[1]) << 16) | (uint32_t(InBytes[2]) << 8) | uint32_t(InBytes[3]);
+		}
+	}
+
+	std::optional<Mp3FrameHeader> ParseFrameHeader(const uint8_t* InBytes)
+	{
+		if (InBytes[0] != 0xFF || (InBytes[1] & 0xE0) != 0xE0)
+			return std::nullopt;
+
+		const uint8_t versionBits = (InBytes[1] >> 3) & 0x3;
+		const uint8_t layerBits = (InBytes[1] >> 1) & 0x3;
+		const uint8_t bitrateIndex = (InBytes[2] >> 4) & 0xF;
+		const uint8_t sampleRateIndex = (InBytes[2] >> 2) & 0x3;
+
+		// Layer III only, no reserved version, no free format, no reserved sample rate.
+		if (versionBits == 1 || layerBits != 1 || bitrateIndex == 0 || bitrateIndex == 15 || sampleRateIndex == 3)
+			return std::nullopt;
+
+		Mp3FrameHeader header;
+		header.Version = versionBits == 3 ? 10 : (versionBits == 2 ? 20 : 25);
+		header.Bitrate = header.Version == 10 ? kBitratesV1[bitrateIndex] : kBitratesV2[bitrateIndex];
+		header.SampleRate = kSampleRates[sampleRateIndex] >> (header.Version == 10 ? 0 : (header.Version == 20 ? 1 : 2));
+		header.Padding = (InBytes[2] >> 1) & 0x1;
+		header.Channels = ((InBytes[3] >> 6) & 0x3) == 3 ? 1 : 2;
+		header.SamplesPerFrame = header.Version == 10 ? 1152 : 576;
+
+		const uint32_t coefficient = header.Version == 10 ? 144 : 72;
+		header.FrameBytes = static_cast<uint16_t>(coefficient * header.Bitrate * 1000 / header.SampleRate + (header.Padding ? 1 : 0));
+
+		return header;
+	}
+
+	std::size_t GetId3v2Size(std::span<const uint8_t> InBytes)
+	{
+		if (InBytes.size() < 10 || std::memcmp(InBytes.data(), "ID3", 3) != 0)
+			return 0;
+
+		// Sizes are syncsafe: 7 bits per byte.
+		const std::size_t size = (std::size_t(InBytes[6] & 0x7F) << 21) | (std::size_t(InBytes[7] & 0x7F) << 14) |
+		                         (std::size_t(InBytes[8] & 0x7F) << 7) | std::size_t(InBytes[9] & 0x7F);
+		const bool hasFooter = (InBytes[5] & 0x10) != 0;
+
+		return 10 + size + (hasFooter ? 10 : 0);
+	}
+
+	Mp3Stream::Mp3Stream(ByteSource& InSource) :
+		Source(InSource),
+		Mapping(InSource.GetMapping())
+	{
+		if (Mapping.empty())
+			Buffer.resize(kBufferBytes);
+		Data = Mapping.empty() ? Buffer.data() : Mapping.data();
+	}
+
+	bool Mp3Stream::Open()
+	{
+		ResetBuffer();
+		if (!Fill(10))
+			return false;
+
+		// ID3v2 tags can be larger than the buffer (embedded cover art), so skip them on the source.
+		if (const auto tagSize = GetId3v2Size({ Data + Begin, End - Begin }); tagSize > 0) {
+			if (tagSize <= End - Begin) {
+				Begin += tagSize;
+			} else if (Source.Seek(Tell() + tagSize)) {
+				ResetBuffer();
+			} else {
+				return false;
+			}
+		}
+
+		if (!Resync())
+			return false;
+
+		Info.DataOffset = Tell();
+		Info.First = *ParseFrameHeader(Data + Begin);
+
+		const auto sourceSize = Source.Size();
+		Info.DataBytes = sourceSize > Info.DataOffset ? sourceSize - Info.DataOffset : 0;
+
+		// The first frame may be a Xing/Info header frame that carries no audio; it is harmless to the decoder.
+		if (Fill(Info.First.FrameBytes))
+			ParseXing(Info.First, { Data + Begin, Info.First.FrameBytes });
+
+		if (Info.TotalFrames > 0)
+			Info.DurationMs = static_cast<uint32_t>(uint64_t(Info.TotalFrames) * Info.First.SamplesPerFrame * 1000 / Info.First.SampleRate);
+		else if (Info.DataBytes > 0)
+			Info.DurationMs = static_cast<uint32_t>(Info.DataBytes * 8 / Info.First.Bitrate);
+
+		return true;
+	}
+
+	std::span<const uint8_t> Mp3Stream::NextFrame(Mp3FrameHeader* OutHeader)
+	{
+		for (;;) {
+			if (!Fill(4))
+				return {};
+
+			const auto header = ParseFrameHeader(Data + Begin);
+			if (!header || !header->SameStream(Info.First)) {
+				++Begin;
+				if (!Resync())
+					return {};
+				continue;
+			}
+
+			if (!Fill(header->FrameBytes))
+				return {};
+
+			std::span<const uint8_t> frame{ Data + Begin, header->FrameBytes };
+			Begin += header->FrameBytes;
+			if (OutHeader)
+				*OutHeader = *header;
+			return frame;
+		}
+	}
+
+	bool Mp3Stream::SeekToMs(uint32_t InMs)
+	{
+		if (!IsSeekable())
+			return false;
+
+		SeekDiscard = 0;
+		if (Index && Index->GetTotalFrames() > 0) {
+			const uint32_t spf = Info.First.SamplesPerFrame;
+			const uint64_t targetSample = uint64_t(InMs) * Info.First.SampleRate / 1000;
+			const auto     targetFrame = static_cast<uint32_t>(std::min<uint64_t>(targetSample / spf, Index->GetTotalFrames() - 1));
+			const uint32_t startFrame = targetFrame > kPrerollFrames ? targetFrame - kPrerollFrames : 0;
+
+			uint32_t frame = 0;
+			if (!Source.Seek(Index->GetOffset(startFrame, frame)))
+				return false;
+			ResetBuffer();
+			for (; frame < startFrame; ++frame) {
+				if (NextFrame().empty())
+					return false;
+			}
+
+			const uint64_t withinFrame = targetSample / spf == targetFrame ? targetSample % spf : 0;
+			SeekDiscard = (targetFrame - startFrame) * spf + static_cast<uint32_t>(withinFrame);
+			return true;
+		}
+
+		uint64_t offset = 0;
+		if (Info.DurationMs > 0 && InMs > 0) {
+			InMs = std::min(InMs, Info.DurationMs - 1);
+			if (Info.HasToc) {
+				// Xing TOC: 100 entries, each the byte position (out of 256) of that percentage of the track.
+				const double percent = 100.0 * InMs / Info.DurationMs;
+				const auto   index = std::min(static_cast<std::size_t>(percent), std::size_t(99));
+				const double lower = Info.Toc[index];
+				const double upper = index < 99 ? Info.Toc[index + 1] : 256.0;
+				const double scaled = lower + (upper - lower) * (percent - index);
+				offset = static_cast<uint64_t>(scaled / 256.0 * Info.DataBytes);
+			} else {
+				offset = uint64_t(InMs) * Info.First.Bitrate / 8;
+			}
+		}
+
+		if (!Source.Seek(Info.DataOffset + std::min(offset, Info.DataBytes)))
+			return false;
+
+		ResetBuffer();
+		return true;
+	}
+
+	bool Mp3Stream::IsSeekable() const
+	{
+		return Info.DataBytes > 0;
+	}
+
+	bool Mp3Stream::Fill(std::size_t InMinBytes)
+	{
+		if (!Mapping.empty())
+			return End - Begin >= InMinBytes;
+
+		while (End - Begin < InMinBytes) {
+			if (Eof)
+				return false;
+
+			if (Begin > 0) {
+				std::memmove(Buffer.data(), Data + Begin, End - Begin);
+				End -= Begin;
+				Begin = 0;
+			}
+
+			const auto count = Source.Read({ Buffer.data() + End, Buffer.size() - End });
+			if (count == 0)
+				Eof = true;
+			End += count;
+		}
+		return true;
+	}
+
+	bool Mp3Stream::Resync()
+	{
+		for (;;) {
+			if (!Fill(4))
+				return false;
+
+			const auto* data = Data;
+			for (; Begin + 4 <= End; ++Begin) {
+				const auto header = ParseFrameHeader(data + Begin);
+				if (!header)
+					continue;
+
+				// Confirm with the following frame header to avoid locking onto 0xFFE garbage inside tag data.
+				if (!Fill(header->FrameBytes + 4))
+					return Fill(header->FrameBytes);
+				data = Data;
+
+				const auto next = ParseFrameHeader(data + Begin + header->FrameBytes);
+				if (next && next->SameStream(*header))
+					return true;
+			}
+		}
+	}
+
+	void Mp3Stream::ParseXing(const Mp3FrameHeader& InHeader, std::span<const uint8_t> InFrame)
+	{
+		const std::size_t sideInfo = InHeader.Version == 10 ? (InHeader.Channels == 1 ? 17 : 32) : (InHeader.Channels == 1 ? 9 : 17);
+		const std::size_t offset = 4 + sideInfo;
+		if (InFrame.size() < offset + 8)
+			return;
+
+		const auto* tag = InFrame.data() + offset;
+		if (std::memcmp(tag, "Xing", 4) != 0 && std::memcmp(tag, "Info", 4) != 0)
+			return;
+		Info.HasXingFrame = true;
+
+		const uint32_t flags = ReadBigEndian32(tag + 4);
+		std::size_t    cursor = offset + 8;
+
+		if ((flags & 0x1) && cursor + 4 <= InFrame.size()) {
+			Info.TotalFrames = ReadBigEndian32(InFrame.data() + cursor);
+			cursor += 4;
+		}
+		// The byte count is ignored: the source size is authoritative and also covers trailing tags.
+		if (flags & 0x2)
+			cursor += 4;
+		if ((flags & 0x4) && cursor + 100 <= InFrame.size()) {
+			std::memcpy(Info.Toc.data(), InFrame.data() + cursor, 100);
+			Info.HasToc = true;
+		}
+	}
+
+	void Mp3Stream::ResetBuffer()
+	{
+		// A mapped source is the buffer: the window starts at its read position.
+		if (!Mapping.empty()) {
+			Begin = static_cast<std::size_t>(std::min<uint64_t>(Source.Tell(), Mapping.size()));
+			End = Mapping.size();
+			Eof = true;
+			return;
+		}
+
+		Begin = 0;
+		End = 0;
+		Eof = false;
+	}
+
+	uint64_t Mp3Stream::Tell() const
+	{
+		return Mapping.empty() ? Source.Tell() - (End - Begin) : Begin;
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Audio
+{
+	class ByteSource;
+	class SeekIndex;
+
+	// Largest legal Layer III frame (MPEG-1, 320 kbps, 32 kHz, padded) rounded up.
+	inline constexpr std::size_t kMaxFrameBytes = 2048;
+	inline constexpr std::size_t kMaxFrameSamples = 1152;
+
+	struct Mp3FrameHeader
+	{
+		uint32_t SampleRate = 0;
+		uint16_t Bitrate = 0;  // kbps
+		uint16_t FrameBytes = 0;
+		uint16_t SamplesPerFrame = 0;
+		uint8_t  Channels = 0;
+		uint8_t  Version = 0;  // 10 = MPEG-1, 20 = MPEG-2, 25 = MPEG-2.5
+		bool     Padding = false;
+
+		// Two headers belong to the same stream when everything but bitrate/padding matches.
+		bool SameStream(const Mp3FrameHeader& InOther) const
+		{
+			return SampleRate == InOther.SampleRate && Channels == InOther.Channels && Version == InOther.Version;
+		}
+	};
+
+	// Parses a 4 byte Layer III frame header. Anything else (Layer I/II, free format, reserved fields) is rejected.
+	std::optional<Mp3FrameHeader> ParseFrameHeader(const uint8_t* InBytes);
+
+	// Returns the size of a leading ID3v2 tag (including its header), or 0 if there is none.
+	std::size_t GetId3v2Size(std::span<const uint8_t> InBytes);
+
+	struct Mp3StreamInfo
+	{
+		Mp3FrameHeader           First;
+		uint64_t                 DataOffset = 0;  // first audio frame
+		uint64_t                 DataBytes = 0;   // 0 when the source size is unknown (live streams)
+		uint32_t                 TotalFrames = 0; // from a Xing/Info header, 0 when unknown
+		std::array<uint8_t, 100> Toc{};
+		bool                     HasToc = false;
+		bool                     HasXingFrame = false;  // the first frame is a Xing/Info tag, not audio
+		uint32_t                 DurationMs = 0;  // 0 when unknown
+	};
+
+	// Frame-by-frame reader on top of a ByteSource. Keeps a single reusable read buffer, so
+	// pulling frames never allocates once the stream is open. Sources that expose a mapping
+	// are read in place: frames are slices of the mapping and no buffer is allocated.
+	class Mp3Stream
+	{
+	public:
+		explicit Mp3Stream(ByteSource& InSource);
+
+		// Skips ID3v2, locates the first frame and reads Xing/Info data. Must be called once before NextFrame.
+		bool Open();
+
+		const Mp3StreamInfo& GetInfo() const { return Info; }
+
+		// Returns the next complete frame, or an empty span at end of stream. The span stays valid until the next call.
+		std::span<const uint8_t> NextFrame(Mp3FrameHeader* OutHeader = nullptr);
+
+		// Repositions at the given millisecond offset. With a seek index this is exact: the
+		// stream lands a few frames early for the decoder to prime, and GetSeekDiscard tells how
+		// many samples (per channel) to drop. Otherwise it is estimated from the TOC or bitrate.
+		bool     SeekToMs(uint32_t InMs);
+		uint32_t GetSeekDiscard() const { return SeekDiscard; }
+
+		bool IsSeekable() const;
+
+		void SetSeekIndex(std::shared_ptr<const SeekIndex> InIndex) { Index = std::move(InIndex); }
+		bool HasSeekIndex() const { return Index != nullptr; }
+
+		// Source offset of the next unread byte.
+		uint64_t Tell() const;
+
+		std::size_t GetBufferBytes() const { return Buffer.size(); }
+
+	private:
+		bool     Fill(std::size_t InMinBytes);
+		bool     Resync();
+		void     ParseXing(const Mp3FrameHeader& InHeader, std::span<const uint8_t> InFrame);
+		void     ResetBuffer();
+
+		ByteSource&              Source;
+		Mp3StreamInfo            Info;
+		std::span<const uint8_t> Mapping;
+		std::vector<uint8_t>     Buffer;
+		const uint8_t*           Data = nullptr;  // Mapping or Buffer; Begin/End index into it
+		std::size_t              Begin = 0;
+		std::size_t              End = 0;
+		bool                     Eof = false;
+
+		std::shared_ptr<const SeekIndex> Index;
+		uint32_t                         SeekDiscard = 0;
+	};
+}
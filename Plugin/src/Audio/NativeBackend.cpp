@@ -0,0 +1,491 @@
+#include "Audio/NativeBackend.h"
+
+#include "Control/MessageQueue.h"
+#include "Control/Telemetry.h"
+#include "Control/ThreadRuntime.h"
+
+namespace Audio
+{
+	namespace
+	{
+		// ~2.7 s of 48 kHz stereo; enough to ride out network hiccups without a large footprint.
+		constexpr std::size_t kRingSamples = 1 << 18;
+	}
+
+	NativeBackend::NativeBackend(std::unique_ptr<AudioSink> InSink, SourceFactory InOpenSource, DecoderFactory InCreateDecoder, std::filesystem::path InIndexDirectory) :
+		Sink(std::move(InSink)),
+		OpenSource(std::move(InOpenSource)),
+		CreateDecoder(std::move(InCreateDecoder)),
+		Pool(OpenSource, CreateDecoder),
+		Indexer(OpenSource, std::move(InIndexDirectory)),
+		Rings{ RingBuffer<float>(kRingSamples), RingBuffer<float>(kRingSamples) },
+		Scratch(kMaxFrameSamples * 2),
+		FadeScratch(kMixSamples)
+	{
+	}
+
+	NativeBackend::~NativeBackend()
+	{
+		Close();
+		Sink->Stop();
+	}
+
+	bool NativeBackend::Open(std::string_view InSource)
+	{
+		// The station being left fades out if it is playing, or goes back to the pool, unless
+		// its source had to be cancelled. A station still fading from an earlier switch is cut.
+		std::unique_ptr<PreparedStream> outgoing;
+		if (StopDecoder()) {
+			Pool.Put(std::move(Outgoing));
+			if (Current && Playing && CrossfadeMs > 0 && !Drained)
+				outgoing = std::move(Current);
+			else
+				Pool.Put(std::move(Current));
+		}
+		Close();
+
+		auto stream = Pool.Take(InSource);
+		if (stream) {
+			Control::Log("{} - Switching to warm station: {}", Plugin::NAME, InSource);
+		} else {
+			stream = PrepareStream(InSource, OpenSource, CreateDecoder);
+		}
+
+		if (!stream) {
+			Pool.Put(std::move(outgoing));
+			return false;
+		}
+		return Start(std::move(stream), std::move(outgoing));
+	}
+
+	bool NativeBackend::Start(std::unique_ptr<PreparedStream> InStream, std::unique_ptr<PreparedStream> InOutgoing)
+	{
+		const auto& info = InStream->Stream->GetInfo();
+
+		Playing = false;
+		SeekPending = false;
+		Drained = false;
+		SourceEnded = false;
+		PositionBaseMs = 0;
+
+		if (Sink->GetSampleRate() != info.First.SampleRate || Sink->GetChannels() != info.First.Channels) {
+			// No consumer while the sink is down, so the rings can be drained from here. A
+			// crossfade needs both stations in one format, so the outgoing one stops here.
+			Sink->Stop();
+			for (auto& ring : Rings)
+				ring.SkipTo(ring.WriteIndex());
+			PlayedFrames = 0;
+			Pool.Put(std::move(InOutgoing));
+			PublishMix(false);
+
+			SampleRate = info.First.SampleRate;
+			Channels = info.First.Channels;
+			if (!Sink->Start(SampleRate, Channels, [this](std::span<float> OutSamples) { Render(OutSamples); })) {
+				INFO("{} - Unable to start audio output", Plugin::NAME);
+				SampleRate = 0;
+				Channels = 0;
+				return false;
+			}
+		} else if (InOutgoing) {
+			// The outgoing station keeps its ring; the incoming one starts on the other.
+			Live ^= 1;
+			FlushMarks[Live].store(Rings[Live].WriteIndex(), std::memory_order_release);
+			FadeFrames.store(static_cast<uint32_t>(uint64_t(CrossfadeMs) * SampleRate / 1000), std::memory_order_relaxed);
+			PublishMix(true);
+			Outgoing = std::move(InOutgoing);
+		} else {
+			FlushMarks[Live].store(Rings[Live].WriteIndex(), std::memory_order_release);
+			PublishMix(false);
+		}
+
+		// A stream coming back from the pool stopped mid-frame sequence.
+		InStream->FrameDecoder->Reset();
+
+		// Local tracks get an exact seek index, built in the background the first time.
+		if (!InStream->IsLive() && !InStream->IndexRequest && !InStream->Key.contains("://"))
+			InStream->IndexRequest = Indexer.Request(InStream->Key);
+
+		LengthMs = info.DurationMs;
+		Current = std::move(InStream);
+
+		Quit = false;
+		DecoderStopped = false;
+		DecodeThread = std::thread(&NativeBackend::DecodeLoop, this);
+		return true;
+	}
+
+	bool NativeBackend::StopDecoder()
+	{
+		Quit = true;
+		Notify();
+
+		// Give a read in progress a moment to complete, so the stream stays usable. A source
+		// that stalls longer is cancelled.
+		bool stopped = true;
+		{
+			std::unique_lock lock(WakeMutex);
+			stopped = Wake.wait_for(lock, 250ms, [this] { return DecoderStopped.load(); });
+		}
+		if (!stopped) {
+			if (Current)
+				Current->Source->Cancel();
+			if (Outgoing)
+				Outgoing->Source->Cancel();
+		}
+
+		if (DecodeThread.joinable())
+			DecodeThread.join();
+		return stopped;
+	}
+
+	void NativeBackend::Close()
+	{
+		StopDecoder();
+
+		Playing = false;
+		ActiveFade = 0;
+		Current.reset();
+		Outgoing.reset();
+		LengthMs = 0;
+	}
+
+	void NativeBackend::Play()
+	{
+		if (!Playing)
+			Control::ExpectAudio(Control::Operation::FirstAudio);
+		Playing = true;
+		Notify();
+	}
+
+	void NativeBackend::PlayFrom(uint32_t InPositionMs)
+	{
+		Control::ExpectAudio(Playing ? Control::Operation::Seek : Control::Operation::FirstAudio);
+		SeekTargetMs = InPositionMs;
+		SeekPending = true;
+		Playing = true;
+		Notify();
+	}
+
+	void NativeBackend::Stop()
+	{
+		Playing = false;
+		ActiveFade = 0;
+		Control::CancelAudio(Control::Operation::FirstAudio);
+	}
+
+	void NativeBackend::SetVolume(float InVolume)
+	{
+		Gain.SetTarget(std::clamp(InVolume, 0.0f, 1.0f));
+	}
+
+	void NativeBackend::SetTrackEndHandler(std::function<void()> InHandler)
+	{
+		// Waits for a call in flight, so the old handler is not used once this returns.
+		std::lock_guard lock(TrackEndMutex);
+		OnTrackEnd = std::move(InHandler);
+	}
+
+	void NativeBackend::SetGameState(GameState InState)
+	{
+		// Pausing only fades the output; the render thread stops reading once it is silent and
+		// the decoder keeps the rings full, so resuming starts from the same sample at once.
+		State.store(InState, std::memory_order_relaxed);
+		switch (InState) {
+		case GameState::Playing:
+			Gain.SetScale(1.0f);
+			break;
+		case GameState::Menu:
+			Gain.SetScale(DbToGain(kMenuDuckDb));
+			break;
+		case GameState::Paused:
+		case GameState::Loading:
+			Gain.SetScale(0.0f);
+			break;
+		}
+	}
+
+	uint32_t NativeBackend::GetPositionMs() const
+	{
+		if (SampleRate == 0)
+			return 0;
+
+		const uint64_t position = PositionBaseMs + PlayedFrames.load(std::memory_order_relaxed) * 1000 / SampleRate;
+		return static_cast<uint32_t>(LengthMs > 0 ? position % LengthMs : position);
+	}
+
+	PlaybackStats NativeBackend::GetStats() const
+	{
+		// Both rings take turns being live, so their counts are summed.
+		PlaybackStats stats;
+		stats.Underruns = Underruns.load(std::memory_order_relaxed);
+		for (const auto& ring : Rings) {
+			const RingStats ringStats = ring.GetStats();
+			stats.Overruns += ringStats.Overruns;
+			stats.HighWater = std::max(stats.HighWater, ringStats.HighWater);
+		}
+		stats.Buffered = Rings[Live].ReadAvailable();
+		stats.Capacity = Rings[Live].Capacity();
+		stats.SampleRate = SampleRate;
+		stats.Channels = Channels;
+		return stats;
+	}
+
+	void NativeBackend::Prefetch(std::span<const std::string_view> InSources, std::size_t InBudgetBytes)
+	{
+		Pool.SetWanted(InSources, InBudgetBytes);
+	}
+
+	void NativeBackend::PublishMix(bool InFading)
+	{
+		// Zero marks "no fade" in ActiveFade, so the 30-bit serial skips it when it wraps.
+		MixSerial = (MixSerial + 1) & 0x3FFFFFFF;
+		if (MixSerial == 0)
+			MixSerial = 1;
+
+		OutgoingFade = InFading ? MixSerial : 0;
+		ActiveFade.store(OutgoingFade, std::memory_order_relaxed);
+		MixState.store((MixSerial << 2) | (InFading ? 2u : 0u) | Live, std::memory_order_release);
+	}
+
+	void NativeBackend::Notify()
+	{
+		// Taking the mutex orders the state change against the waiter's predicate check.
+		{
+			std::lock_guard lock(WakeMutex);
+		}
+		Wake.notify_all();
+	}
+
+	void NativeBackend::DecodeLoop()
+	{
+		Control::EnterThread("Radio Decode", Control::ThreadRole::Audio);
+
+		Mp3Stream&         stream = *Current->Stream;
+		Decoder&           decoder = *Current->FrameDecoder;
+		FrameQueue&        ahead = Current->Ahead;
+		RingBuffer<float>& ring = Rings[Live];
+		const std::size_t frameSamples = std::size_t(stream.GetInfo().First.SamplesPerFrame) * Channels;
+		bool              ended = false;
+		bool              reported = false;
+		bool              fresh = true;  // nothing written since the start, a seek or a pause
+		uint64_t          framesSinceLoop = 0;
+		std::size_t       discard = 0;
+
+		while (!Quit) {
+			if (SeekPending.load(std::memory_order_acquire)) {
+				const auto target = SeekTargetMs.load();
+				if (const auto& request = Current->IndexRequest; request && !stream.HasSeekIndex()) {
+					if (auto index = request->Result.load())
+						stream.SetSeekIndex(std::move(index));
+				}
+
+				if (stream.SeekToMs(target)) {
+					ahead.Clear();
+				} else if (target > 0) {
+					Control::Log("{} - Source is not seekable, playing from current position", Plugin::NAME);
+				}
+
+				decoder.Reset();
+				discard = std::size_t(stream.GetSeekDiscard()) * Channels;
+				PositionBaseMs = target;
+				FlushMarks[Live].store(ring.WriteIndex(), std::memory_order_release);
+				SeekPending.store(false, std::memory_order_release);
+				ended = false;
+				reported = false;
+				fresh = true;
+				Drained = false;
+				SourceEnded = false;
+				framesSinceLoop = 0;
+			}
+
+			if (Outgoing)
+				FeedOutgoing();
+
+			// A track that does not loop is over once the output has played its last samples,
+			// not when they are decoded, which is up to a ring's length earlier.
+			if (ended && !reported && ring.ReadAvailable() == 0) {
+				reported = true;
+				Drained = true;
+				std::lock_guard lock(TrackEndMutex);
+				if (OnTrackEnd)
+					OnTrackEnd();
+			}
+
+			if (ended || !Playing) {
+				const auto resume = [&] { return Quit || SeekPending || (!ended && Playing); };
+				std::unique_lock lock(WakeMutex);
+				if (ended && !reported)
+					Wake.wait_for(lock, 20ms, resume);
+				else
+					Wake.wait(lock, resume);
+				fresh = true;
+				continue;
+			}
+
+			// Ring is full: the sink drains a block every 10-20 ms, so a short nap is enough.
+			if (ring.WriteAvailable() < frameSamples) {
+				std::unique_lock lock(WakeMutex);
+				Wake.wait_for(lock, 10ms, [this] { return Quit || SeekPending; });
+				continue;
+			}
+
+			// Frames read ahead while the station was warm play first.
+			auto frame = ahead.Pop();
+			if (frame.empty())
+				frame = stream.NextFrame();
+			if (frame.empty()) {
+				if (Quit)
+					break;
+
+				// Loop at end of track, like "play ... repeat".
+				if (Looping && framesSinceLoop > 0 && stream.SeekToMs(0)) {
+					decoder.Reset();
+					discard = std::size_t(stream.GetSeekDiscard()) * Channels;
+					framesSinceLoop = 0;
+				} else {
+					Control::Log("{} - Stream ended", Plugin::NAME);
+					ended = true;
+					SourceEnded = true;
+				}
+				continue;
+			}
+
+			std::size_t count = 0;
+			{
+				const Control::ScopedTimer timer(Control::Operation::Decode);
+				count = decoder.Decode(frame, Scratch);
+			}
+			Control::CountEvent(count > 0 ? Control::Counter::FramesDecoded : Control::Counter::EmptyFrames);
+
+			// After an indexed seek, the priming frames and the head of the target frame are dropped.
+			const auto skip = std::min(discard, count);
+			discard -= skip;
+			ring.Write({ Scratch.data() + skip, count - skip });
+			++framesSinceLoop;
+
+			// The output takes these next, within one block of the sink.
+			if (fresh && count > skip) {
+				fresh = false;
+				if (Control::IsExpectingAudio())
+					Control::OnAudioStarted();
+			}
+		}
+
+		{
+			std::lock_guard lock(WakeMutex);
+			DecoderStopped = true;
+		}
+		Wake.notify_all();
+	}
+
+	void NativeBackend::FeedOutgoing()
+	{
+		// Fade over or cut short: the outgoing station goes back to the pool.
+		if (ActiveFade.load(std::memory_order_acquire) != OutgoingFade) {
+			Pool.Put(std::move(Outgoing));
+			return;
+		}
+
+		// Keep enough buffered to cover the whole fade, one frame per pass of the decode loop.
+		RingBuffer<float>& ring = Rings[Live ^ 1];
+		const std::size_t  wanted = std::size_t(FadeFrames.load(std::memory_order_relaxed)) * Channels;
+		if (ring.ReadAvailable() >= wanted || ring.WriteAvailable() < kMaxFrameSamples * Channels)
+			return;
+
+		auto frame = Outgoing->Ahead.Pop();
+		if (frame.empty())
+			frame = Outgoing->Stream->NextFrame();
+		if (frame.empty()) {
+			Outgoing.reset();
+			return;
+		}
+
+		const auto count = Outgoing->FrameDecoder->Decode(frame, Scratch);
+		ring.Write({ Scratch.data(), count });
+	}
+
+	void NativeBackend::Render(std::span<float> OutSamples)
+	{
+		const std::size_t chunk = kMixSamples / Channels * Channels;
+		for (std::size_t offset = 0; offset < OutSamples.size(); offset += chunk)
+			Mix(OutSamples.subspan(offset, std::min(chunk, OutSamples.size() - offset)));
+	}
+
+	void NativeBackend::Mix(std::span<float> OutSamples)
+	{
+		const GameState gameState = State.load(std::memory_order_relaxed);
+		if ((gameState == GameState::Paused || gameState == GameState::Loading) && Gain.IsSilent()) {
+			std::fill(OutSamples.begin(), OutSamples.end(), 0.0f);
+			return;
+		}
+
+		const uint32_t state = MixState.load(std::memory_order_acquire);
+		const uint32_t live = state & 1;
+		if (state >> 2 != SeenMixSerial) {
+			SeenMixSerial = state >> 2;
+			Fading = (state & 2) != 0;
+			FadeLength = std::max(FadeFrames.load(std::memory_order_relaxed), 1u);
+			FadeLeft = FadeLength;
+			Flowing = false;
+			PlayedFrames.store(0, std::memory_order_relaxed);
+		}
+
+		for (uint32_t index = 0; index < Rings.size(); ++index) {
+			if (const auto mark = FlushMarks[index].exchange(kNoFlush, std::memory_order_acq_rel); mark != kNoFlush) {
+				Rings[index].SkipTo(mark);
+				if (index == live) {
+					Flowing = false;
+					PlayedFrames.store(0, std::memory_order_relaxed);
+				}
+			}
+		}
+
+		std::size_t count = 0;
+		if (Playing.load(std::memory_order_relaxed) && !SeekPending.load(std::memory_order_acquire)) {
+			count = Rings[live].Read(OutSamples);
+
+			// Starved: the station was playing and the decoder fell behind. Filling up after a
+			// start, seek or switch, and running out at the end of a track, are not underruns.
+			if (count < OutSamples.size() && Flowing && !SourceEnded.load(std::memory_order_acquire))
+				Underruns.store(Underruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			Flowing = count > 0 || Flowing;
+		} else {
+			Flowing = false;
+		}
+		std::fill(OutSamples.begin() + count, OutSamples.end(), 0.0f);
+		PlayedFrames.fetch_add(count / Channels, std::memory_order_relaxed);
+
+		if (Fading && ActiveFade.load(std::memory_order_relaxed) != SeenMixSerial)
+			Fading = false;
+
+		if (Fading) {
+			// The fade only advances while the incoming station plays; until its first samples
+			// arrive (connecting, seeking) the outgoing one holds its level.
+			const std::size_t channels = Channels;
+			const std::size_t rampFrames = std::min<std::size_t>(count / channels, FadeLeft);
+			const bool        done = rampFrames == FadeLeft;
+			const std::size_t fadeSamples = done ? rampFrames * channels : OutSamples.size();
+			const std::size_t rampSamples = rampFrames * channels;
+			const float       step = 1.0f / static_cast<float>(FadeLength);
+			const float       progress = static_cast<float>(FadeLength - FadeLeft) * step;
+
+			const auto fade = std::span(FadeScratch).first(fadeSamples);
+			const auto fadeCount = Rings[live ^ 1].Read(fade);
+			std::fill(fade.begin() + fadeCount, fade.end(), 0.0f);
+
+			Kernels.Ramp(OutSamples.first(rampSamples), Channels, progress, step);
+			Kernels.MixRamp(OutSamples.first(rampSamples), fade, Channels, 1.0f - progress, -step);
+			Kernels.MixRamp(OutSamples.subspan(rampSamples, fadeSamples - rampSamples), fade.subspan(rampSamples), Channels, 1.0f - progress - step * rampFrames, 0.0f);
+
+			FadeLeft -= static_cast<uint32_t>(rampFrames);
+			if (done) {
+				Fading = false;
+				uint32_t expected = SeenMixSerial;
+				ActiveFade.compare_exchange_strong(expected, 0, std::memory_order_release);
+			}
+		}
+
+		Spatial.Process(OutSamples, Channels, SampleRate);
+		Gain.Process(OutSamples, Channels, SampleRate, Kernels);
+	}
+}
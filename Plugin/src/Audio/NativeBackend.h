@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Audio/AudioBackend.h"
+#include "Audio/AudioSink.h"
+#include "Audio/Gain.h"
+#include "Audio/MixKernels.h"
+#include "Audio/PreparedStream.h"
+#include "Audio/RingBuffer.h"
+#include "Audio/SeekIndex.h"
+#include "Audio/StationPool.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Audio
+{
+	// Decode-and-mix engine: a decode thread pulls MP3 frames from a ByteSource, decodes them
+	// into a lock-free PCM ring, and the sink's render thread drains the ring applying gain.
+	// Volume, pause and seek are plain atomic state changes picked up by those threads.
+	//
+	// Switching stations crossfades: the outgoing station keeps its ring, the decode thread
+	// keeps it topped up alongside the incoming one, and the render thread mixes the two with
+	// opposite gain ramps until the fade completes.
+	class NativeBackend final : public AudioBackend
+	{
+	public:
+		// Seek indexes for local tracks are kept in InIndexDirectory.
+		NativeBackend(std::unique_ptr<AudioSink> InSink, SourceFactory InOpenSource, DecoderFactory InCreateDecoder, std::filesystem::path InIndexDirectory);
+		~NativeBackend() override;
+
+		bool Open(std::string_view InSource) override;
+		void Close() override;
+		bool IsOpen() const override { return Current != nullptr; }
+
+		void Play() override;
+		void PlayFrom(uint32_t InPositionMs) override;
+		void Stop() override;
+
+		void SetVolume(float InVolume) override;
+		void SetCrossfade(uint32_t InMs) override { CrossfadeMs = InMs; }
+		void SetSpatialization(const SpatialParams& InParams) override { Spatial.SetParams(InParams); }
+		void SetGameState(GameState InState) override;
+		void SetLooping(bool InLooping) override { Looping = InLooping; }
+		void SetTrackEndHandler(std::function<void()> InHandler) override;
+
+		uint32_t GetLengthMs() const override { return LengthMs; }
+		uint32_t GetPositionMs() const override;
+
+		PlaybackStats GetStats() const override;
+
+		void Prefetch(std::span<const std::string_view> InSources, std::size_t InBudgetBytes) override;
+
+	private:
+		static constexpr std::size_t kNoFlush = ~std::size_t(0);
+
+		// Largest block the render thread mixes at once; longer sink buffers are split.
+		static constexpr std::size_t kMixSamples = 4096;
+
+		// Level under full-screen menus.
+		static constexpr float kMenuDuckDb = -12.0f;
+
+		bool Start(std::unique_ptr<PreparedStream> InStream, std::unique_ptr<PreparedStream> InOutgoing);
+		bool StopDecoder();
+		void PublishMix(bool InFading);
+		void Notify();
+		void DecodeLoop();
+		void FeedOutgoing();
+		void Render(std::span<float> OutSamples);
+		void Mix(std::span<float> OutSamples);
+
+		std::unique_ptr<AudioSink>      Sink;
+		SourceFactory                   OpenSource;
+		DecoderFactory                  CreateDecoder;
+		StationPool                     Pool;
+		SeekIndexer                     Indexer;
+		std::unique_ptr<PreparedStream> Current;
+		std::unique_ptr<PreparedStream> Outgoing;  // fading out; owned by the decode thread while it runs
+
+		// The live ring is fed from Current; the other one holds the outgoing station during a
+		// crossfade.
+		std::array<RingBuffer<float>, 2> Rings;
+		uint32_t                         Live = 0;
+		std::vector<float>               Scratch;
+		uint32_t                         SampleRate = 0;
+		uint32_t                         Channels = 0;
+		uint32_t                         LengthMs = 0;
+
+		std::atomic<uint32_t> CrossfadeMs = 0;
+		uint32_t              MixSerial = 0;
+		uint32_t              OutgoingFade = 0;  // serial of the fade Outgoing belongs to
+
+		std::thread             DecodeThread;
+		std::mutex              WakeMutex;
+		std::condition_variable Wake;
+
+		std::atomic<bool>        Quit = false;
+		std::atomic<bool>        DecoderStopped = true;
+		std::atomic<bool>        Playing = false;
+		std::atomic<bool>        SeekPending = false;
+		std::atomic<bool>        Looping = true;
+		std::atomic<bool>        Drained = false;      // the track ended and the output has played all of it
+		std::atomic<bool>        SourceEnded = false;  // the decoder reached the end; the ring only drains now
+		std::atomic<uint32_t>    SeekTargetMs = 0;
+		std::atomic<uint32_t>    PositionBaseMs = 0;
+		std::atomic<uint64_t>    PlayedFrames = 0;
+		std::atomic<GameState>   State = GameState::Playing;
+		std::atomic<uint64_t>    Underruns = 0;  // written by the render thread
+		GainRamp                 Gain;
+		SpatialChain             Spatial;
+
+		std::mutex            TrackEndMutex;
+		std::function<void()> OnTrackEnd;
+
+		// Control to render hand-off. MixState packs the serial of the last switch (bits 2+),
+		// whether it crossfades (bit 1) and the live ring (bit 0). ActiveFade is the serial of
+		// the fade in progress, cleared by the render thread when it completes.
+		std::array<std::atomic<std::size_t>, 2> FlushMarks{ kNoFlush, kNoFlush };
+		std::atomic<uint32_t>                   MixState = 0;
+		std::atomic<uint32_t>                   FadeFrames = 0;
+		std::atomic<uint32_t>                   ActiveFade = 0;
+
+		// Render thread only.
+		const MixKernels&  Kernels = GetMixKernels();
+		std::vector<float> FadeScratch;
+		uint32_t           SeenMixSerial = 0;
+		bool               Fading = false;
+		uint32_t           FadeLength = 0;
+		uint32_t           FadeLeft = 0;
+		bool               Flowing = false;  // the live ring has delivered since the last start, seek or pause
+	};
+}
@@ -0,0 +1,240 @@
+#include "Audio/NetworkSource.h"
+
+#include "Control/MessageQueue.h"
+#include "Control/ThreadRuntime.h"
+
+#include <algorithm>
+
+namespace Audio
+{
+	NetworkSource::~NetworkSource()
+	{
+		Cancel();
+		if (Reader.joinable())
+			Reader.join();
+	}
+
+	bool NetworkSource::Open(Connector InConnect)
+	{
+		Connect = std::move(InConnect);
+		Connection = Connect(0);
+		if (!Connection)
+			return false;
+
+		TotalSize = Connection->Size();
+
+		// The first fill is a refill that does not count as an underrun.
+		Refilling = true;
+		LastAdjust = Clock::now();
+		Reader = std::thread(&NetworkSource::Run, this);
+		return true;
+	}
+
+	std::size_t NetworkSource::Read(std::span<uint8_t> OutBytes)
+	{
+		std::unique_lock lock(Mutex);
+		if (Count == 0 && !Refilling && !Ended && !Failed && !Cancelled) {
+			Target = std::min(Target * 2, kMaxTarget);
+			Refilling = true;
+			LastAdjust = Clock::now();
+			Control::Log("{} - Network buffer ran dry, refilling to {} KB", Plugin::NAME, Target / 1024);
+		}
+
+		if (Refilling) {
+			Changed.wait(lock, [this] { return Count >= Target || Ended || Failed || Cancelled; });
+			Refilling = false;
+		}
+
+		const std::size_t count = std::min(OutBytes.size(), Count);
+		const std::size_t first = std::min(count, kCapacity - Start);
+		std::copy_n(Buffer.data() + Start, first, OutBytes.data());
+		std::copy_n(Buffer.data(), count - first, OutBytes.data() + first);
+		Start = (Start + count) % kCapacity;
+		Count -= count;
+		Position += count;
+
+		// A stretch without underruns earns back some of the delay.
+		if (const auto now = Clock::now(); Target > kMinTarget && now - LastAdjust >= kShrinkAfter) {
+			Target = std::max(Target - Target / 4, kMinTarget);
+			LastAdjust = now;
+		}
+
+		lock.unlock();
+		Changed.notify_all();
+		return count;
+	}
+
+	bool NetworkSource::Seek(uint64_t InOffset)
+	{
+		std::lock_guard lock(Mutex);
+		if (InOffset == Position)
+			return true;
+		if (TotalSize == 0 || InOffset > TotalSize)
+			return false;
+
+		// Forward within what is buffered: just drop the bytes in between.
+		if (InOffset > Position && InOffset - Position <= Count) {
+			const auto skip = static_cast<std::size_t>(InOffset - Position);
+			Start = (Start + skip) % kCapacity;
+			Count -= skip;
+			Position = InOffset;
+			Changed.notify_all();
+			return true;
+		}
+
+		// Anywhere else takes a new request; the reader notices the generation change, drops
+		// the connection and reconnects at Position.
+		++Generation;
+		Position = InOffset;
+		Start = 0;
+		Count = 0;
+		Ended = false;
+		Failed = false;
+		Refilling = true;
+		if (Connection)
+			Connection->Cancel();
+		Changed.notify_all();
+		return true;
+	}
+
+	uint64_t NetworkSource::Tell() const
+	{
+		std::lock_guard lock(Mutex);
+		return Position;
+	}
+
+	uint64_t NetworkSource::Size() const
+	{
+		std::lock_guard lock(Mutex);
+		return TotalSize;
+	}
+
+	void NetworkSource::Cancel()
+	{
+		{
+			std::lock_guard lock(Mutex);
+			Cancelled = true;
+			if (Connection)
+				Connection->Cancel();
+		}
+		Reconnecting.Cancel();
+		Changed.notify_all();
+	}
+
+	std::size_t NetworkSource::GetTarget() const
+	{
+		std::lock_guard lock(Mutex);
+		return Target;
+	}
+
+	uint32_t NetworkSource::GetReconnects() const
+	{
+		std::lock_guard lock(Mutex);
+		return Reconnects;
+	}
+
+	void NetworkSource::Run()
+	{
+		Control::EnterThread("Radio Network", Control::ThreadRole::Io);
+
+		std::vector<uint8_t> chunk(kReadBytes);
+		std::unique_lock     lock(Mutex);
+		while (!Cancelled) {
+			if (Ended || Failed || Count == kCapacity) {
+				Changed.wait(lock);
+				continue;
+			}
+			if (!Connection && !Reconnect(lock))
+				continue;
+
+			// A seek while this thread waited leaves Connection at the old offset, and whatever
+			// it still holds from there must not land in the buffer.
+			if (ConnectionGeneration != Generation) {
+				Connection.reset();
+				continue;
+			}
+
+			// The connection is only replaced on this thread, so it can be read unlocked.
+			const uint64_t    generation = Generation;
+			ByteSource*       connection = Connection.get();
+			const std::size_t wanted = std::min(chunk.size(), kCapacity - Count);
+			lock.unlock();
+			const std::size_t read = connection->Read({ chunk.data(), wanted });
+			lock.lock();
+
+			if (generation != Generation) {
+				Connection.reset();
+				continue;
+			}
+			if (Cancelled)
+				break;
+
+			if (read == 0) {
+				Connection.reset();
+				if (TotalSize > 0 && Position + Count >= TotalSize) {
+					Ended = true;
+				} else {
+					++Reconnects;
+					Control::Log("{} - Connection dropped at byte {}, reconnecting", Plugin::NAME, Position + Count);
+				}
+				Changed.notify_all();
+				continue;
+			}
+
+			Append({ chunk.data(), read });
+			Changed.notify_all();
+		}
+	}
+
+	bool NetworkSource::Reconnect(std::unique_lock<std::mutex>& InLock)
+	{
+		auto backoff = std::chrono::duration_cast<std::chrono::milliseconds>(kFirstBackoff);
+		for (int attempt = 0; attempt < kMaxAttempts && !Cancelled; ++attempt) {
+			// Live streams have no offsets to resume from; they pick up wherever they are now.
+			const uint64_t generation = Generation;
+			const uint64_t offset = TotalSize > 0 ? Position + Count : 0;
+			InLock.unlock();
+			std::unique_ptr<ByteSource> connection;
+			{
+				const ConnectGroup::Scope scope(Reconnecting);
+				connection = Connect(offset);
+			}
+			InLock.lock();
+
+			if (Cancelled) {
+				if (connection)
+					connection->Cancel();
+				return false;
+			}
+			if (generation != Generation)
+				return false;  // seeked meanwhile; the next pass connects at the new offset
+
+			if (connection) {
+				if (TotalSize > 0 && connection->Size() > 0)
+					TotalSize = connection->Size();
+				Connection = std::move(connection);
+				ConnectionGeneration = generation;
+				return true;
+			}
+
+			Changed.wait_for(InLock, backoff, [&] { return Cancelled || generation != Generation; });
+			backoff = std::min(backoff * 2, std::chrono::duration_cast<std::chrono::milliseconds>(kMaxBackoff));
+		}
+
+		if (!Cancelled) {
+			Control::Log("{} - Station unreachable after {} attempts", Plugin::NAME, kMaxAttempts);
+			Failed = true;
+			Changed.notify_all();
+		}
+		return false;
+	}
+
+	void NetworkSource::Append(std::span<const uint8_t> InBytes)
+	{
+		const std::size_t end = (Start + Count) % kCapacity;
+		const std::size_t first = std::min(InBytes.size(), kCapacity - end);
+		std::copy_n(InBytes.data(), first, Buffer.data() + end);
+		std::copy_n(InBytes.data() + first, InBytes.size() - first, Buffer.data());
+		Count += InBytes.size();
+	}
+}
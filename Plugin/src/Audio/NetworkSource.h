@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Audio/ByteSource.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Audio
+{
+	// Network stream behind an adaptive jitter buffer. A reader thread keeps the buffer filled
+	// from the connection; Read takes from the buffer and only blocks when it runs dry. Each
+	// time it does, the buffer refills to a target that grows on every underrun and shrinks
+	// again after a stretch without one, so a steady connection keeps a short delay and a
+	// flaky one earns a longer cushion.
+	//
+	// A dropped connection is reopened with exponential backoff. Files resume at the byte they
+	// stopped at (a Range request through InConnect); live streams, which have no offsets,
+	// reconnect from their current position. Either way a drop costs a short gap instead of
+	// ending the station.
+	class NetworkSource final : public ByteSource
+	{
+	public:
+		// Opens a connection whose first byte is at InOffset, or returns nullptr.
+		using Connector = std::function<std::unique_ptr<ByteSource>(uint64_t InOffset)>;
+
+		static constexpr std::size_t kCapacity = 256 * 1024;
+		static constexpr std::size_t kMinTarget = 16 * 1024;   // about 1 s at 128 kbit/s
+		static constexpr std::size_t kMaxTarget = 160 * 1024;  // about 10 s
+		static constexpr auto        kShrinkAfter = std::chrono::seconds(30);
+		static constexpr auto        kFirstBackoff = std::chrono::milliseconds(250);
+		static constexpr auto        kMaxBackoff = std::chrono::seconds(8);
+		static constexpr int         kMaxAttempts = 8;  // about 30 s of retrying
+		static constexpr std::size_t kReadBytes = 16 * 1024;
+
+		~NetworkSource() override;
+
+		// Connects synchronously, so an unreachable station fails here; then starts the reader.
+		bool Open(Connector InConnect);
+
+		std::size_t Read(std::span<uint8_t> OutBytes) override;
+		bool        Seek(uint64_t InOffset) override;
+		uint64_t    Tell() const override;
+		uint64_t    Size() const override;
+		bool        IsRemote() const override { return true; }
+		void        Cancel() override;
+
+		// Current refill target in bytes, and how often the connection has been reopened.
+		std::size_t GetTarget() const;
+		uint32_t    GetReconnects() const;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		void Run();
+		bool Reconnect(std::unique_lock<std::mutex>& InLock);
+		void Append(std::span<const uint8_t> InBytes);
+
+		Connector                   Connect;
+		std::unique_ptr<ByteSource> Connection;  // replaced by the reader thread only, under Mutex
+		ConnectGroup                Reconnecting;  // the reader's connects, so Cancel reaches them too
+		std::thread                 Reader;
+
+		mutable std::mutex      Mutex;
+		std::condition_variable Changed;
+
+		// Buffered bytes start at stream offset Position.
+		std::vector<uint8_t> Buffer = std::vector<uint8_t>(kCapacity);
+		std::size_t          Start = 0;
+		std::size_t          Count = 0;
+		uint64_t             Position = 0;
+		uint64_t             TotalSize = 0;
+		uint64_t             Generation = 0;            // bumped by Seek; data from older requests is dropped
+		uint64_t             ConnectionGeneration = 0;  // Generation when Connection was made
+
+		std::size_t       Target = kMinTarget;
+		bool              Refilling = false;
+		Clock::time_point LastAdjust;
+		uint32_t          Reconnects = 0;
+
+		bool Ended = false;
+		bool Failed = false;
+		bool Cancelled = false;
+	};
+}
@@ -0,0 +1,83 @@
+#include "Audio/Platform.h"
+
+#include "Audio/AcmDecoder.h"
+#include "Audio/CachedSource.h"
+#include "Audio/HttpSource.h"
+#include "Audio/IcySource.h"
+#include "Audio/MappedSource.h"
+#include "Audio/NativeBackend.h"
+#include "Audio/NetworkSource.h"
+#include "Audio/WaveOutSink.h"
+
+namespace Audio
+{
+	namespace
+	{
+		constexpr auto CacheDirectory = ".\\Data\\SFSE\\Plugins\\StarfieldGalacticRadio\\cache";
+
+		std::atomic<uint64_t> CacheBudget = 512ull << 20;
+
+		std::atomic<std::shared_ptr<const StreamTitleHandler>> TitleHandler;
+
+		void OnStreamTitle(std::string_view InSource, std::string_view InTitle)
+		{
+			if (const auto handler = TitleHandler.load(); handler && *handler)
+				(*handler)(InSource, InTitle);
+		}
+	}
+
+	std::unique_ptr<ByteSource> OpenPlatformSource(std::string_view InSource)
+	{
+		if (InSource.contains("://")) {
+			return OpenCachedSource(CacheDirectory, CacheBudget, InSource, [Url = std::string(InSource)]() -> std::unique_ptr<ByteSource> {
+				auto source = std::make_unique<NetworkSource>();
+				const bool opened = source->Open([Url](uint64_t InOffset) -> std::unique_ptr<ByteSource> {
+					auto connection = std::make_unique<HttpSource>();
+					if (!connection->Open(Url, InOffset))
+						return nullptr;
+					if (const auto interval = connection->GetMetaInterval(); interval > 0)
+						return std::make_unique<IcySource>(std::move(connection), interval, [Url](std::string_view InTitle) { OnStreamTitle(Url, InTitle); });
+					return connection;
+				});
+				if (!opened)
+					return nullptr;
+				return source;
+			});
+		}
+
+		const std::filesystem::path path(std::u8string_view(reinterpret_cast<const char8_t*>(InSource.data()), InSource.size()));
+
+		// Mapping fails for empty files and on exhausted address space; plain reads still work.
+		if (auto mapped = std::make_unique<MappedSource>(); mapped->Open(path))
+			return mapped;
+
+		auto source = std::make_unique<FileSource>();
+		if (!source->Open(path))
+			return nullptr;
+		return source;
+	}
+
+	void SetStreamTitleHandler(StreamTitleHandler InHandler)
+	{
+		TitleHandler = std::make_shared<const StreamTitleHandler>(std::move(InHandler));
+	}
+
+	void SetDiskCacheBudget(uint64_t InBytes)
+	{
+		CacheBudget = InBytes;
+	}
+
+	std::unique_ptr<AudioBackend> CreatePlatformBackend()
+	{
+		return std::make_unique<NativeBackend>(
+			std::make_unique<WaveOutSink>(),
+			OpenPlatformSource,
+			[] { return std::make_unique<AcmDecoder>(); },
+			std::filesystem::path(CacheDirectory) / "seek");
+	}
+
+	std::unique_ptr<MetadataStore> CreateMetadataStore()
+	{
+		return std::make_unique<MetadataStore>(OpenPlatformSource, std::filesystem::path(CacheDirectory) / "metadata.bin");
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Audio/AudioBackend.h"
+#include "Audio/ByteSource.h"
+#include "Audio/MetadataStore.h"
+
+#include <functional>
+#include <memory>
+#include <string_view>
+
+namespace Audio
+{
+	// Local path or http(s):// URL to the matching Windows ByteSource.
+	std::unique_ptr<ByteSource> OpenPlatformSource(std::string_view InSource);
+
+	// Receives the "now playing" titles of live streams along with the station's URL. Runs on
+	// the stream's network thread; an empty handler stops the calls.
+	using StreamTitleHandler = std::function<void(std::string_view InSource, std::string_view InTitle)>;
+	void SetStreamTitleHandler(StreamTitleHandler InHandler);
+
+	// Size limit of the disk cache for remote stations; 0 streams them uncached.
+	void SetDiskCacheBudget(uint64_t InBytes);
+
+	// Native engine wired to waveOut, the ACM MP3 codec and WinHTTP.
+	std::unique_ptr<AudioBackend> CreatePlatformBackend();
+
+	// Track metadata store kept next to the disk cache.
+	std::unique_ptr<MetadataStore> CreateMetadataStore();
+}
@@ -0,0 +1,48 @@
+#include "Audio/PreparedStream.h"
+
+namespace Audio
+{
+	namespace
+	{
+		// Read-ahead kept for a live station while it is warm.
+		constexpr uint32_t    kReadAheadMs = 4000;
+		constexpr std::size_t kMaxReadAheadBytes = 256 * 1024;
+	}
+
+	std::unique_ptr<PreparedStream> PrepareStream(std::string_view InSource, const SourceFactory& InOpenSource, const DecoderFactory& InCreateDecoder)
+	{
+		auto prepared = std::make_unique<PreparedStream>();
+		prepared->Key = InSource;
+
+		prepared->Source = InOpenSource(InSource);
+		if (!prepared->Source) {
+			INFO("{} - Unable to open source: {}", Plugin::NAME, InSource);
+			return nullptr;
+		}
+
+		if (!PrepareStream(*prepared, InCreateDecoder))
+			return nullptr;
+		return prepared;
+	}
+
+	bool PrepareStream(PreparedStream& InOutStream, const DecoderFactory& InCreateDecoder)
+	{
+		InOutStream.Stream = std::make_unique<Mp3Stream>(*InOutStream.Source);
+		if (!InOutStream.Stream->Open()) {
+			INFO("{} - No MPEG Layer III audio found in: {}", Plugin::NAME, InOutStream.Key);
+			return false;
+		}
+
+		const auto& first = InOutStream.Stream->GetInfo().First;
+		InOutStream.FrameDecoder = InCreateDecoder();
+		if (!InOutStream.FrameDecoder || !InOutStream.FrameDecoder->Open(first)) {
+			INFO("{} - No decoder for {} Hz / {} channels", Plugin::NAME, first.SampleRate, first.Channels);
+			return false;
+		}
+
+		if (InOutStream.IsLive())
+			InOutStream.Ahead.Reserve(std::min<std::size_t>(std::size_t(first.Bitrate) * kReadAheadMs / 8, kMaxReadAheadBytes));
+
+		return true;
+	}
+}
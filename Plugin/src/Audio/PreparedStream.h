@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Audio/ByteSource.h"
+#include "Audio/Decoder.h"
+#include "Audio/FrameQueue.h"
+#include "Audio/Mp3.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace Audio
+{
+	using SourceFactory = std::function<std::unique_ptr<ByteSource>(std::string_view)>;
+	using DecoderFactory = std::function<std::unique_ptr<Decoder>()>;
+
+	struct SeekIndexRequest;
+
+	// A station opened up to the point where decoding can start: connected source, parsed
+	// stream header and a ready decoder. Live streams also carry the frames read ahead while
+	// the station was waiting in the warm pool.
+	struct PreparedStream
+	{
+		std::string                 Key;  // the path or URL it was opened from
+		std::unique_ptr<ByteSource> Source;
+		std::unique_ptr<Mp3Stream>  Stream;
+		std::unique_ptr<Decoder>    FrameDecoder;
+		FrameQueue                  Ahead;
+
+		std::shared_ptr<SeekIndexRequest> IndexRequest;  // local tracks, while their seek index builds
+
+		// Live streams cannot seek, so their read-ahead is what plays first after a switch.
+		bool IsLive() const { return !Stream->IsSeekable(); }
+
+		std::size_t GetMemoryBytes() const { return sizeof(*this) + Stream->GetBufferBytes() + Ahead.GetCapacity(); }
+	};
+
+	// Opens InSource and readies it for decoding. Blocks while a remote source connects.
+	std::unique_ptr<PreparedStream> PrepareStream(std::string_view InSource, const SourceFactory& InOpenSource, const DecoderFactory& InCreateDecoder);
+
+	// The second half of the above, for a stream whose Key and Source are already set. Blocks
+	// until the stream header has arrived; cancelling the source ends the wait. On failure
+	// the source stays with InOutStream.
+	bool PrepareStream(PreparedStream& InOutStream, const DecoderFactory& InCreateDecoder);
+}
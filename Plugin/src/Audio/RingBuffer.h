@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Audio
+{
+	// What a ring has been through since it was created. Overruns are writes that did not fit;
+	// HighWater is the fullest it has been, in items. A short read is not counted: only the
+	// consumer knows whether an empty ring is starved or simply idle.
+	struct RingStats
+	{
+		uint64_t    Overruns = 0;
+		std::size_t HighWater = 0;
+	};
+
+	// Lock-free single-producer/single-consumer ring. Write is only called from the producer
+	// thread, Read/Skip only from the consumer thread. Capacity is rounded up to a power of two.
+	// The producer's and the consumer's state sit on separate cache lines (the alignment also
+	// pads the end of the ring), so neither side's stores invalidate the line the other reads.
+	template <class T>
+	class RingBuffer
+	{
+	public:
+		explicit RingBuffer(std::size_t InMinCapacity) :
+			Buffer(std::bit_ceil(std::max<std::size_t>(InMinCapacity, 2))),
+			Mask(Buffer.size() - 1)
+		{
+		}
+
+		std::size_t Capacity() const { return Buffer.size(); }
+
+		std::size_t ReadAvailable() const
+		{
+			return Head.load(std::memory_order_acquire) - Tail.load(std::memory_order_acquire);
+		}
+
+		std::size_t WriteAvailable() const
+		{
+			return Capacity() - ReadAvailable();
+		}
+
+		std::size_t Write(std::span<const T> InItems)
+		{
+			const auto head = Head.load(std::memory_order_relaxed);
+			const auto tail = Tail.load(std::memory_order_acquire);
+			const auto count = std::min(InItems.size(), Capacity() - (head - tail));
+
+			const auto start = head & Mask;
+			const auto first = std::min(count, Capacity() - start);
+			std::copy_n(InItems.data(), first, Buffer.data() + start);
+			std::copy_n(InItems.data() + first, count - first, Buffer.data());
+
+			Head.store(head + count, std::memory_order_release);
+
+			// Producer-owned counters: a plain load and store is enough.
+			if (count < InItems.size())
+				Overruns.store(Overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			if (const auto fill = head + count - tail; fill > HighWater.load(std::memory_order_relaxed))
+				HighWater.store(fill, std::memory_order_relaxed);
+			return count;
+		}
+
+		std::size_t Read(std::span<T> OutItems)
+		{
+			const auto tail = Tail.load(std::memory_order_relaxed);
+			const auto head = Head.load(std::memory_order_acquire);
+			const auto count = std::min(OutItems.size(), head - tail);
+
+			const auto start = tail & Mask;
+			const auto first = std::min(count, Capacity() - start);
+			std::copy_n(Buffer.data() + start, first, OutItems.data());
+			std::copy_n(Buffer.data(), count - first, OutItems.data() + first);
+
+			Tail.store(tail + count, std::memory_order_release);
+			return count;
+		}
+
+		// Total number of items ever written. Producer side; pairs with SkipTo to flush stale audio
+		// without waiting for the consumer.
+		std::size_t WriteIndex() const
+		{
+			return Head.load(std::memory_order_relaxed);
+		}
+
+		// Consumer side: drops everything written before InWriteIndex.
+		void SkipTo(std::size_t InWriteIndex)
+		{
+			const auto tail = Tail.load(std::memory_order_relaxed);
+			const auto head = Head.load(std::memory_order_acquire);
+			if (InWriteIndex - tail <= head - tail)
+				Tail.store(InWriteIndex, std::memory_order_release);
+		}
+
+		// Safe to call from any thread; the counters are read without stopping either side.
+		RingStats GetStats() const
+		{
+			return {
+				Overruns.load(std::memory_order_relaxed),
+				HighWater.load(std::memory_order_relaxed),
+			};
+		}
+
+	private:
+		static constexpr std::size_t kCacheLine = 64;
+
+		// Read-only after construction.
+		std::vector<T> Buffer;
+		std::size_t    Mask;
+
+		// Producer side.
+		alignas(kCacheLine) std::atomic<std::size_t> Head{ 0 };
+		std::atomic<uint64_t>    Overruns{ 0 };
+		std::atomic<std::size_t> HighWater{ 0 };
+
+		// Consumer side.
+		alignas(kCacheLine) std::atomic<std::size_t> Tail{ 0 };
+	};
+}
@@ -0,0 +1,177 @@
+#include "Audio/SeekIndex.h"
+
+#include "Config/Hash.h"
+#include "Control/ThreadRuntime.h"
+
+#include <fstream>
+
+namespace Audio
+{
+	namespace
+	{
+		constexpr uint32_t kSeekMagic = 0x53524753;  // "SGRS"
+		constexpr uint32_t kSeekFormat = 1;
+
+		// How often a scan checks whether anyone still wants the index.
+		constexpr uint32_t kCheckFrames = 1024;
+
+		struct SeekHeader
+		{
+			uint32_t Magic = kSeekMagic;
+			uint32_t Format = kSeekFormat;
+			uint64_t FileSize = 0;
+			int64_t  ModifiedTime = 0;
+			uint32_t IntervalFrames = SeekIndex::kIntervalFrames;
+			uint32_t TotalFrames = 0;
+		};
+
+		uint32_t GetPointCount(uint32_t InTotalFrames)
+		{
+			return (InTotalFrames + SeekIndex::kIntervalFrames - 1) / SeekIndex::kIntervalFrames;
+		}
+	}
+
+	std::shared_ptr<const SeekIndex> SeekIndex::Build(Mp3Stream& InStream, const std::function<bool()>& InKeepGoing)
+	{
+		// The Xing/Info tag is shaped like a frame but holds no audio.
+		if (InStream.GetInfo().HasXingFrame && InStream.NextFrame().empty())
+			return nullptr;
+
+		auto     index = std::make_shared<SeekIndex>();
+		uint32_t frame = 0;
+		for (;; ++frame) {
+			if (frame % kCheckFrames == 0 && !InKeepGoing())
+				return nullptr;
+
+			const auto data = InStream.NextFrame();
+			if (data.empty())
+				break;
+			if (frame % kIntervalFrames == 0)
+				index->Offsets.push_back(InStream.Tell() - data.size());
+		}
+
+		if (frame == 0)
+			return nullptr;
+		index->TotalFrames = frame;
+		return index;
+	}
+
+	std::shared_ptr<const SeekIndex> SeekIndex::Load(const std::filesystem::path& InPath, uint64_t InFileSize, int64_t InModifiedTime)
+	{
+		std::ifstream file(InPath, std::ios::binary);
+		SeekHeader    header;
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+			return nullptr;
+		if (header.Magic != kSeekMagic || header.Format != kSeekFormat || header.IntervalFrames != kIntervalFrames ||
+			header.FileSize != InFileSize || header.ModifiedTime != InModifiedTime || header.TotalFrames == 0)
+			return nullptr;
+
+		auto index = std::make_shared<SeekIndex>();
+		index->TotalFrames = header.TotalFrames;
+		index->Offsets.resize(GetPointCount(header.TotalFrames));
+		if (!file.read(reinterpret_cast<char*>(index->Offsets.data()), static_cast<std::streamsize>(index->Offsets.size() * sizeof(uint64_t))))
+			return nullptr;
+		return index;
+	}
+
+	bool SeekIndex::Save(const std::filesystem::path& InPath, uint64_t InFileSize, int64_t InModifiedTime) const
+	{
+		SeekHeader header;
+		header.FileSize = InFileSize;
+		header.ModifiedTime = InModifiedTime;
+		header.TotalFrames = TotalFrames;
+
+		std::ofstream file(InPath, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(Offsets.data()), static_cast<std::streamsize>(Offsets.size() * sizeof(uint64_t)));
+		return file.good();
+	}
+
+	SeekIndexer::SeekIndexer(SourceFactory InOpenSource, std::filesystem::path InDirectory) :
+		OpenSource(std::move(InOpenSource)),
+		Directory(std::move(InDirectory))
+	{
+		Worker = std::thread(&SeekIndexer::Run, this);
+	}
+
+	SeekIndexer::~SeekIndexer()
+	{
+		{
+			std::lock_guard lock(Mutex);
+			Quit = true;
+		}
+		Wake.notify_all();
+		Worker.join();
+	}
+
+	std::shared_ptr<SeekIndexRequest> SeekIndexer::Request(std::string_view InPath)
+	{
+		auto request = std::make_shared<SeekIndexRequest>();
+		request->Path = InPath;
+		{
+			std::lock_guard lock(Mutex);
+			Queue.push_back(request);
+		}
+		Wake.notify_one();
+		return request;
+	}
+
+	void SeekIndexer::Run()
+	{
+		Control::EnterThread("Radio Seek Index", Control::ThreadRole::Io);
+
+		for (;;) {
+			std::weak_ptr<SeekIndexRequest> request;
+			{
+				std::unique_lock lock(Mutex);
+				Wake.wait(lock, [&] { return Quit || !Queue.empty(); });
+				if (Quit)
+					return;
+				request = std::move(Queue.front());
+				Queue.pop_front();
+			}
+			Process(request);
+		}
+	}
+
+	void SeekIndexer::Process(const std::weak_ptr<SeekIndexRequest>& InRequest)
+	{
+		std::string path;
+		if (const auto request = InRequest.lock())
+			path = request->Path;
+		else
+			return;
+
+		const std::filesystem::path file(std::u8string_view(reinterpret_cast<const char8_t*>(path.data()), path.size()));
+		std::error_code             sizeError;
+		std::error_code             timeError;
+		const auto                  size = std::filesystem::file_size(file, sizeError);
+		const auto                  modified = std::filesystem::last_write_time(file, timeError).time_since_epoch().count();
+		if (sizeError || timeError)
+			return;
+
+		const auto indexPath = Directory / (ToHexString(Fnv1a64(path)) + ".seek");
+		auto       index = SeekIndex::Load(indexPath, size, modified);
+		if (!index) {
+			const auto source = OpenSource(path);
+			if (!source)
+				return;
+			Mp3Stream stream(*source);
+			if (!stream.Open())
+				return;
+
+			index = SeekIndex::Build(stream, [&] { return !Quit && !InRequest.expired(); });
+			if (!index)
+				return;
+
+			std::error_code ec;
+			std::filesystem::create_directories(Directory, ec);
+			if (!index->Save(indexPath, size, modified)) {
+				INFO("{} - Could not save seek index for {}", Plugin::NAME, path);
+			}
+		}
+
+		if (const auto request = InRequest.lock())
+			request->Result.store(std::move(index));
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Audio/PreparedStream.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Audio
+{
+	// Byte offsets of every kIntervalFrames-th audio frame of a track. Frames have a fixed
+	// duration, so finding the point before any sample is a division, not a search.
+	class SeekIndex
+	{
+	public:
+		static constexpr uint32_t kIntervalFrames = 32;  // ~0.8 s at 44.1 kHz
+
+		// Scans the whole stream. Returns nullptr if InKeepGoing turns false first.
+		static std::shared_ptr<const SeekIndex> Build(Mp3Stream& InStream, const std::function<bool()>& InKeepGoing);
+
+		// Persisted form, stamped with the track's size and modification time.
+		static std::shared_ptr<const SeekIndex> Load(const std::filesystem::path& InPath, uint64_t InFileSize, int64_t InModifiedTime);
+		bool                                    Save(const std::filesystem::path& InPath, uint64_t InFileSize, int64_t InModifiedTime) const;
+
+		uint32_t GetTotalFrames() const { return TotalFrames; }
+
+		// Offset of the indexed frame at or before InFrame, and that frame's number.
+		uint64_t GetOffset(uint32_t InFrame, uint32_t& OutIndexedFrame) const
+		{
+			const auto point = std::min<std::size_t>(InFrame / kIntervalFrames, Offsets.size() - 1);
+			OutIndexedFrame = static_cast<uint32_t>(point * kIntervalFrames);
+			return Offsets[point];
+		}
+
+	private:
+		std::vector<uint64_t> Offsets;
+		uint32_t              TotalFrames = 0;
+	};
+
+	// Result slot of a background index build, shared by the stream that asked for it.
+	struct SeekIndexRequest
+	{
+		std::string                                   Path;
+		std::atomic<std::shared_ptr<const SeekIndex>> Result;
+	};
+
+	// Builds seek indexes for local tracks on a background thread, one track at a time.
+	// Indexes are kept in InDirectory, so each track is only scanned once.
+	class SeekIndexer
+	{
+	public:
+		SeekIndexer(SourceFactory InOpenSource, std::filesystem::path InDirectory);
+		~SeekIndexer();
+
+		SeekIndexer(const SeekIndexer&) = delete;
+		SeekIndexer& operator=(const SeekIndexer&) = delete;
+
+		// The build is dropped if every holder of the request lets go before it finishes.
+		std::shared_ptr<SeekIndexRequest> Request(std::string_view InPath);
+
+	private:
+		void Run();
+		void Process(const std::weak_ptr<SeekIndexRequest>& InRequest);
+
+		SourceFactory         OpenSource;
+		std::filesystem::path Directory;
+
+		std::mutex                                   Mutex;
+		std::condition_variable                      Wake;
+		std::deque<std::weak_ptr<SeekIndexRequest>> Queue;
+		std::atomic<bool>                            Quit = false;
+		std::thread                                  Worker;
+	};
+}
@@ -0,0 +1,268 @@
+#include "Audio/SpatialDsp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include <immintrin.h>
+
+namespace Audio
+{
+	namespace
+	{
+		// Freeverb tunings at 44.1 kHz; the combs run side by side in the lanes of one vector.
+		constexpr std::size_t kCombLengths[4] = { 1116, 1188, 1277, 1356 };
+		constexpr std::size_t kAllpassLengths[2] = { 556, 441 };
+		constexpr uint32_t    kMaxSampleRate = 48000;
+
+		constexpr float kCombDamping = 0.2f;
+		constexpr float kAllpassFeedback = 0.5f;
+		constexpr float kReverbInputGain = 0.03f;
+		constexpr float kTailSeconds = 3.0f;
+		constexpr float kSmoothingSeconds = 0.05f;
+		constexpr float kOpenLowpassHz = 20000.0f;
+
+		std::size_t ScaleLength(std::size_t InLength, uint32_t InSampleRate)
+		{
+			return std::max<std::size_t>(1, InLength * InSampleRate / 44100);
+		}
+
+		float Approach(float InFrom, float InTo, float InBlend, float InSnap)
+		{
+			const float next = InFrom + (InTo - InFrom) * InBlend;
+			return std::abs(InTo - next) < InSnap ? InTo : next;
+		}
+
+		// Nothing is audible above 20 kHz, and a one-pole filter near Nyquist is no filter at all.
+		bool IsLowpassOpen(float InHz, uint32_t InSampleRate)
+		{
+			return InHz >= std::min(kOpenLowpassHz, 0.45f * InSampleRate);
+		}
+
+		bool IsOff(const SpatialParams& InParams, uint32_t InSampleRate)
+		{
+			return IsLowpassOpen(InParams.LowpassHz, InSampleRate) && InParams.ReverbSend == 0.0f && InParams.Pan == 0.0f && InParams.Level == 1.0f;
+		}
+
+		float LowpassCoefficient(float InHz, uint32_t InSampleRate)
+		{
+			return IsLowpassOpen(InHz, InSampleRate) ? 1.0f : 1.0f - std::exp(-2.0f * std::numbers::pi_v<float> * InHz / InSampleRate);
+		}
+
+		// Constant-power pan, scaled so the centre leaves both channels at unity.
+		void GetPanGains(const SpatialParams& InParams, float& OutLeft, float& OutRight)
+		{
+			const float angle = (std::clamp(InParams.Pan, -1.0f, 1.0f) + 1.0f) * std::numbers::pi_v<float> / 4.0f;
+			OutLeft = std::cos(angle) * std::numbers::sqrt2_v<float> * InParams.Level;
+			OutRight = std::sin(angle) * std::numbers::sqrt2_v<float> * InParams.Level;
+		}
+
+		float ProcessAllpass(float* InData, std::size_t InLength, std::size_t& InOutPosition, float InInput)
+		{
+			const float delayed = InData[InOutPosition];
+			InData[InOutPosition] = InInput + delayed * kAllpassFeedback;
+			if (++InOutPosition == InLength)
+				InOutPosition = 0;
+			return delayed - InInput;
+		}
+	}
+
+	SpatialParams GetSpatialParams(SpatialPreset InPreset)
+	{
+		switch (InPreset) {
+		case SpatialPreset::Cockpit:
+			return { 7000.0f, 0.15f, 0.35f, 0.0f, 0.9f };
+		case SpatialPreset::Outdoors:
+			return { 4500.0f, 0.0f, 0.0f, 0.0f, 0.85f };
+		case SpatialPreset::Interior:
+			return { 9000.0f, 0.3f, 0.75f, 0.0f, 0.8f };
+		default:
+			return {};
+		}
+	}
+
+	SpatialChain::SpatialChain()
+	{
+		std::size_t total = 0;
+		for (const auto length : kCombLengths)
+			total += ScaleLength(length, kMaxSampleRate);
+		for (const auto length : kAllpassLengths)
+			total += ScaleLength(length, kMaxSampleRate);
+		Storage.resize(total);
+
+		SetParams({});
+	}
+
+	void SpatialChain::SetParams(const SpatialParams& InParams)
+	{
+		Target[0].store(InParams.LowpassHz, std::memory_order_relaxed);
+		Target[1].store(std::clamp(InParams.ReverbSend, 0.0f, 1.0f), std::memory_order_relaxed);
+		Target[2].store(std::clamp(InParams.ReverbDecay, 0.0f, 1.0f), std::memory_order_relaxed);
+		Target[3].store(std::clamp(InParams.Pan, -1.0f, 1.0f), std::memory_order_relaxed);
+		Target[4].store(std::max(InParams.Level, 0.0f), std::memory_order_relaxed);
+	}
+
+	void SpatialChain::Configure(uint32_t InSampleRate)
+	{
+		// Lengths for rates above kMaxSampleRate are capped to the storage sized for it.
+		const uint32_t rate = std::min(InSampleRate, kMaxSampleRate);
+		float*         data = Storage.data();
+		for (std::size_t i = 0; i < kCombs; ++i) {
+			Combs[i] = { data, ScaleLength(kCombLengths[i], rate), 0 };
+			data += Combs[i].Length;
+		}
+		for (std::size_t i = 0; i < kAllpasses; ++i) {
+			Allpasses[i] = { data, ScaleLength(kAllpassLengths[i], rate), 0 };
+			data += Allpasses[i].Length;
+		}
+
+		SampleRate = InSampleRate;
+		Clear();
+	}
+
+	void SpatialChain::Clear()
+	{
+		std::fill(Storage.begin(), Storage.end(), 0.0f);
+		CombDamping.fill(0.0f);
+		LowpassState.fill(0.0f);
+		TailFrames = 0;
+	}
+
+	void SpatialChain::Process(std::span<float> InOutSamples, uint32_t InChannels, uint32_t InSampleRate)
+	{
+		if (InChannels == 0 || InChannels > 2 || InSampleRate == 0)
+			return;
+
+		const std::size_t frames = InOutSamples.size() / InChannels;
+		if (frames == 0)
+			return;
+
+		if (InSampleRate != SampleRate)
+			Configure(InSampleRate);
+
+		const float   blend = 1.0f - std::exp(-static_cast<float>(frames) / (kSmoothingSeconds * SampleRate));
+		SpatialParams next;
+		next.LowpassHz = Approach(Current.LowpassHz, Target[0].load(std::memory_order_relaxed), blend, 1.0f);
+		next.ReverbSend = Approach(Current.ReverbSend, Target[1].load(std::memory_order_relaxed), blend, 1e-4f);
+		next.ReverbDecay = Approach(Current.ReverbDecay, Target[2].load(std::memory_order_relaxed), blend, 1e-4f);
+		next.Pan = Approach(Current.Pan, Target[3].load(std::memory_order_relaxed), blend, 1e-4f);
+		next.Level = Approach(Current.Level, Target[4].load(std::memory_order_relaxed), blend, 1e-4f);
+
+		if (next.ReverbSend > 0.0f || Current.ReverbSend > 0.0f)
+			TailFrames = static_cast<std::size_t>(kTailSeconds * SampleRate);
+		else
+			TailFrames -= std::min(TailFrames, frames);
+
+		if (IsOff(Current, SampleRate) && IsOff(next, SampleRate) && TailFrames == 0) {
+			if (Active)
+				Clear();
+			Active = false;
+			Current = next;
+			return;
+		}
+
+		// Coming out of bypass, the filters start from the signal instead of from zero.
+		if (!Active) {
+			const float left = InOutSamples[0];
+			const float right = InOutSamples[InChannels - 1];
+			LowpassState = { left, right, left, right };
+			Active = true;
+		}
+
+		// Reverb feedback decays into denormals, which are very slow on x86.
+		const unsigned int csr = _mm_getcsr();
+		_mm_setcsr(csr | _MM_FLUSH_ZERO_ON | _MM_DENORMALS_ZERO_ON);
+
+		if (InChannels == 2)
+			Run<2>(InOutSamples.data(), frames, Current, next);
+		else
+			Run<1>(InOutSamples.data(), frames, Current, next);
+
+		_mm_setcsr(csr);
+		Current = next;
+	}
+
+	template <uint32_t Channels>
+	void SpatialChain::Run(float* InOutSamples, std::size_t InFrames, const SpatialParams& InFrom, const SpatialParams& InTo)
+	{
+		// Channels occupy the low lanes; the filters run on both at once.
+		const auto load = [](const float* InFrame) {
+			if constexpr (Channels == 2)
+				return _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(InFrame)));
+			else
+				return _mm_load_ss(InFrame);
+		};
+		const auto store = [](float* OutFrame, __m128 InValue) {
+			if constexpr (Channels == 2)
+				_mm_store_sd(reinterpret_cast<double*>(OutFrame), _mm_castps_pd(InValue));
+			else
+				_mm_store_ss(OutFrame, InValue);
+		};
+
+		const float frames = static_cast<float>(InFrames);
+
+		const auto coefficient = _mm_set1_ps(LowpassCoefficient(InTo.LowpassHz, SampleRate));
+		auto       stage1 = _mm_setr_ps(LowpassState[0], LowpassState[1], 0.0f, 0.0f);
+		auto       stage2 = _mm_setr_ps(LowpassState[2], LowpassState[3], 0.0f, 0.0f);
+
+		float fromLeft, fromRight, toLeft, toRight;
+		GetPanGains(InFrom, fromLeft, fromRight);
+		GetPanGains(InTo, toLeft, toRight);
+		if constexpr (Channels == 1) {
+			fromLeft = InFrom.Level;
+			toLeft = InTo.Level;
+		}
+		auto       gain = _mm_setr_ps(fromLeft, fromRight, 0.0f, 0.0f);
+		const auto gainStep = _mm_setr_ps((toLeft - fromLeft) / frames, (toRight - fromRight) / frames, 0.0f, 0.0f);
+
+		const float sendStep = (InTo.ReverbSend - InFrom.ReverbSend) / frames;
+		float       send = InFrom.ReverbSend * kReverbInputGain;
+
+		const auto feedback = _mm_set1_ps(0.7f + 0.28f * InTo.ReverbDecay);
+		const auto damping = _mm_set1_ps(kCombDamping);
+		const auto undamped = _mm_set1_ps(1.0f - kCombDamping);
+		auto       combFilter = _mm_loadu_ps(CombDamping.data());
+
+		alignas(16) float lanes[4];
+		for (std::size_t i = 0; i < InFrames; ++i) {
+			float*     frame = InOutSamples + i * Channels;
+			const auto input = load(frame);
+
+			// Two one-pole stages, 12 dB/octave.
+			stage1 = _mm_add_ps(stage1, _mm_mul_ps(coefficient, _mm_sub_ps(input, stage1)));
+			stage2 = _mm_add_ps(stage2, _mm_mul_ps(coefficient, _mm_sub_ps(stage1, stage2)));
+
+			// Mono send into four parallel damped combs.
+			_mm_store_ps(lanes, stage2);
+			const float reverbInput = (Channels == 2 ? (lanes[0] + lanes[1]) * 0.5f : lanes[0]) * send;
+			send += sendStep * kReverbInputGain;
+
+			const auto combOut = _mm_setr_ps(Combs[0].Data[Combs[0].Position], Combs[1].Data[Combs[1].Position], Combs[2].Data[Combs[2].Position], Combs[3].Data[Combs[3].Position]);
+			combFilter = _mm_add_ps(_mm_mul_ps(combOut, undamped), _mm_mul_ps(combFilter, damping));
+			_mm_store_ps(lanes, _mm_add_ps(_mm_set1_ps(reverbInput), _mm_mul_ps(combFilter, feedback)));
+			for (std::size_t c = 0; c < kCombs; ++c) {
+				auto& comb = Combs[c];
+				comb.Data[comb.Position] = lanes[c];
+				if (++comb.Position == comb.Length)
+					comb.Position = 0;
+			}
+
+			// Alternate combs feed each side, then one allpass per side for diffusion.
+			_mm_store_ps(lanes, combOut);
+			const float wetLeft = ProcessAllpass(Allpasses[0].Data, Allpasses[0].Length, Allpasses[0].Position, lanes[0] + lanes[2]);
+			const float wetRight = ProcessAllpass(Allpasses[1].Data, Allpasses[1].Length, Allpasses[1].Position, lanes[1] + lanes[3]);
+			const auto  wet = Channels == 2 ? _mm_setr_ps(wetLeft, wetRight, 0.0f, 0.0f) : _mm_set_ss((wetLeft + wetRight) * 0.5f);
+
+			store(frame, _mm_add_ps(_mm_mul_ps(stage2, gain), wet));
+			gain = _mm_add_ps(gain, gainStep);
+		}
+
+		_mm_storeu_ps(CombDamping.data(), combFilter);
+		_mm_store_ps(lanes, stage1);
+		LowpassState[0] = lanes[0];
+		LowpassState[1] = lanes[1];
+		_mm_store_ps(lanes, stage2);
+		LowpassState[2] = lanes[0];
+		LowpassState[3] = lanes[1];
+	}
+}
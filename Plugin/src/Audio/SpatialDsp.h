@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Audio
+{
+	// How the radio sits in the world: muffling, room sound, position and distance.
+	struct SpatialParams
+	{
+		float LowpassHz = 20000.0f;  // at or above 20 kHz (or ~0.45 x sample rate) the filter is open
+		float ReverbSend = 0.0f;     // 0..1
+		float ReverbDecay = 0.5f;    // 0..1, room size
+		float Pan = 0.0f;            // -1 left .. 1 right
+		float Level = 1.0f;          // direct sound, falls with distance
+	};
+
+	enum class SpatialPreset : uint32_t
+	{
+		Off,
+		Cockpit,   // ship speakers in a small hard-walled room
+		Outdoors,  // suit radio under the helmet, no room
+		Interior,  // station or building PA, larger room
+	};
+
+	SpatialParams GetSpatialParams(SpatialPreset InPreset);
+
+	// Low-pass, reverb send and constant-power pan on interleaved mono or stereo PCM, run by
+	// the render thread in place. Parameters may be changed from any thread and are smoothed
+	// over ~50 ms. Delay lines are allocated up front for 48 kHz; processing never allocates,
+	// and with the Off parameters (once the reverb tail has died) it is skipped entirely.
+	class SpatialChain
+	{
+	public:
+		SpatialChain();
+
+		void SetParams(const SpatialParams& InParams);
+
+		void Process(std::span<float> InOutSamples, uint32_t InChannels, uint32_t InSampleRate);
+
+	private:
+		static constexpr std::size_t kCombs = 4;
+		static constexpr std::size_t kAllpasses = 2;
+
+		struct DelayLine
+		{
+			float*      Data = nullptr;
+			std::size_t Length = 0;
+			std::size_t Position = 0;
+		};
+
+		void Configure(uint32_t InSampleRate);
+		void Clear();
+
+		template <uint32_t Channels>
+		void Run(float* InOutSamples, std::size_t InFrames, const SpatialParams& InFrom, const SpatialParams& InTo);
+
+		std::array<std::atomic<float>, 5> Target;  // SpatialParams, field by field
+		SpatialParams                     Current;
+
+		std::vector<float>                Storage;
+		std::array<DelayLine, kCombs>     Combs;
+		std::array<DelayLine, kAllpasses> Allpasses;
+		std::array<float, kCombs>         CombDamping{};
+		std::array<float, 4>              LowpassState{};  // two stages x two channels
+		uint32_t                          SampleRate = 0;
+		bool                              Active = false;
+		std::size_t                       TailFrames = 0;  // frames left before the reverb is silent
+	};
+}
@@ -0,0 +1,268 @@
+#include "Audio/StationPool.h"
+
+#include "Control/MessageQueue.h"
+#include "Control/ThreadRuntime.h"
+
+#include <algorithm>
+#include <ranges>
+
+namespace Audio
+{
+	namespace
+	{
+		// Room for the wanted sources before their text has to grow; long URLs fit.
+		constexpr std::size_t kWantedTextBytes = 4096;
+	}
+
+	StationPool::StationPool(SourceFactory InOpenSource, DecoderFactory InCreateDecoder) :
+		OpenSource(std::move(InOpenSource)),
+		CreateDecoder(std::move(InCreateDecoder)),
+		WantedText(std::make_unique<char[]>(kWantedTextBytes)),
+		WantedTextBytes(kWantedTextBytes)
+	{
+		Worker = std::thread(&StationPool::Run, this);
+	}
+
+	StationPool::~StationPool()
+	{
+		{
+			std::lock_guard lock(Mutex);
+			Quit = true;
+			// Unblock a read-ahead or open in progress; the pool is going away with it.
+			for (auto& entry : Entries) {
+				if (entry.Opening)
+					entry.Opening->Cancel();
+				else if (entry.Busy && entry.Stream)
+					entry.Stream->Source->Cancel();
+			}
+		}
+		Changed.notify_all();
+		Worker.join();
+	}
+
+	void StationPool::SetWanted(std::span<const std::string_view> InSources, std::size_t InBudgetBytes)
+	{
+		InSources = InSources.first(std::min(InSources.size(), kMaxWanted));
+		{
+			std::lock_guard lock(Mutex);
+			if (!std::ranges::equal(GetWanted(), InSources)) {
+				CopyWanted(InSources);
+				Failed.clear();
+			}
+			BudgetBytes = InBudgetBytes;
+
+			// Wanted stations move to the front, in order, so eviction spares them.
+			for (const auto wanted : GetWanted() | std::views::reverse) {
+				if (const auto entry = Find(wanted); entry != Entries.end())
+					Entries.splice(Entries.begin(), Entries, entry);
+			}
+			Evict();
+		}
+		Changed.notify_all();
+	}
+
+	std::unique_ptr<PreparedStream> StationPool::Take(std::string_view InSource)
+	{
+		std::unique_lock lock(Mutex);
+
+		// The station is about to play; it no longer needs keeping warm.
+		WantedCount = std::remove(Wanted.begin(), Wanted.begin() + WantedCount, InSource) - Wanted.begin();
+		++Takers;
+		for (;;) {
+			const auto entry = Find(InSource);
+			if (entry == Entries.end() || Quit) {
+				--Takers;
+				Changed.notify_all();
+				return nullptr;
+			}
+
+			if (!entry->Busy) {
+				auto stream = std::move(entry->Stream);
+				Entries.erase(entry);
+				--Takers;
+				Changed.notify_all();
+				return stream;
+			}
+			Changed.wait(lock);
+		}
+	}
+
+	void StationPool::Put(std::unique_ptr<PreparedStream> InStream)
+	{
+		if (!InStream)
+			return;
+
+		{
+			std::lock_guard lock(Mutex);
+			if (const auto entry = Find(InStream->Key); entry != Entries.end()) {
+				// The worker is opening this station or reading ahead on it: its copy stays, and
+				// this one is let go, so the key is never in the pool twice.
+				if (entry->Busy)
+					return;
+				Entries.erase(entry);
+			}
+
+			Entries.push_front({ InStream->Key, std::move(InStream) });
+			Evict();
+		}
+		Changed.notify_all();
+	}
+
+	void StationPool::CopyWanted(std::span<const std::string_view> InSources)
+	{
+		std::size_t bytes = 0;
+		for (const auto source : InSources)
+			bytes += source.size();
+		if (bytes > WantedTextBytes) {
+			WantedTextBytes = std::max(bytes, 2 * WantedTextBytes);
+			WantedText = std::make_unique<char[]>(WantedTextBytes);
+		}
+
+		char* cursor = WantedText.get();
+		WantedCount = 0;
+		for (const auto source : InSources) {
+			Wanted[WantedCount++] = { cursor, source.size() };
+			cursor = std::ranges::copy(source, cursor).out;
+		}
+	}
+
+	bool StationPool::IsWanted(std::string_view InKey) const
+	{
+		const auto wanted = GetWanted();
+		return std::ranges::find(wanted, InKey) != wanted.end();
+	}
+
+	StationPool::EntryList::iterator StationPool::Find(std::string_view InKey)
+	{
+		return std::ranges::find_if(Entries, [&](const Entry& InEntry) { return InEntry.Key == InKey; });
+	}
+
+	void StationPool::Evict()
+	{
+		// Besides the wanted stations, keep the most recent other one: the station just left
+		// is the likeliest to be flipped back to, and a station that finishes opening while a
+		// switch waits for it in Take is the one it wants.
+		const std::size_t maxEntries = WantedCount == 0 && Takers == 0 ? 0 : WantedCount + 1;
+
+		std::size_t count = 0;
+		std::size_t bytes = 0;
+
+		// Wanted stations are admitted first, so a stale stream never pushes out a wanted one.
+		for (const bool wantedPass : { true, false }) {
+			for (auto entry = Entries.begin(); entry != Entries.end();) {
+				if (IsWanted(entry->Key) != wantedPass) {
+					++entry;
+					continue;
+				}
+
+				const std::size_t size = entry->Stream ? entry->Stream->GetMemoryBytes() : 0;
+				if (!entry->Busy && (count >= maxEntries || bytes + size > BudgetBytes)) {
+					entry = Entries.erase(entry);
+					continue;
+				}
+
+				++count;
+				bytes += size;
+				++entry;
+			}
+		}
+	}
+
+	void StationPool::Run()
+	{
+		Control::EnterThread("Radio Prefetch", Control::ThreadRole::Io);
+
+		std::unique_lock lock(Mutex);
+		std::size_t      liveTurn = 0;
+
+		while (!Quit) {
+			// A switch waiting in Take goes first; otherwise back-to-back read-ahead on the
+			// stream it wants would keep it busy indefinitely.
+			if (Takers > 0) {
+				Changed.wait(lock, [this] { return Takers == 0 || Quit; });
+				continue;
+			}
+
+			// Open the first wanted station that is neither warm nor known to fail.
+			const auto wanted = GetWanted();
+			const auto missing = std::ranges::find_if(wanted, [&](std::string_view InKey) {
+				return Find(InKey) == Entries.end() && std::ranges::find(Failed, InKey) == Failed.end();
+			});
+
+			if (missing != wanted.end()) {
+				Entries.push_front({ std::string(*missing), nullptr, true });
+				const auto entry = Entries.begin();
+
+				// Connecting and waiting for the stream header can take as long as the network
+				// does, so the open runs in a group the destructor can cancel until it is over.
+				ConnectGroup opening;
+				entry->Opening = &opening;
+				lock.unlock();
+
+				auto stream = std::make_unique<PreparedStream>();
+				stream->Key = entry->Key;
+				bool opened = false;
+				{
+					const ConnectGroup::Scope scope(opening);
+					stream->Source = OpenSource(stream->Key);
+					if (!stream->Source) {
+						INFO("{} - Unable to open source: {}", Plugin::NAME, stream->Key);
+					} else {
+						const ConnectGroup::Member member(*stream->Source);
+						opened = !member.IsCancelled() && PrepareStream(*stream, CreateDecoder);
+					}
+				}
+
+				lock.lock();
+				entry->Opening = nullptr;
+
+				entry->Busy = false;
+				if (opened) {
+					entry->Stream = std::move(stream);
+				} else {
+					if (!Quit)
+						Failed.push_back(entry->Key);
+					Entries.erase(entry);
+				}
+				Evict();
+				Changed.notify_all();
+				continue;
+			}
+
+			// Read ahead on live stations, one frame each in turn. The reads block on the
+			// network, which paces this loop to the streams' own rate.
+			const auto isLive = [](const Entry& InEntry) { return InEntry.Stream && InEntry.Stream->Ahead.GetCapacity() > 0; };
+			const auto liveCount = std::ranges::count_if(Entries, isLive);
+			if (liveCount == 0) {
+				Changed.wait(lock);
+				continue;
+			}
+
+			auto live = Entries.begin();
+			for (auto skip = liveTurn++ % liveCount;; ++live) {
+				if (isLive(*live) && skip-- == 0)
+					break;
+			}
+
+			live->Busy = true;
+			PreparedStream& stream = *live->Stream;
+
+			lock.unlock();
+			const auto frame = stream.Stream->NextFrame();
+			if (!frame.empty()) {
+				// Live audio: the oldest read-ahead goes so the newest fits.
+				while (!stream.Ahead.Push(frame) && !stream.Ahead.IsEmpty())
+					stream.Ahead.DropOldest();
+			}
+			lock.lock();
+
+			live->Busy = false;
+			if (frame.empty()) {
+				Control::Log("{} - Warm station ended: {}", Plugin::NAME, live->Key);
+				Entries.erase(live);
+			}
+			Evict();
+			Changed.notify_all();
+		}
+	}
+}
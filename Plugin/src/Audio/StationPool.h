@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Audio/PreparedStream.h"
+
+#include <array>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace Audio
+{
+	// Keeps the stations next to the one on air opened on a background thread, so switching to
+	// them swaps a ready stream in instead of connecting from cold. Live streams keep reading
+	// a few seconds ahead so their connection stays current. Streams that are no longer wanted
+	// are evicted least recently used first, and the pool stays within a memory budget.
+	class StationPool
+	{
+	public:
+		StationPool(SourceFactory InOpenSource, DecoderFactory InCreateDecoder);
+		~StationPool();
+
+		StationPool(const StationPool&) = delete;
+		StationPool& operator=(const StationPool&) = delete;
+
+		// Most stations kept warm at once: three either side of the one on air, and a folder
+		// station's next track.
+		static constexpr std::size_t kMaxWanted = 7;
+
+		// Stations to keep warm, most wanted first, and the memory they may use together. Past
+		// kMaxWanted the least wanted are left out.
+		void SetWanted(std::span<const std::string_view> InSources, std::size_t InBudgetBytes);
+
+		// Hands over the warm stream for InSource, or nullptr if there is none. Waits if the
+		// stream is still being opened, which is never slower than opening it again.
+		std::unique_ptr<PreparedStream> Take(std::string_view InSource);
+
+		// Returns a stream that stopped playing, so switching back to it is instant too.
+		void Put(std::unique_ptr<PreparedStream> InStream);
+
+	private:
+		struct Entry
+		{
+			std::string                     Key;
+			std::unique_ptr<PreparedStream> Stream;
+			bool                            Busy = false;       // the worker is using Stream outside the lock
+			ConnectGroup*                   Opening = nullptr;  // the open in progress, while the station opens
+		};
+
+		using EntryList = std::list<Entry>;
+
+		void                              Run();
+		std::span<const std::string_view> GetWanted() const { return { Wanted.data(), WantedCount }; }
+		void                              CopyWanted(std::span<const std::string_view> InSources);
+		bool                              IsWanted(std::string_view InKey) const;
+		EntryList::iterator               Find(std::string_view InKey);
+		void                              Evict();
+
+		SourceFactory  OpenSource;
+		DecoderFactory CreateDecoder;
+
+		std::mutex              Mutex;
+		std::condition_variable Changed;
+		EntryList               Entries;  // most recently used first
+
+		// The wanted set changes on every switch, so it is copied into text that only grows
+		// rather than into strings of its own.
+		std::array<std::string_view, kMaxWanted> Wanted;
+		std::size_t                              WantedCount = 0;
+		std::unique_ptr<char[]>                  WantedText;
+		std::size_t                              WantedTextBytes = 0;
+
+		std::vector<std::string> Failed;  // not retried until the wanted set changes
+		std::size_t              BudgetBytes = 0;
+		int                      Takers = 0;  // threads waiting in Take
+		bool                     Quit = false;
+		std::thread              Worker;
+	};
+}
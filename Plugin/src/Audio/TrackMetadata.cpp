@@ -0,0 +1,147 @@
+#include "Audio/TrackMetadata.h"
+
+#include "Audio/ByteSource.h"
+#include "Audio/Mp3.h"
+
+#include <cstring>
+#include <vector>
+
+namespace Audio
+{
+	namespace
+	{
+		// Tags are only read for their text frames; cover art beyond this is not loaded.
+		constexpr std::size_t kMaxTagBytes = 64 * 1024;
+
+		uint32_t ReadSynchsafe32(const uint8_t* InBytes)
+		{
+			return (uint32_t(InBytes[0] & 0x7F) << 21) | (uint32_t(InBytes[1] & 0x7F) << 14) | (uint32_t(InBytes[2] & 0x7F) << 7) | uint32_t(InBytes[3] & 0x7F);
+		}
+
+		uint32_t ReadBigEndian32(const uint8_t* InBytes)
+		{
+			return (uint32_t(InBytes[0]) << 24) | (uint32_t(InBytes[1]) << 16) | (uint32_t(InBytes[2]) << 8) | uint32_t(InBytes[3]);
+		}
+
+		void AppendUtf8(std::string& OutText, uint32_t InCodePoint)
+		{
+			if (InCodePoint < 0x80) {
+				OutText += static_cast<char>(InCodePoint);
+			} else if (InCodePoint < 0x800) {
+				OutText += static_cast<char>(0xC0 | (InCodePoint >> 6));
+				OutText += static_cast<char>(0x80 | (InCodePoint & 0x3F));
+			} else if (InCodePoint < 0x10000) {
+				OutText += static_cast<char>(0xE0 | (InCodePoint >> 12));
+				OutText += static_cast<char>(0x80 | ((InCodePoint >> 6) & 0x3F));
+				OutText += static_cast<char>(0x80 | (InCodePoint & 0x3F));
+			} else {
+				OutText += static_cast<char>(0xF0 | (InCodePoint >> 18));
+				OutText += static_cast<char>(0x80 | ((InCodePoint >> 12) & 0x3F));
+				OutText += static_cast<char>(0x80 | ((InCodePoint >> 6) & 0x3F));
+				OutText += static_cast<char>(0x80 | (InCodePoint & 0x3F));
+			}
+		}
+
+		// Text frame body: one encoding byte, then the text. Only the first string is kept.
+		std::string DecodeTextFrame(std::span<const uint8_t> InBody)
+		{
+			std::string text;
+			if (InBody.empty())
+				return text;
+
+			const uint8_t encoding = InBody[0];
+			auto          bytes = InBody.subspan(1);
+
+			if (encoding == 0 || encoding == 3) {
+				// Latin-1 maps straight onto the first 256 code points; UTF-8 is copied.
+				for (const uint8_t byte : bytes) {
+					if (byte == 0)
+						break;
+					if (encoding == 3)
+						text += static_cast<char>(byte);
+					else
+						AppendUtf8(text, byte);
+				}
+				return text;
+			}
+
+			bool bigEndian = encoding == 2;
+			if (encoding == 1 && bytes.size() >= 2) {
+				bigEndian = bytes[0] == 0xFE && bytes[1] == 0xFF;
+				bytes = bytes.subspan(2);
+			}
+
+			for (std::size_t i = 0; i + 1 < bytes.size(); i += 2) {
+				uint32_t unit = bigEndian ? (bytes[i] << 8) | bytes[i + 1] : (bytes[i + 1] << 8) | bytes[i];
+				if (unit == 0)
+					break;
+
+				if (unit >= 0xD800 && unit < 0xDC00 && i + 3 < bytes.size()) {
+					const uint32_t low = bigEndian ? (bytes[i + 2] << 8) | bytes[i + 3] : (bytes[i + 3] << 8) | bytes[i + 2];
+					if (low >= 0xDC00 && low < 0xE000) {
+						unit = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+						i += 2;
+					}
+				}
+				AppendUtf8(text, unit);
+			}
+			return text;
+		}
+	}
+
+	void ParseId3v2Tags(std::span<const uint8_t> InTag, TrackMetadata& OutMetadata)
+	{
+		if (InTag.size() < 10 || std::memcmp(InTag.data(), "ID3", 3) != 0)
+			return;
+
+		const uint8_t major = InTag[3];
+		const uint8_t flags = InTag[5];
+		if ((major != 3 && major != 4) || (flags & 0xC0) != 0)
+			return;
+
+		const auto end = std::min<std::size_t>(InTag.size(), 10 + ReadSynchsafe32(InTag.data() + 6));
+		for (std::size_t cursor = 10; cursor + 10 <= end;) {
+			const uint8_t* frame = InTag.data() + cursor;
+			if (frame[0] == 0)
+				break;  // padding
+
+			const uint32_t size = major == 4 ? ReadSynchsafe32(frame + 4) : ReadBigEndian32(frame + 4);
+			if (size > end - cursor - 10)
+				break;
+
+			const auto body = InTag.subspan(cursor + 10, size);
+			if (std::memcmp(frame, "TIT2", 4) == 0)
+				OutMetadata.Title = DecodeTextFrame(body);
+			else if (std::memcmp(frame, "TPE1", 4) == 0)
+				OutMetadata.Artist = DecodeTextFrame(body);
+
+			cursor += 10 + size;
+		}
+	}
+
+	bool ReadTrackMetadata(ByteSource& InSource, TrackMetadata& OutMetadata)
+	{
+		uint8_t header[10];
+		if (InSource.Read(header) == sizeof(header)) {
+			if (const auto tagSize = GetId3v2Size(header); tagSize > 0) {
+				std::vector<uint8_t> tag(std::min(tagSize, kMaxTagBytes));
+				std::memcpy(tag.data(), header, sizeof(header));
+				const auto read = InSource.Read(std::span(tag).subspan(sizeof(header)));
+				ParseId3v2Tags({ tag.data(), sizeof(header) + read }, OutMetadata);
+			}
+		}
+		if (!InSource.Seek(0))
+			return false;
+
+		Mp3Stream stream(InSource);
+		if (!stream.Open())
+			return false;
+
+		const auto& info = stream.GetInfo();
+		OutMetadata.DurationMs = info.DurationMs;
+		OutMetadata.SampleRate = info.First.SampleRate;
+		OutMetadata.Channels = info.First.Channels;
+		OutMetadata.Bitrate = info.DurationMs > 0 && info.DataBytes > 0 ? static_cast<uint32_t>(info.DataBytes * 8 / info.DurationMs) : info.First.Bitrate;
+		return true;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace Audio
+{
+	class ByteSource;
+
+	// What is known about a track without decoding it.
+	struct TrackMetadata
+	{
+		uint32_t    DurationMs = 0;  // 0 when unknown
+		uint32_t    Bitrate = 0;     // kbps, averaged over the file when its size is known
+		uint32_t    SampleRate = 0;
+		uint32_t    Channels = 0;
+		std::string Title;           // ID3v2 TIT2, UTF-8
+		std::string Artist;          // ID3v2 TPE1, UTF-8
+	};
+
+	// Fills OutMetadata from the ID3v2 tag, frame header and Xing/Info data at the start of
+	// InSource. Returns false if it is not an MP3 stream.
+	bool ReadTrackMetadata(ByteSource& InSource, TrackMetadata& OutMetadata);
+
+	// Title and artist from an ID3v2.3/2.4 tag at the start of InTag. Unsynchronised tags and
+	// tags with an extended header are ignored.
+	void ParseId3v2Tags(std::span<const uint8_t> InTag, TrackMetadata& OutMetadata);
+}
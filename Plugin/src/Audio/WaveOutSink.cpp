@@ -0,0 +1,87 @@
+#include "Audio/WaveOutSink.h"
+
+#include "Control/ThreadRuntime.h"
+
+#pragma comment(lib, "Winmm.lib")
+
+namespace Audio
+{
+	bool WaveOutSink::Start(uint32_t InSampleRate, uint32_t InChannels, RenderCallback InCallback)
+	{
+		Stop();
+
+		WAVEFORMATEX format{};
+		format.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+		format.nChannels = static_cast<WORD>(InChannels);
+		format.nSamplesPerSec = InSampleRate;
+		format.wBitsPerSample = 32;
+		format.nBlockAlign = format.nChannels * sizeof(float);
+		format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+
+		BufferDone = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+		if (const auto result = waveOutOpen(&Device, WAVE_MAPPER, &format, reinterpret_cast<DWORD_PTR>(BufferDone), 0, CALLBACK_EVENT); result != MMSYSERR_NOERROR) {
+			INFO("{} - waveOutOpen failed with code: {}", Plugin::NAME, result);
+			CloseHandle(BufferDone);
+			BufferDone = nullptr;
+			Device = nullptr;
+			return false;
+		}
+
+		const std::size_t blockSamples = std::size_t(InSampleRate) * kBufferMs / 1000 * InChannels;
+		for (std::size_t i = 0; i < kBufferCount; ++i) {
+			Buffers[i].assign(blockSamples, 0.0f);
+			Headers[i] = {};
+			Headers[i].lpData = reinterpret_cast<LPSTR>(Buffers[i].data());
+			Headers[i].dwBufferLength = static_cast<DWORD>(blockSamples * sizeof(float));
+			waveOutPrepareHeader(Device, &Headers[i], sizeof(WAVEHDR));
+			// Marked done so the render thread fills and queues it on its first pass.
+			Headers[i].dwFlags |= WHDR_DONE;
+		}
+
+		SampleRate = InSampleRate;
+		Channels = InChannels;
+		Callback = std::move(InCallback);
+		Quit = false;
+		Thread = std::thread(&WaveOutSink::RenderLoop, this);
+		return true;
+	}
+
+	void WaveOutSink::Stop()
+	{
+		if (!Device)
+			return;
+
+		Quit = true;
+		SetEvent(BufferDone);
+		if (Thread.joinable())
+			Thread.join();
+
+		waveOutReset(Device);
+		for (auto& header : Headers)
+			waveOutUnprepareHeader(Device, &header, sizeof(WAVEHDR));
+		waveOutClose(Device);
+		CloseHandle(BufferDone);
+
+		Device = nullptr;
+		BufferDone = nullptr;
+		SampleRate = 0;
+		Channels = 0;
+	}
+
+	void WaveOutSink::RenderLoop()
+	{
+		Control::EnterThread("Radio Output", Control::ThreadRole::Render);
+
+		while (!Quit) {
+			for (std::size_t i = 0; i < kBufferCount; ++i) {
+				if (!(Headers[i].dwFlags & WHDR_DONE))
+					continue;
+
+				Callback(Buffers[i]);
+				waveOutWrite(Device, &Headers[i], sizeof(WAVEHDR));
+			}
+
+			WaitForSingleObject(BufferDone, 100);
+		}
+	}
+}
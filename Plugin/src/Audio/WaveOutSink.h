@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Audio/AudioSink.h"
+
+#include <Mmsystem.h>
+
+namespace Audio
+{
+	// Float PCM output through waveOut, refilled from an event-driven render thread.
+	class WaveOutSink final : public AudioSink
+	{
+	public:
+		~WaveOutSink() override { Stop(); }
+
+		bool Start(uint32_t InSampleRate, uint32_t InChannels, RenderCallback InCallback) override;
+		void Stop() override;
+
+	private:
+		static constexpr std::size_t kBufferCount = 4;
+		static constexpr uint32_t    kBufferMs = 20;
+
+		void RenderLoop();
+
+		HWAVEOUT                                    Device = nullptr;
+		HANDLE                                      BufferDone = nullptr;
+		std::array<WAVEHDR, kBufferCount>           Headers{};
+		std::array<std::vector<float>, kBufferCount> Buffers;
+		RenderCallback                              Callback;
+		std::thread                                 Thread;
+		std::atomic<bool>                           Quit = false;
+	};
+}
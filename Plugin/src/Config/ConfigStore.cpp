@@ -0,0 +1,100 @@
+#include "Config/ConfigStore.h"
+
+#include <algorithm>
+
+ConfigStore::Reader::Reader(ConfigStore& InStore) :
+	Store(InStore)
+{
+	for (std::size_t i = 0; i < kMaxReaders; ++i) {
+		bool expected = false;
+		if (Store.SlotUsed[i].compare_exchange_strong(expected, true)) {
+			Slot = &Store.Hazards[i];
+			return;
+		}
+	}
+
+	// Readers are one per long-lived thread; running out of slots is a programming error, but
+	// not one to crash the game over.
+	INFO("{} - Too many configuration readers, falling back to copies", Plugin::NAME);
+}
+
+ConfigStore::Reader::~Reader()
+{
+	if (!Slot)
+		return;
+
+	Slot->store(nullptr, std::memory_order_release);
+	Store.SlotUsed[Slot - Store.Hazards.data()].store(false, std::memory_order_release);
+}
+
+const ConfigSnapshot& ConfigStore::Reader::Get()
+{
+	// Without a slot nothing keeps the current snapshot alive, so it is copied while Publish,
+	// the only place that frees snapshots, is held off. A StationTable owns its arena and is
+	// not copied; the copy's is compiled again from the playlist.
+	if (!Slot) {
+		std::lock_guard       lock(Store.PublishMutex);
+		const ConfigSnapshot* current = Store.Snapshot.load(std::memory_order_acquire);
+		if (!Copy || Copy->Generation != current->Generation) {
+			auto copy = std::make_unique<ConfigSnapshot>();
+			copy->Settings = current->Settings;
+			copy->Stations = StationTable(copy->Settings.playlist);
+			copy->Generation = current->Generation;
+			Copy = std::move(copy);
+		}
+		return *Copy;
+	}
+
+	// Announce the snapshot, then confirm it is still current: a publisher that swapped in
+	// between either sees the hazard or we retry with the new pointer.
+	const ConfigSnapshot* snapshot = Store.Snapshot.load(std::memory_order_acquire);
+	for (;;) {
+		Slot->store(snapshot, std::memory_order_seq_cst);
+		const ConfigSnapshot* current = Store.Snapshot.load(std::memory_order_seq_cst);
+		if (current == snapshot)
+			return *snapshot;
+		snapshot = current;
+	}
+}
+
+ConfigStore::ConfigStore()
+{
+	for (std::size_t i = 0; i < kMaxReaders; ++i) {
+		Hazards[i].store(nullptr);
+		SlotUsed[i].store(false);
+	}
+
+	Publish(Config{});
+}
+
+ConfigStore::~ConfigStore()
+{
+	Snapshot.store(nullptr);
+	Retired.clear();
+}
+
+void ConfigStore::Publish(Config InConfig)
+{
+	std::lock_guard lock(PublishMutex);
+
+	auto snapshot = std::make_unique<ConfigSnapshot>();
+	snapshot->Settings = std::move(InConfig);
+	snapshot->Stations = StationTable(snapshot->Settings.playlist);
+	snapshot->Generation = ++Generation;
+
+	Snapshot.store(snapshot.get(), std::memory_order_seq_cst);
+	Retired.push_back(std::move(snapshot));
+
+	Reclaim();
+}
+
+void ConfigStore::Reclaim()
+{
+	const ConfigSnapshot* current = Snapshot.load(std::memory_order_seq_cst);
+
+	std::erase_if(Retired, [&](const std::unique_ptr<ConfigSnapshot>& InSnapshot) {
+		if (InSnapshot.get() == current)
+			return false;
+		return std::ranges::none_of(Hazards, [&](const auto& InHazard) { return InHazard.load(std::memory_order_seq_cst) == InSnapshot.get(); });
+	});
+}
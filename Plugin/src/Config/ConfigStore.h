@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Config/RadioConfig.h"
+#include "Config/StationTable.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Immutable configuration shared between threads. Never modified after it is published.
+struct ConfigSnapshot
+{
+	Config       Settings;
+	StationTable Stations;  // Settings.playlist, compiled
+	uint64_t     Generation = 0;
+};
+
+// Publishes configuration snapshots RCU-style: readers pick up the current snapshot with an
+// atomic load and never lock; a reload builds a new snapshot off to the side and swaps the
+// pointer. Old snapshots are freed once no reader still holds them (hazard pointers, one slot
+// per reader thread), so a reader never sees a half-updated or freed list. A reader past
+// kMaxReaders gets no slot and reads private copies made under the publish lock instead.
+class ConfigStore
+{
+public:
+	static constexpr std::size_t kMaxReaders = 4;
+
+	// Per-thread view. Get() returns the latest snapshot, which stays valid until the next
+	// Get() on the same reader or the reader's destruction.
+	class Reader
+	{
+	public:
+		explicit Reader(ConfigStore& InStore);
+		~Reader();
+
+		Reader(const Reader&) = delete;
+		Reader& operator=(const Reader&) = delete;
+
+		const ConfigSnapshot& Get();
+
+	private:
+		ConfigStore&                         Store;
+		std::atomic<const ConfigSnapshot*>* Slot = nullptr;
+		std::unique_ptr<ConfigSnapshot>      Copy;  // without a slot, the snapshot Get returned
+	};
+
+	ConfigStore();
+	~ConfigStore();
+
+	// Makes InConfig the current configuration. Safe to call from any thread.
+	void Publish(Config InConfig);
+
+	const ConfigSnapshot* Current() const { return Snapshot.load(std::memory_order_acquire); }
+
+private:
+	void Reclaim();
+
+	std::atomic<const ConfigSnapshot*>                         Snapshot = nullptr;
+	std::array<std::atomic<const ConfigSnapshot*>, kMaxReaders> Hazards;
+	std::array<std::atomic<bool>, kMaxReaders>                  SlotUsed;
+
+	std::mutex                                   PublishMutex;
+	std::vector<std::unique_ptr<ConfigSnapshot>> Retired;
+	uint64_t                                     Generation = 0;
+};
@@ -0,0 +1,127 @@
+#include "Config/ConfigWatcher.h"
+
+#include "Control/Telemetry.h"
+#include "Control/ThreadRuntime.h"
+
+namespace
+{
+	// Editors save in several writes (truncate, write, rename); wait for the burst to settle.
+	constexpr uint32_t SettleMs = 250;
+
+	std::filesystem::file_time_type GetLastWrite(const std::filesystem::path& InFile)
+	{
+		std::error_code ec;
+		const auto      time = std::filesystem::last_write_time(InFile, ec);
+		return ec ? std::filesystem::file_time_type{} : time;
+	}
+}
+
+bool ConfigWatcher::Start(ConfigStore& InStore, ReloadCallback InOnReload, std::filesystem::path InFile)
+{
+	Stop();
+
+#if defined(_WIN32)
+	// The binary cache lives in a subfolder, so rewriting it does not wake the watcher.
+	ChangeHandle = FindFirstChangeNotificationW(InFile.parent_path().c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+	if (ChangeHandle == INVALID_HANDLE_VALUE) {
+		INFO("{} - Unable to watch configuration folder, error {}", Plugin::NAME, GetLastError());
+		return false;
+	}
+	StopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+#else
+	Stopping = false;
+#endif
+
+	Store = &InStore;
+	OnReload = std::move(InOnReload);
+	File = std::move(InFile);
+	LastWrite = GetLastWrite(File);
+	Thread = std::thread(&ConfigWatcher::Run, this);
+	return true;
+}
+
+void ConfigWatcher::Stop()
+{
+#if defined(_WIN32)
+	if (Thread.joinable()) {
+		SetEvent(StopEvent);
+		Thread.join();
+	}
+
+	if (ChangeHandle != INVALID_HANDLE_VALUE) {
+		FindCloseChangeNotification(ChangeHandle);
+		ChangeHandle = INVALID_HANDLE_VALUE;
+	}
+	if (StopEvent) {
+		CloseHandle(StopEvent);
+		StopEvent = nullptr;
+	}
+#else
+	if (Thread.joinable()) {
+		{
+			std::lock_guard lock(StopMutex);
+			Stopping = true;
+		}
+		StopChanged.notify_all();
+		Thread.join();
+	}
+#endif
+}
+
+void ConfigWatcher::Run()
+{
+	Control::EnterThread("Radio Config Watcher", Control::ThreadRole::Io);
+
+#if defined(_WIN32)
+	const HANDLE handles[] = { StopEvent, ChangeHandle };
+
+	while (WaitForMultipleObjects(2, handles, FALSE, INFINITE) == WAIT_OBJECT_0 + 1) {
+		DWORD wait;
+		do {
+			FindNextChangeNotification(ChangeHandle);
+			wait = WaitForMultipleObjects(2, handles, FALSE, SettleMs);
+		} while (wait == WAIT_OBJECT_0 + 1);
+
+		if (wait != WAIT_TIMEOUT)
+			return;
+
+		Reload();
+	}
+#else
+	// A time that held still from one look to the next has settled.
+	auto             seen = LastWrite;
+	std::unique_lock lock(StopMutex);
+	while (!StopChanged.wait_for(lock, std::chrono::milliseconds(SettleMs), [this] { return Stopping; })) {
+		const auto lastWrite = GetLastWrite(File);
+		const bool settled = lastWrite == seen;
+		seen = lastWrite;
+		if (!settled)
+			continue;
+
+		lock.unlock();
+		Reload();
+		lock.lock();
+	}
+#endif
+}
+
+void ConfigWatcher::Reload()
+{
+	// Something else in the folder changed.
+	const auto lastWrite = GetLastWrite(File);
+	if (lastWrite == LastWrite)
+		return;
+	LastWrite = lastWrite;
+
+	INFO("{} - Configuration changed, reloading", Plugin::NAME);
+
+	Config config;
+	{
+		const Control::ScopedTimer timer(Control::Operation::Reload);
+		loadConfig(config, File);
+		Store->Publish(config);
+	}
+
+	if (OnReload)
+		OnReload(config);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Config/ConfigStore.h"
+
+#include <filesystem>
+#include <functional>
+#include <thread>
+
+#if !defined(_WIN32)
+#	include <condition_variable>
+#	include <mutex>
+#endif
+
+// Watches the configuration file and publishes a fresh snapshot to a ConfigStore whenever it
+// is saved. The thread sleeps on a directory change notification, so it costs nothing until
+// the folder actually changes. Without one (the portable build), it looks at the file's time
+// a few times a second instead.
+class ConfigWatcher
+{
+public:
+	using ReloadCallback = std::function<void(const Config&)>;
+
+	~ConfigWatcher() { Stop(); }
+
+	// Returns false if the configuration folder cannot be watched.
+	bool Start(ConfigStore& InStore, ReloadCallback InOnReload, std::filesystem::path InFile = ConfigFilePath);
+	void Stop();
+
+private:
+	void Run();
+	void Reload();
+
+	ConfigStore*                    Store = nullptr;
+	ReloadCallback                  OnReload;
+	std::filesystem::path           File;
+	std::filesystem::file_time_type LastWrite;
+	std::thread                     Thread;
+#if defined(_WIN32)
+	HANDLE StopEvent = nullptr;
+	HANDLE ChangeHandle = INVALID_HANDLE_VALUE;
+#else
+	std::mutex              StopMutex;
+	std::condition_variable StopChanged;
+	bool                    Stopping = false;
+#endif
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// 64-bit FNV-1a. Used for change detection and identity keys, not for security.
+constexpr uint64_t Fnv1a64(std::string_view InText, uint64_t InHash = 0xCBF29CE484222325ull)
+{
+	for (const char c : InText) {
+		InHash ^= static_cast<unsigned char>(c);
+		InHash *= 0x100000001B3ull;
+	}
+	return InHash;
+}
+
+// Fixed-width lowercase hex, for file names derived from a hash.
+inline std::string ToHexString(uint64_t InValue)
+{
+	std::string text(16, '0');
+	for (auto digit = text.rbegin(); digit != text.rend(); ++digit, InValue >>= 4)
+		*digit = "0123456789abcdef"[InValue & 0xF];
+	return text;
+}
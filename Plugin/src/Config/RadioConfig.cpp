@@ -0,0 +1,336 @@
+#include "Config/RadioConfig.h"
+
+#include "Config/Hash.h"
+#include "Config/Toml.h"
+
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+	constexpr uint32_t CacheMagic = 0x43524753;  // "SGRC"
+	constexpr uint32_t CacheFormat = 8;
+
+	constexpr std::pair<std::string_view, int Config::*> KeyOptions[] = {
+		{ "ToggleRadioKey", &Config::toggleRadioKey },
+		{ "SwitchModeKey", &Config::switchModeKey },
+		{ "VolumeUpKey", &Config::volumeUpKey },
+		{ "VolumeDownKey", &Config::volumeDownKey },
+		{ "NextStationKey", &Config::nextStationKey },
+		{ "PreviousStationKey", &Config::previousStationKey },
+		{ "SeekForwardKey", &Config::seekForwardKey },
+		{ "SeekBackwardKey", &Config::seekBackwardKey },
+		{ "StatsKey", &Config::statsKey },
+	};
+
+	constexpr std::pair<std::string_view, int Config::*> IntOptions[] = {
+		{ "PrefetchStations", &Config::prefetchStations },
+		{ "PrefetchMemoryMB", &Config::prefetchMemoryMB },
+		{ "CacheSizeMB", &Config::cacheSizeMB },
+		{ "CrossfadeMs", &Config::crossfadeMs },
+		{ "SpatialPreset", &Config::spatialPreset },
+		{ "WorkerAffinityMask", &Config::workerAffinityMask },
+		{ "RotationMusicWeight", &Config::rotationMusicWeight },
+		{ "RotationJingleWeight", &Config::rotationJingleWeight },
+		{ "RotationAdWeight", &Config::rotationAdWeight },
+		{ "RotationNewsWeight", &Config::rotationNewsWeight },
+	};
+
+	// Identifies the TOML file a cache was compiled from.
+	struct CacheStamp
+	{
+		int64_t  ModifiedTime = 0;
+		uint64_t Size = 0;
+		uint64_t Hash = 0;
+	};
+
+	bool ReadWholeFile(const std::filesystem::path& InPath, std::string& OutText)
+	{
+		std::error_code ec;
+		const auto      size = std::filesystem::file_size(InPath, ec);
+		if (ec)
+			return false;
+
+		std::ifstream file(InPath, std::ios::binary);
+		if (!file.is_open())
+			return false;
+
+		OutText.resize(static_cast<std::size_t>(size));
+		file.read(OutText.data(), static_cast<std::streamsize>(size));
+		return static_cast<uint64_t>(file.gcount()) == size;
+	}
+
+	bool ReadBool(const Toml::Value& InValue, bool& OutValue)
+	{
+		if (InValue.Type == Toml::Type::Boolean)
+			OutValue = InValue.Boolean;
+		else if (InValue.Type == Toml::Type::Integer)
+			OutValue = InValue.Integer != 0;
+		else
+			return false;
+		return true;
+	}
+
+	bool ReadKeyCode(const Toml::Value& InValue, int& OutValue)
+	{
+		if (InValue.Type == Toml::Type::Integer) {
+			OutValue = static_cast<int>(InValue.Integer);
+			return true;
+		}
+
+		// Also accept quoted codes, "0x60".
+		if (InValue.Type == Toml::Type::String) {
+			auto text = InValue.Text;
+			if (text.starts_with("0x") || text.starts_with("0X"))
+				text.remove_prefix(2);
+			return std::from_chars(text.data(), text.data() + text.size(), OutValue, 16).ec == std::errc{};
+		}
+		return false;
+	}
+
+	// Flat little-endian snapshot: header, options, then length-prefixed playlist entries.
+	class CacheWriter
+	{
+	public:
+		template <class T>
+		void Put(const T& InValue)
+		{
+			Data.append(reinterpret_cast<const char*>(&InValue), sizeof(T));
+		}
+
+		void PutString(std::string_view InText)
+		{
+			Put(static_cast<uint32_t>(InText.size()));
+			Data.append(InText);
+		}
+
+		std::string Data;
+	};
+
+	class CacheReader
+	{
+	public:
+		explicit CacheReader(std::string_view InData) :
+			Data(InData)
+		{
+		}
+
+		template <class T>
+		bool Get(T& OutValue)
+		{
+			if (Data.size() - Pos < sizeof(T))
+				return false;
+			std::memcpy(&OutValue, Data.data() + Pos, sizeof(T));
+			Pos += sizeof(T);
+			return true;
+		}
+
+		bool GetString(std::string& OutText)
+		{
+			uint32_t size = 0;
+			if (!Get(size) || Data.size() - Pos < size)
+				return false;
+			OutText.assign(Data.data() + Pos, size);
+			Pos += size;
+			return true;
+		}
+
+		bool AtEnd() const { return Pos == Data.size(); }
+
+	private:
+		std::string_view Data;
+		std::size_t      Pos = 0;
+	};
+
+	std::filesystem::path GetCachePath(const std::filesystem::path& file)
+	{
+		return file.parent_path() / file.stem() / "config.cache";
+	}
+
+	void WriteConfigCache(const std::filesystem::path& path, const CacheStamp& stamp, const Config& config)
+	{
+		CacheWriter writer;
+		writer.Put(CacheMagic);
+		writer.Put(CacheFormat);
+		writer.Put(static_cast<uint32_t>(Plugin::Version));
+		writer.Put(stamp);
+		writer.Put(static_cast<uint8_t>(config.autoStartRadio));
+		writer.Put(static_cast<uint8_t>(config.randomizeStartTime));
+		for (const auto& [name, member] : KeyOptions)
+			writer.Put(static_cast<int32_t>(config.*member));
+		for (const auto& [name, member] : IntOptions)
+			writer.Put(static_cast<int32_t>(config.*member));
+		writer.Put(static_cast<uint32_t>(config.playlist.size()));
+		for (const auto& station : config.playlist)
+			writer.PutString(station);
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(writer.Data.data(), static_cast<std::streamsize>(writer.Data.size()));
+		if (!file.good())
+			INFO("{} - Could not write configuration cache", Plugin::NAME);
+	}
+
+	bool ReadConfigCache(std::string_view bytes, CacheStamp& stamp, Config& config)
+	{
+		CacheReader reader(bytes);
+
+		uint32_t magic = 0;
+		uint32_t format = 0;
+		uint32_t version = 0;
+		if (!reader.Get(magic) || !reader.Get(format) || !reader.Get(version) ||
+			magic != CacheMagic || format != CacheFormat || version != Plugin::Version)
+			return false;
+
+		uint8_t autoStartRadio = 0;
+		uint8_t randomizeStartTime = 0;
+		if (!reader.Get(stamp) || !reader.Get(autoStartRadio) || !reader.Get(randomizeStartTime))
+			return false;
+		config.autoStartRadio = autoStartRadio != 0;
+		config.randomizeStartTime = randomizeStartTime != 0;
+
+		for (const auto& [name, member] : KeyOptions) {
+			int32_t key = 0;
+			if (!reader.Get(key))
+				return false;
+			config.*member = key;
+		}
+		for (const auto& [name, member] : IntOptions) {
+			int32_t value = 0;
+			if (!reader.Get(value))
+				return false;
+			config.*member = value;
+		}
+
+		uint32_t count = 0;
+		if (!reader.Get(count))
+			return false;
+		config.playlist.resize(count);
+		for (auto& station : config.playlist) {
+			if (!reader.GetString(station))
+				return false;
+		}
+		return reader.AtEnd();
+	}
+}
+
+void parseConfig(std::string_view text, Config& config)
+{
+	Toml::Parser parser(text);
+	Toml::Entry  entry;
+
+	while (parser.Next(entry)) {
+		const auto& value = entry.Value;
+
+		if (entry.Key == "Playlist") {
+			if (!entry.IsArrayItem && value.Type == Toml::Type::Array)
+				config.playlist.clear();  // Clear any existing entries
+			else if (entry.IsArrayItem && value.Type == Toml::Type::String)
+				config.playlist.push_back(value.AsString());
+			continue;
+		}
+
+		if (entry.IsArrayItem)
+			continue;
+
+		if (entry.Key == "AutoStartRadio") {
+			ReadBool(value, config.autoStartRadio);
+			INFO("AutoStartRadio: {}", config.autoStartRadio);
+		} else if (entry.Key == "RandomizeStartTime") {
+			ReadBool(value, config.randomizeStartTime);
+			INFO("RandomizeStartTime: {}", config.randomizeStartTime);
+		} else {
+			for (const auto& [name, member] : KeyOptions) {
+				if (entry.Key == name) {
+					ReadKeyCode(value, config.*member);
+					break;
+				}
+			}
+			for (const auto& [name, member] : IntOptions) {
+				if (entry.Key == name && value.Type == Toml::Type::Integer) {
+					config.*member = static_cast<int>(value.Integer);
+					break;
+				}
+			}
+		}
+	}
+
+	if (parser.GetErrorCount() > 0)
+		INFO("{} - {} error(s) in configuration, first on line {}: {}", Plugin::NAME, parser.GetErrorCount(), parser.GetFirstErrorLine(), parser.GetFirstError());
+}
+
+void loadConfig(Config& config)
+{
+	loadConfig(config, ConfigFilePath);
+}
+
+void loadConfig(Config& config, const std::filesystem::path& file)
+{
+	const auto cachePath = GetCachePath(file);
+
+	std::error_code sizeError;
+	std::error_code timeError;
+	const auto      size = std::filesystem::file_size(file, sizeError);
+	const auto      modified = std::filesystem::last_write_time(file, timeError);
+	if (sizeError || timeError) {
+		INFO("Could not open configuration file!");
+		return;
+	}
+
+	CacheStamp stamp{ modified.time_since_epoch().count(), size, 0 };
+
+	// Fast path: the TOML file is untouched, so the cache is loaded with a single read.
+	std::string cacheBytes;
+	CacheStamp  cachedStamp;
+	Config      cached;
+	const bool  hasCache = ReadWholeFile(cachePath, cacheBytes) && ReadConfigCache(cacheBytes, cachedStamp, cached);
+	if (hasCache && cachedStamp.ModifiedTime == stamp.ModifiedTime && cachedStamp.Size == stamp.Size) {
+		config = std::move(cached);
+		INFO("{} - Loaded configuration from cache", Plugin::NAME);
+		return;
+	}
+
+	std::string text;
+	if (!ReadWholeFile(file, text)) {
+		INFO("Could not open configuration file!");
+		return;
+	}
+
+	stamp.Hash = Fnv1a64(text);
+	if (hasCache && cachedStamp.Hash == stamp.Hash && cachedStamp.Size == stamp.Size) {
+		// Touched but unchanged; refresh the timestamp only.
+		config = std::move(cached);
+	} else {
+		parseConfig(text, config);
+	}
+
+	WriteConfigCache(cachePath, stamp, config);
+}
+
+// Function to print the loaded configuration
+void printConfig(const Config& config) {
+
+    INFO("{} - AutoStartRadio: {}", Plugin::NAME, config.autoStartRadio);
+    INFO("{} - RandomizeStartTime: {}", Plugin::NAME, config.randomizeStartTime);
+    INFO("{} - Playlist:", Plugin::NAME);
+    for (const auto& song : config.playlist) {
+        INFO("{} playlist item - {}", Plugin::NAME, song);
+    }
+	INFO("{} - ToggleRadioKey: 0x{:X}", Plugin::NAME, config.toggleRadioKey);
+	INFO("{} - SwitchModeKey: 0x{:X}", Plugin::NAME, config.switchModeKey);
+	INFO("{} - VolumeUpKey: 0x{:X}", Plugin::NAME, config.volumeUpKey);
+	INFO("{} - VolumeDownKey: 0x{:X}", Plugin::NAME, config.volumeDownKey);
+	INFO("{} - NextStationKey: 0x{:X}", Plugin::NAME, config.nextStationKey);
+	INFO("{} - PreviousStationKey: 0x{:X}", Plugin::NAME, config.previousStationKey);
+	INFO("{} - SeekForwardKey: 0x{:X}", Plugin::NAME, config.seekForwardKey);
+	INFO("{} - SeekBackwardKey: 0x{:X}", Plugin::NAME, config.seekBackwardKey);
+	INFO("{} - StatsKey: 0x{:X}", Plugin::NAME, config.statsKey);
+	INFO("{} - PrefetchStations: {}", Plugin::NAME, config.prefetchStations);
+	INFO("{} - PrefetchMemoryMB: {}", Plugin::NAME, config.prefetchMemoryMB);
+	INFO("{} - CacheSizeMB: {}", Plugin::NAME, config.cacheSizeMB);
+	INFO("{} - CrossfadeMs: {}", Plugin::NAME, config.crossfadeMs);
+	INFO("{} - SpatialPreset: {}", Plugin::NAME, config.spatialPreset);
+	INFO("{} - WorkerAffinityMask: 0x{:X}", Plugin::NAME, config.workerAffinityMask);
+	INFO("{} - Rotation weights: music {}, jingles {}, ads {}, news {}", Plugin::NAME, config.rotationMusicWeight, config.rotationJingleWeight, config.rotationAdWeight, config.rotationNewsWeight);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+inline constexpr auto ConfigDirectory = ".\\Data\\SFSE\\Plugins";
+inline constexpr auto ConfigFilePath = ".\\Data\\SFSE\\Plugins\\StarfieldGalacticRadio.toml";
+
+// Structure to hold the configuration data
+struct Config {
+	bool autoStartRadio = true;
+	bool randomizeStartTime = true;
+	std::vector<std::string> playlist;
+	int toggleRadioKey = 0x60;
+	int switchModeKey = 0x6D;
+	int volumeUpKey = 0x69;
+	int volumeDownKey = 0x66;
+	int nextStationKey = 0x68;
+	int previousStationKey = 0x67;
+	int seekForwardKey = 0x6A;
+	int seekBackwardKey = 0x6F;
+	int statsKey = 0x6E;
+	int prefetchStations = 1;   // stations kept warm on each side of the one on air
+	int prefetchMemoryMB = 8;
+	int cacheSizeMB = 512;      // disk cache for remote stations, 0 disables it
+	int crossfadeMs = 1500;     // station switch crossfade, 0 cuts
+	int spatialPreset = 0;      // Audio::SpatialPreset
+	int workerAffinityMask = 0; // cores for the plugin's threads, 0 for all but the first
+	int rotationMusicWeight = 6;  // folder station slots per category, see Control::Rotation
+	int rotationJingleWeight = 2;
+	int rotationAdWeight = 1;
+	int rotationNewsWeight = 1;
+};
+
+// Parses the TOML text into config; keys that are missing keep their current value.
+void parseConfig(std::string_view text, Config& config);
+
+// Function to load the configuration from the TOML file. Uses the compiled binary cache when
+// the TOML file is unchanged since it was written.
+void loadConfig(Config& config);
+
+// Same, from another file. Its cache is <folder>/<file stem>/config.cache, which for the
+// plugin's own file is the cache above.
+void loadConfig(Config& config, const std::filesystem::path& file);
+
+// Function to print the loaded configuration
+void printConfig(const Config& config);
@@ -0,0 +1,143 @@
+#include "Config/StationTable.h"
+
+#include "Config/Hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <unordered_set>
+
+namespace
+{
+	constexpr auto TracksDirectory = ".\\Data\\SFSE\\Plugins\\StarfieldGalacticRadio\\tracks";
+
+	std::string_view Trim(std::string_view InText)
+	{
+		constexpr std::string_view Whitespace = " \t\r\n";
+		const auto                 first = InText.find_first_not_of(Whitespace);
+		if (first == std::string_view::npos)
+			return {};
+		return InText.substr(first, InText.find_last_not_of(Whitespace) - first + 1);
+	}
+
+	std::string ToUtf8(const std::filesystem::path& InPath)
+	{
+		const auto text = InPath.u8string();
+		return std::string(reinterpret_cast<const char*>(text.data()), text.size());
+	}
+
+	struct ParsedEntry
+	{
+		uint64_t         Key;
+		std::string_view Name;
+		std::string_view Source;  // as written; local paths are resolved while building
+		bool             IsRemote;
+		bool             IsFolder;
+	};
+}
+
+StationTable::StationTable(std::span<const std::string> InPlaylist)
+{
+	std::error_code ec;
+	const auto      tracks = std::filesystem::absolute(TracksDirectory, ec);
+
+	// First pass: split and trim, and resolve local paths, to size the arena exactly.
+	std::vector<ParsedEntry> entries;
+	std::vector<std::string> resolved;
+	entries.reserve(InPlaylist.size());
+	resolved.reserve(InPlaylist.size());  // no reallocation, so views into it stay valid
+
+	// A line listed twice would be two stations with one key, and Find would only ever see the
+	// first; the same station twice in the dial is no use either.
+	std::unordered_set<uint64_t> keys;
+	keys.reserve(InPlaylist.size());
+
+	std::size_t arenaSize = 0;
+	for (const auto& line : InPlaylist) {
+		const std::string_view entry = Trim(line);
+		const auto             separator = entry.find('|');
+
+		ParsedEntry parsed{};
+		parsed.Key = Fnv1a64(entry);
+		parsed.Name = separator != std::string_view::npos ? Trim(entry.substr(0, separator)) : std::string_view{};
+		parsed.Source = separator != std::string_view::npos ? Trim(entry.substr(separator + 1)) : entry;
+		parsed.IsRemote = parsed.Source.contains("://");
+
+		if (parsed.Source.empty()) {
+			INFO("{} - Skipping playlist entry without a source - {}", Plugin::NAME, line);
+			continue;
+		}
+
+		if (!keys.insert(parsed.Key).second) {
+			INFO("{} - Skipping playlist entry listed twice - {}", Plugin::NAME, line);
+			continue;
+		}
+
+		if (!parsed.IsRemote) {
+			// "Chill/" plays every MP3 below tracks\Chill; "Chill/*.mp3" and "Chill/**/Live*.mp3"
+			// pick files by pattern.
+			parsed.IsFolder = parsed.Source.ends_with('/') || parsed.Source.ends_with('\\') || parsed.Source.find_first_of("*?") != std::string_view::npos;
+
+			std::filesystem::path relative(std::u8string_view(reinterpret_cast<const char8_t*>(parsed.Source.data()), parsed.Source.size()));
+			if (parsed.IsFolder && !relative.has_filename())
+				relative /= "**/*.mp3";
+			resolved.push_back(ToUtf8((tracks / relative).lexically_normal()));
+			parsed.Source = resolved.back();
+		}
+
+		arenaSize += parsed.Name.size() + parsed.Source.size();
+		entries.push_back(parsed);
+	}
+
+	// Second pass: intern everything into the arena.
+	Arena = std::make_unique<char[]>(arenaSize);
+	Stations.reserve(entries.size());
+
+	char* cursor = Arena.get();
+	auto  intern = [&cursor](std::string_view InText) {
+		std::memcpy(cursor, InText.data(), InText.size());
+		const std::string_view interned(cursor, InText.size());
+		cursor += InText.size();
+		return interned;
+	};
+
+	for (const auto& parsed : entries) {
+		Station station;
+		station.Key = parsed.Key;
+		station.Name = intern(parsed.Name);
+		station.Source = intern(parsed.Source);
+		station.IsRemote = parsed.IsRemote;
+		station.IsFolder = parsed.IsFolder;
+		Stations.push_back(station);
+	}
+}
+
+int StationTable::Find(uint64_t InKey) const
+{
+	for (std::size_t i = 0; i < Stations.size(); ++i) {
+		if (Stations[i].Key == InKey)
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+std::size_t StationTable::GatherNeighbors(int InIndex, int InRadius, std::span<std::string_view> OutSources, std::size_t InCount) const
+{
+	const int count = static_cast<int>(Stations.size());
+	if (count == 0)
+		return InCount;
+
+	for (int distance = 1; distance <= InRadius; ++distance) {
+		for (const int direction : { 1, -1 }) {
+			const int      index = ((InIndex + direction * distance) % count + count) % count;
+			const Station& station = Stations[index];
+			if (index == InIndex || station.IsFolder || InCount == OutSources.size())
+				continue;
+
+			const auto listed = OutSources.first(InCount);
+			if (std::ranges::find(listed, station.Source) == listed.end())
+				OutSources[InCount++] = station.Source;
+		}
+	}
+	return InCount;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// One playlist entry, compiled once when the configuration is loaded.
+struct Station
+{
+	uint64_t         Key = 0;  // hash of the playlist entry; finds the station again after a reload
+	std::string_view Name;     // empty when the entry has no "Name|" prefix
+	std::string_view Source;   // URL for remote stations, absolute path for local tracks and folders
+	bool             IsRemote = false;
+	bool             IsFolder = false;  // Source is a directory with a glob pattern, "...\Chill\**\*.mp3"
+};
+
+// The playlist compiled into contiguous records, with every name and source interned in one
+// arena. Building it is the only place "Name|URL" entries are parsed; selecting a station
+// afterwards is an index into the table and allocates nothing. Entries without a source, and
+// repeats of an earlier entry, are left out, so every key is unique.
+class StationTable
+{
+public:
+	StationTable() = default;
+	explicit StationTable(std::span<const std::string> InPlaylist);
+
+	std::size_t size() const { return Stations.size(); }
+	bool        empty() const { return Stations.empty(); }
+	auto        begin() const { return Stations.begin(); }
+	auto        end() const { return Stations.end(); }
+
+	const Station& operator[](std::size_t InIndex) const { return Stations[InIndex]; }
+
+	// Index of the station with InKey, or -1.
+	int Find(uint64_t InKey) const;
+
+	// Adds the sources of the stations up to InRadius either side of InIndex, nearest first,
+	// to OutSources after the InCount already there, and returns the new count. Folders are
+	// left out, as which track they play is only known when they are opened, and so are
+	// InIndex itself and sources already listed. Stops when OutSources is full.
+	std::size_t GatherNeighbors(int InIndex, int InRadius, std::span<std::string_view> OutSources, std::size_t InCount = 0) const;
+
+private:
+	std::unique_ptr<char[]> Arena;  // stable across moves, unlike a std::string with SSO
+	std::vector<Station>    Stations;
+};
@@ -0,0 +1,419 @@
+#include "Config/Toml.h"
+
+#include <charconv>
+
+namespace Toml
+{
+	namespace
+	{
+		bool IsInlineSpace(char InChar) { return InChar == ' ' || InChar == '\t'; }
+		bool IsNewline(char InChar) { return InChar == '\n' || InChar == '\r'; }
+
+		bool IsBareKeyChar(char InChar)
+		{
+			return (InChar >= 'A' && InChar <= 'Z') || (InChar >= 'a' && InChar <= 'z') || (InChar >= '0' && InChar <= '9') ||
+			       InChar == '_' || InChar == '-' || InChar == '.';
+		}
+
+		bool IsValueEnd(char InChar)
+		{
+			return InChar == '\0' || IsInlineSpace(InChar) || IsNewline(InChar) || InChar == ',' || InChar == ']' || InChar == '}' || InChar == '#';
+		}
+
+		void AppendUtf8(std::string& OutText, uint32_t InCodepoint)
+		{
+			if (InCodepoint < 0x80) {
+				OutText += static_cast<char>(InCodepoint);
+			} else if (InCodepoint < 0x800) {
+				OutText += static_cast<char>(0xC0 | (InCodepoint >> 6));
+				OutText += static_cast<char>(0x80 | (InCodepoint & 0x3F));
+			} else if (InCodepoint < 0x10000) {
+				OutText += static_cast<char>(0xE0 | (InCodepoint >> 12));
+				OutText += static_cast<char>(0x80 | ((InCodepoint >> 6) & 0x3F));
+				OutText += static_cast<char>(0x80 | (InCodepoint & 0x3F));
+			} else {
+				OutText += static_cast<char>(0xF0 | (InCodepoint >> 18));
+				OutText += static_cast<char>(0x80 | ((InCodepoint >> 12) & 0x3F));
+				OutText += static_cast<char>(0x80 | ((InCodepoint >> 6) & 0x3F));
+				OutText += static_cast<char>(0x80 | (InCodepoint & 0x3F));
+			}
+		}
+	}
+
+	std::string Value::AsString() const
+	{
+		if (!Escaped)
+			return std::string(Text);
+
+		std::string result;
+		result.reserve(Text.size());
+		for (std::size_t i = 0; i < Text.size(); ++i) {
+			if (Text[i] != '\\' || i + 1 >= Text.size()) {
+				result += Text[i];
+				continue;
+			}
+
+			const char escape = Text[++i];
+			switch (escape) {
+			case 'b': result += '\b'; break;
+			case 't': result += '\t'; break;
+			case 'n': result += '\n'; break;
+			case 'f': result += '\f'; break;
+			case 'r': result += '\r'; break;
+			case '"': result += '"'; break;
+			case '\\': result += '\\'; break;
+			case 'u':
+			case 'U':
+				{
+					const std::size_t digits = escape == 'u' ? 4 : 8;
+					uint32_t          codepoint = 0;
+					if (i + digits < Text.size() &&
+						std::from_chars(Text.data() + i + 1, Text.data() + i + 1 + digits, codepoint, 16).ec == std::errc{}) {
+						AppendUtf8(result, codepoint);
+						i += digits;
+					}
+					break;
+				}
+			default:
+				// Line-ending backslash in a multi-line string: drop the newline and leading whitespace.
+				if (IsInlineSpace(escape) || IsNewline(escape)) {
+					while (i + 1 < Text.size() && (IsInlineSpace(Text[i + 1]) || IsNewline(Text[i + 1])))
+						++i;
+				}
+				break;
+			}
+		}
+		return result;
+	}
+
+	bool Parser::Next(Entry& OutEntry)
+	{
+		for (;;) {
+			if (ArrayDepth > 0) {
+				SkipSpaceAndComments();
+				if (AtEnd()) {
+					Fail("unterminated array");
+					ArrayDepth = 0;
+					return false;
+				}
+
+				switch (Peek()) {
+				case ']':
+					++Pos;
+					if (--ArrayDepth == 0 && !FinishLine()) {
+						Fail("unexpected text after array");
+						SkipLine();
+					}
+					continue;
+				case '[':
+					// Nested arrays are flattened into the parent's items.
+					++ArrayDepth;
+					++Pos;
+					continue;
+				case ',':
+					++Pos;
+					continue;
+				case '{':
+					SkipBalanced('{', '}');
+					continue;
+				default:
+					break;
+				}
+
+				if (!ParseValue(OutEntry.Value)) {
+					Fail("invalid array item");
+					ArrayDepth = 0;
+					SkipLine();
+					continue;
+				}
+
+				OutEntry.Table = Table;
+				OutEntry.Key = ArrayKey;
+				OutEntry.IsArrayItem = true;
+				return true;
+			}
+
+			SkipSpaceAndComments();
+			if (AtEnd())
+				return false;
+
+			if (Peek() == '[') {
+				if (!ParseTableHeader()) {
+					Fail("invalid table header");
+					SkipLine();
+				}
+				continue;
+			}
+
+			std::string_view key;
+			if (!ParseKey(key)) {
+				Fail("expected key = value");
+				SkipLine();
+				continue;
+			}
+
+			SkipInlineSpace();
+			if (Peek() == '[') {
+				++Pos;
+				ArrayDepth = 1;
+				ArrayKey = key;
+				OutEntry.Table = Table;
+				OutEntry.Key = key;
+				OutEntry.Value = {};
+				OutEntry.Value.Type = Type::Array;
+				OutEntry.IsArrayItem = false;
+				return true;
+			}
+
+			if (Peek() == '{') {
+				SkipBalanced('{', '}');
+				FinishLine();
+				continue;
+			}
+
+			if (!ParseValue(OutEntry.Value)) {
+				Fail("invalid value");
+				SkipLine();
+				continue;
+			}
+
+			if (!FinishLine()) {
+				Fail("unexpected text after value");
+				SkipLine();
+			}
+
+			OutEntry.Table = Table;
+			OutEntry.Key = key;
+			OutEntry.IsArrayItem = false;
+			return true;
+		}
+	}
+
+	void Parser::SkipInlineSpace()
+	{
+		while (!AtEnd() && IsInlineSpace(Text[Pos]))
+			++Pos;
+	}
+
+	void Parser::SkipSpaceAndComments()
+	{
+		while (!AtEnd()) {
+			const char c = Text[Pos];
+			if (c == '#') {
+				while (!AtEnd() && Text[Pos] != '\n')
+					++Pos;
+			} else if (c == '\n') {
+				++Line;
+				++Pos;
+			} else if (IsInlineSpace(c) || c == '\r') {
+				++Pos;
+			} else {
+				break;
+			}
+		}
+	}
+
+	void Parser::SkipLine()
+	{
+		while (!AtEnd() && Text[Pos] != '\n')
+			++Pos;
+	}
+
+	bool Parser::FinishLine()
+	{
+		SkipInlineSpace();
+		if (Peek() == '#')
+			SkipLine();
+		return AtEnd() || IsNewline(Peek());
+	}
+
+	void Parser::SkipBalanced(char InOpen, char InClose)
+	{
+		int depth = 0;
+		for (; !AtEnd(); ++Pos) {
+			const char c = Text[Pos];
+			if (c == '\n')
+				++Line;
+			if (c == InOpen)
+				++depth;
+			else if (c == InClose && --depth == 0) {
+				++Pos;
+				return;
+			}
+		}
+	}
+
+	bool Parser::ParseTableHeader()
+	{
+		const bool arrayTable = Peek(1) == '[';
+		Pos += arrayTable ? 2 : 1;
+
+		const auto start = Pos;
+		while (!AtEnd() && Text[Pos] != ']' && !IsNewline(Text[Pos]))
+			++Pos;
+		if (Peek() != ']' || (arrayTable && Peek(1) != ']'))
+			return false;
+
+		auto name = Text.substr(start, Pos - start);
+		while (!name.empty() && IsInlineSpace(name.front()))
+			name.remove_prefix(1);
+		while (!name.empty() && IsInlineSpace(name.back()))
+			name.remove_suffix(1);
+
+		Table = name;
+		Pos += arrayTable ? 2 : 1;
+		return FinishLine();
+	}
+
+	bool Parser::ParseKey(std::string_view& OutKey)
+	{
+		if (Peek() == '"' || Peek() == '\'') {
+			const char quote = Text[Pos++];
+			const auto start = Pos;
+			while (!AtEnd() && Text[Pos] != quote && !IsNewline(Text[Pos]))
+				++Pos;
+			if (Peek() != quote)
+				return false;
+			OutKey = Text.substr(start, Pos - start);
+			++Pos;
+		} else {
+			const auto start = Pos;
+			while (!AtEnd() && IsBareKeyChar(Text[Pos]))
+				++Pos;
+			if (Pos == start)
+				return false;
+			OutKey = Text.substr(start, Pos - start);
+		}
+
+		SkipInlineSpace();
+		if (Peek() != '=')
+			return false;
+		++Pos;
+		return true;
+	}
+
+	bool Parser::ParseValue(Value& OutValue)
+	{
+		OutValue = {};
+		const char c = Peek();
+		if (c == '"' || c == '\'')
+			return ParseQuoted(OutValue);
+		return ParseScalar(OutValue);
+	}
+
+	bool Parser::ParseQuoted(Value& OutValue)
+	{
+		const char quote = Text[Pos];
+		const bool basic = quote == '"';
+		const bool multiline = Peek(1) == quote && Peek(2) == quote;
+
+		Pos += multiline ? 3 : 1;
+		// A newline right after the opening delimiter is not part of the string.
+		if (multiline && Peek() == '\r')
+			++Pos;
+		if (multiline && Peek() == '\n') {
+			++Pos;
+			++Line;
+		}
+
+		const auto start = Pos;
+		for (; !AtEnd(); ++Pos) {
+			const char ch = Text[Pos];
+			if (basic && ch == '\\') {
+				OutValue.Escaped = true;
+				if (Peek(1) == '\n')
+					++Line;
+				++Pos;
+				continue;
+			}
+			if (ch == '\n') {
+				if (!multiline)
+					return false;
+				++Line;
+			}
+			if (ch != quote)
+				continue;
+			if (!multiline) {
+				OutValue.Text = Text.substr(start, Pos - start);
+				++Pos;
+				return true;
+			}
+			if (Peek(1) == quote && Peek(2) == quote) {
+				// Up to two quotes may sit right before the closing delimiter.
+				while (Peek(3) == quote)
+					++Pos;
+				OutValue.Text = Text.substr(start, Pos - start);
+				Pos += 3;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool Parser::ParseScalar(Value& OutValue)
+	{
+		const auto start = Pos;
+		while (!IsValueEnd(Peek()))
+			++Pos;
+		const auto token = Text.substr(start, Pos - start);
+		OutValue.Text = token;
+
+		if (token == "true" || token == "false") {
+			OutValue.Type = Type::Boolean;
+			OutValue.Boolean = token == "true";
+			return true;
+		}
+
+		// Underscores are digit separators; strip them into a stack buffer.
+		char        digits[64];
+		std::size_t length = 0;
+		for (const char ch : token) {
+			if (ch == '_')
+				continue;
+			if (length == sizeof(digits))
+				return false;
+			digits[length++] = ch;
+		}
+		if (length == 0)
+			return false;
+
+		const char* first = digits;
+		const char* last = digits + length;
+		bool        negative = false;
+		if (*first == '+' || *first == '-') {
+			negative = *first == '-';
+			++first;
+		}
+
+		int base = 10;
+		if (last - first > 2 && first[0] == '0') {
+			base = first[1] == 'x' ? 16 : first[1] == 'o' ? 8 : first[1] == 'b' ? 2 : 10;
+			if (base != 10)
+				first += 2;
+		}
+
+		int64_t integer = 0;
+		if (const auto [end, ec] = std::from_chars(first, last, integer, base); ec == std::errc{} && end == last) {
+			OutValue.Type = Type::Integer;
+			OutValue.Integer = negative ? -integer : integer;
+			return true;
+		}
+
+		double number = 0.0;
+		if (const auto [end, ec] = std::from_chars(digits, last, number); ec == std::errc{} && end == last) {
+			OutValue.Type = Type::Float;
+			OutValue.Float = number;
+			return true;
+		}
+
+		return false;
+	}
+
+	void Parser::Fail(std::string_view InMessage)
+	{
+		if (ErrorCount++ == 0) {
+			FirstError = InMessage;
+			FirstErrorLine = Line;
+		}
+	}
+}
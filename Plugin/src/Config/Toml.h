@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Toml
+{
+	enum class Type : uint8_t
+	{
+		String,
+		Integer,
+		Float,
+		Boolean,
+		Array,  // start of an array; its scalar items follow as separate entries
+	};
+
+	struct Value
+	{
+		Toml::Type       Type = Toml::Type::String;
+		std::string_view Text;             // string contents without quotes, or the raw scalar token
+		bool             Escaped = false;  // basic string containing escape sequences
+		bool             Boolean = false;
+		int64_t          Integer = 0;
+		double           Float = 0.0;
+
+		// Decoded string value. Only allocates for the returned std::string.
+		std::string AsString() const;
+	};
+
+	struct Entry
+	{
+		std::string_view Table;  // current [table] header, empty at the root
+		std::string_view Key;
+		Toml::Value      Value;
+		bool             IsArrayItem = false;
+	};
+
+	// Single-pass pull parser over a TOML document held in memory. Every view it hands out
+	// points into the source text, so parsing itself never allocates.
+	//
+	// Supported: comments, [tables], [[array tables]], bare/quoted/dotted keys, basic, literal and
+	// multi-line strings, integers (with 0x/0o/0b and underscores), floats, booleans and arrays
+	// spanning lines (nested arrays are flattened). Inline tables are skipped. Malformed lines are
+	// skipped and counted instead of aborting the whole document.
+	class Parser
+	{
+	public:
+		explicit Parser(std::string_view InText) :
+			Text(InText)
+		{
+			// UTF-8 byte order mark, as written by Notepad.
+			if (Text.starts_with("\xEF\xBB\xBF"))
+				Pos = 3;
+		}
+
+		// Produces the next key/value or array item; false at end of document.
+		bool Next(Entry& OutEntry);
+
+		std::size_t      GetErrorCount() const { return ErrorCount; }
+		std::size_t      GetFirstErrorLine() const { return FirstErrorLine; }
+		std::string_view GetFirstError() const { return FirstError; }
+
+	private:
+		bool AtEnd() const { return Pos >= Text.size(); }
+		char Peek(std::size_t InOffset = 0) const { return Pos + InOffset < Text.size() ? Text[Pos + InOffset] : '\0'; }
+
+		void SkipInlineSpace();
+		void SkipSpaceAndComments();
+		void SkipLine();
+		bool FinishLine();
+		void SkipBalanced(char InOpen, char InClose);
+
+		bool ParseTableHeader();
+		bool ParseKey(std::string_view& OutKey);
+		bool ParseValue(Value& OutValue);
+		bool ParseQuoted(Value& OutValue);
+		bool ParseScalar(Value& OutValue);
+
+		void Fail(std::string_view InMessage);
+
+		std::string_view Text;
+		std::size_t      Pos = 0;
+		std::size_t      Line = 1;
+		std::string_view Table;
+		std::string_view ArrayKey;
+		int              ArrayDepth = 0;
+
+		std::size_t      ErrorCount = 0;
+		std::size_t      FirstErrorLine = 0;
+		std::string_view FirstError;
+	};
+}
@@ -0,0 +1,67 @@
+#include "Control/BroadcastSchedule.h"
+
+#include <chrono>
+
+namespace Control
+{
+	namespace
+	{
+		// SplitMix64 finalizer: spreads similar keys over the whole 64-bit range.
+		uint64_t Mix(uint64_t InValue)
+		{
+			InValue = (InValue ^ (InValue >> 30)) * 0xBF58476D1CE4E5B9ull;
+			InValue = (InValue ^ (InValue >> 27)) * 0x94D049BB133111EBull;
+			return InValue ^ (InValue >> 31);
+		}
+	}
+
+	uint64_t BroadcastSchedule::SteadyNowMs()
+	{
+		using namespace std::chrono;
+		return static_cast<uint64_t>(duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+	}
+
+	BroadcastSchedule::BroadcastSchedule(uint64_t InSeed, Clock InClock) :
+		Now(std::move(InClock)),
+		Seed(InSeed),
+		Epoch(Now())
+	{
+	}
+
+	void BroadcastSchedule::Resume(uint64_t InElapsedMs)
+	{
+		// May wrap below zero on a clock younger than the broadcast; the subtraction in
+		// GetElapsedMs wraps back.
+		Epoch = Now() - InElapsedMs;
+	}
+
+	void BroadcastSchedule::SetDurationMs(uint64_t InStation, uint32_t InDurationMs)
+	{
+		Durations[InStation] = InDurationMs;
+	}
+
+	uint32_t BroadcastSchedule::GetDurationMs(uint64_t InStation) const
+	{
+		const auto found = Durations.find(InStation);
+		return found != Durations.end() ? found->second : 0;
+	}
+
+	uint32_t BroadcastSchedule::GetPositionMs(uint64_t InStation) const
+	{
+		const uint64_t duration = GetDurationMs(InStation);
+		if (duration == 0)
+			return 0;
+		return static_cast<uint32_t>((GetElapsedMs() % duration + GetOffsetMs(InStation) % duration) % duration);
+	}
+
+	uint64_t BroadcastSchedule::GetStationTimeMs(uint64_t InStation) const
+	{
+		const uint64_t duration = GetDurationMs(InStation);
+		return GetElapsedMs() + (duration > 0 ? GetOffsetMs(InStation) % duration : 0);
+	}
+
+	uint64_t BroadcastSchedule::GetOffsetMs(uint64_t InStation) const
+	{
+		return Mix(Seed ^ Mix(InStation));
+	}
+}
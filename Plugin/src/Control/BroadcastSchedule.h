@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+namespace Control
+{
+	// Where every station is "on air" right now, as pure arithmetic. All stations share one
+	// broadcast epoch; each is offset from it by a hash of the schedule seed and its key, so
+	// switching away and back lands where the station would have been had it kept playing.
+	// Nothing here asks the player for anything but the track length, once per station.
+	class BroadcastSchedule
+	{
+	public:
+		// Monotonic milliseconds. Injectable, so the schedule can be driven by a fake clock.
+		using Clock = std::function<uint64_t()>;
+
+		static uint64_t SteadyNowMs();
+
+		explicit BroadcastSchedule(uint64_t InSeed, Clock InClock = SteadyNowMs);
+
+		uint64_t GetSeed() const { return Seed; }
+
+		// Milliseconds since the broadcast began.
+		uint64_t GetElapsedMs() const { return Now() - Epoch; }
+
+		// Carries on a broadcast an earlier session left at InElapsedMs.
+		void Resume(uint64_t InElapsedMs);
+
+		// Remembers a station's track length; 0 marks a live stream.
+		void     SetDurationMs(uint64_t InStation, uint32_t InDurationMs);
+		uint32_t GetDurationMs(uint64_t InStation) const;
+
+		// Position of InStation now, or 0 for a live stream or an unknown length.
+		uint32_t GetPositionMs(uint64_t InStation) const;
+
+		// How long InStation has been on air, counting its offset: GetPositionMs is this modulo
+		// the length. Stations that play a sequence of tracks find their place with it.
+		uint64_t GetStationTimeMs(uint64_t InStation) const;
+
+	private:
+		uint64_t GetOffsetMs(uint64_t InStation) const;
+
+		Clock    Now;
+		uint64_t Seed;
+		uint64_t Epoch;
+
+		std::unordered_map<uint64_t, uint32_t> Durations;
+	};
+}
@@ -0,0 +1,123 @@
+#include "Control/CommandQueue.h"
+
+#include "Control/ThreadRuntime.h"
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+
+namespace Control
+{
+	std::size_t CoalesceCommands(std::span<RadioCommand> InOutCommands)
+	{
+		std::size_t count = 0;
+		for (const auto& command : InOutCommands) {
+			if (count > 0 && InOutCommands[count - 1].Action == command.Action) {
+				InOutCommands[count - 1].Amount += command.Amount;
+			} else {
+				InOutCommands[count++] = command;
+			}
+		}
+
+		// Drop what cancelled out: Next+Prev, Up+Down, or an even number of toggles.
+		std::size_t kept = 0;
+		for (std::size_t i = 0; i < count; ++i) {
+			const auto& command = InOutCommands[i];
+			const bool  isToggle = command.Action == RadioAction::TogglePlayer || command.Action == RadioAction::ToggleMode;
+			if (isToggle ? (command.Amount % 2 == 0) : (command.Amount == 0))
+				continue;
+
+			InOutCommands[kept] = command;
+			if (isToggle)
+				InOutCommands[kept].Amount = 1;
+			++kept;
+		}
+		return kept;
+	}
+
+	void CommandWorker::Start(std::function<void()> InInit, Handler InHandler)
+	{
+		Stop();
+
+		Execute = std::move(InHandler);
+		Quit = false;
+		Thread = std::thread(&CommandWorker::Run, this, std::move(InInit));
+	}
+
+	void CommandWorker::Stop()
+	{
+		if (Ticker.joinable()) {
+			Ticker.request_stop();
+			Ticker.join();
+		}
+
+		if (!Thread.joinable())
+			return;
+
+		Quit = true;
+		Pending = true;
+		Pending.notify_one();
+		Thread.join();
+	}
+
+	bool CommandWorker::Post(RadioCommand InCommand)
+	{
+		if (Queue.Write({ &InCommand, 1 }) == 0)
+			return false;
+
+		Pending.store(true, std::memory_order_release);
+		Pending.notify_one();
+		return true;
+	}
+
+	void CommandWorker::Raise(RadioAction InAction)
+	{
+		Raised.fetch_or(1u << static_cast<uint32_t>(InAction), std::memory_order_release);
+		Pending.store(true, std::memory_order_release);
+		Pending.notify_one();
+	}
+
+	void CommandWorker::RaiseEvery(RadioAction InAction, std::chrono::milliseconds InInterval)
+	{
+		if (Ticker.joinable()) {
+			Ticker.request_stop();
+			Ticker.join();
+		}
+
+		Ticker = std::jthread([this, InAction, InInterval](std::stop_token InStop) {
+			EnterThread("Radio Ticks", ThreadRole::Io);
+
+			std::mutex                  mutex;
+			std::condition_variable_any stopped;
+			std::unique_lock            lock(mutex);
+			while (!stopped.wait_for(lock, InStop, InInterval, [&InStop] { return InStop.stop_requested(); }))
+				Raise(InAction);
+		});
+	}
+
+	void CommandWorker::Run(std::function<void()> InInit)
+	{
+		EnterThread("Radio Commands", ThreadRole::Audio);
+
+		if (InInit)
+			InInit();
+
+		std::array<RadioCommand, kCapacity> batch;
+		while (!Quit) {
+			Pending.wait(false, std::memory_order_acquire);
+			// Cleared before draining: anything posted from here on raises it again.
+			Pending.exchange(false, std::memory_order_acq_rel);
+
+			const auto read = Queue.Read(batch);
+			const auto count = CoalesceCommands({ batch.data(), read });
+			for (std::size_t i = 0; i < count && !Quit; ++i)
+				Execute(batch[i]);
+
+			const uint32_t raised = Raised.exchange(0, std::memory_order_acq_rel);
+			for (uint32_t action = 0; raised >> action != 0 && !Quit; ++action) {
+				if (raised & (1u << action))
+					Execute({ static_cast<RadioAction>(action), 1 });
+			}
+		}
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Audio/RingBuffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <thread>
+
+namespace Control
+{
+	enum class RadioAction : uint8_t
+	{
+		TogglePlayer,
+		ToggleMode,
+		Volume,   // Amount = volume steps
+		Station,  // Amount = stations to move
+		Seek,     // Amount = seconds
+		ShowStats,
+		TrackEnded,  // a folder station's track finished playing
+		Tick,        // periodic housekeeping, see CommandWorker::RaiseEvery
+	};
+
+	struct RadioCommand
+	{
+		RadioAction Action;
+		int32_t     Amount;
+	};
+
+	// Folds adjacent commands of the same kind into one, in place, so a burst of presses costs
+	// a single action: five NextStation presses become one Station +5, Toggle twice cancels out.
+	// Returns the number of commands left.
+	std::size_t CoalesceCommands(std::span<RadioCommand> InOutCommands);
+
+	// Single-producer/single-consumer hand-off from the input thread to a dedicated audio
+	// worker. Post never blocks; the worker drains everything queued, coalesces it, then runs it.
+	class CommandWorker
+	{
+	public:
+		using Handler = std::function<void(const RadioCommand&)>;
+
+		CommandWorker() = default;
+		~CommandWorker() { Stop(); }
+
+		// InInit runs on the worker before the first command, so slow startup (opening the
+		// first station) stays off the input thread as well.
+		void Start(std::function<void()> InInit, Handler InHandler);
+		void Stop();
+
+		// Producer side. Returns false if the queue is full and the command was dropped.
+		bool Post(RadioCommand InCommand);
+
+		// Any thread; for events from the backend, which cannot share the single-producer
+		// queue. InAction runs once, with Amount 1, after the commands queued before it, however
+		// often it is raised until then.
+		void Raise(RadioAction InAction);
+
+		// Raises InAction every InInterval until Stop, for work that has to happen while no
+		// commands come in.
+		void RaiseEvery(RadioAction InAction, std::chrono::milliseconds InInterval);
+
+	private:
+		static constexpr std::size_t kCapacity = 64;
+
+		void Run(std::function<void()> InInit);
+
+		Audio::RingBuffer<RadioCommand> Queue{ kCapacity };
+		Handler                         Execute;
+		std::thread                     Thread;
+		std::jthread                    Ticker;
+		std::atomic<uint32_t>           Raised = 0;  // bit per RadioAction
+		std::atomic<bool>               Pending = false;
+		std::atomic<bool>               Quit = false;
+	};
+}
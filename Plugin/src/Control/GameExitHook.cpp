@@ -0,0 +1,57 @@
+#include "Control/GameExitHook.h"
+
+namespace Control
+{
+	namespace
+	{
+		// The game's main window: visible, top-level and owned by this process.
+		HWND FindGameWindow()
+		{
+			HWND found = nullptr;
+			EnumWindows(
+				[](HWND InWindow, LPARAM InFound) -> BOOL {
+					DWORD processId = 0;
+					GetWindowThreadProcessId(InWindow, &processId);
+					if (processId != GetCurrentProcessId() || !IsWindowVisible(InWindow) || GetWindow(InWindow, GW_OWNER))
+						return TRUE;
+
+					*reinterpret_cast<HWND*>(InFound) = InWindow;
+					return FALSE;
+				},
+				reinterpret_cast<LPARAM>(&found));
+			return found;
+		}
+	}
+
+	bool GameExitHook::Install(std::function<void()> InOnExit)
+	{
+		if (Window.load())
+			return true;
+
+		const HWND window = FindGameWindow();
+		if (!window) {
+			INFO("{} - Game window not found, threads will not be stopped on quit", Plugin::NAME);
+			return false;
+		}
+
+		OnExit = std::move(InOnExit);
+		Window = window;
+		if (!SetWindowsHookEx(WH_CALLWNDPROC, &GameExitHook::HookProc, nullptr, GetWindowThreadProcessId(window, nullptr))) {
+			INFO("{} - Unable to install exit hook, error: {}", Plugin::NAME, GetLastError());
+			Window = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+	LRESULT CALLBACK GameExitHook::HookProc(int InCode, WPARAM InMessage, LPARAM InData)
+	{
+		if (InCode == HC_ACTION) {
+			const auto* message = reinterpret_cast<const CWPSTRUCT*>(InData);
+			if (message->message == WM_DESTROY && message->hwnd == Window.load() && !Fired.exchange(true))
+				OnExit();
+		}
+
+		return CallNextHookEx(nullptr, InCode, InMessage, InData);
+	}
+}
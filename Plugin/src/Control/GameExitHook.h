@@ -0,0 +1,26 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+namespace Control
+{
+	// Tells the plugin the game is quitting. The game destroys its main window on an orderly
+	// quit, before the process starts tearing down threads, so a message hook on the window's
+	// thread is the last point where the plugin can still shut down cleanly. The callback runs
+	// once, on the game's window thread.
+	class GameExitHook
+	{
+	public:
+		// Call once the game window exists (from the first HUD menu on). Returns false if the
+		// window could not be found or the hook could not be installed.
+		static bool Install(std::function<void()> InOnExit);
+
+	private:
+		static LRESULT CALLBACK HookProc(int InCode, WPARAM InMessage, LPARAM InData);
+
+		static inline std::function<void()> OnExit;
+		static inline std::atomic<HWND>     Window = nullptr;
+		static inline std::atomic<bool>     Fired = false;
+	};
+}
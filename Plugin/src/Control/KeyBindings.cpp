@@ -0,0 +1,44 @@
+#include "Control/KeyBindings.h"
+
+#include <algorithm>
+
+namespace Control
+{
+	bool KeyDispatcher::OnKey(int InVirtualKey, bool InDown)
+	{
+		Refresh();
+
+		bool bound = false;
+		for (auto& binding : Bindings) {
+			if (binding.VirtualKey != InVirtualKey)
+				continue;
+
+			bound = true;
+			if (InDown && !binding.Held)
+				Sink(binding.Action, binding.Amount);
+			binding.Held = InDown;
+		}
+		return bound;
+	}
+
+	void KeyDispatcher::Refresh()
+	{
+		KeyBindingTable bindings{};
+		if (!Source || !Source(bindings))
+			return;
+
+		// Carry the held state over by key, so a key that is down across the swap does not
+		// fire again without a new press.
+		for (auto& binding : bindings) {
+			binding.Held = std::ranges::any_of(Bindings, [&](const KeyBinding& InOld) {
+				return InOld.VirtualKey == binding.VirtualKey && InOld.Held;
+			});
+		}
+		Bindings = bindings;
+	}
+
+	bool KeyDispatcher::NeedsPolling() const
+	{
+		return std::ranges::any_of(Bindings, [](const KeyBinding& InBinding) { return IsGamepadKey(InBinding.VirtualKey); });
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Control/CommandQueue.h"
+
+#include <array>
+#include <functional>
+
+namespace Control
+{
+	struct KeyBinding
+	{
+		int         VirtualKey;
+		RadioAction Action;
+		int32_t     Amount;
+		bool        Held = false;  // edge state: the action fires on the up -> down transition only
+	};
+
+	inline constexpr std::size_t kBindingCount = 9;
+	using KeyBindingTable = std::array<KeyBinding, kBindingCount>;
+
+	// Gamepad virtual keys (VK_GAMEPAD_*) never reach a keyboard hook and need polling.
+	constexpr bool IsGamepadKey(int InVirtualKey)
+	{
+		return InVirtualKey >= 0xC3 && InVirtualKey <= 0xDA;
+	}
+
+	// Table-driven key-to-action mapping. Fed key transitions by whatever input source is
+	// active (keyboard hook, polling fallback); not thread safe, use it from that source's thread.
+	class KeyDispatcher
+	{
+	public:
+		using ActionSink = std::function<void(RadioAction, int32_t)>;
+		// Fills in a new table and returns true when the bindings changed since the last call.
+		using BindingSource = std::function<bool(KeyBindingTable&)>;
+
+		KeyDispatcher(const KeyBindingTable& InBindings, ActionSink InSink) :
+			Bindings(InBindings),
+			Sink(std::move(InSink))
+		{
+		}
+
+		// Returns true if the key is bound to an action.
+		bool OnKey(int InVirtualKey, bool InDown);
+
+		// Checked before every key so reloaded bindings apply on the next press.
+		void SetBindingSource(BindingSource InSource) { Source = std::move(InSource); }
+		void Refresh();
+
+		const KeyBindingTable& GetBindings() const { return Bindings; }
+		bool                   NeedsPolling() const;
+
+	private:
+		KeyBindingTable Bindings;
+		ActionSink      Sink;
+		BindingSource   Source;
+	};
+}
@@ -0,0 +1,64 @@
+#include "Control/KeyboardHook.h"
+
+namespace Control
+{
+	namespace
+	{
+		bool IsGameForeground()
+		{
+			DWORD processId = 0;
+			GetWindowThreadProcessId(GetForegroundWindow(), &processId);
+			return processId == GetCurrentProcessId();
+		}
+	}
+
+	bool KeyboardHook::Run(KeyDispatcher& InDispatcher)
+	{
+		ActiveDispatcher = &InDispatcher;
+
+		HHOOK hook = SetWindowsHookEx(WH_KEYBOARD_LL, &KeyboardHook::HookProc, GetModuleHandle(nullptr), 0);
+		if (!hook) {
+			INFO("{} - Unable to install keyboard hook, error: {}", Plugin::NAME, GetLastError());
+			ActiveDispatcher = nullptr;
+			return false;
+		}
+
+		// Stop posts to this thread's queue; make sure it exists before Stop can see the id, and
+		// catch a Stop that came before the id was published.
+		MSG message;
+		PeekMessage(&message, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+		ThreadId = GetCurrentThreadId();
+
+		while (!StopRequested && GetMessage(&message, nullptr, 0, 0) > 0) {
+			TranslateMessage(&message);
+			DispatchMessage(&message);
+		}
+
+		UnhookWindowsHookEx(hook);
+		ActiveDispatcher = nullptr;
+		ThreadId = 0;
+		StopRequested = false;
+		return true;
+	}
+
+	void KeyboardHook::Stop()
+	{
+		StopRequested = true;
+		if (const auto threadId = ThreadId.load(); threadId != 0)
+			PostThreadMessage(threadId, WM_QUIT, 0, 0);
+	}
+
+	LRESULT CALLBACK KeyboardHook::HookProc(int InCode, WPARAM InMessage, LPARAM InData)
+	{
+		// Low-level hooks run under a system timeout; the dispatcher only posts to the command queue.
+		if (InCode == HC_ACTION) {
+			const auto* key = reinterpret_cast<const KBDLLHOOKSTRUCT*>(InData);
+			const bool  down = InMessage == WM_KEYDOWN || InMessage == WM_SYSKEYDOWN;
+			// Releases always go through so no binding stays latched after an alt-tab.
+			if (auto* dispatcher = ActiveDispatcher.load(); dispatcher && (!down || IsGameForeground()))
+				dispatcher->OnKey(static_cast<int>(key->vkCode), down);
+		}
+
+		return CallNextHookEx(nullptr, InCode, InMessage, InData);
+	}
+}
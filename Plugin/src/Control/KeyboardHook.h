@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Control/KeyBindings.h"
+
+#include <atomic>
+
+namespace Control
+{
+	// Event-driven keyboard input through a low-level keyboard hook. Run installs the hook on
+	// the calling thread and sleeps in its message loop until Stop; the thread only wakes when
+	// a key actually changes state. Keys are ignored while the game is not the foreground window.
+	class KeyboardHook
+	{
+	public:
+		// Returns false immediately if the hook could not be installed.
+		bool Run(KeyDispatcher& InDispatcher);
+
+		// Safe to call from any thread, before or during Run.
+		void Stop();
+
+	private:
+		static LRESULT CALLBACK HookProc(int InCode, WPARAM InMessage, LPARAM InData);
+
+		static inline std::atomic<KeyDispatcher*> ActiveDispatcher = nullptr;
+
+		std::atomic<DWORD> ThreadId = 0;
+		std::atomic<bool>  StopRequested = false;
+	};
+}
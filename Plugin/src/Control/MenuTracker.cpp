@@ -0,0 +1,53 @@
+#include "Control/MenuTracker.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace Control
+{
+	namespace
+	{
+		constexpr std::string_view kLoadingMenus[] = { "LoadingMenu" };
+		constexpr std::string_view kPauseMenus[] = { "PauseMenu", "MainMenu" };
+
+		// Full-screen menus the player spends time in; the radio keeps playing under them.
+		constexpr std::string_view kDuckingMenus[] = {
+			"DataMenu",
+			"InventoryMenu",
+			"ContainerMenu",
+			"BarterMenu",
+			"SkillsMenu",
+			"GalaxyStarMapMenu",
+			"DialogueMenu",
+			"PhotoModeMenu",
+			"Console",
+		};
+
+		void Count(int& InOutOpen, bool InOpening)
+		{
+			InOutOpen = InOpening ? InOutOpen + 1 : std::max(InOutOpen - 1, 0);
+		}
+	}
+
+	bool MenuTracker::OnMenu(std::string_view InMenu, bool InOpening)
+	{
+		if (std::ranges::find(kLoadingMenus, InMenu) != std::end(kLoadingMenus))
+			Count(LoadingMenus, InOpening);
+		else if (std::ranges::find(kPauseMenus, InMenu) != std::end(kPauseMenus))
+			Count(PauseMenus, InOpening);
+		else if (std::ranges::find(kDuckingMenus, InMenu) != std::end(kDuckingMenus))
+			Count(DuckingMenus, InOpening);
+		else
+			return false;
+
+		Audio::GameState state = Audio::GameState::Playing;
+		if (LoadingMenus > 0)
+			state = Audio::GameState::Loading;
+		else if (PauseMenus > 0)
+			state = Audio::GameState::Paused;
+		else if (DuckingMenus > 0)
+			state = Audio::GameState::Menu;
+
+		return State.exchange(state, std::memory_order_acq_rel) != state;
+	}
+}
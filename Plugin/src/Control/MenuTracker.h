@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Audio/AudioBackend.h"
+
+#include <atomic>
+#include <string_view>
+
+namespace Control
+{
+	// Follows the game's menu open/close events and reduces them to the one GameState playback
+	// cares about: load screens beat the pause menu, which beats any other menu. Menus are
+	// counted, so nested and overlapping menus resolve correctly; a close that was never seen
+	// open (the plugin started with it up) is ignored. OnMenu is called from the game's event
+	// thread; GetState may be read from anywhere.
+	class MenuTracker
+	{
+	public:
+		// Returns true when the resulting state changed.
+		bool OnMenu(std::string_view InMenu, bool InOpening);
+
+		Audio::GameState GetState() const { return State.load(std::memory_order_acquire); }
+
+	private:
+		int LoadingMenus = 0;
+		int PauseMenus = 0;
+		int DuckingMenus = 0;
+
+		std::atomic<Audio::GameState> State = Audio::GameState::Playing;
+	};
+}
@@ -0,0 +1,302 @@
+#include "Control/MessageQueue.h"
+
+#include <algorithm>
+#include <optional>
+#include <thread>
+
+namespace Control
+{
+	namespace
+	{
+		using Clock = std::chrono::steady_clock;
+
+		struct Policy
+		{
+			std::chrono::milliseconds Interval;
+			bool                      Debounce;  // wait for a quiet Interval instead of showing at once
+		};
+
+		// By MessageCategory; Log lines have limits of their own.
+		constexpr std::array<Policy, kMessageCategoryCount> kPolicies = { {
+			{ std::chrono::milliseconds(0), false },
+			{ std::chrono::milliseconds(500), false },
+			{ std::chrono::milliseconds(1000), false },
+			{ std::chrono::milliseconds(300), true },
+			{ std::chrono::milliseconds(300), true },
+			{ std::chrono::milliseconds(2000), false },
+		} };
+
+		// The same notification again within this long is not shown twice.
+		constexpr auto kRepeatWindow = std::chrono::seconds(2);
+
+		// Repeated log lines are counted for at most this long before the count is written.
+		constexpr auto kRepeatFlush = std::chrono::seconds(1);
+
+		// Longest a message can sit in the ring while notifications are held back.
+		constexpr auto kPollInterval = std::chrono::milliseconds(20);
+	}
+
+	struct MessageQueue::Drain
+	{
+		struct Held
+		{
+			std::string       Text;  // waiting to be shown
+			bool              Waiting = false;
+			Clock::time_point Due;
+			std::string       Shown;  // last shown
+			Clock::time_point ShownAt;
+		};
+
+		MessageQueue& Queue;
+		const Sink&   Deliver;
+
+		std::array<Held, kMessageCategoryCount> Notifications{};
+
+		std::string       LastLine{};
+		uint64_t          Repeats = 0;
+		Clock::time_point RepeatsSince{};
+		Clock::time_point WindowStart{};
+		uint32_t          WindowCount = 0;
+		uint64_t          WindowSuppressed = 0;
+
+		void Take(MessageCategory InCategory, std::string_view InText, Clock::time_point InNow)
+		{
+			if (InCategory == MessageCategory::Log)
+				TakeLine(InText, InNow);
+			else
+				TakeNotification(InCategory, InText, InNow);
+		}
+
+		void TakeLine(std::string_view InText, Clock::time_point InNow)
+		{
+			if (InText == LastLine) {
+				if (Repeats++ == 0)
+					RepeatsSince = InNow;
+				Queue.Coalesced.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			if (InNow - WindowStart >= std::chrono::seconds(1))
+				FlushWindow(InNow);
+
+			if (WindowCount >= kMaxLogsPerSecond) {
+				++WindowSuppressed;
+				Queue.Suppressed.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			FlushRepeats();
+			LastLine = InText;
+			++WindowCount;
+			Deliver(MessageCategory::Log, InText);
+		}
+
+		void TakeNotification(MessageCategory InCategory, std::string_view InText, Clock::time_point InNow)
+		{
+			const auto& policy = kPolicies[static_cast<std::size_t>(InCategory)];
+			auto&       held = Notifications[static_cast<std::size_t>(InCategory)];
+
+			if (held.Waiting) {
+				Queue.Coalesced.fetch_add(1, std::memory_order_relaxed);
+			} else if (InText == held.Shown && InNow - held.ShownAt < kRepeatWindow) {
+				Queue.Coalesced.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			if (!policy.Debounce && !held.Waiting && InNow - held.ShownAt >= policy.Interval) {
+				Show(InCategory, held, InText, InNow);
+				return;
+			}
+
+			held.Text = InText;
+			held.Waiting = true;
+			held.Due = policy.Debounce ? InNow + policy.Interval : held.ShownAt + policy.Interval;
+		}
+
+		// Whatever has come due; returns when the next thing will.
+		std::optional<Clock::time_point> Tick(Clock::time_point InNow)
+		{
+			std::optional<Clock::time_point> next;
+			auto                             consider = [&](Clock::time_point InDue) {
+				if (!next || InDue < *next)
+					next = InDue;
+			};
+
+			for (std::size_t category = 0; category < kMessageCategoryCount; ++category) {
+				auto& held = Notifications[category];
+				if (!held.Waiting)
+					continue;
+
+				if (held.Due <= InNow) {
+					Show(static_cast<MessageCategory>(category), held, held.Text, InNow);
+				} else {
+					consider(held.Due);
+				}
+			}
+
+			if (Repeats > 0) {
+				if (InNow - RepeatsSince >= kRepeatFlush) {
+					FlushRepeats();
+				} else {
+					consider(RepeatsSince + kRepeatFlush);
+				}
+			}
+
+			if (WindowSuppressed > 0) {
+				if (InNow - WindowStart >= std::chrono::seconds(1)) {
+					FlushWindow(InNow);
+				} else {
+					consider(WindowStart + std::chrono::seconds(1));
+				}
+			}
+			return next;
+		}
+
+		// Log lines held back are written; notifications are not worth showing any more.
+		void Finish()
+		{
+			FlushRepeats();
+			if (WindowSuppressed > 0)
+				Deliver(MessageCategory::Log, std::format("{} - {} log line(s) suppressed", Plugin::NAME, WindowSuppressed));
+		}
+
+		void Show(MessageCategory InCategory, Held& InOutHeld, std::string_view InText, Clock::time_point InNow)
+		{
+			Deliver(InCategory, InText);
+			InOutHeld.Shown = InText;
+			InOutHeld.ShownAt = InNow;
+			InOutHeld.Waiting = false;
+		}
+
+		void FlushRepeats()
+		{
+			if (Repeats == 0)
+				return;
+
+			Deliver(MessageCategory::Log, std::format("{} - Last line repeated {} more time(s)", Plugin::NAME, Repeats));
+			Repeats = 0;
+		}
+
+		void FlushWindow(Clock::time_point InNow)
+		{
+			if (WindowSuppressed > 0)
+				Deliver(MessageCategory::Log, std::format("{} - {} log line(s) suppressed", Plugin::NAME, WindowSuppressed));
+
+			WindowStart = InNow;
+			WindowCount = 0;
+			WindowSuppressed = 0;
+		}
+	};
+
+	std::size_t TrimPartialCodePoint(std::string_view InText)
+	{
+		// Back over continuation bytes to the lead byte of the last sequence, then keep it only
+		// if all the bytes it announces are there. Text that is not UTF-8 is left alone.
+		std::size_t lead = InText.size();
+		while (lead > 0 && InText.size() - lead < 4 && (static_cast<uint8_t>(InText[lead - 1]) & 0xC0) == 0x80)
+			--lead;
+		if (lead == 0)
+			return InText.size();
+
+		const auto        byte = static_cast<uint8_t>(InText[--lead]);
+		const std::size_t needed = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+		return InText.size() - lead >= needed ? InText.size() : lead;
+	}
+
+	MessageQueue::MessageQueue() :
+		Cells(std::make_unique<Cell[]>(kCapacity))
+	{
+		for (std::size_t i = 0; i < kCapacity; ++i)
+			Cells[i].Sequence.store(i, std::memory_order_relaxed);
+	}
+
+	MessageQueue::~MessageQueue() = default;
+
+	MessageQueue::Cell* MessageQueue::Claim()
+	{
+		uint64_t position = Tail.load(std::memory_order_relaxed);
+		for (;;) {
+			Cell&          cell = Cells[position % kCapacity];
+			const uint64_t sequence = cell.Sequence.load(std::memory_order_acquire);
+			const auto     lead = static_cast<int64_t>(sequence - position);
+
+			if (lead == 0) {
+				if (Tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					return &cell;
+			} else if (lead < 0) {
+				// Not yet read since the ring last went round: full.
+				Dropped.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			} else {
+				position = Tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void MessageQueue::Commit(Cell& InOutCell, MessageCategory InCategory)
+	{
+		InOutCell.Category = InCategory;
+		const uint64_t position = InOutCell.Sequence.load(std::memory_order_relaxed);
+		InOutCell.Sequence.store(position + 1, std::memory_order_release);
+
+		if (!Pending.exchange(true, std::memory_order_acq_rel))
+			Pending.notify_one();
+	}
+
+	void MessageQueue::Run(std::stop_token InStop, const Sink& InDeliver)
+	{
+		std::stop_callback wake(InStop, [this] {
+			Pending.store(true, std::memory_order_release);
+			Pending.notify_one();
+		});
+
+		Drain drain{ *this, InDeliver };
+		for (;;) {
+			// Cleared before draining: anything posted from here on raises it again.
+			Pending.exchange(false, std::memory_order_acq_rel);
+
+			const auto now = Clock::now();
+			for (;;) {
+				Cell& cell = Cells[Head % kCapacity];
+				if (cell.Sequence.load(std::memory_order_acquire) != Head + 1)
+					break;
+
+				drain.Take(cell.Category, { cell.Text.data(), cell.Length }, now);
+				cell.Sequence.store(Head + kCapacity, std::memory_order_release);
+				++Head;
+			}
+
+			const auto due = drain.Tick(now);
+			if (InStop.stop_requested()) {
+				drain.Finish();
+				return;
+			}
+
+			// A timed wait on the flag does not exist; short sleeps bound how long a new message
+			// waits while a notification is held back.
+			if (due) {
+				std::this_thread::sleep_for(std::min<Clock::duration>(*due - now, kPollInterval));
+			} else {
+				Pending.wait(false, std::memory_order_acquire);
+			}
+		}
+	}
+
+	MessageQueue::Stats MessageQueue::GetStats() const
+	{
+		const uint64_t dropped = Dropped.load(std::memory_order_relaxed);
+		return {
+			Tail.load(std::memory_order_relaxed) + dropped,
+			dropped,
+			Coalesced.load(std::memory_order_relaxed),
+			Suppressed.load(std::memory_order_relaxed),
+		};
+	}
+
+	MessageQueue& GetMessages()
+	{
+		// Never destroyed: threads stopped during static destruction may still post to it.
+		static MessageQueue* messages = new MessageQueue;
+		return *messages;
+	}
+}
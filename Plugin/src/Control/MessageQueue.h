@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <string_view>
+
+namespace Control
+{
+	// What a message is; notifications of one category replace each other, see MessageQueue.
+	enum class MessageCategory : uint8_t
+	{
+		Log,      // a line for the log file
+		Status,   // radio on or off, configuration reloaded, statistics
+		Station,  // tuning in
+		Volume,
+		Seek,
+		Title,  // now playing
+	};
+
+	inline constexpr std::size_t kMessageCategoryCount = 6;
+
+	// Length of InText without a UTF-8 sequence cut off at its end, for text cut short.
+	std::size_t TrimPartialCodePoint(std::string_view InText);
+
+	// Log lines and HUD notifications from any thread, delivered by one low-priority thread.
+	// Posting formats into a slot of a fixed ring and never blocks or allocates: producers claim
+	// slots with a compare-and-swap, and a full ring drops the message and counts it.
+	//
+	// The drain thread is where the spam stops. Log lines repeated back to back are folded into
+	// a count, and past kMaxLogsPerSecond the rest of the second is summarised in one line.
+	// Notifications keep only the newest of their category: Volume and Seek wait until presses
+	// stop, so holding a key shows the final value once; the others show at once and then at
+	// most one per interval, the latest at the end of it.
+	class MessageQueue
+	{
+	public:
+		using Sink = std::function<void(MessageCategory InCategory, std::string_view InText)>;
+
+		static constexpr std::size_t kCapacity = 256;
+		static constexpr std::size_t kMaxText = 496;  // longer messages are cut short, between characters
+		static constexpr uint32_t    kMaxLogsPerSecond = 50;
+
+		struct Stats
+		{
+			uint64_t Posted = 0;      // including dropped ones
+			uint64_t Dropped = 0;     // ring full
+			uint64_t Coalesced = 0;   // replaced by a newer notification, or a repeated log line
+			uint64_t Suppressed = 0;  // over the log rate
+		};
+
+		MessageQueue();
+		~MessageQueue();
+
+		MessageQueue(const MessageQueue&) = delete;
+		MessageQueue& operator=(const MessageQueue&) = delete;
+
+		// Any thread. Returns false if the ring is full and the message was dropped.
+		template <class... Args>
+		bool Post(MessageCategory InCategory, std::format_string<Args...> InFormat, Args&&... InArgs)
+		{
+			Cell* cell = Claim();
+			if (!cell)
+				return false;
+
+			const auto result = std::format_to_n(cell->Text.data(), kMaxText, InFormat, std::forward<Args>(InArgs)...);
+			std::size_t length = std::min<std::size_t>(result.size, kMaxText);
+			if (static_cast<std::size_t>(result.size) > kMaxText)
+				length = TrimPartialCodePoint({ cell->Text.data(), length });
+			cell->Length = static_cast<uint16_t>(length);
+			Commit(*cell, InCategory);
+			return true;
+		}
+
+		bool Post(MessageCategory InCategory, std::string_view InText) { return Post(InCategory, "{}", InText); }
+
+		// Body of the drain thread; messages posted before it starts wait in the ring. On stop,
+		// log lines still held back are written and pending notifications are let go.
+		void Run(std::stop_token InStop, const Sink& InDeliver);
+
+		// Read by the drain thread as it goes; approximate from any other.
+		Stats GetStats() const;
+
+	private:
+		struct Cell
+		{
+			std::atomic<uint64_t>      Sequence;  // slot's position in the ring when free, position + 1 once written
+			MessageCategory            Category;
+			uint16_t                   Length;
+			std::array<char, kMaxText> Text;
+		};
+
+		struct Drain;
+
+		Cell* Claim();
+		void  Commit(Cell& InOutCell, MessageCategory InCategory);
+
+		std::unique_ptr<Cell[]> Cells;
+
+		// Producers share Tail and Pending; the drain thread alone reads Head.
+		alignas(64) std::atomic<uint64_t> Tail = 0;
+		alignas(64) std::atomic<bool>     Pending = false;
+		alignas(64) uint64_t              Head = 0;
+
+		std::atomic<uint64_t> Dropped = 0;
+		std::atomic<uint64_t> Coalesced = 0;
+		std::atomic<uint64_t> Suppressed = 0;
+	};
+
+	// The plugin's queue, drained by the thread main.cpp starts.
+	MessageQueue& GetMessages();
+
+	template <class... Args>
+	void Log(std::format_string<Args...> InFormat, Args&&... InArgs)
+	{
+		GetMessages().Post(MessageCategory::Log, InFormat, std::forward<Args>(InArgs)...);
+	}
+
+	template <class... Args>
+	void Notify(MessageCategory InCategory, std::format_string<Args...> InFormat, Args&&... InArgs)
+	{
+		GetMessages().Post(InCategory, InFormat, std::forward<Args>(InArgs)...);
+	}
+}
@@ -0,0 +1,35 @@
+#include "Control/NowPlaying.h"
+
+namespace Control
+{
+	void NowPlaying::SetOnAir(std::string_view InSource)
+	{
+		std::string title;
+		{
+			std::lock_guard lock(Mutex);
+			OnAir = InSource;
+			if (const auto found = Titles.find(OnAir); found != Titles.end())
+				title = found->second;
+		}
+
+		// Announced outside the lock: it goes through the game's console.
+		if (!title.empty())
+			Announce(title);
+	}
+
+	void NowPlaying::OnTitle(std::string_view InSource, std::string_view InTitle)
+	{
+		bool onAir = false;
+		{
+			std::lock_guard lock(Mutex);
+			auto& title = Titles[std::string(InSource)];
+			if (title == InTitle)
+				return;
+			title = InTitle;
+			onAir = OnAir == InSource;
+		}
+
+		if (onAir)
+			Announce(InTitle);
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Control
+{
+	// Latest "now playing" title of every live station, whether it is on air or only kept warm.
+	// Titles of the station on air are announced as they change; switching to a station
+	// announces the title it is playing already. One entry per station, so memory is bounded by
+	// the playlist.
+	class NowPlaying
+	{
+	public:
+		using Announcer = std::function<void(std::string_view InTitle)>;
+
+		explicit NowPlaying(Announcer InAnnounce) :
+			Announce(std::move(InAnnounce))
+		{
+		}
+
+		// InSource is the station on air; empty when nothing is.
+		void SetOnAir(std::string_view InSource);
+
+		// Safe to call from any thread.
+		void OnTitle(std::string_view InSource, std::string_view InTitle);
+
+	private:
+		Announcer Announce;
+
+		std::mutex                                   Mutex;
+		std::unordered_map<std::string, std::string> Titles;
+		std::string                                  OnAir;
+	};
+}
@@ -0,0 +1,232 @@
+#include "Control/Rotation.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace Control
+{
+	namespace
+	{
+		uint64_t SplitMix64(uint64_t& InOutState)
+		{
+			uint64_t value = (InOutState += 0x9E3779B97F4A7C15ull);
+			value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+			value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+			return value ^ (value >> 31);
+		}
+
+		uint64_t RotateLeft(uint64_t InValue, int InBits)
+		{
+			return (InValue << InBits) | (InValue >> (64 - InBits));
+		}
+
+		bool EqualsNoCase(std::string_view InLeft, std::string_view InRight)
+		{
+			return std::ranges::equal(InLeft, InRight, [](char InA, char InB) {
+				return std::tolower(static_cast<unsigned char>(InA)) == std::tolower(static_cast<unsigned char>(InB));
+			});
+		}
+	}
+
+	Random::Random(uint64_t InSeed)
+	{
+		for (auto& word : State)
+			word = SplitMix64(InSeed);
+	}
+
+	uint64_t Random::Next()
+	{
+		const uint64_t result = RotateLeft(State[1] * 5, 7) * 9;
+		const uint64_t shifted = State[1] << 17;
+
+		State[2] ^= State[0];
+		State[3] ^= State[1];
+		State[1] ^= State[2];
+		State[0] ^= State[3];
+		State[2] ^= shifted;
+		State[3] = RotateLeft(State[3], 45);
+		return result;
+	}
+
+	uint32_t Random::Below(uint32_t InBound)
+	{
+		// Lemire's multiply-shift, rejecting the few values that would favor low results.
+		if (InBound == 0)
+			return 0;
+
+		uint64_t product = (Next() >> 32) * InBound;
+		if (static_cast<uint32_t>(product) < InBound) {
+			const uint32_t threshold = (0u - InBound) % InBound;
+			while (static_cast<uint32_t>(product) < threshold)
+				product = (Next() >> 32) * InBound;
+		}
+		return static_cast<uint32_t>(product >> 32);
+	}
+
+	TrackCategory GetTrackCategory(std::string_view InRelativePath)
+	{
+		const auto separator = InRelativePath.find_first_of("/\\");
+		if (separator == std::string_view::npos)
+			return TrackCategory::Music;
+
+		const auto folder = InRelativePath.substr(0, separator);
+		if (EqualsNoCase(folder, "Jingles") || EqualsNoCase(folder, "Jingle"))
+			return TrackCategory::Jingle;
+		if (EqualsNoCase(folder, "Ads") || EqualsNoCase(folder, "Ad") || EqualsNoCase(folder, "Commercials"))
+			return TrackCategory::Ad;
+		if (EqualsNoCase(folder, "News"))
+			return TrackCategory::News;
+		return TrackCategory::Music;
+	}
+
+	Rotation::Rotation(uint64_t InSeed, std::span<const TrackCategory> InTracks, const RotationWeights& InWeights) :
+		Rng(InSeed),
+		Recent(InTracks.size())
+	{
+		for (uint32_t track = 0; track < InTracks.size(); ++track)
+			Decks[static_cast<std::size_t>(InTracks[track])].Tracks.push_back(track);
+
+		for (std::size_t category = 0; category < kTrackCategoryCount; ++category) {
+			if (!Decks[category].Tracks.empty() && InWeights[category] > 0)
+				Active.push_back(static_cast<uint8_t>(category));
+		}
+
+		// Every category with tracks weighted 0: they still play, evenly, rather than nothing.
+		if (Active.empty()) {
+			for (std::size_t category = 0; category < kTrackCategoryCount; ++category) {
+				if (!Decks[category].Tracks.empty())
+					Active.push_back(static_cast<uint8_t>(category));
+			}
+		}
+
+		for (const auto category : Active) {
+			auto& deck = Decks[category];
+			deck.Weight = std::max<int64_t>(InWeights[category], 1);
+			TotalWeight += deck.Weight;
+			Shuffle(deck);
+		}
+	}
+
+	uint32_t Rotation::Next()
+	{
+		Deck* chosen = nullptr;
+		for (const auto category : Active) {
+			auto& deck = Decks[category];
+			deck.Credit += deck.Weight;
+			if (!chosen || deck.Credit > chosen->Credit)
+				chosen = &deck;
+		}
+		chosen->Credit -= TotalWeight;
+
+		if (chosen->Dealt == chosen->Tracks.size())
+			Shuffle(*chosen);
+		return chosen->Tracks[chosen->Dealt++];
+	}
+
+	void Rotation::Shuffle(Deck& InOutDeck)
+	{
+		auto&             tracks = InOutDeck.Tracks;
+		const std::size_t count = tracks.size();
+		const std::size_t window = std::min(count / 2, kNoRepeatWindow);
+
+		// The end of the deck just played, before it is shuffled away.
+		const bool reshuffle = InOutDeck.Dealt > 0;
+		if (reshuffle) {
+			for (std::size_t i = count - window; i < count; ++i)
+				Recent[tracks[i]] = 1;
+		}
+
+		for (std::size_t i = count; i > 1; --i)
+			std::swap(tracks[i - 1], tracks[Rng.Below(static_cast<uint32_t>(i))]);
+
+		// Recent tracks dealt at the top trade places with ones further down. There are always
+		// enough: at most window tracks are recent, and at least window positions lie below.
+		if (reshuffle) {
+			for (std::size_t i = 0; i < window; ++i) {
+				if (!Recent[tracks[i]])
+					continue;
+
+				const std::size_t span = count - window;
+				std::size_t       j = window + Rng.Below(static_cast<uint32_t>(span));
+				while (Recent[tracks[j]])
+					j = j + 1 < count ? j + 1 : window;
+				std::swap(tracks[i], tracks[j]);
+			}
+			for (const auto track : tracks)
+				Recent[track] = 0;
+		}
+
+		InOutDeck.Dealt = 0;
+	}
+
+	RotationClock::RotationClock(uint64_t InSeed, std::vector<uint32_t> InLengthsMs, std::span<const TrackCategory> InCategories, const RotationWeights& InWeights) :
+		Seed(InSeed),
+		LengthsMs(std::move(InLengthsMs)),
+		Categories(InCategories.begin(), InCategories.end()),
+		Weights(InWeights),
+		Plan(InSeed, Categories, Weights)
+	{
+		if (!Plan.empty())
+			Queue.push_back(Plan.Next());
+	}
+
+	bool RotationClock::Matches(uint64_t InSeed, std::span<const uint32_t> InLengthsMs, std::span<const TrackCategory> InCategories, const RotationWeights& InWeights) const
+	{
+		return InSeed == Seed && InWeights == Weights && std::ranges::equal(InLengthsMs, LengthsMs) && std::ranges::equal(InCategories, Categories);
+	}
+
+	RotationClock::Slot RotationClock::Find(uint64_t InStationTimeMs)
+	{
+		if (InStationTimeMs < StartMs)
+			Restart(InStationTimeMs);
+
+		while (InStationTimeMs - StartMs >= LengthsMs[Queue.front()])
+			Advance();
+
+		return { Queue.front(), static_cast<uint32_t>(InStationTimeMs - StartMs) };
+	}
+
+	std::span<const uint32_t> RotationClock::GetUpcoming(std::size_t InCount)
+	{
+		while (Queue.size() < InCount + 1)
+			Queue.push_back(Plan.Next());
+
+		Upcoming.assign(Queue.begin() + 1, Queue.begin() + 1 + static_cast<std::ptrdiff_t>(InCount));
+		return Upcoming;
+	}
+
+	void RotationClock::Restart(uint64_t InStationTimeMs)
+	{
+		// Checkpoints after the time asked for describe a future it has to walk into again.
+		while (!Checkpoints.empty() && Checkpoints.back().StartMs > InStationTimeMs)
+			Checkpoints.pop_back();
+
+		if (!Checkpoints.empty()) {
+			const auto& checkpoint = Checkpoints.back();
+			Plan = checkpoint.Plan;
+			Queue = checkpoint.Queue;
+			StartMs = checkpoint.StartMs;
+			return;
+		}
+
+		Plan = Rotation(Seed, Categories, Weights);
+		Queue.clear();
+		Queue.push_back(Plan.Next());
+		StartMs = 0;
+	}
+
+	void RotationClock::Advance()
+	{
+		StartMs += LengthsMs[Queue.front()];
+		Queue.pop_front();
+		if (Queue.empty())
+			Queue.push_back(Plan.Next());
+
+		const uint64_t last = Checkpoints.empty() ? 0 : Checkpoints.back().StartMs;
+		if (StartMs / kCheckpointMs > last / kCheckpointMs) {
+			if (Checkpoints.size() == kMaxCheckpoints)
+				Checkpoints.pop_front();
+			Checkpoints.push_back({ Plan, Queue, StartMs });
+		}
+	}
+}
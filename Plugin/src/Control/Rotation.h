@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Control
+{
+	// xoshiro256** seeded through SplitMix64. The same seed gives the same sequence on every
+	// platform and build, unlike rand(), and nothing is shared between instances.
+	class Random
+	{
+	public:
+		explicit Random(uint64_t InSeed);
+
+		uint64_t Next();
+
+		// Uniform in [0, InBound), without the bias of Next() % InBound. 0 for a bound of 0.
+		uint32_t Below(uint32_t InBound);
+
+	private:
+		std::array<uint64_t, 4> State;
+	};
+
+	enum class TrackCategory : uint8_t
+	{
+		Music,
+		Jingle,
+		Ad,
+		News,
+	};
+
+	inline constexpr std::size_t kTrackCategoryCount = 4;
+
+	// Category of a folder station's track from the first folder of its path below the
+	// station's folder: "Jingles\...", "Ads\..." and "News\..."; anything else is music.
+	TrackCategory GetTrackCategory(std::string_view InRelativePath);
+
+	// Relative share of the slots each category gets, by TrackCategory. Categories without
+	// tracks are left out.
+	using RotationWeights = std::array<uint32_t, kTrackCategoryCount>;
+
+	// The order a multi-track station plays its tracks in, as an endless sequence fixed by its
+	// seed. Categories take turns in proportion to their weights, spread out rather than
+	// bunched (smooth weighted round-robin: at 8:1 an ad comes after every eighth song, never
+	// twice in a row). Each category deals from its own shuffled deck, so every track plays
+	// once before any plays again, and a new deck keeps the last tracks of the previous one
+	// away from its top so a reshuffle does not repeat what was just heard.
+	class Rotation
+	{
+	public:
+		Rotation(uint64_t InSeed, std::span<const TrackCategory> InTracks, const RotationWeights& InWeights);
+
+		// Index of the next track in the list the rotation was built from.
+		uint32_t Next();
+
+		bool empty() const { return Active.empty(); }
+
+	private:
+		// Tracks kept off the top of a new deck; at most half the deck, so small decks still shuffle.
+		static constexpr std::size_t kNoRepeatWindow = 16;
+
+		struct Deck
+		{
+			std::vector<uint32_t> Tracks;
+			std::size_t           Dealt = 0;
+			int64_t               Weight = 0;
+			int64_t               Credit = 0;  // round-robin balance
+		};
+
+		void Shuffle(Deck& InOutDeck);
+
+		Random                                 Rng;
+		std::array<Deck, kTrackCategoryCount> Decks;
+		std::vector<uint8_t>                   Active;  // categories with tracks and a weight
+		int64_t                                TotalWeight = 0;
+		std::vector<uint8_t>                   Recent;  // by track: among the last of its deck
+	};
+
+	// A rotation laid out on a station's broadcast clock: which track is on air at a point of
+	// the station's time (BroadcastSchedule::GetStationTimeMs) and which ones follow. Lookups
+	// walk forward from the last one, so they cost a step per track that went by since. The
+	// first lookup walks from the start of the broadcast; keep the clock (see Matches) rather
+	// than building it again. Every kCheckpointMs of station time the walk leaves a checkpoint,
+	// and a clock that went backward resumes from the last one before the time asked for.
+	class RotationClock
+	{
+	public:
+		struct Slot
+		{
+			uint32_t Track = 0;
+			uint32_t PositionMs = 0;  // into the track
+		};
+
+		// InLengthsMs and InCategories describe the same tracks; all lengths are above 0.
+		RotationClock(uint64_t InSeed, std::vector<uint32_t> InLengthsMs, std::span<const TrackCategory> InCategories, const RotationWeights& InWeights);
+
+		bool empty() const { return Plan.empty(); }
+
+		// Whether these inputs lay out the same rotation as the clock's.
+		bool Matches(uint64_t InSeed, std::span<const uint32_t> InLengthsMs, std::span<const TrackCategory> InCategories, const RotationWeights& InWeights) const;
+
+		uint32_t GetLengthMs(uint32_t InTrack) const { return LengthsMs[InTrack]; }
+
+		Slot Find(uint64_t InStationTimeMs);
+
+		// The InCount tracks after the one Find returned last, known in advance for prefetching.
+		std::span<const uint32_t> GetUpcoming(std::size_t InCount);
+
+	private:
+		static constexpr uint64_t    kCheckpointMs = 60 * 60 * 1000;
+		static constexpr std::size_t kMaxCheckpoints = 8;  // the oldest goes first
+
+		// Everything Find depends on, as of the track starting at StartMs.
+		struct Checkpoint
+		{
+			Rotation             Plan;
+			std::deque<uint32_t> Queue;
+			uint64_t             StartMs = 0;
+		};
+
+		void Restart(uint64_t InStationTimeMs);
+		void Advance();
+
+		uint64_t                   Seed;
+		std::vector<uint32_t>      LengthsMs;
+		std::vector<TrackCategory> Categories;
+		RotationWeights            Weights;
+		Rotation                   Plan;
+		std::deque<uint32_t>       Queue;  // Queue[0] is on air from StartMs
+		std::vector<uint32_t>      Upcoming;
+		uint64_t                   StartMs = 0;
+		std::deque<Checkpoint>     Checkpoints;  // by StartMs
+	};
+}
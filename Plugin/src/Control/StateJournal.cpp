@@ -0,0 +1,262 @@
+#include "Control/StateJournal.h"
+
+#include "Config/Hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#if defined(_WIN32)
+#	include <io.h>
+#else
+#	include <unistd.h>
+#endif
+
+namespace Control
+{
+	namespace
+	{
+		constexpr uint32_t kJournalMagic = 0x4A524753;  // "SGRJ"
+		constexpr uint32_t kJournalFormat = 1;
+		constexpr uint32_t kRecordMagic = 0x53415453;  // "STAS"
+
+		constexpr std::size_t kHeaderBytes = 8;
+		constexpr std::size_t kRecordBytes = 48;
+
+		template <class T>
+		void Put(std::string& OutData, const T& InValue)
+		{
+			OutData.append(reinterpret_cast<const char*>(&InValue), sizeof(T));
+		}
+
+		template <class T>
+		T Get(std::string_view& InOutData)
+		{
+			T value;
+			std::memcpy(&value, InOutData.data(), sizeof(T));
+			InOutData.remove_prefix(sizeof(T));
+			return value;
+		}
+
+		std::string MakeHeader()
+		{
+			std::string data;
+			Put(data, kJournalMagic);
+			Put(data, kJournalFormat);
+			return data;
+		}
+
+		std::string MakeRecord(uint32_t InSequence, const ListeningState& InState)
+		{
+			std::string data;
+			Put(data, kRecordMagic);
+			Put(data, InSequence);
+			Put(data, InState.StationKey);
+			Put(data, InState.Volume);
+			Put(data, InState.Mode);
+			Put(data, InState.ScheduleSeed);
+			Put(data, InState.ElapsedMs);
+			Put(data, Fnv1a64(data));
+			return data;
+		}
+
+		// False for anything torn or corrupt.
+		bool ReadRecord(std::string_view InRecord, uint32_t& OutSequence, ListeningState& OutState)
+		{
+			const uint64_t checksum = Fnv1a64(InRecord.substr(0, kRecordBytes - sizeof(uint64_t)));
+
+			std::string_view data = InRecord;
+			if (Get<uint32_t>(data) != kRecordMagic)
+				return false;
+			OutSequence = Get<uint32_t>(data);
+			OutState.StationKey = Get<uint64_t>(data);
+			OutState.Volume = Get<float>(data);
+			OutState.Mode = Get<int32_t>(data);
+			OutState.ScheduleSeed = Get<uint64_t>(data);
+			OutState.ElapsedMs = Get<uint64_t>(data);
+			return Get<uint64_t>(data) == checksum;
+		}
+
+		// Worth a record: anything but the broadcast time changed, or that moved a step.
+		bool IsNewState(const std::optional<ListeningState>& InLast, const ListeningState& InState)
+		{
+			if (!InLast)
+				return true;
+
+			const uint64_t stepMs = std::chrono::milliseconds(StateJournal::kElapsedStep).count();
+			const uint64_t movedMs = std::max(InLast->ElapsedMs, InState.ElapsedMs) - std::min(InLast->ElapsedMs, InState.ElapsedMs);
+			return InLast->StationKey != InState.StationKey || InLast->Volume != InState.Volume || InLast->Mode != InState.Mode ||
+			       InLast->ScheduleSeed != InState.ScheduleSeed || movedMs >= stepMs;
+		}
+
+		void FlushToDisk(std::FILE* InStream)
+		{
+#if defined(_WIN32)
+			_commit(_fileno(InStream));
+#else
+			fsync(fileno(InStream));
+#endif
+		}
+	}
+
+	StateJournal::StateJournal(std::filesystem::path InFile) :
+		File(std::move(InFile))
+	{
+	}
+
+	StateJournal::~StateJournal()
+	{
+		if (!Stream)
+			return;
+		if (SyncPending)
+			Sync();
+		std::fclose(Stream);
+	}
+
+	std::optional<ListeningState> StateJournal::Load()
+	{
+		std::string     bytes;
+		std::error_code ec;
+		const auto      size = std::filesystem::file_size(File, ec);
+		if (!ec && size <= 2 * kMaxJournalBytes) {
+			bytes.resize(static_cast<std::size_t>(size));
+			std::ifstream file(File, std::ios::binary);
+			if (!file.read(bytes.data(), static_cast<std::streamsize>(size)))
+				bytes.clear();
+		}
+
+		// Records count until the first one that does not read back or breaks the sequence.
+		std::size_t      valid = 0;
+		std::string_view data = bytes;
+		if (data.size() >= kHeaderBytes && data.substr(0, kHeaderBytes) == MakeHeader()) {
+			valid = kHeaderBytes;
+			data.remove_prefix(kHeaderBytes);
+
+			uint32_t       sequence = 0;
+			ListeningState state;
+			while (data.size() >= kRecordBytes && ReadRecord(data.substr(0, kRecordBytes), sequence, state) && (!Last || sequence == Sequence + 1)) {
+				Last = state;
+				Sequence = sequence;
+				valid += kRecordBytes;
+				data.remove_prefix(kRecordBytes);
+			}
+		}
+
+		if (Last && valid == bytes.size()) {
+			Stream = std::fopen(File.string().c_str(), "ab");
+			Size = valid;
+		} else if (Last) {
+			INFO("{} - Listening state journal was cut short, keeping its last complete record", Plugin::NAME);
+			Compact(*Last);
+		} else {
+			std::filesystem::create_directories(File.parent_path(), ec);
+			Stream = std::fopen(File.string().c_str(), "wb");
+			if (Stream) {
+				const auto header = MakeHeader();
+				std::fwrite(header.data(), 1, header.size(), Stream);
+				std::fflush(Stream);
+			}
+			Size = kHeaderBytes;
+			Sequence = 0;
+		}
+
+		if (!Stream)
+			INFO("{} - Could not open the listening state journal", Plugin::NAME);
+		LastSync = std::chrono::steady_clock::now();
+		return Last;
+	}
+
+	void StateJournal::Record(const ListeningState& InState)
+	{
+		if (!Stream || !IsNewState(Last, InState))
+			return;
+
+		if (Size + kRecordBytes > kMaxJournalBytes) {
+			Compact(InState);
+			return;
+		}
+
+		if (!Append(InState))
+			return;
+
+		if (std::chrono::steady_clock::now() - LastSync >= kSyncInterval)
+			Sync();
+		else
+			SyncPending = true;
+	}
+
+	void StateJournal::Flush()
+	{
+		if (Stream && SyncPending && std::chrono::steady_clock::now() - LastSync >= kSyncInterval)
+			Sync();
+	}
+
+	void StateJournal::Compact(const ListeningState& InState)
+	{
+		if (Stream) {
+			std::fclose(Stream);
+			Stream = nullptr;
+		}
+
+		// The old journal stays whole until the new one replaces it in one step.
+		auto temporary = File;
+		temporary += ".tmp";
+
+		std::error_code ec;
+		std::filesystem::create_directories(File.parent_path(), ec);
+
+		bool written = false;
+		if (std::FILE* stream = std::fopen(temporary.string().c_str(), "wb")) {
+			const auto data = MakeHeader() + MakeRecord(0, InState);
+			written = std::fwrite(data.data(), 1, data.size(), stream) == data.size() && std::fflush(stream) == 0;
+			if (written)
+				FlushToDisk(stream);
+			written = std::fclose(stream) == 0 && written;
+		}
+
+		if (written)
+			std::filesystem::rename(temporary, File, ec);
+		// Nothing is appended to a journal that may end in a torn record; the next Compact,
+		// at shutdown at the latest, tries again.
+		if (!written || ec) {
+			INFO("{} - Could not compact the listening state journal", Plugin::NAME);
+			std::filesystem::remove(temporary, ec);
+			return;
+		}
+
+		Stream = std::fopen(File.string().c_str(), "ab");
+		Size = kHeaderBytes + kRecordBytes;
+		Sequence = 0;
+		Last = InState;
+		SyncPending = false;
+		LastSync = std::chrono::steady_clock::now();
+	}
+
+	bool StateJournal::Append(const ListeningState& InState)
+	{
+		if (!Stream)
+			return false;
+
+		const auto record = MakeRecord(Sequence + 1, InState);
+		if (std::fwrite(record.data(), 1, record.size(), Stream) != record.size() || std::fflush(Stream) != 0) {
+			// Part of the record may have made it; the next one compacts instead of following it.
+			INFO("{} - Could not write the listening state journal", Plugin::NAME);
+			Size = kMaxJournalBytes;
+			return false;
+		}
+
+		++Sequence;
+		Size += record.size();
+		Last = InState;
+		return true;
+	}
+
+	void StateJournal::Sync()
+	{
+		FlushToDisk(Stream);
+		SyncPending = false;
+		LastSync = std::chrono::steady_clock::now();
+	}
+}
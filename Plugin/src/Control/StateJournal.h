@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+
+namespace Control
+{
+	// What the player restores at startup.
+	struct ListeningState
+	{
+		uint64_t StationKey = 0;  // Station::Key on air, 0 for none
+		float    Volume = 700.0f;
+		int32_t  Mode = 0;
+		uint64_t ScheduleSeed = 0;
+		uint64_t ElapsedMs = 0;  // broadcast time, so stations carry on where they were
+
+		bool operator==(const ListeningState&) const = default;
+	};
+
+	// Append-only journal of the listening state. Every record is a whole state with its own
+	// checksum, so whatever a crash leaves behind, the last record that reads back intact is the
+	// state to restore; a torn tail is cut off before anything is appended after it. Records
+	// reach the OS as they are written, which survives the game crashing; flushes to the disk
+	// itself are batched to one per kSyncInterval. Compact rewrites the journal as one record
+	// through a temporary file swapped in whole, on shutdown and whenever it grows too long.
+	// Broadcast time moves on by itself, so a state differing from the last only there is
+	// recorded once it moved kElapsedStep; a restore resumes at most that much early.
+	class StateJournal
+	{
+	public:
+		static constexpr auto kSyncInterval = std::chrono::seconds(2);
+		static constexpr auto kElapsedStep = std::chrono::minutes(1);
+
+		explicit StateJournal(std::filesystem::path InFile);
+		~StateJournal();
+
+		StateJournal(const StateJournal&) = delete;
+		StateJournal& operator=(const StateJournal&) = delete;
+
+		// The last state recorded, if one survived. Call once, before Record.
+		std::optional<ListeningState> Load();
+
+		void Record(const ListeningState& InState);
+
+		// Flushes a record still waiting for its batch to disk once kSyncInterval has passed;
+		// call it periodically, as records may stop coming.
+		void Flush();
+
+		// Rewrites the journal as InState alone and flushes it to disk.
+		void Compact(const ListeningState& InState);
+
+	private:
+		// Journals are compacted past this; a record is 48 bytes.
+		static constexpr std::size_t kMaxJournalBytes = 64 * 1024;
+
+		bool Append(const ListeningState& InState);
+		void Sync();
+
+		std::filesystem::path                 File;
+		std::FILE*                            Stream = nullptr;
+		std::size_t                           Size = 0;
+		uint32_t                              Sequence = 0;
+		std::optional<ListeningState>         Last;
+		bool                                  SyncPending = false;
+		std::chrono::steady_clock::time_point LastSync;
+	};
+}
@@ -0,0 +1,227 @@
+#include "Control/Telemetry.h"
+
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <fstream>
+
+namespace Control
+{
+	std::size_t LatencyHistogram::GetBucket(uint64_t InValueUs)
+	{
+		const uint64_t value = std::min(InValueUs, kMaxValue);
+		if (value < kLinearBuckets)
+			return static_cast<std::size_t>(value);
+
+		// The top five bits pick the bucket: the leading one and four below it.
+		const int shift = std::bit_width(value) - 5;
+		return kLinearBuckets + std::size_t(shift - 1) * kSubBuckets + static_cast<std::size_t>((value >> shift) - kSubBuckets);
+	}
+
+	uint64_t LatencyHistogram::GetBucketLow(std::size_t InBucket)
+	{
+		if (InBucket < kLinearBuckets)
+			return InBucket;
+
+		const std::size_t shift = (InBucket - kLinearBuckets) / kSubBuckets + 1;
+		const uint64_t    top = (InBucket - kLinearBuckets) % kSubBuckets + kSubBuckets;
+		return top << shift;
+	}
+
+	uint64_t LatencyHistogram::GetBucketHigh(std::size_t InBucket)
+	{
+		return InBucket + 1 < kBucketCount ? GetBucketLow(InBucket + 1) - 1 : kMaxValue;
+	}
+
+	void LatencyHistogram::Record(uint64_t InValueUs)
+	{
+		Counts[GetBucket(InValueUs)].fetch_add(1, std::memory_order_relaxed);
+		Count.fetch_add(1, std::memory_order_relaxed);
+		SumUs.fetch_add(InValueUs, std::memory_order_relaxed);
+
+		uint64_t max = MaxUs.load(std::memory_order_relaxed);
+		while (InValueUs > max && !MaxUs.compare_exchange_weak(max, InValueUs, std::memory_order_relaxed)) {}
+	}
+
+	LatencyHistogram::Summary LatencyHistogram::Summarize() const
+	{
+		const auto counts = GetCounts();
+
+		Summary summary;
+		for (const auto count : counts)
+			summary.Count += count;
+		if (summary.Count == 0)
+			return summary;
+
+		summary.MaxUs = MaxUs.load(std::memory_order_relaxed);
+		summary.MeanUs = SumUs.load(std::memory_order_relaxed) / std::max<uint64_t>(Count.load(std::memory_order_relaxed), 1);
+
+		const auto percentile = [&](uint64_t InPerThousand) {
+			// The smallest value at least InPerThousand / 1000 of the samples are at or below.
+			const uint64_t rank = std::max<uint64_t>((summary.Count * InPerThousand + 999) / 1000, 1);
+			uint64_t       seen = 0;
+			for (std::size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+				seen += counts[bucket];
+				if (seen >= rank)
+					return std::min(GetBucketHigh(bucket), summary.MaxUs);
+			}
+			return summary.MaxUs;
+		};
+		summary.P50Us = percentile(500);
+		summary.P90Us = percentile(900);
+		summary.P99Us = percentile(990);
+		summary.P999Us = percentile(999);
+		return summary;
+	}
+
+	std::array<uint64_t, LatencyHistogram::kBucketCount> LatencyHistogram::GetCounts() const
+	{
+		std::array<uint64_t, kBucketCount> counts;
+		for (std::size_t bucket = 0; bucket < kBucketCount; ++bucket)
+			counts[bucket] = Counts[bucket].load(std::memory_order_relaxed);
+		return counts;
+	}
+
+#if RADIO_TELEMETRY
+	namespace
+	{
+		using Clock = std::chrono::steady_clock;
+
+		constexpr auto kMaxAudioWait = std::chrono::minutes(1);
+
+		constexpr std::array<std::string_view, kOperationCount> kOperationNames = {
+			"open",
+			"firstAudio",
+			"seek",
+			"switch",
+			"reload",
+			"decode",
+		};
+
+		constexpr std::array<std::string_view, kCounterCount> kCounterNames = {
+			"framesDecoded",
+			"emptyFrames",
+		};
+
+		struct Registry
+		{
+			std::array<LatencyHistogram, kOperationCount>     Histograms;
+			std::array<std::atomic<uint64_t>, kCounterCount>  Counters{};
+			std::array<std::atomic<int64_t>, kOperationCount> Expected{};     // start in Clock ticks, 0 for none
+			std::atomic<uint32_t>                             Expecting = 0;  // bit per Operation
+			Clock::time_point                                 Started = Clock::now();
+		};
+
+		// Never destroyed, like the message queue: threads may record during static destruction.
+		Registry& GetRegistry()
+		{
+			static Registry* registry = new Registry;
+			return *registry;
+		}
+
+		uint64_t ToMicroseconds(Clock::duration InElapsed)
+		{
+			return static_cast<uint64_t>(std::max<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(InElapsed).count(), 0));
+		}
+	}
+
+	void RecordLatency(Operation InOperation, std::chrono::steady_clock::duration InElapsed)
+	{
+		GetRegistry().Histograms[static_cast<std::size_t>(InOperation)].Record(ToMicroseconds(InElapsed));
+	}
+
+	void CountEvent(Counter InCounter, uint64_t InAmount)
+	{
+		GetRegistry().Counters[static_cast<std::size_t>(InCounter)].fetch_add(InAmount, std::memory_order_relaxed);
+	}
+
+	void ExpectAudio(Operation InOperation)
+	{
+		auto& registry = GetRegistry();
+		// Never 0, which marks "not expected".
+		const int64_t now = std::max<int64_t>(Clock::now().time_since_epoch().count(), 1);
+		registry.Expected[static_cast<std::size_t>(InOperation)].store(now, std::memory_order_relaxed);
+		registry.Expecting.fetch_or(1u << static_cast<uint32_t>(InOperation), std::memory_order_release);
+	}
+
+	void CancelAudio(Operation InOperation)
+	{
+		auto& registry = GetRegistry();
+		registry.Expected[static_cast<std::size_t>(InOperation)].store(0, std::memory_order_relaxed);
+	}
+
+	bool IsExpectingAudio()
+	{
+		return GetRegistry().Expecting.load(std::memory_order_relaxed) != 0;
+	}
+
+	void OnAudioStarted()
+	{
+		auto&          registry = GetRegistry();
+		const uint32_t expecting = registry.Expecting.exchange(0, std::memory_order_acquire);
+		const auto     now = Clock::now();
+		for (uint32_t operation = 0; expecting >> operation != 0; ++operation) {
+			if (!(expecting & (1u << operation)))
+				continue;
+
+			const int64_t start = registry.Expected[operation].exchange(0, std::memory_order_relaxed);
+			if (start == 0)
+				continue;
+
+			const auto elapsed = now - Clock::time_point(Clock::duration(start));
+			if (elapsed <= kMaxAudioWait)
+				registry.Histograms[operation].Record(ToMicroseconds(elapsed));
+		}
+	}
+
+	std::string FormatTelemetry(TelemetryFields InFields)
+	{
+		auto& registry = GetRegistry();
+
+		std::string json = std::format("{{\n\t\"plugin\": \"{}\",\n\t\"version\": {},\n\t\"uptimeMs\": {},\n\t\"operations\": {{",
+			Plugin::NAME, Plugin::Version, std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - registry.Started).count());
+
+		for (std::size_t operation = 0; operation < kOperationCount; ++operation) {
+			const auto& histogram = registry.Histograms[operation];
+			const auto  summary = histogram.Summarize();
+			json += std::format("{}\n\t\t\"{}\": {{ \"count\": {}, \"meanUs\": {}, \"p50Us\": {}, \"p90Us\": {}, \"p99Us\": {}, \"p999Us\": {}, \"maxUs\": {}, \"buckets\": [",
+				operation == 0 ? "" : ",", kOperationNames[operation], summary.Count, summary.MeanUs, summary.P50Us, summary.P90Us, summary.P99Us, summary.P999Us, summary.MaxUs);
+
+			// Non-empty buckets only, as [lowest us, highest us, count].
+			const auto counts = histogram.GetCounts();
+			bool       first = true;
+			for (std::size_t bucket = 0; bucket < counts.size(); ++bucket) {
+				if (counts[bucket] == 0)
+					continue;
+				json += std::format("{}[{}, {}, {}]", first ? "" : ", ", LatencyHistogram::GetBucketLow(bucket), LatencyHistogram::GetBucketHigh(bucket), counts[bucket]);
+				first = false;
+			}
+			json += "] }";
+		}
+
+		json += "\n\t},\n\t\"counters\": {";
+		bool       first = true;
+		const auto counter = [&](std::string_view InName, uint64_t InValue) {
+			json += std::format("{}\n\t\t\"{}\": {}", first ? "" : ",", InName, InValue);
+			first = false;
+		};
+		for (std::size_t index = 0; index < kCounterCount; ++index)
+			counter(kCounterNames[index], registry.Counters[index].load(std::memory_order_relaxed));
+		for (const auto& [name, value] : InFields)
+			counter(name, value);
+
+		json += "\n\t}\n}\n";
+		return json;
+	}
+
+	bool WriteTelemetry(const std::filesystem::path& InFile, TelemetryFields InFields)
+	{
+		const std::string json = FormatTelemetry(InFields);
+
+		std::error_code ec;
+		std::filesystem::create_directories(InFile.parent_path(), ec);
+		std::ofstream file(InFile, std::ios::binary | std::ios::trunc);
+		return file.write(json.data(), static_cast<std::streamsize>(json.size())) && file.flush();
+	}
+#endif
+}
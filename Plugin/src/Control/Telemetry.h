@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Set to 0 (the RADIO_TELEMETRY CMake option) to compile the timers and counters away.
+#if !defined(RADIO_TELEMETRY)
+#	define RADIO_TELEMETRY 1
+#endif
+
+namespace Control
+{
+	enum class Operation : uint8_t
+	{
+		Open,        // AudioBackend::Open: connecting, or taking a warm station
+		FirstAudio,  // play requested until its first samples reach the output
+		Seek,        // seek requested until samples from the new position reach the output
+		Switch,      // station change requested until the new station reaches the output
+		Reload,      // configuration file read, compiled and published
+		Decode,      // one MP3 frame
+	};
+
+	inline constexpr std::size_t kOperationCount = 6;
+
+	enum class Counter : uint8_t
+	{
+		FramesDecoded,
+		EmptyFrames,  // frames the decoder produced nothing from
+	};
+
+	inline constexpr std::size_t kCounterCount = 2;
+
+	// Latencies in microseconds, in buckets of at most 1/16 of their value (log-linear, like
+	// HdrHistogram): exact below 32 us, then 16 buckets per doubling up to ~19 hours. Recording
+	// is a few relaxed atomic adds, safe from any thread including the render thread.
+	class LatencyHistogram
+	{
+	public:
+		static constexpr std::size_t kLinearBuckets = 32;
+		static constexpr std::size_t kSubBuckets = 16;
+		static constexpr uint64_t    kMaxValue = (uint64_t(1) << 36) - 1;
+		static constexpr std::size_t kBucketCount = kLinearBuckets + 31 * kSubBuckets;
+
+		struct Summary
+		{
+			uint64_t Count = 0;
+			uint64_t MeanUs = 0;
+			uint64_t P50Us = 0;
+			uint64_t P90Us = 0;
+			uint64_t P99Us = 0;
+			uint64_t P999Us = 0;
+			uint64_t MaxUs = 0;
+		};
+
+		static std::size_t GetBucket(uint64_t InValueUs);
+		static uint64_t    GetBucketLow(std::size_t InBucket);
+		static uint64_t    GetBucketHigh(std::size_t InBucket);
+
+		void Record(uint64_t InValueUs);
+
+		// Percentiles are the top of the bucket they fall in, never above the largest value.
+		// Read while others record, the figures may be a few samples apart.
+		Summary Summarize() const;
+
+		// Bucket counts as they are now, for the dump.
+		std::array<uint64_t, kBucketCount> GetCounts() const;
+
+	private:
+		std::array<std::atomic<uint64_t>, kBucketCount> Counts{};
+		std::atomic<uint64_t>                           Count = 0;
+		std::atomic<uint64_t>                           SumUs = 0;
+		std::atomic<uint64_t>                           MaxUs = 0;
+	};
+
+	// Extra counters for the dump, such as the backend's underruns.
+	using TelemetryFields = std::span<const std::pair<std::string_view, uint64_t>>;
+
+#if RADIO_TELEMETRY
+	void RecordLatency(Operation InOperation, std::chrono::steady_clock::duration InElapsed);
+	void CountEvent(Counter InCounter, uint64_t InAmount = 1);
+
+	// Starts the clock of an operation that ends when audio does (FirstAudio, Seek, Switch);
+	// OnAudioStarted stops every one that is running. A clock that ran for over a minute was
+	// left behind, and is dropped rather than recorded.
+	void ExpectAudio(Operation InOperation);
+	void CancelAudio(Operation InOperation);
+	bool IsExpectingAudio();
+	void OnAudioStarted();
+
+	// Every histogram and counter as JSON, InFields included.
+	std::string FormatTelemetry(TelemetryFields InFields);
+	bool        WriteTelemetry(const std::filesystem::path& InFile, TelemetryFields InFields);
+
+	// Records the time from construction to destruction under InOperation.
+	class ScopedTimer
+	{
+	public:
+		explicit ScopedTimer(Operation InOperation) :
+			Op(InOperation),
+			Start(std::chrono::steady_clock::now())
+		{
+		}
+
+		~ScopedTimer() { RecordLatency(Op, std::chrono::steady_clock::now() - Start); }
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		Operation                             Op;
+		std::chrono::steady_clock::time_point Start;
+	};
+#else
+	inline void RecordLatency(Operation, std::chrono::steady_clock::duration) {}
+	inline void CountEvent(Counter, uint64_t = 1) {}
+	inline void ExpectAudio(Operation) {}
+	inline void CancelAudio(Operation) {}
+	inline bool IsExpectingAudio() { return false; }
+	inline void OnAudioStarted() {}
+	inline std::string FormatTelemetry(TelemetryFields) { return {}; }
+	inline bool WriteTelemetry(const std::filesystem::path&, TelemetryFields) { return false; }
+
+	class ScopedTimer
+	{
+	public:
+		explicit ScopedTimer(Operation) {}
+	};
+#endif
+}
@@ -0,0 +1,128 @@
+#include "Control/ThreadRuntime.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace Control
+{
+	namespace
+	{
+		std::atomic<uint64_t> WorkerAffinity = 0;
+
+#if defined(_WIN32)
+		int GetRolePriority(ThreadRole InRole)
+		{
+			switch (InRole) {
+			case ThreadRole::Input:
+			case ThreadRole::Audio:
+				return THREAD_PRIORITY_ABOVE_NORMAL;
+			case ThreadRole::Render:
+				return THREAD_PRIORITY_TIME_CRITICAL;
+			case ThreadRole::Io:
+				return THREAD_PRIORITY_BELOW_NORMAL;
+			}
+			return THREAD_PRIORITY_NORMAL;
+		}
+
+		DWORD_PTR GetAffinityMask()
+		{
+			DWORD_PTR process = 0;
+			DWORD_PTR system = 0;
+			if (!GetProcessAffinityMask(GetCurrentProcess(), &process, &system))
+				return 0;
+
+			if (const uint64_t mask = WorkerAffinity.load(std::memory_order_relaxed); mask != 0)
+				return process & static_cast<DWORD_PTR>(mask);
+
+			// Drop the lowest core, unless that leaves too few to share with the game.
+			return std::popcount(process) > 2 ? process & (process - 1) : 0;
+		}
+#endif
+	}
+
+	void SetWorkerAffinity(uint64_t InMask)
+	{
+		WorkerAffinity.store(InMask, std::memory_order_relaxed);
+	}
+
+	void EnterThread(std::string_view InName, ThreadRole InRole)
+	{
+#if defined(_WIN32)
+		const std::wstring name(InName.begin(), InName.end());
+		SetThreadDescription(GetCurrentThread(), name.c_str());
+		SetThreadPriority(GetCurrentThread(), GetRolePriority(InRole));
+		if (const auto mask = GetAffinityMask(); mask != 0)
+			SetThreadAffinityMask(GetCurrentThread(), mask);
+#else
+		(void)InName;
+		(void)InRole;
+#endif
+	}
+
+	bool ThreadRuntime::Start(std::string InName, ThreadRole InRole, Body InBody)
+	{
+		std::lock_guard lock(Mutex);
+		if (Stopping)
+			return false;
+
+		std::size_t index = 0;
+		{
+			std::lock_guard exitLock(Finished->Mutex);
+			index = Finished->Done.size();
+			Finished->Done.push_back(false);
+		}
+
+		auto thread = std::jthread([exits = Finished, index, name = InName, InRole, body = std::move(InBody)](std::stop_token InStop) {
+			EnterThread(name, InRole);
+			body(InStop);
+
+			{
+				std::lock_guard exitLock(exits->Mutex);
+				exits->Done[index] = true;
+			}
+			exits->Changed.notify_all();
+		});
+		Workers.push_back({ std::move(InName), std::move(thread) });
+		return true;
+	}
+
+	bool ThreadRuntime::Shutdown(std::chrono::milliseconds InTimeout)
+	{
+		std::vector<Worker> workers;
+		{
+			std::lock_guard lock(Mutex);
+			Stopping = true;
+			workers.swap(Workers);
+		}
+		if (workers.empty())
+			return true;
+
+		for (auto& worker : workers)
+			worker.Thread.request_stop();
+
+		std::vector<bool> done;
+		{
+			std::unique_lock exitLock(Finished->Mutex);
+			Finished->Changed.wait_for(exitLock, InTimeout, [&] { return std::ranges::all_of(Finished->Done, std::identity{}); });
+			done = Finished->Done;
+		}
+
+		bool stopped = true;
+		for (std::size_t i = 0; i < workers.size(); ++i) {
+			if (done[i]) {
+				workers[i].Thread.join();
+			} else {
+				INFO("{} - Thread '{}' did not stop in time, leaving it behind", Plugin::NAME, workers[i].Name);
+				workers[i].Thread.detach();
+				stopped = false;
+			}
+		}
+		return stopped;
+	}
+
+	bool ThreadRuntime::IsStopping() const
+	{
+		std::lock_guard lock(Mutex);
+		return Stopping;
+	}
+}
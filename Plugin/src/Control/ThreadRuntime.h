@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Control
+{
+	// What a thread does decides its priority and which cores it may use.
+	enum class ThreadRole : uint8_t
+	{
+		Input,   // key handling; sleeps until a key changes
+		Audio,   // commands and decoding; must keep the output fed
+		Render,  // fills the output device; never waits on anything else
+		Io,      // disk and network work nobody is waiting on
+	};
+
+	// Cores the plugin's threads may run on, one bit per logical processor; 0 keeps them off
+	// the first core, where the game's main thread usually runs. Applies to threads that start
+	// afterwards.
+	void SetWorkerAffinity(uint64_t InMask);
+
+	// Names the calling thread and applies the priority and affinity of InRole. Every thread
+	// the plugin starts calls this first.
+	void EnterThread(std::string_view InName, ThreadRole InRole);
+
+	// Owns the plugin's long-lived threads. Each runs with a stop token; Shutdown asks all of
+	// them to stop and waits a bounded time, so quitting the game is never held up by a stuck
+	// connection. Threads that miss the deadline are detached and reported.
+	class ThreadRuntime
+	{
+	public:
+		using Body = std::function<void(std::stop_token)>;
+
+		static constexpr auto kShutdownTimeout = std::chrono::milliseconds(1000);
+
+		ThreadRuntime() = default;
+		~ThreadRuntime() { Shutdown(kShutdownTimeout); }
+
+		ThreadRuntime(const ThreadRuntime&) = delete;
+		ThreadRuntime& operator=(const ThreadRuntime&) = delete;
+
+		// Returns false once Shutdown has started.
+		bool Start(std::string InName, ThreadRole InRole, Body InBody);
+
+		// Safe to call more than once and from any thread but the runtime's own. Returns true
+		// when every thread stopped in time.
+		bool Shutdown(std::chrono::milliseconds InTimeout);
+
+		bool IsStopping() const;
+
+	private:
+		// Shared with the threads, so a detached one can still report that it finished.
+		struct Exits
+		{
+			std::mutex              Mutex;
+			std::condition_variable Changed;
+			std::vector<bool>       Done;
+		};
+
+		struct Worker
+		{
+			std::string  Name;
+			std::jthread Thread;
+		};
+
+		mutable std::mutex     Mutex;
+		std::shared_ptr<Exits> Finished = std::make_shared<Exits>();
+		std::vector<Worker>    Workers;
+		bool                   Stopping = false;
+	};
+}
@@ -1,722 +1,899 @@
-#include "DKUtil/Config.hpp"
-#include "DKUtil/Hook.hpp"
-#include "DKUtil/Logger.hpp"
-#include "SFSE/SFSE.h"
-#include "fmt/format.h"  // Ensure fmt is included
-
-// For MCI
-#include <Mmsystem.h>
-#include <mciapi.h>
-#pragma comment(lib, "Winmm.lib")
-
-// Formatting, string and console
-#include <codecvt>
-#include <algorithm>
-#include <ctime>
-#include <fstream>
-#include <filesystem>
-#include <iomanip>
-#include <iostream>
-#include <locale>
-#include <sstream>
-#include <string>
-#include <vector>
-
-static bool gIsInitialized = false;
-
-// For type aliases
-using namespace DKUtil::Alias;
-std::wstring to_wstring(const std::string& stringToConvert)
-{
-	std::wstring wideString =
-		std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(stringToConvert);
-	return wideString;
-}
-
-// Function to trim trailing commas and spaces
-std::string trimTrailingCommas(const std::string& str) {
-    std::string result = str;
-    // Remove trailing spaces
-    result.erase(result.find_last_not_of(" \t") + 1);
-    // Remove trailing commas
-    if (!result.empty() && result.back() == ',') {
-        result.pop_back();
-    }
-    return result;
-}
-
-std::string trim(const std::string& str) {
-    size_t first = str.find_first_not_of(" \t");
-    if (first == std::string::npos) return "";
-    size_t last = str.find_last_not_of(" \t");
-    return str.substr(first, (last - first + 1));
-}
-
-// Function to trim all items in the playlist
-void trimPlaylist(std::vector<std::string>& playlist) {
-    for (auto& song : playlist) {
-        song = trimTrailingCommas(song);
-    }
-}
-
-int hexStringToInt(const std::string& hexStr) {
-    int value = 0;
-    std::stringstream ss;
-    ss << std::hex << hexStr;  // Read the hex string
-    ss >> value;               // Convert to integer
-    return value;
-}
-
-void ConsoleExecute(std::string command)
-{
-	static REL::Relocation<void**>                       BGSScaleFormManager{ REL::ID(879512) };
-	static REL::Relocation<void (*)(void*, const char*)> ExecuteCommand{ REL::ID(166307) };
-	ExecuteCommand(*BGSScaleFormManager, command.data());
-}
-
-void Notification(std::string Message)
-{
-	std::string Command = fmt::format("cgf \"Debug.Notification\" \"{}\"", Message);
-	ConsoleExecute(Command);
-}
-
-// Structure to hold the configuration data
-struct Config {
-    bool autoStartRadio = true;
-    bool randomizeStartTime = true;
-    std::vector<std::string> playlist;
-    int toggleRadioKey = 0x60;
-    int switchModeKey = 0x6D;
-    int volumeUpKey = 0x69;
-    int volumeDownKey = 0x66;
-    int nextStationKey = 0x68;
-    int previousStationKey = 0x67;
-    int seekForwardKey = 0x6A;
-    int seekBackwardKey = 0x6F;
-};
-
-// Function to load the configuration from the TOML file
-void loadConfig(Config& config) {
-    std::ifstream configFile(".\\Data\\SFSE\\Plugins\\StarfieldGalacticRadio.toml");
-    if (!configFile.is_open()) {
-        INFO("Could not open configuration file!");
-        return;
-    }
-
-    std::string line;
-    while (std::getline(configFile, line)) {
-        std::istringstream lineStream(line);
-        std::string key;
-		line = trim(line);
-
-        if (line.find("AutoStartRadio") != std::string::npos) {
-            bool value;
-            lineStream >> key >> value;
-            config.autoStartRadio = value;
-            INFO("AutoStartRadio: {}", config.autoStartRadio);
-        } else if (line.find("RandomizeStartTime") != std::string::npos) {
-            bool value;
-            lineStream >> key >> value;
-            config.randomizeStartTime = value;
-            INFO("RandomizeStartTime: {}", config.randomizeStartTime);
-        } else if (line.find("Playlist =") != std::string::npos) {
-			config.playlist.clear();  // Clear any existing entries
-
-			// Now read each playlist item until we find a line containing ']'
-			while (std::getline(configFile, line)) {
-				line = trim(line);  // Trim whitespace from line
-
-				size_t closingBracketPos = line.find("]");
-				if (closingBracketPos != std::string::npos) {
-					// If ']' is found, take everything before it and break the loop
-					line = line.substr(0, closingBracketPos);
-				}
-
-				if (!line.empty()) {
-					line.erase(std::remove(line.begin(), line.end(), '"'), line.end()); // Remove quotes
-					config.playlist.push_back(line);
-					// INFO("Playlist item: {}", line);
-				}
-
-				// Break if we found ']' on this line
-				if (closingBracketPos != std::string::npos) {
-					break;
-				}
-			}
-		} else if (line.find("ToggleRadioKey=") != std::string::npos) {
-			config.toggleRadioKey = hexStringToInt(line.substr(line.find('=') + 1));
-		} else if (line.find("SwitchModeKey=") != std::string::npos) {
-			config.switchModeKey = hexStringToInt(line.substr(line.find('=') + 1));
-		} else if (line.find("VolumeUpKey=") != std::string::npos) {
-			config.volumeUpKey = hexStringToInt(line.substr(line.find('=') + 1));
-		} else if (line.find("VolumeDownKey=") != std::string::npos) {
-			config.volumeDownKey = hexStringToInt(line.substr(line.find('=') + 1));
-		} else if (line.find("NextStationKey=") != std::string::npos) {
-			config.nextStationKey = hexStringToInt(line.substr(line.find('=') + 1));
-		} else if (line.find("PreviousStationKey=") != std::string::npos) {
-			config.previousStationKey = hexStringToInt(line.substr(line.find('=') + 1));
-		} else if (line.find("SeekForwardKey=") != std::string::npos) {
-			config.seekForwardKey = hexStringToInt(line.substr(line.find('=') + 1));
-		} else if (line.find("SeekBackwardKey=") != std::string::npos) {
-			config.seekBackwardKey = hexStringToInt(line.substr(line.find('=') + 1));
-		}
-    }
-}
-
-// Function to print the loaded configuration
-void printConfig(const Config& config) {
-	
-    INFO("{} - AutoStartRadio: {}", Plugin::NAME, config.autoStartRadio);
-    INFO("{} - RandomizeStartTime: {}", Plugin::NAME, config.randomizeStartTime);
-    INFO("{} - Playlist:", Plugin::NAME);
-    for (const auto& song : config.playlist) {
-        INFO("{} playlist item - {}", Plugin::NAME, song);
-    }
-	INFO("{} - ToggleRadioKey: 0x{:X}", Plugin::NAME, config.toggleRadioKey);
-	INFO("{} - SwitchModeKey: 0x{:X}", Plugin::NAME, config.switchModeKey);
-	INFO("{} - VolumeUpKey: 0x{:X}", Plugin::NAME, config.volumeUpKey);
-	INFO("{} - VolumeDownKey: 0x{:X}", Plugin::NAME, config.volumeDownKey);
-	INFO("{} - NextStationKey: 0x{:X}", Plugin::NAME, config.nextStationKey);
-	INFO("{} - PreviousStationKey: 0x{:X}", Plugin::NAME, config.previousStationKey);
-	INFO("{} - SeekForwardKey: 0x{:X}", Plugin::NAME, config.seekForwardKey);
-	INFO("{} - SeekBackwardKey: 0x{:X}", Plugin::NAME, config.seekBackwardKey);
-}
-
-
-class RadioPlayer
-{
-public:
-	RadioPlayer(const std::vector<std::string>& InStations, bool InAutoStart, bool InRandomizeStartTime) :
-		AutoStart(InAutoStart),
-		RandomizeStartTime(InRandomizeStartTime),
-		Stations(InStations)
-	{
-	}
-
-	~RadioPlayer()
-	{
-	}
-
-	void Init()
-	{
-		srand(time(NULL));
-		randStart = rand() % (3600);
-		RadioStartTime = std::time(nullptr);
-
-		INFO("{} v{} - Initializing Starfield Radio Sound System -", Plugin::NAME, Plugin::Version);
-
-		if (Stations.size() <= 0) {
-			INFO("{} v{} - No Stations Found, Starfield Radio Shutting Down -", Plugin::NAME, Plugin::Version);
-			return;
-		}
-
-		INFO("{} v{} - Starting Starfield Radio -", Plugin::NAME, Plugin::Version);
-
-		if (!Stations.empty()) {
-			INFO("{} v{} - {} Stations Found, Starfield Radio operational -", Plugin::NAME, Plugin::Version, Stations.size());
-			StationIndex = rand() % Stations.size();
-			if (StationIndex >= Stations.size()) {
-				INFO("{} - Invalid StationIndex: {}, unable to select station.", Plugin::NAME, StationIndex);
-				return;
-			}
-		}
-
-		std::pair<std::string, std::string> StationInfo = GetStationInfo(Stations[StationIndex]);
-
-		if (!StationInfo.second.empty()) {
-			INFO("{} - Attempt to load file - {}", Plugin::NAME, StationInfo.second);
-			std::wstring OpenLocalFile;
-			if (StationInfo.second.find("://") != std::string::npos) {
-				OpenLocalFile = to_wstring(std::format("open {} type mpegvideo alias sfradio", StationInfo.second));
-			} else {
-				OpenLocalFile = to_wstring(std::format("open \".\\Data\\SFSE\\Plugins\\StarfieldGalacticRadio\\tracks\\{}\" type mpegvideo alias sfradio", StationInfo.second));
-			}
-			int result = mciSendString(OpenLocalFile.c_str(), NULL, 0, NULL);
-			if (result != 0) {
-				INFO("{} - mciSendString failed with code: {}", Plugin::NAME, result);
-				return;
-			}
-		} else {
-			// Лог или сообщение об ошибке
-			INFO("{} v{} - Station path is empty, unable to start playback -", Plugin::NAME, Plugin::Version);
-		}
-
-		if (!StationInfo.first.empty())
-			Notification(std::format("On Air - {}", StationInfo.first));
-
-		INFO("{} v{} - Selected Station {}, AutoStart: {}, Mode: {} -", Plugin::NAME, Plugin::Version, Stations[StationIndex], AutoStart, Mode);
-
-		if (AutoStart && Mode == 0) {
-			IsStarted = true;
-			//mciSendString(L"play sfradio repeat", NULL, 0, NULL);
-			int trackLength = getTrackLength();
-			INFO("{} - Track length: {}", Plugin::NAME, trackLength);
-
-			// Проверка корректности значения trackLength
-			if (trackLength > 0) {
-				mciSendString(to_wstring(std::format("play sfradio from {} repeat", (randStart % trackLength))).c_str(), NULL, 0, NULL);
-			} else {
-				// Лог или сообщение об ошибке для отладки
-				INFO("{} - Invalid track length: {}, playback cannot start", Plugin::NAME, trackLength);
-			}
-			//Notification(std::format("当前播放进度：{}%%", std::floor((static_cast<float>(randStart % getTrackLength()) * 100 / getTrackLength()) * 10) / 10.0f));
-			Notification(std::format("Play at: {}%%", std::floor((static_cast<float>(randStart % getTrackLength())*100 / getTrackLength()) * 10) / 10.0f));
-			mciSendString(L"setaudio sfradio volume to 0", NULL, 0, NULL);
-		}
-
-		Notification("银河电台初始化完成");
-		//Notification("Starfield Radio Initialized");
-	}
-
-	int32_t getElapsedTimeInSec()
-	{
-		std::time_t currentTime = std::time(nullptr);
-		return static_cast<int>(currentTime - RadioStartTime);
-	}
-
-	int32_t getTrackLength()
-	{
-		std::wstring StatusBuffer;
-		StatusBuffer.reserve(128);
-
-		mciSendString(L"status sfradio length", StatusBuffer.data(), 128, NULL);
-
-		// Convert Length to int
-		int32_t TrackLength = std::stoi(StatusBuffer);
-		StatusBuffer.clear();
-		return TrackLength;
-	}
-
-	void SelectStation(int InStationIndex)
-	{
-		// Index out of bounds.
-		if (Stations.size() <= InStationIndex)
-			return;
-
-		std::pair<std::string, std::string> StationInfo = GetStationInfo(Stations[InStationIndex]);
-
-		const std::string& StationName = StationInfo.first;
-		const std::string& StationURL = StationInfo.second;
-
-		mciSendString(L"close sfradio", NULL, 0, NULL);
-
-		if (StationURL.contains("://")) {
-			std::wstring OpenLocalFile = to_wstring(std::format("open {} type mpegvideo alias sfradio", StationURL));
-			int result = mciSendString(OpenLocalFile.c_str(), NULL, 0, NULL);
-			if (result != 0) {
-				INFO("{} - mciSendString failed with code: {}", Plugin::NAME, result);
-				return;
-			}
-			//Notification("正在连接至银河电台网络。由于跨星际传输，通讯可能存在延迟，请稍等。");
-			Notification("Connecting to Galactic Radio Network. Delay expected because of the inter-stellar communication.");
-		} else {
-			std::wstring OpenLocalFile = to_wstring(std::format("open \".\\Data\\SFSE\\Plugins\\StarfieldGalacticRadio\\tracks\\{}\" type mpegvideo alias sfradio", StationURL));
-			//Notification("在当前设备上检测到本地媒体文件，现在进行播放。");
-			Notification("Local media on your device found, playing right now.");
-			INFO("{} - Attempt to load file - {}", Plugin::NAME, StationURL);
-			int result = mciSendString(OpenLocalFile.c_str(), NULL, 0, NULL);
-			if (result != 0) {
-				INFO("{} - mciSendString failed with code: {}", Plugin::NAME, result);
-				return;
-			}
-		}
-
-		int32_t NewPosition = (getElapsedTimeInSec() % getTrackLength() + randStart) * 1000 % getTrackLength();
-
-		if (!StationInfo.first.empty())
-			Notification(std::format("On Air - {}", StationInfo.first));
-
-		// mciSendString(L"play sfradio repeat", NULL, 0, NULL);
-		//Notification(std::format("当前播放进度：{}%%", std::floor((static_cast<float>(NewPosition % getTrackLength()) * 100 / getTrackLength()) * 10) / 10.0f));
-		Notification(std::format("Play at: {}%%", std::floor((static_cast<float>(NewPosition % getTrackLength()) * 100 / getTrackLength()) * 10) / 10.0f));
-		mciSendString(to_wstring(std::format("play sfradio from {} repeat", NewPosition)).c_str(), NULL, 0, NULL);
-
-		std::wstring v = to_wstring(std::format("setaudio sfradio volume to {}", (int)Volume));
-		mciSendString(v.c_str(), NULL, 0, NULL);
-	}
-
-	void NextStation()
-	{
-		StationIndex = (StationIndex + 1) % Stations.size();
-
-		SelectStation(StationIndex);
-	}
-
-	void PrevStation()
-	{
-		StationIndex = (StationIndex - 1);
-		if (StationIndex < 0)
-			StationIndex = Stations.size() - 1;
-		SelectStation(StationIndex);
-	}
-
-	void SetVolume(float InVolume)
-	{
-		Volume = InVolume;
-		std::wstring v = to_wstring(std::format("setaudio sfradio volume to {}", (int)InVolume));
-		mciSendString(v.c_str(), NULL, 0, NULL);
-	}
-
-	void DecreaseVolume()
-	{
-		Volume = Volume - 25.0f;
-		std::wstring v = to_wstring(std::format("setaudio sfradio volume to {}", (int)Volume));
-		mciSendString(v.c_str(), NULL, 0, NULL);
-
-		Notification(std::format("Volume {}", Volume));
-	}
-
-	void IncreaseVolume()
-	{
-		Volume = Volume + 25.0f;
-		std::wstring v = to_wstring(std::format("setaudio sfradio volume to {}", (int)Volume));
-		mciSendString(v.c_str(), NULL, 0, NULL);
-
-		Notification(std::format("Volume {}", Volume));
-	}
-
-	uint32_t GetTrackLength()
-	{
-		std::wstring StatusBuffer;
-		StatusBuffer.reserve(128);
-
-		mciSendString(L"status sfradio length", StatusBuffer.data(), 128, NULL);
-
-		// Convert Length to int
-		uint32_t TrackLength = std::stoi(StatusBuffer);
-
-		return TrackLength;
-	}
-
-	void Seek(int32_t InSeconds)
-	{
-		// Get current position from MCI with mciSendString
-		std::wstring StatusBuffer;
-		StatusBuffer.reserve(128);
-
-		mciSendString(L"status sfradio length", StatusBuffer.data(), 128, NULL);
-
-		// Convert Length to int
-		int32_t TrackLength = std::stoi(StatusBuffer);
-		StatusBuffer.clear();
-		StatusBuffer.reserve(128);
-		mciSendString(L"status sfradio position", StatusBuffer.data(), 128, NULL);
-
-		int32_t Position = 0;
-
-		if (StatusBuffer.contains(L":")) {
-			std::tm             t;
-			std::wistringstream ss(StatusBuffer);
-			ss >> std::get_time(&t, L"%H:%M:%S");
-			Position = t.tm_hour * 3600 + t.tm_min * 60 + t.tm_sec;
-		} else {
-			Position = std::stoi(StatusBuffer);
-		}
-
-		int32_t NewPosition = Position + (InSeconds * 1000);
-
-		if (NewPosition >= TrackLength)
-			NewPosition = TrackLength - 1;
-
-		mciSendString(to_wstring(std::format("play sfradio from {} repeat", (int)NewPosition)).c_str(), NULL, 0, NULL);
-	}
-
-	void TogglePlayer()
-	{
-		ENABLE_DEBUG
-
-		IsPlaying = !IsPlaying;
-		if (!IsStarted && IsPlaying) {
-			IsStarted = true;
-			mciSendString(L"play sfradio repeat", NULL, 0, NULL);
-
-			if (RandomizeStartTime) {
-				uint32_t TrackLength = GetTrackLength();
-				srand(time(NULL));
-				uint32_t RandomTime = rand() % TrackLength;
-
-				Seek(RandomTime);
-			}
-		}
-
-		std::pair<std::string, std::string> StationInfo = GetStationInfo(Stations[StationIndex]);
-
-		if (IsPlaying) {
-			if (!StationInfo.first.empty())
-				Notification(std::format("On Air - {}", StationInfo.first));
-			else
-				Notification("Radio On");
-		} else
-			Notification("Radio Off");
-
-		if (Mode == 0) {
-			std::wstring v = to_wstring(std::format("setaudio sfradio volume to {}", (int)IsPlaying ? Volume : 0.0f));
-			mciSendString(v.c_str(), NULL, 0, NULL);
-		} else {
-			if (!IsPlaying) {
-				mciSendString(L"stop sfradio", NULL, 0, NULL);
-			} else {
-				mciSendString(L"play sfradio repeat", NULL, 0, NULL);
-				if (RandomizeStartTime) {
-					uint32_t TrackLength = GetTrackLength();
-					srand(time(NULL));
-					uint32_t RandomTime = rand() % TrackLength;
-
-					Seek(RandomTime);
-				}
-				std::wstring v = to_wstring(std::format("setaudio sfradio volume to {}", (int)Volume));
-				mciSendString(v.c_str(), NULL, 0, NULL);
-			}
-		}
-	}
-
-	// 0 = Radio, 1 = Podcast
-	void ToggleMode()
-	{
-		Mode = ~Mode;
-
-		// Handle Podcast vs Radio mode.
-		// Podcast mode will actually stop the stream, while Radio mode just mutes it so that time passes when not listened to.
-	}
-
-	std::pair<std::string, std::string> GetStationInfo(const std::string& StationConfig)
-	{
-		std::string Station = StationConfig;
-		size_t      Separator = Station.find("|");
-
-		std::string StationName = Separator != std::string::npos ? Station.substr(0, Station.find("|")) : "";
-		std::string StationURL = Separator != std::string::npos ? Station.substr(Station.find("|") + 1) : Station;
-
-		return std::make_pair(StationName, StationURL);
-	}
-
-private:
-	int   Mode = 0;
-	int   StationIndex = 0;
-	float Volume = 700.0f;
-	float Seconds = 0.0f;
-	bool  RandomizeStartTime = false;
-	bool  AutoStart = true;
-	bool  IsStarted = false;
-	bool  IsPlaying = false;
-
-	std::vector<std::string> Stations;
-	std::time_t              RadioStartTime;
-	int32_t                  randStart;
-};
-
-const int    TimePerFrame = 50;
-static DWORD MainLoop(void* unused)
-{
-	(void)unused;
-
-	ENABLE_DEBUG
-
-	DEBUG("Input Loop Starting");
-	
-	std::string configFilename = "StarfieldGalacticRadio.toml";
-
-    Config config; // Create a Config instance
-    loadConfig(config); // Load configuration from file
-	
-	trimPlaylist(config.playlist);
-	// printConfig(config);
-
-
-	DEBUG("Loaded config, waiting for player form...");
-	while (!RE::TESForm::LookupByID(0x14))
-		Sleep(1000);
-
-	DEBUG("Pre-Initialize RadioPlayer.");
-
-	RadioPlayer Radio(config.playlist, config.autoStartRadio, config.randomizeStartTime);
-	Radio.Init();
-
-	DEBUG("Post-Initialize RadioPlayer.")
-
-	bool ToggleRadioHoldFlag = false;
-	bool SwitchModeHoldFlag = false;
-	bool VolumeUpHoldFlag = false;
-	bool VolumeDownHoldFlag = false;
-	bool NextStationHoldFlag = false;
-	bool PrevStationHoldFlag = false;
-	bool SeekForwardHoldFlag = false;
-	bool SeekBackwardHoldFlag = false;
-
-	for (;;) {
-		// Get current key states
-		short ToggleRadioKeyState = GetKeyState(config.toggleRadioKey);
-		short SwitchModeKeyState = GetKeyState(config.switchModeKey);
-		short VolumeUpKeyState = GetKeyState(config.volumeUpKey);
-		short VolumeDownKeyState = GetKeyState(config.volumeDownKey);
-		short NextStationKeyState = GetKeyState(config.nextStationKey);
-		short PrevStationKeyState = GetKeyState(config.previousStationKey);
-		short SeekForwardKeyState = GetKeyState(config.seekForwardKey);
-		short SeekBackwardKeyState = GetKeyState(config.seekBackwardKey);
-		
-		// INFO("ToggleRadioKeyState: {}\nSwitchModeKeyState: {}\nVolumeUpKeyState: {}\nVolumeDownKeyState: {}\nNextStationKeyState: {}\nPrevStationKeyState: {}\nSeekForwardKeyState: {}\nSeekBackwardKeyState: {}", ToggleRadioKeyState, SwitchModeKeyState, VolumeUpKeyState, VolumeDownKeyState, NextStationKeyState, PrevStationKeyState, SeekForwardKeyState, SeekBackwardKeyState);
-
-		// Handle toggle logic based on key states
-		if (ToggleRadioKeyState < 0) { // Key is pressed
-			if (!ToggleRadioHoldFlag) {
-				ToggleRadioHoldFlag = 1; // Set the hold flag
-				Radio.TogglePlayer(); // Perform action
-			}
-		} else {
-			ToggleRadioHoldFlag = 0; // Reset hold flag when key is released
-		}
-
-		if (SwitchModeKeyState < 0) {
-			if (!SwitchModeHoldFlag) {
-				SwitchModeHoldFlag = 1;
-				Radio.ToggleMode();
-			}
-		} else {
-			SwitchModeHoldFlag = 0;
-		}
-
-		if (VolumeUpKeyState < 0) {
-			if (!VolumeUpHoldFlag) {
-				VolumeUpHoldFlag = 1;
-				Radio.IncreaseVolume();
-			}
-		} else {
-			VolumeUpHoldFlag = 0;
-		}
-
-		if (VolumeDownKeyState < 0) {
-			if (!VolumeDownHoldFlag) {
-				VolumeDownHoldFlag = 1;
-				Radio.DecreaseVolume();
-			}
-		} else {
-			VolumeDownHoldFlag = 0;
-		}
-
-		if (NextStationKeyState < 0) {
-			if (!NextStationHoldFlag) {
-				NextStationHoldFlag = 1;
-				Radio.NextStation();
-			}
-		} else {
-			NextStationHoldFlag = 0;
-		}
-
-		if (PrevStationKeyState < 0) {
-			if (!PrevStationHoldFlag) {
-				PrevStationHoldFlag = 1;
-				Radio.PrevStation();
-			}
-		} else {
-			PrevStationHoldFlag = 0;
-		}
-
-		if (SeekForwardKeyState < 0) {
-			if (!SeekForwardHoldFlag) {
-				SeekForwardHoldFlag = 1;
-				Radio.Seek(10);
-			}
-		} else {
-			SeekForwardHoldFlag = 0;
-		}
-
-		if (SeekBackwardKeyState < 0) {
-			if (!SeekBackwardHoldFlag) {
-				SeekBackwardHoldFlag = 1;
-				Radio.Seek(-10);
-			}
-		} else {
-			SeekBackwardHoldFlag = 0;
-		}
-
-		// Delay to control frame rate
-		Sleep(TimePerFrame);
-	}
-
-	return 0;
-}
-
-class OpenCloseSink final :
-	public RE::BSTEventSink<RE::MenuOpenCloseEvent>
-{
-public:
-	static OpenCloseSink* GetSingleton()
-	{
-		static OpenCloseSink self;
-		return std::addressof(self);
-	}
-
-	RE::BSEventNotifyControl ProcessEvent(RE::MenuOpenCloseEvent const& a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>* a_eventSource)
-	{
-		if (a_event.menuName == "HUDMenu" && a_event.opening && !gIsInitialized) {
-			INFO("Creating Input Thread")
-			CreateThread(NULL, 0, MainLoop, NULL, 0, NULL);
-
-			gIsInitialized = true;
-		}
-
-		return RE::BSEventNotifyControl::kContinue;
-	}
-};
-
-DLLEXPORT constinit auto SFSEPlugin_Version = []() noexcept {
-	SFSE::PluginVersionData data{};
-
-	data.PluginVersion(Plugin::Version);
-	data.PluginName(Plugin::NAME);
-	data.AuthorName(Plugin::AUTHOR);
-	//data.UsesSigScanning(true);
-	data.UsesAddressLibrary(true);
-	//data.HasNoStructUse(true);
-	data.IsLayoutDependent(true);
-	data.CompatibleVersions({ SFSE::RUNTIME_LATEST });
-
-	return data;
-}();
-
-namespace
-{
-	void MessageCallback(SFSE::MessagingInterface::Message* a_msg) noexcept
-	{
-		switch (a_msg->type) {
-		case SFSE::MessagingInterface::kPostLoad:
-			{
-				if (const auto ui = RE::UI::GetSingleton(); ui) {
-					ui->RegisterSink<RE::MenuOpenCloseEvent>(OpenCloseSink::GetSingleton());
-				}
-
-				break;
-			}
-		default:
-			break;
-		}
-	}
-}
-
-/**
-// for preload plugins
-void SFSEPlugin_Preload(SFSE::LoadInterface* a_sfse);
-/**/
-
-DLLEXPORT bool SFSEAPI SFSEPlugin_Load(const SFSE::LoadInterface* a_sfse)
-{
-#ifndef NDEBUG
-	while (!IsDebuggerPresent()) {
-		Sleep(100);
-	}
-#endif
-
-	SFSE::Init(a_sfse, false);
-
-	DKUtil::Logger::Init(Plugin::NAME, std::to_string(Plugin::Version));
-
-	INFO("{} v{} loaded", Plugin::NAME, Plugin::Version);
-
-	// do stuff
-	SFSE::AllocTrampoline(1 << 10);
-
-	SFSE::GetMessagingInterface()->RegisterListener(MessageCallback);
-
-	return true;
-}
-
+#include "DKUtil/Config.hpp"
+#include "DKUtil/Hook.hpp"
+#include "DKUtil/Logger.hpp"
+#include "SFSE/SFSE.h"
+#include "fmt/format.h"  // Ensure fmt is included
+
+// Audio engine
+#include "Audio/AudioBackend.h"
+#include "Audio/FolderSpec.h"
+#include "Audio/Gain.h"
+#include "Audio/Platform.h"
+#include "Config/ConfigStore.h"
+#include "Config/ConfigWatcher.h"
+#include "Config/RadioConfig.h"
+#include "Control/BroadcastSchedule.h"
+#include "Control/CommandQueue.h"
+#include "Control/GameExitHook.h"
+#include "Control/KeyBindings.h"
+#include "Control/KeyboardHook.h"
+#include "Control/MenuTracker.h"
+#include "Control/MessageQueue.h"
+#include "Control/NowPlaying.h"
+#include "Control/Rotation.h"
+#include "Control/StateJournal.h"
+#include "Control/Telemetry.h"
+#include "Control/ThreadRuntime.h"
+
+// Formatting, string and console
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <locale>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static bool gIsInitialized = false;
+
+// Menu state follows the game's menu events from plugin load; the backend picks it up once
+// MainLoop has created it. Menu events arrive on the game's thread, so the backend is only
+// used, published and withdrawn under gBackendMutex: once MainLoop has withdrawn it, no
+// event is still passing state to it while it is destroyed.
+static Control::MenuTracker gMenuTracker;
+static std::mutex           gBackendMutex;
+static Audio::AudioBackend* gBackend = nullptr;
+
+// Every long-lived thread the plugin starts itself; stopped when the game quits.
+static Control::ThreadRuntime gThreads;
+
+// For type aliases
+using namespace DKUtil::Alias;
+
+static void PublishBackend(Audio::AudioBackend* InBackend)
+{
+	std::lock_guard Lock(gBackendMutex);
+	gBackend = InBackend;
+	if (gBackend)
+		gBackend->SetGameState(gMenuTracker.GetState());
+}
+
+void ConsoleExecute(std::string command)
+{
+	static REL::Relocation<void**>                       BGSScaleFormManager{ REL::ID(879512) };
+	static REL::Relocation<void (*)(void*, const char*)> ExecuteCommand{ REL::ID(166307) };
+	ExecuteCommand(*BGSScaleFormManager, command.data());
+}
+
+// Shown on the HUD by the message thread, which keeps only the newest of a burst per category.
+template <class... Args>
+void Notification(Control::MessageCategory InCategory, std::format_string<Args...> InFormat, Args&&... InArgs)
+{
+	Control::Notify(InCategory, InFormat, std::forward<Args>(InArgs)...);
+}
+
+// Runs on the message thread, for whatever Control::MessageQueue lets through.
+void DeliverMessage(Control::MessageCategory InCategory, std::string_view InText)
+{
+	if (InCategory == Control::MessageCategory::Log) {
+		INFO("{}", InText);
+		return;
+	}
+
+	// The console command is quoted; a quote in the text would end it early.
+	std::string Text(InText);
+	std::ranges::replace(Text, '"', '\'');
+	std::string Command = std::format("cgf \"Debug.Notification\" \"{}\"", Text);
+
+	// The scaleform manager belongs to the game's main thread. An SFSE without the task
+	// interface gets the command from here, as before.
+	if (const auto* Tasks = SFSE::GetTaskInterface()) {
+		Tasks->AddTask([Command = std::move(Command)] { ConsoleExecute(Command); });
+	} else {
+		ConsoleExecute(std::move(Command));
+	}
+}
+
+class RadioPlayer
+{
+public:
+	RadioPlayer(ConfigStore& InConfig, std::unique_ptr<Audio::AudioBackend> InBackend, std::unique_ptr<Audio::MetadataStore> InMetadata) :
+		ConfigReader(InConfig),
+		Titles([](std::string_view InTitle) { Notification(Control::MessageCategory::Title, "Now Playing - {}", InTitle); }),
+		Backend(std::move(InBackend)),
+		Metadata(std::move(InMetadata)),
+		Journal(kJournalPath),
+		Restored(Journal.Load()),
+		Schedule(Restored ? Restored->ScheduleSeed : (uint64_t(std::random_device{}()) << 32) | std::random_device{}()),
+		Rng(Schedule.GetSeed() ^ (Restored ? Restored->ElapsedMs : 0))
+	{
+		Audio::SetStreamTitleHandler([this](std::string_view InSource, std::string_view InTitle) { Titles.OnTitle(InSource, InTitle); });
+
+		// The last session's broadcast carries on; its station is picked up in Init.
+		if (Restored) {
+			Schedule.Resume(Restored->ElapsedMs);
+			Volume = std::clamp(Restored->Volume, 0.0f, 1000.0f);
+			Mode = Restored->Mode;
+		}
+	}
+
+	~RadioPlayer()
+	{
+		Audio::SetStreamTitleHandler({});
+		Journal.Compact(CaptureState());
+	}
+
+	void Init()
+	{
+		RefreshConfig();
+
+		INFO("{} v{} - Initializing Starfield Radio Sound System -", Plugin::NAME, Plugin::Version);
+
+		if (Stations->empty()) {
+			INFO("{} v{} - No Stations Found, Starfield Radio Shutting Down -", Plugin::NAME, Plugin::Version);
+			return;
+		}
+
+		INFO("{} v{} - Starting Starfield Radio -", Plugin::NAME, Plugin::Version);
+
+		INFO("{} v{} - {} Stations Found, Starfield Radio operational -", Plugin::NAME, Plugin::Version, Stations->size());
+		// The last session's station if it is still in the playlist, a random one otherwise.
+		const int SavedIndex = Restored ? Stations->Find(Restored->StationKey) : -1;
+		StationIndex = SavedIndex >= 0 ? SavedIndex : static_cast<int>(Rng.Below(static_cast<uint32_t>(Stations->size())));
+
+		const Station& Current = (*Stations)[StationIndex];
+		OnAir = Current.Key;
+
+		INFO("{} - Attempt to load file - {}", Plugin::NAME, Current.Source);
+		if (!OpenStation(Current)) {
+			INFO("{} - Unable to open station - {}", Plugin::NAME, Current.Source);
+			return;
+		}
+
+		PrefetchNeighbors();
+
+		if (!Current.Name.empty())
+			Notification(Control::MessageCategory::Station, "On Air - {}", Current.Name);
+		if (Current.IsFolder)
+			AnnounceTrack(OnAirTrack);
+		Titles.SetOnAir(Current.Source);
+
+		INFO("{} v{} - Selected Station {}, AutoStart: {}, Mode: {} -", Plugin::NAME, Plugin::Version, Current.Source, AutoStart, Mode);
+
+		if (AutoStart && Mode == 0) {
+			IsStarted = true;
+			const uint32_t position = GetOnAirPosition(Current);
+			const uint32_t trackLength = GetOnAirLength(Current);
+			INFO("{} - Track length: {}", Plugin::NAME, trackLength);
+
+			// Проверка корректности значения trackLength
+			if (trackLength > 0) {
+				Backend->SetVolume(0.0f);
+				Backend->PlayFrom(position);
+				//Notification(std::format("当前播放进度：{}%%", std::floor((static_cast<float>(position) * 100 / trackLength) * 10) / 10.0f));
+				Notification(Control::MessageCategory::Seek, "Play at: {}%%", std::floor((static_cast<float>(position) * 100 / trackLength) * 10) / 10.0f);
+			} else {
+				// Лог или сообщение об ошибке для отладки
+				INFO("{} - Invalid track length: {}, playback cannot start", Plugin::NAME, trackLength);
+			}
+		}
+
+		Notification(Control::MessageCategory::Status, "银河电台初始化完成");
+		//Notification("Starfield Radio Initialized");
+	}
+
+	// Where InStation is on air now. The track length comes from the metadata store, or from
+	// the backend for tracks not scanned yet, once per station; after that the schedule has it.
+	// A folder station's position in its track was found when the track was opened.
+	uint32_t GetOnAirPosition(const Station& InStation)
+	{
+		if (InStation.IsFolder)
+			return OnAirTrackPositionMs;
+
+		if (Schedule.GetDurationMs(InStation.Key) == 0) {
+			const auto                  Table = Metadata->GetTable();
+			const Audio::TrackMetadata* Track = Table->Find(InStation.Source);
+			Schedule.SetDurationMs(InStation.Key, Track && Track->DurationMs > 0 ? Track->DurationMs : Backend->GetLengthMs());
+		}
+		return Schedule.GetPositionMs(InStation.Key);
+	}
+
+	// Length of what InStation is playing: the station's track, or one track of a folder.
+	uint32_t GetOnAirLength(const Station& InStation) const
+	{
+		return InStation.IsFolder ? OnAirTrackMs : Schedule.GetDurationMs(InStation.Key);
+	}
+
+	int32_t getTrackLength()
+	{
+		const int OnAirIndex = Stations->Find(OnAir);
+		return static_cast<int32_t>(OnAirIndex >= 0 ? GetOnAirLength((*Stations)[OnAirIndex]) : Schedule.GetDurationMs(OnAir));
+	}
+
+	// Lays out the rotation of a folder station from its scanned tracks, when it is tuned in
+	// or the library changed since. Tracks of unknown length are left out. A station keeps its
+	// clock while its tracks stay the same, so tuning back in or a scan of other folders does
+	// not walk the rotation again from the start of the broadcast.
+	bool PrepareRotation(const Station& InStation)
+	{
+		const auto      Table = Metadata->GetTable();
+		FolderRotation& Rotation = FolderRotations[InStation.Key];
+		FolderStation = InStation.Key;
+		if (Rotation.Clock && Rotation.Table == Table)
+			return true;
+
+		// Categories come from the folders right below the station's.
+		const std::size_t                   RootLength = Audio::ParseFolderSpec(InStation.Source).Root.u8string().size();
+		std::vector<std::string>            Tracks;
+		std::vector<uint32_t>               Lengths;
+		std::vector<Control::TrackCategory> Categories;
+		uint64_t                            CycleMs = 0;
+		for (const auto& Track : Table->GetFolder(InStation.Source)) {
+			const Audio::TrackMetadata* Entry = Table->Find(Track);
+			if (!Entry || Entry->DurationMs == 0)
+				continue;
+
+			Tracks.push_back(Track);
+			Lengths.push_back(Entry->DurationMs);
+			Categories.push_back(Control::GetTrackCategory(std::string_view(Track).substr(RootLength)));
+			CycleMs += Entry->DurationMs;
+		}
+		if (Tracks.empty()) {
+			FolderRotations.erase(InStation.Key);
+			return false;
+		}
+
+		// One pass through the folder spreads the stations' offsets, as a track's length does.
+		Schedule.SetDurationMs(InStation.Key, static_cast<uint32_t>(std::min<uint64_t>(CycleMs, UINT32_MAX)));
+
+		const uint64_t Seed = Schedule.GetSeed() ^ InStation.Key;
+		Rotation.Table = Table;
+		if (Rotation.Clock && Rotation.Tracks == Tracks && Rotation.Clock->Matches(Seed, Lengths, Categories, Weights))
+			return true;
+
+		Rotation.Tracks = std::move(Tracks);
+		Rotation.Clock = std::make_unique<Control::RotationClock>(Seed, std::move(Lengths), Categories, Weights);
+		return true;
+	}
+
+	// A folder station plays its tracks in rotation (see Control::Rotation) on the broadcast
+	// schedule: the track on air is wherever the station's time falls in the rotation. When
+	// the track found is InAfter, which just ended while the clock still places it on air for
+	// a moment, the one following it starts from the top instead.
+	bool FindFolderTrack(const Station& InStation, std::string_view InAfter, std::string& OutTrack, uint32_t& OutPositionMs, uint32_t& OutLengthMs)
+	{
+		if (!PrepareRotation(InStation))
+			return false;
+
+		const FolderRotation&        Rotation = FolderRotations[InStation.Key];
+		const uint64_t               StationTimeMs = Schedule.GetStationTimeMs(InStation.Key);
+		Control::RotationClock::Slot Slot = Rotation.Clock->Find(StationTimeMs);
+		if (Rotation.Tracks[Slot.Track] == InAfter)
+			Slot = Rotation.Clock->Find(StationTimeMs - Slot.PositionMs + Rotation.Clock->GetLengthMs(Slot.Track));
+
+		OutTrack = Rotation.Tracks[Slot.Track];
+		OutPositionMs = Slot.PositionMs;
+		OutLengthMs = Rotation.Clock->GetLengthMs(Slot.Track);
+		return true;
+	}
+
+	// Opens InStation, or for a folder station the track on air in it (see FindFolderTrack).
+	bool OpenStation(const Station& InStation, std::string_view InAfter = {})
+	{
+		std::string_view Source = InStation.Source;
+		if (InStation.IsFolder) {
+			if (!FindFolderTrack(InStation, InAfter, OnAirTrack, OnAirTrackPositionMs, OnAirTrackMs)) {
+				Control::Log("{} - No tracks found in folder yet - {}", Plugin::NAME, InStation.Source);
+				return false;
+			}
+			Source = OnAirTrack;
+		}
+
+		Backend->SetLooping(!InStation.IsFolder);
+		const Control::ScopedTimer Timer(Control::Operation::Open);
+		return Backend->Open(Source);
+	}
+
+	// "On Air - Artist - Title" from the tags of a local track, if it has any.
+	void AnnounceTrack(std::string_view InSource)
+	{
+		const auto                  Table = Metadata->GetTable();
+		const Audio::TrackMetadata* Track = Table->Find(InSource);
+		if (!Track || Track->Title.empty())
+			return;
+
+		if (Track->Artist.empty())
+			Notification(Control::MessageCategory::Title, "On Air - {}", Track->Title);
+		else
+			Notification(Control::MessageCategory::Title, "On Air - {} - {}", Track->Artist, Track->Title);
+	}
+
+	// The track of the folder station on air finished playing; the next one goes on air.
+	void PlayNextTrack()
+	{
+		const int OnAirIndex = Stations->Find(OnAir);
+		if (OnAirIndex < 0 || !(*Stations)[OnAirIndex].IsFolder)
+			return;
+
+		const Station&    Current = (*Stations)[OnAirIndex];
+		const std::string Finished = OnAirTrack;
+		if (!OpenStation(Current, Finished)) {
+			Control::Log("{} - Unable to open station - {}", Plugin::NAME, Current.Source);
+			return;
+		}
+
+		PrefetchNeighbors();
+		AnnounceTrack(OnAirTrack);
+		Backend->PlayFrom(OnAirTrackPositionMs);
+	}
+
+	// InHandler runs on a backend thread when a folder station's track ends; empty to clear.
+	void SetTrackEndHandler(std::function<void()> InHandler)
+	{
+		Backend->SetTrackEndHandler(std::move(InHandler));
+	}
+
+	void SelectStation(int InStationIndex)
+	{
+		// Index out of bounds.
+		if (InStationIndex < 0 || Stations->size() <= static_cast<std::size_t>(InStationIndex))
+			return;
+
+		const Station& Current = (*Stations)[InStationIndex];
+		OnAir = Current.Key;
+		Control::ExpectAudio(Control::Operation::Switch);
+
+		if (Current.IsRemote) {
+			//Notification("正在连接至银河电台网络。由于跨星际传输，通讯可能存在延迟，请稍等。");
+			Notification(Control::MessageCategory::Station, "Connecting to Galactic Radio Network. Delay expected because of the inter-stellar communication.");
+		} else {
+			//Notification("在当前设备上检测到本地媒体文件，现在进行播放。");
+			Notification(Control::MessageCategory::Station, "Local media on your device found, playing right now.");
+			Control::Log("{} - Attempt to load file - {}", Plugin::NAME, Current.Source);
+		}
+
+		if (!OpenStation(Current)) {
+			Control::Log("{} - Unable to open station - {}", Plugin::NAME, Current.Source);
+			Control::CancelAudio(Control::Operation::Switch);
+			return;
+		}
+
+		PrefetchNeighbors();
+
+		const uint32_t NewPosition = GetOnAirPosition(Current);
+		const uint32_t TrackLength = GetOnAirLength(Current);
+
+		// Unnamed local tracks, and the tracks of folder stations, are announced by their tags.
+		if (!Current.Name.empty())
+			Notification(Control::MessageCategory::Station, "On Air - {}", Current.Name);
+		if (Current.IsFolder)
+			AnnounceTrack(OnAirTrack);
+		else if (Current.Name.empty())
+			AnnounceTrack(Current.Source);
+		Titles.SetOnAir(Current.Source);
+
+		if (TrackLength > 0) {
+			//Notification(std::format("当前播放进度：{}%%", std::floor((static_cast<float>(NewPosition) * 100 / TrackLength) * 10) / 10.0f));
+			Notification(Control::MessageCategory::Seek, "Play at: {}%%", std::floor((static_cast<float>(NewPosition) * 100 / TrackLength) * 10) / 10.0f);
+		}
+
+		Backend->SetVolume(GetGain());
+		Backend->PlayFrom(NewPosition);
+	}
+
+	// Moves InDelta stations forward (negative = backward), wrapping around, with a single open.
+	void StepStation(int InDelta)
+	{
+		if (Stations->empty())
+			return;
+
+		const int StationCount = static_cast<int>(Stations->size());
+		StationIndex = ((StationIndex + InDelta) % StationCount + StationCount) % StationCount;
+
+		SelectStation(StationIndex);
+	}
+
+	// Keeps the stations around the current one warm so stepping to them is instant, and the
+	// next track of a folder station so it starts without a gap.
+	void PrefetchNeighbors()
+	{
+		std::array<std::string_view, 2 * kMaxPrefetchStations + 1> Sources;
+		std::size_t                                               Count = 0;
+
+		if (StationIndex >= 0 && static_cast<std::size_t>(StationIndex) < Stations->size() && (*Stations)[StationIndex].Key == FolderStation) {
+			if (const auto Found = FolderRotations.find(FolderStation); Found != FolderRotations.end() && Found->second.Clock)
+				Sources[Count++] = Found->second.Tracks[Found->second.Clock->GetUpcoming(1)[0]];
+		}
+
+		Count = Stations->GatherNeighbors(StationIndex, PrefetchStations, Sources, Count);
+		Backend->Prefetch({ Sources.data(), Count }, PrefetchBudget);
+	}
+
+	void NextStation()
+	{
+		StepStation(1);
+	}
+
+	void PrevStation()
+	{
+		StepStation(-1);
+	}
+
+	// Volume is a 0..1000 control position; the backend gets it through the dB curve.
+	float GetGain() const
+	{
+		return Audio::VolumeToGain(Volume / 1000.0f);
+	}
+
+	void SetVolume(float InVolume)
+	{
+		Volume = std::clamp(InVolume, 0.0f, 1000.0f);
+		Backend->SetVolume(GetGain());
+	}
+
+	// InSteps volume steps of 25 up (positive) or down (negative).
+	void AdjustVolume(int InSteps)
+	{
+		Volume = std::clamp(Volume + 25.0f * InSteps, 0.0f, 1000.0f);
+		Backend->SetVolume(GetGain());
+
+		Notification(Control::MessageCategory::Volume, "Volume {}", Volume);
+	}
+
+	void DecreaseVolume()
+	{
+		AdjustVolume(-1);
+	}
+
+	void IncreaseVolume()
+	{
+		AdjustVolume(1);
+	}
+
+	void Execute(const Control::RadioCommand& InCommand)
+	{
+		RefreshConfig();
+
+		switch (InCommand.Action) {
+		case Control::RadioAction::TogglePlayer:
+			TogglePlayer();
+			break;
+		case Control::RadioAction::ToggleMode:
+			ToggleMode();
+			break;
+		case Control::RadioAction::Volume:
+			AdjustVolume(InCommand.Amount);
+			break;
+		case Control::RadioAction::Station:
+			StepStation(InCommand.Amount);
+			break;
+		case Control::RadioAction::Seek:
+			Seek(InCommand.Amount);
+			break;
+		case Control::RadioAction::ShowStats:
+			ShowStats();
+			break;
+		case Control::RadioAction::TrackEnded:
+			PlayNextTrack();
+			break;
+		case Control::RadioAction::Tick:
+			Journal.Flush();
+			break;
+		}
+
+		Journal.Record(CaptureState());
+	}
+
+	Control::ListeningState CaptureState() const
+	{
+		return { OnAir, Volume, Mode, Schedule.GetSeed(), Schedule.GetElapsedMs() };
+	}
+
+	void ShowStats()
+	{
+		const Audio::PlaybackStats Stats = Backend->GetStats();
+		const double               SamplesPerSecond = double(Stats.SampleRate) * Stats.Channels;
+		const auto                 ToSeconds = [&](std::size_t InSamples) { return SamplesPerSecond > 0 ? InSamples / SamplesPerSecond : 0.0; };
+
+		Control::Log("{} - Buffer: {} of {} samples, high water {}, {} underruns, {} overruns", Plugin::NAME, Stats.Buffered, Stats.Capacity, Stats.HighWater, Stats.Underruns, Stats.Overruns);
+		Notification(Control::MessageCategory::Status, "Radio buffer {:.1f}s (peak {:.1f}s), {} underruns, {} overruns", ToSeconds(Stats.Buffered), ToSeconds(Stats.HighWater), Stats.Underruns, Stats.Overruns);
+
+#if RADIO_TELEMETRY
+		const std::pair<std::string_view, uint64_t> Fields[] = {
+			{ "underruns", Stats.Underruns },
+			{ "overruns", Stats.Overruns },
+			{ "bufferHighWater", Stats.HighWater },
+		};
+		const std::filesystem::path Path = GetTelemetryPath();
+		if (Control::WriteTelemetry(Path, Fields))
+			Control::Log("{} - Telemetry written to {}", Plugin::NAME, Path.string());
+		else
+			Control::Log("{} - Could not write telemetry to {}", Plugin::NAME, Path.string());
+#endif
+	}
+
+	// Next to the plugin's log, or with its other files when SFSE has no log folder.
+	static std::filesystem::path GetTelemetryPath()
+	{
+		const std::string Name = std::format("{}.telemetry.json", Plugin::NAME);
+		if (const auto Directory = SFSE::log::log_directory())
+			return *Directory / Name;
+		return std::filesystem::path(kDataPath) / Name;
+	}
+
+	void Seek(int32_t InSeconds)
+	{
+		int32_t TrackLength = getTrackLength();
+		int32_t Position = static_cast<int32_t>(Backend->GetPositionMs());
+
+		int32_t NewPosition = Position + (InSeconds * 1000);
+
+		if (NewPosition >= TrackLength)
+			NewPosition = TrackLength - 1;
+		if (NewPosition < 0)
+			NewPosition = 0;
+
+		Backend->PlayFrom(NewPosition);
+	}
+
+	void TogglePlayer()
+	{
+		ENABLE_DEBUG
+
+		IsPlaying = !IsPlaying;
+		if (!IsStarted && IsPlaying) {
+			IsStarted = true;
+			Backend->Play();
+
+			if (RandomizeStartTime)
+				Seek(static_cast<int32_t>(Rng.Below(static_cast<uint32_t>(getTrackLength())) / 1000));
+		}
+
+		const int        OnAirIndex = Stations->Find(OnAir);
+		std::string_view StationName = OnAirIndex >= 0 ? (*Stations)[OnAirIndex].Name : std::string_view{};
+
+		if (IsPlaying) {
+			if (!StationName.empty())
+				Notification(Control::MessageCategory::Status, "On Air - {}", StationName);
+			else
+				Notification(Control::MessageCategory::Status, "Radio On");
+		} else
+			Notification(Control::MessageCategory::Status, "Radio Off");
+
+		if (Mode == 0) {
+			Backend->SetVolume(IsPlaying ? GetGain() : 0.0f);
+		} else {
+			if (!IsPlaying) {
+				Backend->Stop();
+			} else {
+				Backend->Play();
+				if (RandomizeStartTime)
+					Seek(static_cast<int32_t>(Rng.Below(static_cast<uint32_t>(getTrackLength())) / 1000));
+				Backend->SetVolume(GetGain());
+			}
+		}
+	}
+
+	// 0 = Radio, 1 = Podcast
+	void ToggleMode()
+	{
+		Mode = ~Mode;
+
+		// Handle Podcast vs Radio mode.
+		// Podcast mode will actually stop the stream, while Radio mode just mutes it so that time passes when not listened to.
+	}
+
+	// Picks up a reloaded configuration. The station on air keeps playing; it is looked up in
+	// the new list so next/previous continue from it, or the index is clamped if it was removed.
+	void RefreshConfig()
+	{
+		const ConfigSnapshot& Snapshot = ConfigReader.Get();
+		if (Snapshot.Generation == Generation)
+			return;
+
+		Generation = Snapshot.Generation;
+		AutoStart = Snapshot.Settings.autoStartRadio;
+		RandomizeStartTime = Snapshot.Settings.randomizeStartTime;
+		PrefetchStations = std::clamp(Snapshot.Settings.prefetchStations, 0, kMaxPrefetchStations);
+		PrefetchBudget = std::size_t(std::max(Snapshot.Settings.prefetchMemoryMB, 0)) << 20;
+		Audio::SetDiskCacheBudget(uint64_t(std::max(Snapshot.Settings.cacheSizeMB, 0)) << 20);
+		Backend->SetCrossfade(static_cast<uint32_t>(std::clamp(Snapshot.Settings.crossfadeMs, 0, 10000)));
+		Backend->SetSpatialization(Audio::GetSpatialParams(static_cast<Audio::SpatialPreset>(std::clamp(Snapshot.Settings.spatialPreset, 0, 3))));
+		Stations = &Snapshot.Stations;
+
+		Weights = {
+			static_cast<uint32_t>(std::max(Snapshot.Settings.rotationMusicWeight, 0)),
+			static_cast<uint32_t>(std::max(Snapshot.Settings.rotationJingleWeight, 0)),
+			static_cast<uint32_t>(std::max(Snapshot.Settings.rotationAdWeight, 0)),
+			static_cast<uint32_t>(std::max(Snapshot.Settings.rotationNewsWeight, 0)),
+		};
+		// Clocks of stations gone from the list go with them. The rest are checked again when
+		// tuned in, and kept unless the weights or the station's folder changed their layout.
+		std::erase_if(FolderRotations, [&](const auto& Entry) { return Stations->Find(Entry.first) < 0; });
+		for (auto& [Key, Rotation] : FolderRotations)
+			Rotation.Table.reset();
+
+		std::vector<std::string_view> LocalTracks;
+		std::vector<std::string_view> Folders;
+		for (const Station& Entry : *Stations) {
+			if (Entry.IsFolder)
+				Folders.push_back(Entry.Source);
+			else if (!Entry.IsRemote)
+				LocalTracks.push_back(Entry.Source);
+		}
+		Metadata->Scan(LocalTracks, Folders);
+
+		if (OnAir == 0 || Stations->empty()) {
+			StationIndex = 0;
+			return;
+		}
+
+		const int Found = Stations->Find(OnAir);
+		if (Found >= 0) {
+			StationIndex = Found;
+		} else {
+			Control::Log("{} - Station on air was removed from the playlist", Plugin::NAME);
+			StationIndex = std::min(StationIndex, static_cast<int>(Stations->size()) - 1);
+		}
+
+		PrefetchNeighbors();
+	}
+
+private:
+	static constexpr int kMaxPrefetchStations = 3;
+
+	static constexpr auto kDataPath = ".\\Data\\SFSE\\Plugins\\StarfieldGalacticRadio";
+	// One state for the installation rather than one per save: SFSE offers Starfield plugins
+	// no co-save and sends no save or load messages to tie a state to.
+	static constexpr auto kJournalPath = ".\\Data\\SFSE\\Plugins\\StarfieldGalacticRadio\\state.journal";
+
+	int   Mode = 0;
+	int   StationIndex = 0;
+	float Volume = 700.0f;
+	float Seconds = 0.0f;
+	bool  RandomizeStartTime = false;
+	bool  AutoStart = true;
+	bool  IsStarted = false;
+	bool  IsPlaying = false;
+
+	int         PrefetchStations = 1;
+	std::size_t PrefetchBudget = 0;
+
+	ConfigStore::Reader                    ConfigReader;
+	uint64_t                               Generation = 0;
+	const StationTable*                    Stations = nullptr;        // owned by the current config snapshot
+	uint64_t                               OnAir = 0;                 // Station::Key of the station last opened
+	std::string                            OnAirTrack;                // file playing when OnAir is a folder station
+	uint32_t                               OnAirTrackMs = 0;          // its length
+	uint32_t                               OnAirTrackPositionMs = 0;  // where it was on air when opened
+	Control::NowPlaying                    Titles;                    // outlives Backend, whose streams report to it
+	std::unique_ptr<Audio::AudioBackend>   Backend;
+	std::unique_ptr<Audio::MetadataStore>  Metadata;
+	Control::StateJournal                  Journal;
+	std::optional<Control::ListeningState> Restored;                  // from the last session, for Init
+	Control::BroadcastSchedule             Schedule;
+	Control::Random                        Rng;                       // start station and start times; seeded with the schedule
+
+	// Rotation of a folder station, with its tracks by rotation index.
+	struct FolderRotation
+	{
+		std::shared_ptr<const Audio::MetadataTable> Table;  // the library it was last checked against
+		std::vector<std::string>                    Tracks;
+		std::unique_ptr<Control::RotationClock>     Clock;
+	};
+
+	Control::RotationWeights                     Weights{};
+	std::unordered_map<uint64_t, FolderRotation> FolderRotations;  // by Station::Key
+	uint64_t                                     FolderStation = 0;  // the folder station last tuned in
+};
+
+Control::KeyBindingTable MakeKeyBindings(const Config& config)
+{
+	return { {
+		{ config.toggleRadioKey, Control::RadioAction::TogglePlayer, 1 },
+		{ config.switchModeKey, Control::RadioAction::ToggleMode, 1 },
+		{ config.volumeUpKey, Control::RadioAction::Volume, 1 },
+		{ config.volumeDownKey, Control::RadioAction::Volume, -1 },
+		{ config.nextStationKey, Control::RadioAction::Station, 1 },
+		{ config.previousStationKey, Control::RadioAction::Station, -1 },
+		{ config.seekForwardKey, Control::RadioAction::Seek, 10 },
+		{ config.seekBackwardKey, Control::RadioAction::Seek, -10 },
+		{ config.statsKey, Control::RadioAction::ShowStats, 1 },
+	} };
+}
+
+const int    TimePerFrame = 50;
+static void MainLoop(std::stop_token InStop)
+{
+	ENABLE_DEBUG
+
+	DEBUG("Input Loop Starting");
+	
+	std::string configFilename = "StarfieldGalacticRadio.toml";
+
+    Config config; // Create a Config instance
+	{
+		const Control::ScopedTimer Timer(Control::Operation::Reload);
+		loadConfig(config); // Load configuration from file
+	}
+	
+	// printConfig(config);
+
+
+	DEBUG("Loaded config, waiting for player form...");
+	while (!RE::TESForm::LookupByID(0x14)) {
+		if (InStop.stop_requested())
+			return;
+		Sleep(1000);
+	}
+
+	// Threads started from here on stay off the cores the player reserved for the game.
+	Control::SetWorkerAffinity(static_cast<uint32_t>(config.workerAffinityMask));
+
+	DEBUG("Pre-Initialize RadioPlayer.");
+
+	// Stations and key bindings are re-read whenever the TOML file is saved.
+	ConfigStore Store;
+	Store.Publish(config);
+
+	ConfigWatcher Watcher;
+	Watcher.Start(Store, [](const Config& InConfig) {
+		Notification(Control::MessageCategory::Status, "Radio configuration reloaded, {} stations", InConfig.playlist.size());
+	});
+
+	// Radio owns the backend and destroys it with itself; it is withdrawn again before that.
+	auto  Backend = Audio::CreatePlatformBackend();
+	auto* BackendView = Backend.get();
+
+	RadioPlayer Radio(Store, std::move(Backend), Audio::CreateMetadataStore());
+	PublishBackend(BackendView);
+
+	// Everything that touches the audio backend runs on the worker, so a slow station open
+	// never stalls key handling.
+	Control::CommandWorker Worker;
+	Worker.Start(
+		[&Radio] { Radio.Init(); },
+		[&Radio](const Control::RadioCommand& InCommand) { Radio.Execute(InCommand); });
+	Radio.SetTrackEndHandler([&Worker] { Worker.Raise(Control::RadioAction::TrackEnded); });
+	Worker.RaiseEvery(Control::RadioAction::Tick, Control::StateJournal::kSyncInterval);
+
+	auto Post = [&Worker](Control::RadioAction InAction, int32_t InAmount) {
+		if (!Worker.Post({ InAction, InAmount }))
+			INFO("{} - Command queue full, dropping input", Plugin::NAME);
+	};
+
+	DEBUG("Post-Initialize RadioPlayer.")
+
+	ConfigStore::Reader BindingReader(Store);
+	uint64_t            BindingGeneration = BindingReader.Get().Generation;
+
+	Control::KeyDispatcher Dispatcher(MakeKeyBindings(BindingReader.Get().Settings), Post);
+	Dispatcher.SetBindingSource([&](Control::KeyBindingTable& OutBindings) {
+		const ConfigSnapshot& Snapshot = BindingReader.Get();
+		if (Snapshot.Generation == BindingGeneration)
+			return false;
+
+		BindingGeneration = Snapshot.Generation;
+		OutBindings = MakeKeyBindings(Snapshot.Settings);
+		return true;
+	});
+
+	// Keyboard bindings are event driven; this thread sleeps in the hook's message loop.
+	Control::KeyboardHook Hook;
+	std::stop_callback    StopHook(InStop, [&Hook] { Hook.Stop(); });
+	if (Dispatcher.NeedsPolling() || !Hook.Run(Dispatcher)) {
+		// Fallback for gamepad bindings or when the hook cannot be installed.
+		INFO("{} - Using polled input", Plugin::NAME);
+		while (!InStop.stop_requested()) {
+			for (const auto& Binding : Dispatcher.GetBindings())
+				Dispatcher.OnKey(Binding.VirtualKey, GetKeyState(Binding.VirtualKey) < 0);
+
+			// Delay to control frame rate
+			Sleep(TimePerFrame);
+		}
+	}
+
+	// The backend is withdrawn first, while Radio still owns it. Everything below then unwinds
+	// in reverse: the command worker stops, then the backend closes the output device.
+	INFO("{} - Shutting down", Plugin::NAME);
+	PublishBackend(nullptr);
+	Radio.SetTrackEndHandler({});
+}
+
+class OpenCloseSink final :
+	public RE::BSTEventSink<RE::MenuOpenCloseEvent>
+{
+public:
+	static OpenCloseSink* GetSingleton()
+	{
+		static OpenCloseSink self;
+		return std::addressof(self);
+	}
+
+	RE::BSEventNotifyControl ProcessEvent(RE::MenuOpenCloseEvent const& a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>* a_eventSource)
+	{
+		if (gMenuTracker.OnMenu(a_event.menuName.c_str(), a_event.opening)) {
+			std::lock_guard Lock(gBackendMutex);
+			if (gBackend)
+				gBackend->SetGameState(gMenuTracker.GetState());
+		}
+
+		if (a_event.menuName == "HUDMenu" && a_event.opening && !gIsInitialized) {
+			INFO("Creating Input Thread")
+			gThreads.Start("Radio Messages", Control::ThreadRole::Io, [](std::stop_token InStop) { Control::GetMessages().Run(InStop, DeliverMessage); });
+			gThreads.Start("Radio Input", Control::ThreadRole::Input, MainLoop);
+			Control::GameExitHook::Install([] { gThreads.Shutdown(Control::ThreadRuntime::kShutdownTimeout); });
+
+			gIsInitialized = true;
+		}
+
+		return RE::BSEventNotifyControl::kContinue;
+	}
+};
+
+DLLEXPORT constinit auto SFSEPlugin_Version = []() noexcept {
+	SFSE::PluginVersionData data{};
+
+	data.PluginVersion(Plugin::Version);
+	data.PluginName(Plugin::NAME);
+	data.AuthorName(Plugin::AUTHOR);
+	//data.UsesSigScanning(true);
+	data.UsesAddressLibrary(true);
+	//data.HasNoStructUse(true);
+	data.IsLayoutDependent(true);
+	data.CompatibleVersions({ SFSE::RUNTIME_LATEST });
+
+	return data;
+}();
+
+namespace
+{
+	void MessageCallback(SFSE::MessagingInterface::Message* a_msg) noexcept
+	{
+		switch (a_msg->type) {
+		case SFSE::MessagingInterface::kPostLoad:
+			{
+				if (const auto ui = RE::UI::GetSingleton(); ui) {
+					ui->RegisterSink<RE::MenuOpenCloseEvent>(OpenCloseSink::GetSingleton());
+				}
+
+				break;
+			}
+		default:
+			break;
+		}
+	}
+}
+
+/**
+// for preload plugins
+void SFSEPlugin_Preload(SFSE::LoadInterface* a_sfse);
+/**/
+
+DLLEXPORT bool SFSEAPI SFSEPlugin_Load(const SFSE::LoadInterface* a_sfse)
+{
+#ifndef NDEBUG
+	while (!IsDebuggerPresent()) {
+		Sleep(100);
+	}
+#endif
+
+	SFSE::Init(a_sfse, false);
+
+	DKUtil::Logger::Init(Plugin::NAME, std::to_string(Plugin::Version));
+
+	INFO("{} v{} loaded", Plugin::NAME, Plugin::Version);
+
+	// do stuff
+	SFSE::AllocTrampoline(1 << 10);
+
+	SFSE::GetMessagingInterface()->RegisterListener(MessageCallback);
+
+	return true;
+}
+
@@ -0,0 +1,248 @@
+#include "Audio/CachedSource.h"
+#include "Audio/NetworkSource.h"
+#include "Config/Hash.h"
+
+#include "Check.h"
+#include "Fixtures.h"
+#include "HttpServer.h"
+
+using namespace Audio;
+
+namespace
+{
+	constexpr uint32_t kChunk = 64 * 1024;
+	constexpr uint64_t kBudget = 64 * 1024 * 1024;
+
+	std::vector<uint8_t> MakeBody(std::size_t InSize, uint32_t InSeed = 1)
+	{
+		std::vector<uint8_t> body(InSize);
+		std::mt19937         random(InSeed);
+		for (auto& byte : body)
+			byte = static_cast<uint8_t>(random());
+		return body;
+	}
+
+	// A cache directory and the remote as Platform.cpp opens it, with the test client in place
+	// of WinHTTP. Stations are cached under their URL, whichever server happens to serve them.
+	struct Cache
+	{
+		std::unique_ptr<ByteSource> Open(std::string_view InUrl, uint16_t InPort, uint64_t InBudget = kBudget)
+		{
+			return OpenCachedSource(Directory.Get(), InBudget, InUrl, [this, InPort]() -> std::unique_ptr<ByteSource> {
+				++Connects;
+				auto source = std::make_unique<NetworkSource>();
+				const bool opened = source->Open([InPort](uint64_t InOffset) -> std::unique_ptr<ByteSource> {
+					auto connection = std::make_unique<Test::HttpClient>();
+					if (!connection->Open(InPort, InOffset))
+						return nullptr;
+					return connection;
+				});
+				if (!opened)
+					return nullptr;
+				return source;
+			});
+		}
+
+		std::filesystem::path GetIndexPath(std::string_view InUrl) const
+		{
+			return Directory / (ToHexString(Fnv1a64(InUrl)) + ".index");
+		}
+
+		Test::TempDirectory Directory{ "cache" };
+		std::atomic<int>    Connects = 0;
+	};
+
+	std::vector<uint8_t> ReadAll(ByteSource& InSource, std::size_t InLimit = SIZE_MAX)
+	{
+		std::vector<uint8_t> bytes;
+		std::vector<uint8_t> chunk(10000);  // not a divisor of the chunk size, so reads straddle chunks
+		while (bytes.size() < InLimit) {
+			const auto count = InSource.Read({ chunk.data(), std::min(chunk.size(), InLimit - bytes.size()) });
+			if (count == 0)
+				break;
+			bytes.insert(bytes.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(count));
+		}
+		return bytes;
+	}
+
+	std::vector<uint8_t> Slice(const std::vector<uint8_t>& InBytes, std::size_t InOffset, std::size_t InCount)
+	{
+		return { InBytes.begin() + static_cast<std::ptrdiff_t>(InOffset), InBytes.begin() + static_cast<std::ptrdiff_t>(InOffset + InCount) };
+	}
+}
+
+TEST(CachedSource, ColdFetchReadsThroughAndStores)
+{
+	const auto       body = MakeBody(5 * kChunk + 1000);
+	Test::HttpServer server(body);
+	Cache            cache;
+
+	const auto source = cache.Open("http://station/a.mp3", server.GetPort());
+	CHECK(source && source->IsRemote() && source->Size() == body.size());
+	CHECK(ReadAll(*source) == body);
+
+	// One response carried the whole file, and all of it is on disk.
+	CHECK(server.GetRequests() == std::vector<uint64_t>{ 0 });
+	CHECK(std::filesystem::file_size(std::filesystem::path(cache.GetIndexPath("http://station/a.mp3")).replace_extension(".data")) == body.size());
+}
+
+TEST(CachedSource, WarmRestartNeedsNoServer)
+{
+	const auto body = MakeBody(3 * kChunk + 77);
+	Cache      cache;
+	uint16_t   port = 0;
+	{
+		Test::HttpServer server(body);
+		port = server.GetPort();
+		const auto source = cache.Open("http://station/a.mp3", port);
+		CHECK(source && ReadAll(*source) == body);
+	}
+
+	// The server is gone; a complete copy plays without trying to reach it.
+	cache.Connects = 0;
+	const auto source = cache.Open("http://station/a.mp3", port);
+	CHECK(source && source->Size() == body.size());
+	CHECK(ReadAll(*source) == body);
+	CHECK(cache.Connects == 0);
+}
+
+TEST(CachedSource, SeeksIntoCachedAndMissingRanges)
+{
+	const auto       body = MakeBody(8 * kChunk);
+	Test::HttpServer server(body);
+	Cache            cache;
+	{
+		// Only the first two chunks get cached.
+		const auto source = cache.Open("http://station/a.mp3", server.GetPort());
+		CHECK(source && ReadAll(*source, 2 * kChunk) == Slice(body, 0, 2 * kChunk));
+	}
+
+	cache.Connects = 0;
+	const auto source = cache.Open("http://station/a.mp3", server.GetPort());
+	CHECK(source);
+
+	// Within the cached range: served from disk, without connecting.
+	CHECK(source->Seek(kChunk + 123));
+	CHECK(ReadAll(*source, 20000) == Slice(body, kChunk + 123, 20000));
+	CHECK(cache.Connects == 0);
+
+	// Past it: a range request from the start of the chunk that holds the offset.
+	const std::size_t missing = 5 * kChunk + 4567;
+	CHECK(source->Seek(missing));
+	CHECK(source->Tell() == missing);
+	CHECK(ReadAll(*source, 30000) == Slice(body, missing, 30000));
+	CHECK(cache.Connects == 1);
+	const auto requests = server.GetRequests();
+	CHECK(std::ranges::find(requests, uint64_t(5 * kChunk)) != requests.end());
+}
+
+TEST(CachedSource, RemoteSizeChangeInvalidatesTheIndex)
+{
+	constexpr auto url = "http://station/a.mp3";
+	Cache          cache;
+	{
+		Test::HttpServer server(MakeBody(5 * kChunk, 1));
+		const auto       source = cache.Open(url, server.GetPort());
+		CHECK(source && ReadAll(*source, 2 * kChunk).size() == 2 * kChunk);
+	}
+
+	// The file was replaced by a shorter one. The cached size holds until a missing chunk needs
+	// the remote, which reports the new size; the chunk is then fetched at its new length.
+	const auto       replaced = MakeBody(2 * kChunk + 5000, 2);
+	Test::HttpServer server(replaced);
+	{
+		const auto source = cache.Open(url, server.GetPort());
+		CHECK(source && source->Size() == 5 * kChunk);
+
+		const std::size_t offset = 2 * kChunk + 100;
+		CHECK(source->Seek(offset));
+		CHECK(ReadAll(*source) == Slice(replaced, offset, replaced.size() - offset));
+		CHECK(source->Size() == replaced.size());
+	}
+
+	// None of the old chunks survive: the next open reads the new file throughout.
+	const auto source = cache.Open(url, server.GetPort());
+	CHECK(source && source->Size() == replaced.size());
+	CHECK(ReadAll(*source) == replaced);
+}
+
+TEST(CachedSource, ShrinkingPastTheReadPositionEndsTheRead)
+{
+	constexpr auto url = "http://station/a.mp3";
+	Cache          cache;
+	{
+		Test::HttpServer server(MakeBody(5 * kChunk, 1));
+		const auto       source = cache.Open(url, server.GetPort());
+		CHECK(source && ReadAll(*source, kChunk).size() == kChunk);
+	}
+
+	Test::HttpServer server(MakeBody(kChunk + 10, 2));
+	const auto       source = cache.Open(url, server.GetPort());
+	CHECK(source && source->Seek(3 * kChunk));
+	std::vector<uint8_t> bytes(100);
+	CHECK(source->Read(bytes) == 0);
+	CHECK(source->Size() == kChunk + 10);
+}
+
+TEST(CachedSource, TrimsLeastRecentlyUsedToTheBudget)
+{
+	const auto       body = MakeBody(3 * kChunk);
+	Test::HttpServer server(body);
+	Cache            cache;
+
+	for (const auto url : { "http://station/old.mp3", "http://station/new.mp3" }) {
+		const auto source = cache.Open(url, server.GetPort());
+		CHECK(source && ReadAll(*source) == body);
+	}
+
+	// Timestamps may not tell the two apart; make the first one plainly older.
+	const auto oldIndex = cache.GetIndexPath("http://station/old.mp3");
+	const auto newIndex = cache.GetIndexPath("http://station/new.mp3");
+	std::filesystem::last_write_time(oldIndex, std::filesystem::file_time_type::clock::now() - 1h);
+
+	// Room for two cached files: filling a third drops the older one.
+	const auto source = cache.Open("http://station/third.mp3", server.GetPort(), 7 * kChunk);
+	CHECK(source && ReadAll(*source) == body);
+	CHECK(!std::filesystem::exists(oldIndex));
+	CHECK(!std::filesystem::exists(std::filesystem::path(oldIndex).replace_extension(".data")));
+	CHECK(std::filesystem::exists(newIndex));
+}
+
+TEST(CachedSource, WritesStayWithinTheBudget)
+{
+	const auto       small = MakeBody(2 * kChunk, 2);
+	const auto       large = MakeBody(10 * kChunk + 500);
+	Test::HttpServer smallServer(small);
+	Test::HttpServer largeServer(large);
+	Cache            cache;
+
+	const auto directoryBytes = [&] {
+		uint64_t bytes = 0;
+		for (const auto& file : std::filesystem::directory_iterator(cache.Directory.Get()))
+			bytes += file.file_size();
+		return bytes;
+	};
+
+	constexpr uint64_t kSmallBudget = 4 * kChunk;
+	{
+		const auto source = cache.Open("http://station/small.mp3", smallServer.GetPort(), kSmallBudget);
+		CHECK(source && ReadAll(*source) == small);
+	}
+	std::filesystem::last_write_time(cache.GetIndexPath("http://station/small.mp3"), std::filesystem::file_time_type::clock::now() - 1h);
+
+	// The cache fits at open and is overrun while one source plays: the other station goes
+	// first, then this one stops storing, and still plays to the end.
+	{
+		const auto source = cache.Open("http://station/large.mp3", largeServer.GetPort(), kSmallBudget);
+		CHECK(source && ReadAll(*source) == large);
+		CHECK(directoryBytes() <= kSmallBudget);
+	}
+	CHECK(!std::filesystem::exists(cache.GetIndexPath("http://station/small.mp3")));
+	CHECK(directoryBytes() <= kSmallBudget);
+
+	// What was stored is used: the next open reads the start from disk and fetches the rest.
+	const auto source = cache.Open("http://station/large.mp3", largeServer.GetPort(), kSmallBudget);
+	CHECK(source && ReadAll(*source) == large);
+	CHECK(largeServer.GetRequests().back() == 3 * kChunk);
+	CHECK(directoryBytes() <= kSmallBudget);
+}
@@ -0,0 +1,69 @@
+#include "Audio/FolderSpec.h"
+
+#include "Check.h"
+
+using namespace Audio;
+
+TEST(FolderSpec, SplitsAtTheFirstWildcard)
+{
+	auto spec = ParseFolderSpec("C:\\Music\\Chill\\**\\*.mp3");
+	CHECK(spec.Root == std::filesystem::path("C:\\Music\\Chill\\"));
+	CHECK(spec.Pattern == "**/*.mp3");
+	CHECK(spec.Recursive);
+
+	spec = ParseFolderSpec("/music/live/*.mp3");
+	CHECK(spec.Root == std::filesystem::path("/music/live/"));
+	CHECK(spec.Pattern == "*.mp3");
+	CHECK(!spec.Recursive);
+
+	// A wildcard inside a component takes the whole component into the pattern.
+	spec = ParseFolderSpec("/music/20?\?/best/*.mp3");
+	CHECK(spec.Root == std::filesystem::path("/music/"));
+	CHECK(spec.Pattern == "20?\?/best/*.mp3");
+	CHECK(spec.Recursive);
+
+	// A plain directory plays every MP3 below it.
+	spec = ParseFolderSpec("/music/all");
+	CHECK(spec.Root == std::filesystem::path("/music/all"));
+	CHECK(spec.Pattern == "**/*.mp3");
+	CHECK(spec.Recursive);
+}
+
+TEST(FolderSpec, MatchesGlobs)
+{
+	CHECK(MatchGlob("*.mp3", "track.mp3"));
+	CHECK(MatchGlob("*.mp3", "TRACK.MP3"));
+	CHECK(MatchGlob("*.mp3", ".mp3"));
+	CHECK(!MatchGlob("*.mp3", "track.mp3.part"));
+	CHECK(!MatchGlob("*.mp3", "sub/track.mp3"));
+	CHECK(MatchGlob("track?.mp3", "track1.mp3"));
+	CHECK(!MatchGlob("track?.mp3", "track.mp3"));
+	CHECK(!MatchGlob("a?b", "a/b"));
+
+	// "**/" spans any number of directories, none included.
+	CHECK(MatchGlob("**/*.mp3", "track.mp3"));
+	CHECK(MatchGlob("**/*.mp3", "a/track.mp3"));
+	CHECK(MatchGlob("**/*.mp3", "a/b/c/track.mp3"));
+	CHECK(!MatchGlob("**/*.mp3", "a/b/c/track.ogg"));
+	CHECK(MatchGlob("live/**/set*.mp3", "live/set1.mp3"));
+	CHECK(MatchGlob("live/**/set*.mp3", "LIVE/2023/berlin/set1.mp3"));
+	CHECK(!MatchGlob("live/**/set*.mp3", "studio/2023/set1.mp3"));
+	CHECK(!MatchGlob("live/**/set*.mp3", "live/2023/reset1.mp3"));
+
+	// '*' stays within one component.
+	CHECK(MatchGlob("*/*.mp3", "a/track.mp3"));
+	CHECK(!MatchGlob("*/*.mp3", "a/b/track.mp3"));
+	CHECK(MatchGlob("*", ""));
+	CHECK(!MatchGlob("", "a"));
+}
+
+TEST(FolderSpec, PathologicalPatternsFinish)
+{
+	// Many stars against a long near-miss: trying every split would take longer than the
+	// age of the universe.
+	const std::string path(200, 'a');
+	CHECK(!MatchGlob("*a*a*a*a*a*a*a*a*b", path));
+	CHECK(MatchGlob("*a*a*a*a*a*a*a*a*", path));
+	CHECK(!MatchGlob("**/*a*a*a*a*a*a*a*a*b", "x/y/" + path));
+	CHECK(!MatchGlob("*a*a*a*a*/*b", path + "/" + path));
+}
@@ -0,0 +1,181 @@
+#include "Audio/Gain.h"
+
+#include "Check.h"
+
+using namespace Audio;
+
+namespace
+{
+	constexpr uint32_t kSampleRate = 48000;
+
+	// The applied gain, read back by running a block of ones through the ramp.
+	struct Run
+	{
+		std::vector<float> Gains;  // one per frame, first channel
+
+		float MaxStep() const
+		{
+			float step = 0.0f;
+			for (std::size_t i = 1; i < Gains.size(); ++i)
+				step = std::max(step, std::abs(Gains[i] - Gains[i - 1]));
+			return step;
+		}
+	};
+
+	Run Process(GainRamp& InOutRamp, std::size_t InFrames, std::size_t InBlockFrames, uint32_t InChannels = 2, const MixKernels& InKernels = GetMixKernels())
+	{
+		Run                run;
+		std::vector<float> block;
+		for (std::size_t done = 0; done < InFrames; done += InBlockFrames) {
+			const std::size_t frames = std::min(InBlockFrames, InFrames - done);
+			block.assign(frames * InChannels, 1.0f);
+			InOutRamp.Process(block, InChannels, kSampleRate, InKernels);
+			for (std::size_t frame = 0; frame < frames; ++frame)
+				run.Gains.push_back(block[frame * InChannels]);
+		}
+		return run;
+	}
+}
+
+TEST(Gain, DecibelConversions)
+{
+	CHECK(DbToGain(0.0f) == 1.0f);
+	CHECK(DbToGain(kSilenceDb) == 0.0f);
+	CHECK(DbToGain(-100.0f) == 0.0f);
+	CHECK(std::abs(DbToGain(-6.0206f) - 0.5f) < 1e-4f);
+
+	CHECK(GainToDb(0.0f) == kSilenceDb);
+	CHECK(GainToDb(1.0f) == 0.0f);
+	for (float db = -59.0f; db <= 12.0f; db += 0.5f)
+		CHECK(std::abs(GainToDb(DbToGain(db)) - db) < 1e-3f);
+}
+
+TEST(Gain, VolumeCurveIsClampedAndMonotonic)
+{
+	CHECK(VolumeToGain(0.0f) == 0.0f);
+	CHECK(VolumeToGain(-1.0f) == 0.0f);
+	CHECK(VolumeToGain(1.0f) == 1.0f);
+	CHECK(VolumeToGain(2.0f) == 1.0f);
+	CHECK(std::abs(GainToDb(VolumeToGain(0.5f)) + kVolumeRangeDb / 2) < 1e-3f);
+
+	float last = 0.0f;
+	for (int step = 1; step <= 1000; ++step) {
+		const float gain = VolumeToGain(static_cast<float>(step) / 1000.0f);
+		CHECK(gain > last);
+		last = gain;
+	}
+}
+
+TEST(Gain, SteadyGainIsExact)
+{
+	GainRamp ramp;
+	CHECK(Process(ramp, 1000, 256).MaxStep() == 0.0f);
+
+	ramp.SetTarget(0.25f);
+	Process(ramp, kSampleRate, 256);
+	const auto run = Process(ramp, 1000, 256);
+	CHECK(run.Gains.front() == 0.25f);
+	CHECK(run.MaxStep() == 0.0f);
+}
+
+TEST(Gain, RampIsClickFree)
+{
+	// The largest change between neighbouring frames, against the full step an unramped change
+	// would make. 300 dB/s from unity is at most 0.35 % of full scale per frame at 48 kHz.
+	for (const std::size_t blockFrames : { std::size_t(1), std::size_t(7), std::size_t(256), std::size_t(4096) }) {
+		GainRamp ramp;
+		ramp.SetTarget(VolumeToGain(0.1f));
+		auto run = Process(ramp, kSampleRate / 2, blockFrames);
+		CHECK(run.MaxStep() < 0.0035f);
+
+		ramp.SetTarget(1.0f);
+		run = Process(ramp, kSampleRate / 2, blockFrames);
+		CHECK(run.MaxStep() < 0.0035f);
+	}
+}
+
+TEST(Gain, RampEndsExactlyOnTarget)
+{
+	GainRamp ramp;
+	ramp.SetTarget(0.5f);
+	const auto run = Process(ramp, kSampleRate, 333);
+
+	// Starts where it was, lands on the target and stays there.
+	CHECK(run.Gains.front() == 1.0f);
+	CHECK(run.Gains.back() == 0.5f);
+
+	const auto reached = std::ranges::find(run.Gains, 0.5f);
+	CHECK(reached != run.Gains.end());
+	CHECK(std::all_of(reached, run.Gains.end(), [](float InGain) { return InGain == 0.5f; }));
+
+	// 6 dB at kDbPerSecond, give or take a block.
+	const auto frames = static_cast<float>(reached - run.Gains.begin());
+	CHECK(std::abs(frames - 6.0206f / GainRamp::kDbPerSecond * kSampleRate) <= 333.0f);
+}
+
+TEST(Gain, BlocksJoinUp)
+{
+	// Each block starts on the gain the last one was heading for, so the ramp has the same
+	// slope across a block boundary as within a block.
+	GainRamp ramp;
+	ramp.SetTarget(0.1f);
+	const auto run = Process(ramp, 4096, 512);
+	for (std::size_t boundary = 512; boundary < 4096; boundary += 512) {
+		const float across = run.Gains[boundary] - run.Gains[boundary - 1];
+		const float before = run.Gains[boundary - 1] - run.Gains[boundary - 2];
+		CHECK(across < 0.0f);
+		CHECK(std::abs(across) <= std::abs(before) * 1.1f);
+	}
+}
+
+TEST(Gain, MuteReachesSilenceAndComesBack)
+{
+	GainRamp ramp;
+	ramp.SetTarget(0.0f);
+
+	// kSilenceDb at kDbPerSecond: 200 ms, then true silence.
+	auto run = Process(ramp, kSampleRate / 4, 480);
+	CHECK(ramp.IsSilent());
+	CHECK(run.Gains.back() == 0.0f);
+	CHECK(run.MaxStep() < 0.0035f);
+
+	const auto silentFrom = std::ranges::find(run.Gains, 0.0f) - run.Gains.begin();
+	CHECK(std::abs(static_cast<float>(silentFrom) - -kSilenceDb / GainRamp::kDbPerSecond * kSampleRate) <= 480.0f);
+
+	// Unmuting starts from nothing, not from the -60 dB floor.
+	ramp.SetTarget(1.0f);
+	run = Process(ramp, kSampleRate / 4, 480);
+	CHECK(run.Gains.front() == 0.0f);
+	CHECK(!ramp.IsSilent());
+	CHECK(run.Gains.back() == 1.0f);
+	CHECK(run.MaxStep() < 0.0035f);
+}
+
+TEST(Gain, ScaleDucksOnTopOfTarget)
+{
+	GainRamp ramp;
+	ramp.SetTarget(0.5f);
+	ramp.SetScale(DbToGain(-12.0f));
+	Process(ramp, kSampleRate, 256);
+
+	const auto run = Process(ramp, 256, 256);
+	CHECK(std::abs(run.Gains.front() - 0.5f * DbToGain(-12.0f)) < 1e-6f);
+	CHECK(ramp.GetTarget() == 0.5f);
+}
+
+TEST(Gain, ChannelsShareTheRamp)
+{
+	for (const auto* kernels : GetSupportedMixKernels()) {
+		for (const uint32_t channels : { 1u, 2u, 3u, 6u }) {
+			GainRamp ramp;
+			ramp.SetTarget(0.2f);
+
+			std::vector<float> block(101 * channels, 1.0f);
+			ramp.Process(block, channels, kSampleRate, *kernels);
+			for (std::size_t frame = 0; frame < 101; ++frame) {
+				for (uint32_t channel = 1; channel < channels; ++channel)
+					CHECK(block[frame * channels + channel] == block[frame * channels]);
+			}
+		}
+	}
+}
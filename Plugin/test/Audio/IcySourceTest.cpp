@@ -0,0 +1,197 @@
+#include "Audio/IcySource.h"
+#include "Audio/NetworkSource.h"
+
+#include "Check.h"
+#include "Fixtures.h"
+#include "HttpServer.h"
+
+using namespace Audio;
+
+namespace
+{
+	std::vector<uint8_t> MakeAudio(std::size_t InSize)
+	{
+		std::vector<uint8_t> audio(InSize);
+		for (std::size_t i = 0; i < InSize; ++i)
+			audio[i] = static_cast<uint8_t>(i * 7 + i / 251);
+		return audio;
+	}
+
+	std::string Block(std::string_view InTitle)
+	{
+		return std::format("StreamTitle='{}';StreamUrl='';", InTitle);
+	}
+
+	// Records where each Read wrote, to tell audio read in place from audio copied.
+	class RecordingSource final : public Test::MemorySource
+	{
+	public:
+		using MemorySource::MemorySource;
+
+		std::size_t Read(std::span<uint8_t> OutBytes) override
+		{
+			const auto count = MemorySource::Read(OutBytes);
+			Targets.push_back(OutBytes.first(count));
+			return count;
+		}
+
+		std::vector<std::span<uint8_t>> Targets;
+	};
+
+	struct Demux
+	{
+		Demux(std::vector<uint8_t> InWire, uint32_t InInterval, std::size_t InMaxRead = SIZE_MAX)
+		{
+			auto body = std::make_unique<RecordingSource>(std::move(InWire), false, InMaxRead);
+			Body = body.get();
+			Source = std::make_unique<IcySource>(std::move(body), InInterval, [this](std::string_view InTitle) { Titles.emplace_back(InTitle); });
+		}
+
+		std::vector<uint8_t> ReadAll(std::size_t InChunk)
+		{
+			std::vector<uint8_t> audio;
+			std::vector<uint8_t> chunk(InChunk);
+			while (const auto count = Source->Read(chunk))
+				audio.insert(audio.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(count));
+			return audio;
+		}
+
+		RecordingSource*           Body;
+		std::unique_ptr<IcySource> Source;
+		std::vector<std::string>   Titles;
+	};
+}
+
+TEST(IcySource, ParsesStreamTitles)
+{
+	CHECK(ParseStreamTitle("StreamTitle='Artist - Title';") == "Artist - Title");
+	CHECK(ParseStreamTitle("StreamUrl='x';StreamTitle='A';") == "A");
+	CHECK(ParseStreamTitle("StreamTitle='';") == "");
+	CHECK(!ParseStreamTitle("StreamUrl='http://example';").has_value());
+	CHECK(!ParseStreamTitle("").has_value());
+
+	// Quotes inside the title, and a block missing its ';'.
+	CHECK(ParseStreamTitle("StreamTitle='Guns N' Roses - Don't Cry';StreamUrl='';") == "Guns N' Roses - Don't Cry");
+	CHECK(ParseStreamTitle("StreamTitle='It's over'") == "It's over");
+	CHECK(ParseStreamTitle("StreamTitle='unterminated") == "unterminated");
+
+	// UTF-8 passes through; anything else is taken as Latin-1.
+	CHECK(ParseStreamTitle("StreamTitle='Sigur R\xC3\xB3s';") == "Sigur R\xC3\xB3s");
+	CHECK(ParseStreamTitle("StreamTitle='Sigur R\xF3s';") == "Sigur R\xC3\xB3s");
+	CHECK(ParseStreamTitle("StreamTitle='\xE9t\xE9';") == "\xC3\xA9t\xC3\xA9");
+}
+
+TEST(IcySource, SeparatesAudioFromMetadata)
+{
+	// Every mix of read sizes, the connection handing out whatever has arrived.
+	const auto            audio = MakeAudio(64 * 1024 + 100);
+	const Test::IcyStream stream{ 8000, { Block("One"), "", "", Block("Two"), Block("Two"), "", Block("Three") } };
+	const auto            wire = Test::InterleaveIcy(audio, stream);
+
+	for (const std::size_t maxRead : { std::size_t(1), std::size_t(7), std::size_t(4096), SIZE_MAX }) {
+		for (const std::size_t chunk : { std::size_t(1), std::size_t(1000), std::size_t(8000), std::size_t(65536) }) {
+			if (maxRead == 1 && chunk > 1000)
+				continue;
+
+			Demux demux(wire, stream.MetaInterval, maxRead);
+			const auto out = demux.ReadAll(chunk);
+
+			CHECK(out == audio);
+
+			// Empty blocks and repeats are not changes.
+			CHECK(demux.Titles == std::vector<std::string>{ "One", "Two", "Three", "One" });
+			CHECK(demux.Source->Tell() == out.size());
+		}
+	}
+}
+
+TEST(IcySource, ReadsAudioInPlace)
+{
+	// Audio goes from the connection straight into the caller's buffer, never more than the
+	// interval allows; only metadata goes elsewhere.
+	const Test::IcyStream stream{ 1000, { Block("Title") } };
+	Demux                 demux(Test::InterleaveIcy(MakeAudio(10'000), stream), stream.MetaInterval);
+
+	std::vector<uint8_t> buffer(4096);
+	std::size_t          total = 0;
+	for (std::size_t read = 0; (read = demux.Source->Read(buffer)) > 0;) {
+		CHECK(read <= stream.MetaInterval);
+		total += read;
+	}
+	CHECK(total == 10'000);
+
+	std::size_t inPlace = 0;
+	for (const auto target : demux.Body->Targets) {
+		if (target.data() == buffer.data()) {
+			CHECK(target.size() <= stream.MetaInterval);
+			inPlace += target.size();
+		}
+	}
+	CHECK(inPlace == 10'000);
+}
+
+TEST(IcySource, MetadataIsBounded)
+{
+	// The largest block the length byte allows, 255 x 16 bytes, is read whole; a title cut off
+	// by the connection ends the stream instead of reading past it.
+	const std::string     longTitle(4080 - Block("").size(), 'x');
+	const Test::IcyStream stream{ 100, { Block(longTitle) } };
+	{
+		Demux demux(Test::InterleaveIcy(MakeAudio(300), stream), stream.MetaInterval, 13);
+		CHECK(demux.ReadAll(64).size() == 300);
+		CHECK(demux.Titles == std::vector{ longTitle });
+	}
+
+	auto wire = Test::InterleaveIcy(MakeAudio(300), { 100, { Block("Cut") } });
+	wire.resize(100 + 1 + 8);
+	Demux demux(std::move(wire), 100);
+	CHECK(demux.ReadAll(64).size() == 100);
+	CHECK(demux.Titles.empty());
+}
+
+TEST(IcySource, StreamsFromAMockServer)
+{
+	// Platform.cpp's chain against a mock Icecast server: NetworkSource over a connection that
+	// asks for metadata and is demuxed by IcySource. The server drops the listener every
+	// 40 KB; each reconnect joins the station afresh and announces its title again.
+	const auto            audio = MakeAudio(96 * 1024);
+	const Test::IcyStream stream{ 8000, { Block("First"), "", Block("Second \xE9"), "" } };
+	const auto            wire = Test::InterleaveIcy(audio, stream);
+	Test::HttpServer      server(audio, { .DropEvery = 40 * 1024, .ChunkBytes = 1500 }, stream);
+
+	std::mutex               mutex;
+	std::vector<std::string> titles;
+	NetworkSource            source;
+	CHECK(source.Open([&](uint64_t InOffset) -> std::unique_ptr<ByteSource> {
+		auto connection = std::make_unique<Test::HttpClient>();
+		if (!connection->Open(server.GetPort(), InOffset, true))
+			return nullptr;
+		const auto interval = connection->GetMetaInterval();
+		CHECK(interval == stream.MetaInterval);
+		return std::make_unique<IcySource>(std::move(connection), interval, [&](std::string_view InTitle) {
+			std::lock_guard lock(mutex);
+			titles.emplace_back(InTitle);
+		});
+	}));
+	CHECK(source.Size() == 0);
+
+	std::vector<uint8_t> out(100 * 1024);
+	for (std::size_t filled = 0; filled < out.size();) {
+		const auto count = source.Read(std::span(out).subspan(filled));
+		CHECK(count > 0);
+		if (count == 0)
+			break;
+		filled += count;
+	}
+	source.Cancel();
+
+	// Each connection plays the station from the start, up to where it was dropped.
+	Demux      reference(std::vector(wire.begin(), wire.begin() + 40 * 1024), stream.MetaInterval);
+	const auto expected = reference.ReadAll(4096);
+	CHECK(std::equal(expected.begin(), expected.end(), out.begin()));
+	CHECK(std::equal(expected.begin(), expected.end(), out.begin() + static_cast<std::ptrdiff_t>(expected.size())));
+
+	std::lock_guard lock(mutex);
+	CHECK(titles.size() >= 4);
+	CHECK(titles.size() >= 2 && titles[0] == "First" && titles[1] == "Second \xC3\xA9");
+}
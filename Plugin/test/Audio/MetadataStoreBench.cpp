@@ -0,0 +1,94 @@
+#include "Audio/MetadataStore.h"
+
+#include "Check.h"
+#include "Fixtures.h"
+#include "Library.h"
+
+using namespace Audio;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	// RADIO_BENCH_LIBRARY_FILES sets the size of the tree; ctest builds 50k.
+	uint32_t GetLibraryFiles()
+	{
+		const char* files = std::getenv("RADIO_BENCH_LIBRARY_FILES");
+		return files ? static_cast<uint32_t>(std::strtoul(files, nullptr, 10)) : 50'000;
+	}
+
+	double MillisecondsSince(Clock::time_point InStart)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - InStart).count();
+	}
+}
+
+TEST(MetadataStoreBench, SyntheticLibrary)
+{
+	// Artists, albums of 50 tracks each, and a cover beside every album that the glob skips.
+	// Tracks are a few tagged frames: the scan reads headers, not audio.
+	const uint32_t            files = GetLibraryFiles();
+	const uint32_t            albums = std::max(1u, files / 50);
+	const Test::TempDirectory directory("library-bench");
+	const auto                root = directory / "music";
+	const auto                albumPath = [&](uint32_t InAlbum) { return root / std::format("artist {:03}", InAlbum / 20) / std::format("album {:02}", InAlbum % 20); };
+
+	auto start = Clock::now();
+	for (uint32_t album = 0; album < albums; ++album) {
+		const auto path = albumPath(album);
+		for (uint32_t track = 0; track < 50 && album * 50 + track < files; ++track)
+			Test::WriteTrack(path / std::format("{:02} track.mp3", track), 4, std::format("Track {}", track), std::format("Artist {}", album / 20));
+		Test::WriteFile(path / "cover.jpg", "jpeg"sv);
+	}
+	std::printf("  %u files in %u directories written in %.0f ms\n", files, albums + albums / 20 + 1, MillisecondsSince(start));
+
+	const auto folder = Test::ToUtf8(root / "**" / "*.mp3");
+	const auto index = directory / "index.bin";
+	{
+		Test::Library library(index);
+
+		// First launch: every directory listed, every track parsed, in parallel.
+		start = Clock::now();
+		auto table = library.Scan({}, { folder }, std::chrono::seconds(600));
+		CHECK(table && table->GetFolder(folder).size() == files);
+		const double cold = MillisecondsSince(start);
+		std::printf("  first scan:                %8.0f ms  %8.0f files/s  %u opened\n", cold, files / cold * 1000.0, library.Opens.load() - 1);
+
+		// The same store again: one stat per directory.
+		library.Opens = 0;
+		start = Clock::now();
+		table = library.Scan({}, { folder });
+		CHECK(table && table->GetFolder(folder).size() == files);
+		std::printf("  unchanged rescan:          %8.1f ms  %u opened\n", MillisecondsSince(start), library.Opens.load() - 1);
+		CHECK(library.Opens == 1);
+	}
+	std::printf("  index on disk:             %8.1f MB\n", static_cast<double>(std::filesystem::file_size(index)) / (1 << 20));
+
+	// Next launch: the index is loaded, the folder is playable before any scan, and the scan
+	// only stats directories.
+	std::this_thread::sleep_for(20ms);
+	start = Clock::now();
+	Test::Library library(index);
+	const double load = MillisecondsSince(start);
+	CHECK(library.Store.GetTable()->GetFolder(folder).size() == files);
+
+	start = Clock::now();
+	auto table = library.Scan({}, { folder });
+	CHECK(table && table->GetFolder(folder).size() == files);
+	std::printf("  next launch:               %8.1f ms load, %.1f ms scan, %u opened\n", load, MillisecondsSince(start), library.Opens.load() - 1);
+	CHECK(library.Opens == 1);
+
+	// 100 new tracks in 10 albums: those directories are listed again, those tracks parsed.
+	for (uint32_t album = 0; album < std::min(albums, 10u); ++album) {
+		for (uint32_t track = 0; track < 10; ++track)
+			Test::WriteTrack(albumPath(album * (albums / 10)) / std::format("bonus {:02}.mp3", track), 4);
+	}
+	const uint32_t added = std::min(albums, 10u) * 10;
+
+	library.Opens = 0;
+	start = Clock::now();
+	table = library.Scan({}, { folder });
+	CHECK(table && table->GetFolder(folder).size() == files + added);
+	std::printf("  %u files added:            %8.1f ms  %u opened\n", added, MillisecondsSince(start), library.Opens.load() - 1);
+	CHECK(library.Opens == added + 1);
+}
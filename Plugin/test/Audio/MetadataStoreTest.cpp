@@ -0,0 +1,132 @@
+#include "Audio/MetadataStore.h"
+
+#include "Check.h"
+#include "Fixtures.h"
+#include "Library.h"
+
+using namespace Audio;
+
+TEST(MetadataStore, ScansTracksAndFolders)
+{
+	const Test::TempDirectory directory("library");
+	Test::WriteTrack(directory / "music/chill/a.mp3", 100, "Alpha", "Artist A");
+	Test::WriteTrack(directory / "music/chill/deep/b.mp3", 200, "Beta", "Artist B");
+	Test::WriteTrack(directory / "music/chill/deep/er/c.MP3", 50);
+	Test::WriteFile(directory / "music/chill/cover.jpg", "not a track"sv);
+	Test::WriteFile(directory / "music/chill/broken.mp3", "not an mp3 either"sv);
+	Test::WriteTrack(directory / "music/rock/d.mp3", 10);
+	Test::WriteTrack(directory / "single.mp3", 300, "Single");
+
+	Test::Library library(directory / "index.bin");
+	const auto    recursive = Test::ToUtf8(directory / "music/chill/**/*.mp3");
+	const auto    flat = Test::ToUtf8(directory / "music/chill/*.mp3");
+	const auto    single = Test::ToUtf8(directory / "single.mp3");
+	const auto    table = library.Scan({ single, "http://example.com/stream.mp3" }, { recursive, flat });
+	CHECK(table != nullptr);
+	if (!table)
+		return;
+
+	// Folders play what could be read, in path order; the glob is case-insensitive.
+	CHECK(std::vector(table->GetFolder(recursive).begin(), table->GetFolder(recursive).end()) ==
+		  std::vector{ Test::ToUtf8(directory / "music/chill/a.mp3"), Test::ToUtf8(directory / "music/chill/deep/b.mp3"), Test::ToUtf8(directory / "music/chill/deep/er/c.MP3") });
+	CHECK(std::vector(table->GetFolder(flat).begin(), table->GetFolder(flat).end()) == std::vector{ Test::ToUtf8(directory / "music/chill/a.mp3") });
+	CHECK(table->GetFolder("elsewhere").empty());
+
+	// What the reader found is kept per track; TrackMetadataTest covers the parsing itself.
+	const auto* alpha = table->Find(Test::ToUtf8(directory / "music/chill/a.mp3"));
+	CHECK(alpha && alpha->Title == "Alpha" && alpha->DurationMs > 0);
+	const auto* lone = table->Find(single);
+	CHECK(lone && lone->Title == "Single" && lone->DurationMs > 0);
+	CHECK(!table->Find(Test::ToUtf8(directory / "music/chill/broken.mp3")));
+	CHECK(!table->Find(Test::ToUtf8(directory / "music/rock/d.mp3")));
+	CHECK(!table->Find("http://example.com/stream.mp3"));
+	CHECK(library.Opens == 5 + 1);  // every .mp3 found, the broken one included, and the sentinel
+}
+
+TEST(MetadataStore, RescansOnlyWhatChanged)
+{
+	const Test::TempDirectory directory("library");
+	for (int i = 0; i < 20; ++i)
+		Test::WriteTrack(directory / std::format("music/{}/{}.mp3", i % 4, i), 20 + i);
+
+	Test::Library library(directory / "index.bin");
+	const auto    folder = Test::ToUtf8(directory / "music");
+	auto          table = library.Scan({}, { folder });
+	CHECK(table && table->GetFolder(folder).size() == 20);
+	CHECK(library.Opens == 20 + 1);
+
+	// Nothing changed: nothing is opened.
+	library.Opens = 0;
+	table = library.Scan({}, { folder });
+	CHECK(table && table->GetFolder(folder).size() == 20);
+	CHECK(library.Opens == 1);
+
+	// A new track, and one replaced by a longer one, in the same directory: both are parsed,
+	// nothing else is. The directory's time moves on with the files it gains.
+	std::this_thread::sleep_for(20ms);
+	Test::WriteTrack(directory / "music/1/new.mp3", 40);
+	Test::WriteTrack(directory / "music/1/5.mp3.tmp", 400);
+	std::filesystem::rename(directory / "music/1/5.mp3.tmp", directory / "music/1/5.mp3");
+
+	library.Opens = 0;
+	table = library.Scan({}, { folder });
+	CHECK(table && table->GetFolder(folder).size() == 21);
+	CHECK(library.Opens == 2 + 1);
+	const auto* replaced = table ? table->Find(Test::ToUtf8(directory / "music/1/5.mp3")) : nullptr;
+	CHECK(replaced && std::abs(static_cast<int>(replaced->DurationMs) - 10449) <= 30);
+
+	// A removed track leaves the folder.
+	std::filesystem::remove(directory / "music/2/6.mp3");
+	table = library.Scan({}, { folder });
+	CHECK(table && table->GetFolder(folder).size() == 20);
+	CHECK(table && !table->Find(Test::ToUtf8(directory / "music/2/6.mp3")));
+}
+
+TEST(MetadataStore, PersistsAcrossLaunches)
+{
+	const Test::TempDirectory directory("library");
+	for (int i = 0; i < 10; ++i)
+		Test::WriteTrack(directory / std::format("music/{}.mp3", i), 30 + i, std::format("Track {}", i));
+	const auto folder = Test::ToUtf8(directory / "music");
+
+	{
+		Test::Library library(directory / "index.bin");
+		CHECK(library.Scan({}, { folder }) != nullptr);
+	}
+
+	// The next launch has the folder before any scan, and its scan opens nothing.
+	Test::Library library(directory / "index.bin");
+	auto          table = library.Store.GetTable();
+	CHECK(table->GetFolder(folder).size() == 10);
+	const auto* track = table->Find(Test::ToUtf8(directory / "music/3.mp3"));
+	CHECK(track && track->Title == "Track 3");
+
+	table = library.Scan({}, { folder });
+	CHECK(table && table->GetFolder(folder).size() == 10);
+	CHECK(library.Opens == 1);
+}
+
+TEST(MetadataStore, DiscardsACorruptIndex)
+{
+	const Test::TempDirectory directory("library");
+	for (int i = 0; i < 5; ++i)
+		Test::WriteTrack(directory / std::format("music/{}.mp3", i), 30);
+	const auto folder = Test::ToUtf8(directory / "music");
+
+	{
+		Test::Library library(directory / "index.bin");
+		CHECK(library.Scan({}, { folder }) != nullptr);
+	}
+
+	// Cut short anywhere, the index is dropped whole and the scan rebuilds it.
+	const auto size = std::filesystem::file_size(directory / "index.bin");
+	for (const auto keep : { std::uintmax_t(0), std::uintmax_t(7), size / 3, size / 2, size - 1 }) {
+		std::filesystem::resize_file(directory / "index.bin", keep);
+
+		Test::Library library(directory / "index.bin");
+		CHECK(library.Store.GetTable()->GetFolder(folder).empty());
+		const auto table = library.Scan({}, { folder });
+		CHECK(table && table->GetFolder(folder).size() == 5);
+		CHECK(library.Opens == 5 + 1);
+	}
+}
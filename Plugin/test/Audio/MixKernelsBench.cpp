@@ -0,0 +1,87 @@
+#include "Audio/Gain.h"
+#include "Audio/MixKernels.h"
+
+#include "Bench.h"
+#include "Check.h"
+
+using namespace Audio;
+
+namespace
+{
+	// One render block of stereo at the mixer's largest size.
+	constexpr std::size_t kBlockSamples = 4096;
+	constexpr uint32_t    kChannels = 2;
+}
+
+TEST(MixKernelsBench, Kernels)
+{
+	std::vector<float>       samples(kBlockSamples, 0.5f);
+	const std::vector<float> source(kBlockSamples, 0.25f);
+	const float              step = 1.0f / (kBlockSamples / kChannels);
+
+	// Ramp and MixRamp include refilling the block, as they would compound otherwise.
+	std::printf("samples per second, one core:\n");
+	double scalarRamp = 0.0;
+	for (const auto* kernels : GetSupportedMixKernels()) {
+		const std::string name = kernels->Name;
+		Test::Measure(name + " Scale", kBlockSamples, "samples", [&] {
+			kernels->Scale(samples, 1.0f);
+			Test::KeepAlive(samples[0]);
+		});
+		const double ramp = Test::Measure(name + " Ramp", kBlockSamples, "samples", [&] {
+			std::ranges::fill(samples, 0.5f);
+			kernels->Ramp(samples, kChannels, 1.0f, -step);
+			Test::KeepAlive(samples[0]);
+		});
+		Test::Measure(name + " MixRamp", kBlockSamples, "samples", [&] {
+			std::ranges::fill(samples, 0.0f);
+			kernels->MixRamp(samples, source, kChannels, 0.0f, step);
+			Test::KeepAlive(samples[0]);
+		});
+
+		if (kernels == &GetScalarMixKernels())
+			scalarRamp = ramp;
+		else
+			std::printf("  %s Ramp is %.1fx scalar\n", kernels->Name, ramp / scalarRamp);
+		CHECK(ramp > 0.0);
+	}
+}
+
+TEST(MixKernelsBench, GainRamp)
+{
+	// A volume change every block keeps the ramp moving: the worst case for the gain stage.
+	std::vector<float> samples(kBlockSamples, 0.5f);
+	GainRamp           ramp;
+	bool               up = false;
+
+	Test::Measure("GainRamp::Process, ramping", kBlockSamples, "samples", [&] {
+		ramp.SetTarget((up = !up) ? 1.0f : 0.5f);
+		ramp.Process(samples, kChannels, 48000, GetMixKernels());
+		Test::KeepAlive(samples[0]);
+	});
+}
+
+TEST(MixKernelsBench, Crossfade)
+{
+	// What the mixer does to every block during a switch: the incoming station ramps up and
+	// the outgoing one is mixed in ramping down.
+	std::vector<float>       incoming(kBlockSamples, 0.5f);
+	const std::vector<float> outgoing(kBlockSamples, -0.5f);
+	const float              step = 1.0f / (kBlockSamples / kChannels);
+
+	std::printf("crossfaded samples per second, one core:\n");
+	double scalar = 0.0;
+	for (const auto* kernels : GetSupportedMixKernels()) {
+		const double rate = Test::Measure(std::string(kernels->Name) + " crossfade", kBlockSamples, "samples", [&] {
+			std::ranges::fill(incoming, 0.5f);
+			kernels->Ramp(incoming, kChannels, 0.0f, step);
+			kernels->MixRamp(incoming, outgoing, kChannels, 1.0f, -step);
+			Test::KeepAlive(incoming[0]);
+		});
+
+		if (kernels == &GetScalarMixKernels())
+			scalar = rate;
+		else
+			std::printf("  %s is %.1fx scalar, %.0fx real time for 48 kHz stereo\n", kernels->Name, rate / scalar, rate / 96000);
+	}
+}
@@ -0,0 +1,139 @@
+#include "Audio/MixKernels.h"
+
+#include "Check.h"
+
+using namespace Audio;
+
+namespace
+{
+	// SIMD and scalar build the gain of each frame the same way, start + step * frame, but a
+	// compiler may still fuse or reorder the scalar arithmetic; allow a few ulps.
+	bool Near(float InA, float InB)
+	{
+		return std::abs(InA - InB) <= 4 * std::numeric_limits<float>::epsilon() * std::max(1.0f, std::abs(InB));
+	}
+
+	std::vector<float> Noise(std::size_t InCount, uint32_t InSeed)
+	{
+		std::mt19937                          random(InSeed);
+		std::uniform_real_distribution<float> sample(-1.0f, 1.0f);
+		std::vector<float>                    samples(InCount);
+		for (auto& value : samples)
+			value = sample(random);
+		return samples;
+	}
+
+	// Every length up to a few vectors, so each tail length meets each vector width.
+	constexpr std::size_t kMaxLength = 67;
+
+	// Offsets the data from the start of the buffer, so the unaligned loads are exercised too.
+	constexpr std::size_t kMaxOffset = 3;
+}
+
+TEST(MixKernels, ScalarComesFirst)
+{
+	const auto kernels = GetSupportedMixKernels();
+	CHECK(kernels.size() >= 2);
+	CHECK(kernels[0] == &GetScalarMixKernels());
+	CHECK(std::ranges::find(kernels, &GetMixKernels()) != kernels.end());
+}
+
+TEST(MixKernels, ScaleMatchesScalar)
+{
+	const auto& scalar = GetScalarMixKernels();
+	for (const auto* kernels : GetSupportedMixKernels()) {
+		for (std::size_t length = 0; length <= kMaxLength; ++length) {
+			for (std::size_t offset = 0; offset <= kMaxOffset; ++offset) {
+				auto expected = Noise(length + offset, 1);
+				auto actual = expected;
+				scalar.Scale(std::span(expected).subspan(offset), 0.37f);
+				kernels->Scale(std::span(actual).subspan(offset), 0.37f);
+				CHECK(actual == expected);
+			}
+		}
+	}
+}
+
+TEST(MixKernels, RampMatchesScalar)
+{
+	const auto& scalar = GetScalarMixKernels();
+	for (const auto* kernels : GetSupportedMixKernels()) {
+		for (const uint32_t channels : { 1u, 2u, 3u }) {
+			for (std::size_t frames = 0; frames * channels <= kMaxLength; ++frames) {
+				for (std::size_t offset = 0; offset <= kMaxOffset; ++offset) {
+					const float step = frames > 0 ? -0.8f / static_cast<float>(frames) : 0.0f;
+					auto        expected = Noise(frames * channels + offset, 2);
+					auto        actual = expected;
+					scalar.Ramp(std::span(expected).subspan(offset), channels, 0.9f, step);
+					kernels->Ramp(std::span(actual).subspan(offset), channels, 0.9f, step);
+
+					bool same = true;
+					for (std::size_t i = 0; i < actual.size(); ++i)
+						same = same && Near(actual[i], expected[i]);
+					if (!CHECK(same))
+						std::fprintf(stderr, "  %s, %u channel(s), %zu frame(s), offset %zu\n", kernels->Name, channels, frames, offset);
+				}
+			}
+		}
+	}
+}
+
+TEST(MixKernels, MixRampMatchesScalar)
+{
+	const auto& scalar = GetScalarMixKernels();
+	for (const auto* kernels : GetSupportedMixKernels()) {
+		for (const uint32_t channels : { 1u, 2u, 3u }) {
+			for (std::size_t frames = 0; frames * channels <= kMaxLength; ++frames) {
+				const std::size_t length = frames * channels;
+				const auto        source = Noise(length + kMaxOffset, 3);
+				for (std::size_t offset = 0; offset <= kMaxOffset; ++offset) {
+					const float step = frames > 0 ? 0.8f / static_cast<float>(frames) : 0.0f;
+					auto        expected = Noise(length + offset, 4);
+					auto        actual = expected;
+					const auto  from = std::span(source).subspan(kMaxOffset - offset, length);
+					scalar.MixRamp(std::span(expected).subspan(offset), from, channels, 0.1f, step);
+					kernels->MixRamp(std::span(actual).subspan(offset), from, channels, 0.1f, step);
+
+					bool same = true;
+					for (std::size_t i = 0; i < actual.size(); ++i)
+						same = same && Near(actual[i], expected[i]);
+					if (!CHECK(same))
+						std::fprintf(stderr, "  %s, %u channel(s), %zu frame(s), offset %zu\n", kernels->Name, channels, frames, offset);
+				}
+			}
+		}
+	}
+}
+
+TEST(MixKernels, RampEndpoints)
+{
+	// The first frame gets the start gain exactly and the last start + step * (frames - 1),
+	// leaving the next block to start on the target: no step at either end.
+	for (const auto* kernels : GetSupportedMixKernels()) {
+		for (const uint32_t channels : { 1u, 2u }) {
+			for (const std::size_t frames : { std::size_t(1), std::size_t(5), std::size_t(33), std::size_t(1023) }) {
+				std::vector<float> ones(frames * channels, 1.0f);
+				const float        step = (0.25f - 1.0f) / static_cast<float>(frames);
+				kernels->Ramp(ones, channels, 1.0f, step);
+
+				for (uint32_t channel = 0; channel < channels; ++channel) {
+					CHECK(ones[channel] == 1.0f);
+					CHECK(Near(ones[(frames - 1) * channels + channel], 1.0f + step * static_cast<float>(frames - 1)));
+				}
+				CHECK(Near(ones.back() + step, 0.25f));
+			}
+		}
+	}
+}
+
+TEST(MixKernels, LongRampsDoNotDrift)
+{
+	// Gains come from the frame number, not a running sum, so a ramp over a whole second
+	// still lands where it should.
+	constexpr std::size_t kFrames = 48000;
+	for (const auto* kernels : GetSupportedMixKernels()) {
+		std::vector<float> ones(kFrames * 2, 1.0f);
+		kernels->Ramp(ones, 2, 0.0f, 1.0f / kFrames);
+		CHECK(std::abs(ones.back() - (1.0f - 1.0f / kFrames)) < 1e-6f);
+	}
+}
@@ -0,0 +1,160 @@
+#include "Audio/Mp3.h"
+
+#include "Bench.h"
+#include "Check.h"
+#include "Fixtures.h"
+
+#if __has_include(<sys/mman.h>)
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
+
+using namespace Audio;
+
+namespace
+{
+	// RADIO_BENCH_MP3_MB sizes the track; the request's 1-4 GB runs take a while, so ctest
+	// runs a small one.
+	std::size_t GetTrackBytes()
+	{
+		const char* megabytes = std::getenv("RADIO_BENCH_MP3_MB");
+		return (megabytes ? std::strtoull(megabytes, nullptr, 10) : 64) << 20;
+	}
+
+	// Resident set size in MB, where the platform tells.
+	double GetResidentMb()
+	{
+		std::ifstream statm("/proc/self/statm");
+		uint64_t      size = 0;
+		uint64_t      resident = 0;
+		if (!(statm >> size >> resident))
+			return 0.0;
+#if __has_include(<sys/mman.h>)
+		return static_cast<double>(resident * sysconf(_SC_PAGESIZE)) / (1 << 20);
+#else
+		return 0.0;
+#endif
+	}
+
+	// The plugin maps tracks with MappedSource on Windows; this is the POSIX counterpart, or
+	// the file read into memory where there is no mmap.
+	class MappedFile final : public ByteSource
+	{
+	public:
+		explicit MappedFile(const std::filesystem::path& InPath)
+		{
+#if __has_include(<sys/mman.h>)
+			const int file = open(InPath.c_str(), O_RDONLY);
+			const auto size = static_cast<std::size_t>(std::filesystem::file_size(InPath));
+			void*      view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+			close(file);
+			if (view != MAP_FAILED) {
+				madvise(view, size, MADV_SEQUENTIAL);
+				View = { static_cast<const uint8_t*>(view), size };
+			}
+#else
+			std::ifstream file(InPath, std::ios::binary);
+			Copy.resize(static_cast<std::size_t>(std::filesystem::file_size(InPath)));
+			file.read(reinterpret_cast<char*>(Copy.data()), static_cast<std::streamsize>(Copy.size()));
+			View = Copy;
+#endif
+		}
+
+		~MappedFile() override
+		{
+#if __has_include(<sys/mman.h>)
+			if (!View.empty())
+				munmap(const_cast<uint8_t*>(View.data()), View.size());
+#endif
+		}
+
+		std::size_t Read(std::span<uint8_t> OutBytes) override
+		{
+			const auto count = std::min<std::size_t>(OutBytes.size(), View.size() - Position);
+			std::memcpy(OutBytes.data(), View.data() + Position, count);
+			Position += count;
+			return count;
+		}
+
+		bool Seek(uint64_t InOffset) override
+		{
+			Position = std::min<uint64_t>(InOffset, View.size());
+			return InOffset <= View.size();
+		}
+
+		uint64_t                 Tell() const override { return Position; }
+		uint64_t                 Size() const override { return View.size(); }
+		std::span<const uint8_t> GetMapping() const override { return View; }
+
+	private:
+		std::span<const uint8_t> View;
+		std::vector<uint8_t>     Copy;
+		uint64_t                 Position = 0;
+	};
+
+	// Every frame header parsed and the frame touched, as the decoder would.
+	uint64_t WalkFrames(ByteSource& InSource)
+	{
+		Mp3Stream stream(InSource);
+		if (!stream.Open())
+			return 0;
+
+		uint64_t checksum = 0;
+		for (auto frame = stream.NextFrame(); !frame.empty(); frame = stream.NextFrame())
+			checksum += frame[frame.size() / 2] + frame.size();
+		return checksum;
+	}
+}
+
+TEST(Mp3Bench, MappedAgainstBuffered)
+{
+	const Test::TempDirectory directory("mp3bench");
+	const auto                path = directory / "track.mp3";
+
+	// Written in pieces, so a multi-gigabyte track never has to fit in memory here.
+	const auto        piece = Test::MakeMp3(20'000, { .Vbr = true });
+	const std::size_t pieces = std::max<std::size_t>(GetTrackBytes() / piece.Bytes.size(), 1);
+	{
+		std::ofstream file(path, std::ios::binary);
+		for (std::size_t i = 0; i < pieces; ++i)
+			file.write(reinterpret_cast<const char*>(piece.Bytes.data()), static_cast<std::streamsize>(piece.Bytes.size()));
+	}
+	const double megabytes = static_cast<double>(std::filesystem::file_size(path)) / (1 << 20);
+	std::printf("track %.0f MB, %zu frames; RSS %.0f MB before\n", megabytes, pieces * 20'000, GetResidentMb());
+
+	// One cold-ish pass each, with the resident set taken while the source is still open.
+	const auto pass = [&](std::string_view InName, ByteSource& InSource) {
+		const auto     start = std::chrono::steady_clock::now();
+		const uint64_t checksum = WalkFrames(InSource);
+		const double   seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::printf("  %-32.*s %8.0f MB/s, RSS %.0f MB\n", static_cast<int>(InName.size()), InName.data(), megabytes / seconds, GetResidentMb());
+		return checksum;
+	};
+
+	uint64_t buffered = 0;
+	{
+		FileSource source;
+		CHECK(source.Open(path));
+		buffered = pass("buffered FileSource", source);
+	}
+
+	uint64_t mapped = 0;
+	{
+		MappedFile source(path);
+		mapped = pass("mapped, frames sliced in place", source);
+	}
+
+	CHECK(buffered != 0);
+	CHECK(buffered == mapped);
+}
+
+TEST(Mp3Bench, FrameParsing)
+{
+	const auto track = Test::MakeMp3(100'000, { .Vbr = true });
+	Test::MemorySource source(track.Bytes, true);
+	Test::Measure("NextFrame, mapped", 100'000, "frames", [&] {
+		source.Position = 0;
+		Test::KeepAlive(WalkFrames(source));
+	});
+}
@@ -0,0 +1,236 @@
+#include "Audio/Mp3.h"
+
+#include "Check.h"
+#include "Fixtures.h"
+
+using namespace Audio;
+
+namespace
+{
+	// Every frame of the stream, by number; the walk stops at the first frame out of order.
+	std::vector<uint32_t> Walk(Mp3Stream& InOutStream)
+	{
+		std::vector<uint32_t> numbers;
+		for (auto frame = InOutStream.NextFrame(); !frame.empty(); frame = InOutStream.NextFrame())
+			numbers.push_back(Test::GetFrameNumber(frame));
+		return numbers;
+	}
+
+	std::vector<uint32_t> Sequence(uint32_t InFirst, uint32_t InEnd)
+	{
+		std::vector<uint32_t> numbers(InEnd - InFirst);
+		std::iota(numbers.begin(), numbers.end(), InFirst);
+		return numbers;
+	}
+}
+
+TEST(Mp3, ParsesLayerIIIHeaders)
+{
+	const uint8_t cbr[] = { 0xFF, 0xFB, 0x90, 0x00 };
+	const auto    header = ParseFrameHeader(cbr);
+	CHECK(header.has_value());
+	CHECK(header->Version == 10);
+	CHECK(header->Bitrate == 128);
+	CHECK(header->SampleRate == 44100);
+	CHECK(header->FrameBytes == 417);
+	CHECK(header->SamplesPerFrame == 1152);
+	CHECK(header->Channels == 2);
+
+	const uint8_t padded[] = { 0xFF, 0xFB, 0x92, 0xC0 };
+	CHECK(ParseFrameHeader(padded)->FrameBytes == 418);
+	CHECK(ParseFrameHeader(padded)->Channels == 1);
+
+	// MPEG-2, 64 kbps, 24 kHz: half the samples per frame.
+	const uint8_t mpeg2[] = { 0xFF, 0xF3, 0x84, 0x00 };
+	const auto    half = ParseFrameHeader(mpeg2);
+	CHECK(half && half->Version == 20 && half->SampleRate == 24000 && half->SamplesPerFrame == 576 && half->FrameBytes == 192);
+
+	const uint8_t layer2[] = { 0xFF, 0xFD, 0x90, 0x00 };
+	const uint8_t freeFormat[] = { 0xFF, 0xFB, 0x00, 0x00 };
+	const uint8_t badBitrate[] = { 0xFF, 0xFB, 0xF0, 0x00 };
+	const uint8_t badRate[] = { 0xFF, 0xFB, 0x9C, 0x00 };
+	const uint8_t reserved[] = { 0xFF, 0xEB, 0x90, 0x00 };
+	const uint8_t noSync[] = { 0xFE, 0xFB, 0x90, 0x00 };
+	for (const auto* bytes : { layer2, freeFormat, badBitrate, badRate, reserved, noSync })
+		CHECK(!ParseFrameHeader(bytes));
+}
+
+TEST(Mp3, Id3v2Size)
+{
+	const uint8_t tag[] = { 'I', 'D', '3', 4, 0, 0x00, 0x00, 0x00, 0x02, 0x01 };
+	CHECK(GetId3v2Size(tag) == 10 + 257);
+
+	const uint8_t withFooter[] = { 'I', 'D', '3', 4, 0, 0x10, 0x00, 0x00, 0x00, 0x05 };
+	CHECK(GetId3v2Size(withFooter) == 10 + 5 + 10);
+
+	const uint8_t none[] = { 'T', 'A', 'G', 4, 0, 0, 0, 0, 0, 5 };
+	CHECK(GetId3v2Size(none) == 0);
+	CHECK(GetId3v2Size(std::span(tag).first(9)) == 0);
+}
+
+TEST(Mp3, OpenFindsTheFirstFrame)
+{
+	// Tags inside the first buffer and tags larger than it, which are skipped on the source.
+	for (const std::size_t id3 : { std::size_t(0), std::size_t(300), std::size_t(200'000) }) {
+		for (const bool mapped : { false, true }) {
+			const auto         track = Test::MakeMp3(100, { .Id3Bytes = id3 });
+			Test::MemorySource source(track.Bytes, mapped);
+			Mp3Stream          stream(source);
+			CHECK(stream.Open());
+
+			const auto& info = stream.GetInfo();
+			CHECK(info.DataOffset == track.DataOffset);
+			CHECK(info.DataBytes == track.Bytes.size() - track.DataOffset);
+			CHECK(info.First.Bitrate == 128);
+			CHECK(!info.HasXingFrame);
+
+			// No Xing frame: the duration is estimated from the first bitrate.
+			const uint32_t exact = 100 * 1152 * 1000 / 44100;
+			CHECK(info.DurationMs >= exact - 5 && info.DurationMs <= exact + 5);
+			CHECK(Walk(stream) == Sequence(0, 100));
+		}
+	}
+}
+
+TEST(Mp3, ReadsXingFrames)
+{
+	const auto         track = Test::MakeMp3(2000, { .Vbr = true, .Xing = true });
+	Test::MemorySource source(track.Bytes);
+	Mp3Stream          stream(source);
+	CHECK(stream.Open());
+
+	const auto& info = stream.GetInfo();
+	CHECK(info.HasXingFrame);
+	CHECK(info.TotalFrames == 2000);
+	CHECK(info.HasToc);
+	CHECK(info.DurationMs == uint64_t(2000) * 1152 * 1000 / 44100);
+
+	// The Xing frame itself is handed out first; it decodes to nothing.
+	CHECK(!stream.NextFrame().empty());
+	CHECK(Walk(stream) == Sequence(0, 2000));
+}
+
+TEST(Mp3, BufferedAndMappedAgree)
+{
+	const auto         track = Test::MakeMp3(3000, { .Id3Bytes = 30, .Vbr = true });
+	Test::MemorySource buffered(track.Bytes);
+	Test::MemorySource mapped(track.Bytes, true);
+	Mp3Stream          fromBuffer(buffered);
+	Mp3Stream          fromMapping(mapped);
+	CHECK(fromBuffer.Open());
+	CHECK(fromMapping.Open());
+
+	// Mapped frames are slices of the mapping itself, with no buffer behind them.
+	CHECK(fromMapping.GetBufferBytes() == 0);
+	CHECK(fromBuffer.GetBufferBytes() > 0);
+
+	uint32_t frames = 0;
+	uint32_t mismatches = 0;
+	uint32_t copies = 0;
+	for (;;) {
+		const auto a = fromBuffer.NextFrame();
+		const auto b = fromMapping.NextFrame();
+		if (a.empty() || b.empty()) {
+			CHECK(a.empty() && b.empty());
+			break;
+		}
+		mismatches += a.size() != b.size() || std::memcmp(a.data(), b.data(), a.size()) != 0;
+		copies += b.data() < mapped.Bytes.data() || b.data() + b.size() > mapped.Bytes.data() + mapped.Bytes.size();
+		++frames;
+	}
+	CHECK(frames == 3000);
+	CHECK(mismatches == 0);
+	CHECK(copies == 0);
+}
+
+TEST(Mp3, ShortReads)
+{
+	// A few bytes per Read, as from a slow connection: frames still come out whole.
+	const auto         track = Test::MakeMp3(500, { .Vbr = true });
+	Test::MemorySource source(track.Bytes, false, 7);
+	Mp3Stream          stream(source);
+	CHECK(stream.Open());
+	CHECK(Walk(stream) == Sequence(0, 500));
+}
+
+TEST(Mp3, ResyncsOverGarbage)
+{
+	for (const bool mapped : { false, true }) {
+		const auto         track = Test::MakeMp3(400, { .JunkEvery = 37 });
+		Test::MemorySource source(track.Bytes, mapped);
+		Mp3Stream          stream(source);
+		CHECK(stream.Open());
+		CHECK(Walk(stream) == Sequence(0, 400));
+	}
+}
+
+TEST(Mp3, TruncatedLastFrameIsDropped)
+{
+	auto track = Test::MakeMp3(50);
+	track.Bytes.resize(track.Bytes.size() - 100);
+
+	for (const bool mapped : { false, true }) {
+		Test::MemorySource source(track.Bytes, mapped);
+		Mp3Stream          stream(source);
+		CHECK(stream.Open());
+		CHECK(Walk(stream) == Sequence(0, 49));
+	}
+}
+
+TEST(Mp3, NotAnMp3)
+{
+	std::vector<uint8_t> text(5000, 'x');
+	Test::MemorySource   source(text);
+	Mp3Stream            stream(source);
+	CHECK(!stream.Open());
+
+	Test::MemorySource empty({});
+	Mp3Stream          nothing(empty);
+	CHECK(!nothing.Open());
+}
+
+TEST(Mp3, EstimatedSeeks)
+{
+	// Without an index: by bitrate on CBR, through the Xing TOC on VBR. Either lands within a
+	// percent of the track of the target.
+	for (const bool vbr : { false, true }) {
+		const auto         track = Test::MakeMp3(5000, { .Vbr = vbr, .Xing = vbr });
+		Test::MemorySource source(track.Bytes, !vbr);
+		Mp3Stream          stream(source);
+		CHECK(stream.Open());
+		CHECK(stream.IsSeekable());
+
+		for (const uint32_t ms : { 0u, 10'000u, 60'000u, 100'000u }) {
+			CHECK(stream.SeekToMs(ms));
+			CHECK(stream.GetSeekDiscard() == 0);
+
+			const auto     frame = stream.NextFrame();
+			const uint32_t target = static_cast<uint32_t>(uint64_t(ms) * 44100 / 1152 / 1000);
+			const uint32_t landed = Test::GetFrameNumber(frame);
+			CHECK(landed + 50 >= target && landed <= target + 50);
+		}
+
+		// Past the end is clamped to the end of the track.
+		CHECK(stream.SeekToMs(10'000'000));
+		const auto frames = Walk(stream);
+		CHECK(frames.size() <= 2);
+		CHECK(frames.empty() || frames.back() == 4999);
+	}
+}
+
+TEST(Mp3, LiveStreamsAreNotSeekable)
+{
+	// A source without a size, like a radio stream.
+	struct Live final : Test::MemorySource
+	{
+		using MemorySource::MemorySource;
+		uint64_t Size() const override { return 0; }
+	};
+
+	Live      source(Test::MakeMp3(20).Bytes);
+	Mp3Stream stream(source);
+	CHECK(stream.Open());
+	CHECK(stream.GetInfo().DurationMs == 0);
+	CHECK(!stream.IsSeekable());
+	CHECK(!stream.SeekToMs(1000));
+}
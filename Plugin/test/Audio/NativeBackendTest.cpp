@@ -0,0 +1,325 @@
+#include "Audio/NativeBackend.h"
+
+#include "Check.h"
+#include "Fixtures.h"
+
+using namespace Audio;
+
+namespace
+{
+	constexpr uint32_t    kSampleRate = 44100;
+	constexpr std::size_t kBlockFrames = 441;  // 10 ms
+
+	// Stations are named by the level they play at: "0.5" decodes to samples of 0.5. The level
+	// rides in every frame's payload, after the frame number.
+	class LevelDecoder final : public Decoder
+	{
+	public:
+		bool Open(const Mp3FrameHeader& InHeader) override
+		{
+			Header = InHeader;
+			return true;
+		}
+
+		std::size_t Decode(std::span<const uint8_t> InFrame, std::span<float> OutSamples) override
+		{
+			float level = 0.0f;
+			std::memcpy(&level, InFrame.data() + 8, sizeof(level));
+			const auto count = std::min<std::size_t>(OutSamples.size(), std::size_t(Header.SamplesPerFrame) * Header.Channels);
+			std::fill_n(OutSamples.data(), count, level);
+			return count;
+		}
+
+		void Reset() override {}
+
+	private:
+		Mp3FrameHeader Header;
+	};
+
+	std::vector<uint8_t> MakeStation(std::string_view InName, uint32_t InFrames)
+	{
+		auto        track = Test::MakeMp3(InFrames);
+		const float level = std::stof(std::string(InName));
+		for (const auto offset : track.FrameOffsets)
+			std::memcpy(track.Bytes.data() + offset + 8, &level, sizeof(level));
+		return std::move(track.Bytes);
+	}
+
+	std::unique_ptr<ByteSource> OpenStation(std::string_view InName, uint32_t InFrames)
+	{
+		return std::make_unique<Test::MemorySource>(MakeStation(InName, InFrames));
+	}
+
+	// A connection that stops delivering after InStallAt bytes, until cancelled.
+	class StallingSource final : public Test::MemorySource
+	{
+	public:
+		StallingSource(std::vector<uint8_t> InBytes, uint64_t InStallAt) :
+			MemorySource(std::move(InBytes)),
+			StallAt(InStallAt)
+		{
+		}
+
+		std::size_t Read(std::span<uint8_t> OutBytes) override
+		{
+			if (Position >= StallAt) {
+				std::unique_lock lock(Mutex);
+				Wake.wait(lock, [this] { return Cancelled; });
+				return 0;
+			}
+			return MemorySource::Read(OutBytes.first(std::min<std::size_t>(OutBytes.size(), StallAt - Position)));
+		}
+
+		void Cancel() override
+		{
+			{
+				std::lock_guard lock(Mutex);
+				Cancelled = true;
+			}
+			Wake.notify_all();
+		}
+
+	private:
+		uint64_t                StallAt;
+		std::mutex              Mutex;
+		std::condition_variable Wake;
+		bool                    Cancelled = false;
+	};
+
+	// The test thread is the render thread: it pulls blocks when it wants them.
+	class ManualSink final : public AudioSink
+	{
+	public:
+		bool Start(uint32_t InSampleRate, uint32_t InChannels, RenderCallback InCallback) override
+		{
+			SampleRate = InSampleRate;
+			Channels = InChannels;
+			Callback = std::move(InCallback);
+			return true;
+		}
+
+		void Stop() override { SampleRate = 0; }
+
+		RenderCallback Callback;
+	};
+
+	struct Harness
+	{
+		explicit Harness(uint32_t InFrames = 2000) :
+			Harness([InFrames](std::string_view InName) { return OpenStation(InName, InFrames); })
+		{
+		}
+
+		explicit Harness(SourceFactory InOpenSource)
+		{
+			auto sink = std::make_unique<ManualSink>();
+			Sink = sink.get();
+			Backend = std::make_unique<NativeBackend>(
+				std::move(sink),
+				std::move(InOpenSource),
+				[] { return std::make_unique<LevelDecoder>(); },
+				Directory / "index");
+		}
+
+		// One block; returns the first channel of every frame.
+		std::vector<float> Render(std::size_t InFrames = kBlockFrames)
+		{
+			std::vector<float> block(InFrames * 2);
+			Sink->Callback(block);
+
+			std::vector<float> left(InFrames);
+			for (std::size_t frame = 0; frame < InFrames; ++frame)
+				left[frame] = block[frame * 2];
+			return left;
+		}
+
+		// Renders until InDone says so, giving the decoder time between blocks.
+		bool RenderUntil(const std::function<bool(std::span<const float>)>& InDone, std::vector<float>* OutAll = nullptr, int InMaxBlocks = 1000)
+		{
+			for (int i = 0; i < InMaxBlocks; ++i) {
+				const auto block = Render();
+				if (OutAll)
+					OutAll->insert(OutAll->end(), block.begin(), block.end());
+				if (InDone(block))
+					return true;
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			return false;
+		}
+
+		Test::TempDirectory            Directory{ "backend" };
+		ManualSink*                    Sink = nullptr;
+		std::unique_ptr<NativeBackend> Backend;
+	};
+
+	bool AllAt(std::span<const float> InSamples, float InLevel)
+	{
+		return std::ranges::all_of(InSamples, [&](float InSample) { return std::abs(InSample - InLevel) < 1e-6f; });
+	}
+}
+
+TEST(NativeBackend, PlaysAStation)
+{
+	Harness harness;
+	CHECK(harness.Backend->Open("0.5"));
+	harness.Backend->PlayFrom(0);
+	CHECK(harness.RenderUntil([](auto InBlock) { return AllAt(InBlock, 0.5f); }));
+	CHECK(harness.Backend->GetLengthMs() > 0);
+}
+
+TEST(NativeBackend, CrossfadeIsSmooth)
+{
+	constexpr uint32_t kFadeMs = 200;
+
+	Harness harness;
+	harness.Backend->SetCrossfade(kFadeMs);
+	CHECK(harness.Backend->Open("1"));
+	harness.Backend->PlayFrom(0);
+	CHECK(harness.RenderUntil([](auto InBlock) { return AllAt(InBlock, 1.0f); }));
+
+	CHECK(harness.Backend->Open("-1"));
+	harness.Backend->PlayFrom(0);
+
+	std::vector<float> output;
+	CHECK(harness.RenderUntil([](auto InBlock) { return AllAt(InBlock, -1.0f); }, &output));
+
+	// From one level to the other without a step, and over the time asked for: the outgoing
+	// station holds its level until the incoming one has samples, then they cross.
+	float       largestStep = 0.0f;
+	std::size_t rising = 0;
+	for (std::size_t i = 1; i < output.size(); ++i) {
+		largestStep = std::max(largestStep, std::abs(output[i] - output[i - 1]));
+		rising += output[i] > output[i - 1] + 1e-6f;
+	}
+	CHECK(output.front() > 0.99f);
+	CHECK(rising == 0);
+
+	const std::size_t fadeFrames = kFadeMs * kSampleRate / 1000;
+	CHECK(largestStep <= 2.0f / fadeFrames * 1.01f);
+
+	const auto        fadeStart = std::ranges::find_if(output, [](float InSample) { return InSample < 1.0f - 1e-6f; });
+	const auto        fadeEnd = std::ranges::find_if(output, [](float InSample) { return InSample <= -1.0f + 1e-6f; });
+	const std::size_t measured = static_cast<std::size_t>(fadeEnd - fadeStart);
+	if (!CHECK(measured + 2 >= fadeFrames && measured <= fadeFrames + 2))
+		std::fprintf(stderr, "  fade of %zu frames, expected %zu\n", measured, fadeFrames);
+}
+
+TEST(NativeBackend, NoCrossfadeCuts)
+{
+	Harness harness;
+	harness.Backend->SetCrossfade(0);
+	CHECK(harness.Backend->Open("1"));
+	harness.Backend->PlayFrom(0);
+	CHECK(harness.RenderUntil([](auto InBlock) { return AllAt(InBlock, 1.0f); }));
+
+	CHECK(harness.Backend->Open("-1"));
+	harness.Backend->PlayFrom(0);
+
+	// Nothing of the old station once the switch is made: silence while the new one starts,
+	// then the new one.
+	std::vector<float> output;
+	CHECK(harness.RenderUntil([](auto InBlock) { return AllAt(InBlock, -1.0f); }, &output));
+	CHECK(std::ranges::none_of(output, [](float InSample) { return InSample > 0.0f; }));
+}
+
+TEST(NativeBackend, CrossfadeFromAStoppedStationCuts)
+{
+	Harness harness;
+	harness.Backend->SetCrossfade(500);
+	CHECK(harness.Backend->Open("1"));
+	harness.Backend->PlayFrom(0);
+	CHECK(harness.RenderUntil([](auto InBlock) { return AllAt(InBlock, 1.0f); }));
+	harness.Backend->Stop();
+	harness.Render();
+
+	CHECK(harness.Backend->Open("-1"));
+	harness.Backend->PlayFrom(0);
+	std::vector<float> output;
+	CHECK(harness.RenderUntil([](auto InBlock) { return AllAt(InBlock, -1.0f); }, &output));
+	CHECK(std::ranges::none_of(output, [](float InSample) { return InSample > 0.0f; }));
+}
+
+TEST(NativeBackend, SwitchingMidFadeCutsTheOldest)
+{
+	Harness harness;
+	harness.Backend->SetCrossfade(1000);
+	CHECK(harness.Backend->Open("1"));
+	harness.Backend->PlayFrom(0);
+	CHECK(harness.RenderUntil([](auto InBlock) { return AllAt(InBlock, 1.0f); }));
+
+	CHECK(harness.Backend->Open("-1"));
+	harness.Backend->PlayFrom(0);
+	CHECK(harness.RenderUntil([](auto InBlock) { return InBlock.back() < 0.9f; }));
+
+	// A third station while the first two are still crossing: the first is dropped, the
+	// second fades out against the third.
+	CHECK(harness.Backend->Open("0.25"));
+	harness.Backend->PlayFrom(0);
+	std::vector<float> output;
+	CHECK(harness.RenderUntil([](auto InBlock) { return AllAt(InBlock, 0.25f); }, &output));
+	CHECK(std::ranges::all_of(output, [](float InSample) { return InSample <= 0.9f; }));
+}
+
+TEST(NativeBackend, FillingUpIsNotAnUnderrun)
+{
+	// The first blocks after play, a seek or a switch find the ring empty; that is the
+	// decoder starting, not falling behind.
+	Harness harness;
+	CHECK(harness.Backend->Open("0.5"));
+	harness.Backend->PlayFrom(0);
+	harness.Render();
+	CHECK(harness.RenderUntil([](auto InBlock) { return AllAt(InBlock, 0.5f); }));
+
+	harness.Backend->PlayFrom(10'000);
+	harness.Render();
+	CHECK(harness.RenderUntil([](auto InBlock) { return AllAt(InBlock, 0.5f); }));
+
+	harness.Backend->SetCrossfade(0);
+	CHECK(harness.Backend->Open("0.25"));
+	harness.Backend->PlayFrom(0);
+	harness.Render();
+	CHECK(harness.RenderUntil([](auto InBlock) { return AllAt(InBlock, 0.25f); }));
+
+	// Stopped, the output is silent by choice.
+	harness.Backend->Stop();
+	for (int i = 0; i < 10; ++i)
+		harness.Render();
+
+	CHECK(harness.Backend->GetStats().Underruns == 0);
+}
+
+TEST(NativeBackend, EndOfTrackIsNotAnUnderrun)
+{
+	Harness harness(40);
+	harness.Backend->SetLooping(false);
+
+	std::atomic<bool> ended = false;
+	harness.Backend->SetTrackEndHandler([&] { ended = true; });
+	CHECK(harness.Backend->Open("0.5"));
+	harness.Backend->PlayFrom(0);
+	CHECK(harness.RenderUntil([&](auto) { return ended.load(); }));
+	for (int i = 0; i < 10; ++i)
+		harness.Render();
+
+	harness.Backend->SetTrackEndHandler({});
+	CHECK(harness.Backend->GetStats().Underruns == 0);
+}
+
+TEST(NativeBackend, StarvedOutputIsAnUnderrun)
+{
+	// The connection stalls 100 frames in: once those have played, every block comes up short.
+	Harness harness([](std::string_view InName) -> std::unique_ptr<ByteSource> {
+		auto bytes = MakeStation(InName, 2000);
+		return std::make_unique<StallingSource>(std::move(bytes), 100 * 417);
+	});
+	CHECK(harness.Backend->Open("0.5"));
+	harness.Backend->PlayFrom(0);
+	CHECK(harness.RenderUntil([](auto InBlock) { return AllAt(InBlock, 0.5f); }));
+
+	// 100 frames are about 2.6 s, well past by 500 blocks of 10 ms.
+	for (int i = 0; i < 500; ++i)
+		harness.Render();
+	const auto underruns = harness.Backend->GetStats().Underruns;
+	CHECK(underruns > 0);
+	CHECK(underruns <= 500);
+}
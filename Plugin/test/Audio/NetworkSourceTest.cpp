@@ -0,0 +1,241 @@
+#include "Audio/NetworkSource.h"
+
+#include "Check.h"
+#include "HttpServer.h"
+
+using namespace Audio;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	std::vector<uint8_t> MakeBody(std::size_t InSize)
+	{
+		std::vector<uint8_t> body(InSize);
+		std::mt19937         random(static_cast<uint32_t>(InSize));
+		for (auto& byte : body)
+			byte = static_cast<uint8_t>(random());
+		return body;
+	}
+
+	// Connects as Platform.cpp does, with the test client in place of WinHTTP; remembers the
+	// offset of every attempt.
+	struct Station
+	{
+		explicit Station(const Test::HttpServer& InServer) :
+			Port(InServer.GetPort())
+		{
+		}
+
+		bool Open()
+		{
+			return Source.Open([this](uint64_t InOffset) -> std::unique_ptr<ByteSource> {
+				{
+					std::lock_guard lock(Mutex);
+					Offsets.push_back(InOffset);
+				}
+				auto connection = std::make_unique<Test::HttpClient>();
+				if (!connection->Open(Port, InOffset))
+					return nullptr;
+				return connection;
+			});
+		}
+
+		// Reads until the end, or InLimit bytes, in reads of InChunk.
+		std::vector<uint8_t> ReadAll(std::size_t InLimit = SIZE_MAX, std::size_t InChunk = 4096, std::chrono::microseconds InPause = {})
+		{
+			std::vector<uint8_t> bytes;
+			std::vector<uint8_t> chunk(InChunk);
+			while (bytes.size() < InLimit) {
+				const auto count = Source.Read({ chunk.data(), std::min(chunk.size(), InLimit - bytes.size()) });
+				if (count == 0)
+					break;
+				bytes.insert(bytes.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(count));
+				if (InPause.count() > 0)
+					std::this_thread::sleep_for(InPause);
+			}
+			return bytes;
+		}
+
+		std::vector<uint64_t> GetOffsets()
+		{
+			std::lock_guard lock(Mutex);
+			return Offsets;
+		}
+
+		uint16_t              Port;
+		std::mutex            Mutex;
+		std::vector<uint64_t> Offsets;
+		NetworkSource         Source;  // last, so its reader stops before the rest goes
+	};
+}
+
+TEST(NetworkSource, ReadsTheWholeBody)
+{
+	const auto       body = MakeBody(1 << 20);
+	Test::HttpServer server(body);
+	Station          station(server);
+	CHECK(station.Open());
+	CHECK(station.Source.Size() == body.size());
+	CHECK(station.ReadAll() == body);
+	CHECK(station.Source.GetReconnects() == 0);
+	CHECK(server.GetRequests() == std::vector<uint64_t>{ 0 });
+}
+
+TEST(NetworkSource, FailsWhenUnreachable)
+{
+	// The first connection is made in Open, so a dead station fails right there.
+	uint16_t port = 0;
+	{
+		Test::HttpServer server({});
+		port = server.GetPort();
+	}
+	NetworkSource source;
+	CHECK(!source.Open([port](uint64_t InOffset) -> std::unique_ptr<ByteSource> {
+		auto connection = std::make_unique<Test::HttpClient>();
+		if (!connection->Open(port, InOffset))
+			return nullptr;
+		return connection;
+	}));
+}
+
+TEST(NetworkSource, ResumesWhereItDropped)
+{
+	// Every connection drops after 200 KB, with latency on each answer: the bytes still come
+	// out whole, each reconnect a Range request from where the last one stopped.
+	constexpr std::size_t kDropEvery = 200 * 1024;
+	const auto            body = MakeBody(1 << 20);
+	Test::HttpServer      server(body, { .DropEvery = kDropEvery, .Latency = 20ms, .ChunkBytes = 8 * 1024, .ChunkDelay = 1ms });
+	Station               station(server);
+	CHECK(station.Open());
+	CHECK(station.ReadAll() == body);
+
+	std::vector<uint64_t> expected;
+	for (uint64_t offset = 0; offset < body.size(); offset += kDropEvery)
+		expected.push_back(offset);
+	CHECK(server.GetRequests() == expected);
+	CHECK(station.GetOffsets() == expected);
+	CHECK(station.Source.GetReconnects() == expected.size() - 1);
+}
+
+TEST(NetworkSource, BacksOffWhileRefused)
+{
+	// After the drop, three attempts are turned away: 250 + 500 + 1000 ms of backoff, then
+	// the fourth resumes.
+	const auto       body = MakeBody(512 * 1024);
+	Test::HttpServer server(body, { .DropEvery = 256 * 1024, .RefuseFrom = 1, .RefuseCount = 3 });
+	Station          station(server);
+	CHECK(station.Open());
+
+	const auto start = Clock::now();
+	CHECK(station.ReadAll() == body);
+	const auto elapsed = Clock::now() - start;
+
+	CHECK(elapsed >= 1750ms);
+	CHECK(elapsed < 5s);
+	CHECK(server.GetConnections() == 5);
+	CHECK(station.GetOffsets() == std::vector<uint64_t>{ 0, 256 * 1024, 256 * 1024, 256 * 1024, 256 * 1024 });
+	CHECK(station.Source.GetReconnects() == 1);
+}
+
+TEST(NetworkSource, SteadyConnectionKeepsAShortDelay)
+{
+	// A reader slower than the connection never finds the buffer empty.
+	const auto       body = MakeBody(512 * 1024);
+	Test::HttpServer server(body);
+	Station          station(server);
+	CHECK(station.Open());
+	CHECK(station.ReadAll(SIZE_MAX, 4096, 500us) == body);
+	CHECK(station.Source.GetTarget() == NetworkSource::kMinTarget);
+}
+
+TEST(NetworkSource, UnderrunsGrowTheBuffer)
+{
+	// A connection slower than the reader: each time the buffer runs dry the target doubles,
+	// up to the cap.
+	const auto       body = MakeBody(384 * 1024);
+	Test::HttpServer server(body, { .ChunkBytes = 4 * 1024, .ChunkDelay = 2ms });
+	Station          station(server);
+	CHECK(station.Open());
+	CHECK(station.ReadAll() == body);
+	CHECK(station.Source.GetTarget() >= 4 * NetworkSource::kMinTarget);
+	CHECK(station.Source.GetTarget() <= NetworkSource::kMaxTarget);
+}
+
+TEST(NetworkSource, SeeksWithARangeRequest)
+{
+	const auto       body = MakeBody(1 << 20);
+	Test::HttpServer server(body, { .ChunkBytes = 4 * 1024, .ChunkDelay = 1ms });
+	Station          station(server);
+	CHECK(station.Open());
+	CHECK(station.ReadAll(4096) == std::vector(body.begin(), body.begin() + 4096));
+
+	constexpr uint64_t kTarget = 700'000;
+	CHECK(station.Source.Seek(kTarget));
+	CHECK(station.Source.Tell() == kTarget);
+	CHECK(station.ReadAll(8192) == std::vector(body.begin() + kTarget, body.begin() + kTarget + 8192));
+	CHECK(server.GetRequests().back() == kTarget);
+
+	// Past the end is refused; the end itself reads nothing.
+	CHECK(!station.Source.Seek(body.size() + 1));
+	CHECK(station.Source.Seek(body.size()));
+	CHECK(station.ReadAll().empty());
+}
+
+TEST(NetworkSource, SeekDropsWhatTheOldConnectionHeld)
+{
+	// The whole body arrives at once, so the reader fills the buffer and waits with bytes of
+	// the first response still unread; none of them may turn up after the seek.
+	const auto       body = MakeBody(1 << 20);
+	Test::HttpServer server(body);
+	for (const auto settle : { 0ms, 100ms }) {
+		Station station(server);
+		CHECK(station.Open());
+		std::this_thread::sleep_for(settle);
+
+		constexpr uint64_t kTarget = 400'000;
+		CHECK(station.Source.Seek(kTarget));
+		CHECK(station.ReadAll(8192) == std::vector(body.begin() + kTarget, body.begin() + kTarget + 8192));
+	}
+}
+
+TEST(NetworkSource, LiveStreamsReconnectFromNow)
+{
+	// No length, so nothing to resume: every reconnect starts the stream afresh, without Range.
+	const auto       body = MakeBody(100 * 1024);
+	Test::HttpServer server(body, { .DropEvery = 64 * 1024 }, Test::IcyStream{});
+	Station          station(server);
+	CHECK(station.Open());
+	CHECK(station.Source.Size() == 0);
+
+	const auto bytes = station.ReadAll(200 * 1024);
+	CHECK(bytes.size() == 200 * 1024);
+	CHECK(std::equal(body.begin(), body.begin() + 64 * 1024, bytes.begin()));
+	CHECK(std::equal(body.begin(), body.begin() + 64 * 1024, bytes.begin() + 64 * 1024));
+	CHECK(!station.Source.Seek(1000));
+
+	const auto offsets = station.GetOffsets();
+	CHECK(offsets.size() >= 4);
+	CHECK(std::ranges::all_of(offsets, [](uint64_t InOffset) { return InOffset == 0; }));
+}
+
+TEST(NetworkSource, CancelUnblocksARead)
+{
+	// The connection delivers one chunk and then stalls; the refill waits for more until
+	// Cancel, from another thread, ends it.
+	const auto       body = MakeBody(1 << 20);
+	Test::HttpServer server(body, { .ChunkBytes = 1024, .ChunkDelay = 60s });
+	Station          station(server);
+	CHECK(station.Open());
+
+	const auto  start = Clock::now();
+	std::thread canceller([&] {
+		std::this_thread::sleep_for(100ms);
+		station.Source.Cancel();
+	});
+	const auto bytes = station.ReadAll();
+	canceller.join();
+
+	CHECK(bytes.size() <= 1024);
+	CHECK(Clock::now() - start < 2s);
+}
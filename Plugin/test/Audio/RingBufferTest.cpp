@@ -0,0 +1,171 @@
+#include "Audio/RingBuffer.h"
+
+#include "Check.h"
+
+using Audio::RingBuffer;
+
+namespace
+{
+	// Items are their own index in the stream, so order and loss show up as a wrong value.
+	constexpr uint32_t kStressItems = 4'000'000;
+}
+
+TEST(RingBuffer, CapacityIsAPowerOfTwo)
+{
+	CHECK(RingBuffer<float>(0).Capacity() == 2);
+	CHECK(RingBuffer<float>(1000).Capacity() == 1024);
+	CHECK(RingBuffer<float>(1024).Capacity() == 1024);
+	CHECK(alignof(RingBuffer<float>) == 64);
+}
+
+TEST(RingBuffer, WrapsAround)
+{
+	RingBuffer<uint32_t>  ring(8);
+	std::vector<uint32_t> out(8);
+	uint32_t              next = 0;
+	uint32_t              expected = 0;
+
+	for (int round = 0; round < 100; ++round) {
+		std::array<uint32_t, 5> in;
+		for (auto& item : in)
+			item = next++;
+		CHECK(ring.Write(in) == in.size());
+		CHECK(ring.ReadAvailable() == in.size());
+
+		CHECK(ring.Read(out) == in.size());
+		for (std::size_t i = 0; i < in.size(); ++i)
+			CHECK(out[i] == expected++);
+	}
+}
+
+TEST(RingBuffer, FullWriteIsCutAndCounted)
+{
+	RingBuffer<uint32_t>         ring(8);
+	const std::vector<uint32_t> in(6, 7);
+
+	CHECK(ring.Write(in) == 6);
+	CHECK(ring.Write(in) == 2);
+	CHECK(ring.WriteAvailable() == 0);
+
+	const auto stats = ring.GetStats();
+	CHECK(stats.Overruns == 1);
+	CHECK(stats.HighWater == 8);
+}
+
+TEST(RingBuffer, ShortReadsAreNotCounted)
+{
+	// Prefill, drains and command batches all read more than is there; only the mixer knows
+	// when that is an underrun.
+	RingBuffer<uint32_t>  ring(16);
+	std::vector<uint32_t> out(64);
+
+	CHECK(ring.Read(out) == 0);
+	ring.Write(std::vector<uint32_t>(3, 1));
+	CHECK(ring.Read(out) == 3);
+
+	const auto stats = ring.GetStats();
+	CHECK(stats.Overruns == 0);
+	CHECK(stats.HighWater == 3);
+}
+
+TEST(RingBuffer, SkipToDropsStaleItems)
+{
+	RingBuffer<uint32_t>  ring(16);
+	std::vector<uint32_t> out(16);
+
+	ring.Write(std::vector<uint32_t>{ 1, 2, 3, 4 });
+	const auto mark = ring.WriteIndex();
+	ring.Write(std::vector<uint32_t>{ 5, 6 });
+
+	ring.SkipTo(mark);
+	CHECK(ring.Read(out) == 2);
+	CHECK(out[0] == 5);
+	CHECK(out[1] == 6);
+
+	// A mark the consumer is already past is ignored.
+	ring.SkipTo(mark);
+	CHECK(ring.ReadAvailable() == 0);
+}
+
+TEST(RingBuffer, ProducerConsumerStress)
+{
+	// Random block sizes on both sides and the odd stall, so the ring spends time full, empty
+	// and wrapping mid-block.
+	RingBuffer<uint32_t> ring(1024);
+
+	std::thread producer([&] {
+		std::mt19937          random(1);
+		std::vector<uint32_t> block(700);
+		uint32_t              next = 0;
+		while (next < kStressItems) {
+			const std::size_t size = std::min<std::size_t>(random() % block.size() + 1, kStressItems - next);
+			for (std::size_t i = 0; i < size; ++i)
+				block[i] = next + static_cast<uint32_t>(i);
+			next += static_cast<uint32_t>(ring.Write({ block.data(), size }));
+			if (random() % 1000 == 0)
+				std::this_thread::sleep_for(std::chrono::microseconds(random() % 200));
+		}
+	});
+
+	std::mt19937          random(2);
+	std::vector<uint32_t> block(700);
+	uint32_t              expected = 0;
+	uint32_t              misordered = 0;
+	while (expected < kStressItems) {
+		const auto count = ring.Read({ block.data(), random() % block.size() + 1 });
+		for (std::size_t i = 0; i < count; ++i)
+			misordered += block[i] != expected++;
+		if (random() % 1000 == 0)
+			std::this_thread::sleep_for(std::chrono::microseconds(random() % 200));
+	}
+	producer.join();
+
+	CHECK(misordered == 0);
+	CHECK(ring.ReadAvailable() == 0);
+	CHECK(ring.GetStats().HighWater <= ring.Capacity());
+}
+
+TEST(RingBuffer, SkipWhileProducing)
+{
+	// The mixer flushes with SkipTo while the decoder keeps writing: whatever is read after a
+	// skip must still be in order and never older than the mark.
+	RingBuffer<uint32_t>  ring(256);
+	std::atomic<bool>     done = false;
+	std::atomic<uint32_t> mark = 0;
+
+	std::thread producer([&] {
+		std::array<uint32_t, 37> block;
+		uint32_t                 next = 0;
+		while (next < kStressItems / 4) {
+			for (std::size_t i = 0; i < block.size(); ++i)
+				block[i] = next + static_cast<uint32_t>(i);
+			const auto written = static_cast<uint32_t>(ring.Write(block));
+			next += written;
+			if (next % 4096 < written)
+				mark.store(static_cast<uint32_t>(ring.WriteIndex()), std::memory_order_release);
+			if (written == 0)
+				std::this_thread::yield();
+		}
+		done = true;
+	});
+
+	std::array<uint32_t, 53> block;
+	uint32_t                 last = 0;
+	bool                     first = true;
+	uint32_t                 problems = 0;
+	while (!done || ring.ReadAvailable() > 0) {
+		const uint32_t floor = mark.load(std::memory_order_acquire);
+		ring.SkipTo(floor);
+		const auto count = ring.Read(block);
+		for (std::size_t i = 0; i < count; ++i) {
+			problems += block[i] < floor || (!first && block[i] <= last);
+			last = block[i];
+			first = false;
+		}
+		if (count == 0)
+			std::this_thread::yield();
+	}
+	producer.join();
+
+	CHECK(problems == 0);
+}
@@ -0,0 +1,54 @@
+#include "Audio/SeekIndex.h"
+
+#include "Bench.h"
+#include "Check.h"
+#include "Fixtures.h"
+
+using namespace Audio;
+
+namespace
+{
+	// RADIO_BENCH_SEEK_MINUTES sets the longest track; ctest stops at an hour.
+	uint32_t GetLongestMinutes()
+	{
+		const char* minutes = std::getenv("RADIO_BENCH_SEEK_MINUTES");
+		return minutes ? static_cast<uint32_t>(std::strtoul(minutes, nullptr, 10)) : 60;
+	}
+}
+
+TEST(SeekIndexBench, SeekLatencyAgainstTrackLength)
+{
+	// Random sample-accurate seeks, each followed by the first frame read. Without an index
+	// the only exact way there is a scan from the start, timed for comparison.
+	std::printf("microseconds per exact seek, VBR 44.1 kHz, mapped:\n");
+	for (uint32_t minutes = 1; minutes <= GetLongestMinutes(); minutes *= minutes < 10 ? 10 : 6) {
+		const auto         frames = static_cast<uint32_t>(uint64_t(minutes) * 60 * 44100 / 1152);
+		const auto         track = Test::MakeMp3(frames, { .Vbr = true });
+		Test::MemorySource source(track.Bytes, true);
+		Mp3Stream          stream(source);
+		CHECK(stream.Open());
+
+		const auto start = std::chrono::steady_clock::now();
+		stream.SetSeekIndex(SeekIndex::Build(stream, [] { return true; }));
+		const double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		std::mt19937 random(minutes);
+		const double indexed = Test::Measure(std::format("{} min, indexed", minutes), 1, "seeks", [&] {
+			stream.SeekToMs(random() % (minutes * 60'000));
+			Test::KeepAlive(stream.NextFrame().size());
+		});
+
+		const double scanned = Test::Measure(std::format("{} min, scanned from the start", minutes), 1, "seeks", [&] {
+			const uint32_t target = random() % frames;
+			source.Position = track.DataOffset;
+			Mp3Stream scan(source);
+			scan.Open();
+			for (uint32_t frame = 0; frame < target; ++frame)
+				scan.NextFrame();
+			Test::KeepAlive(scan.NextFrame().size());
+		});
+
+		std::printf("  %u min: %.2f us indexed, %.0f us scanned, index built in %.1f ms\n", minutes, 1e6 / indexed, 1e6 / scanned, buildMs);
+		CHECK(indexed > scanned);
+	}
+}
@@ -0,0 +1,176 @@
+#include "Audio/SeekIndex.h"
+
+#include "Check.h"
+#include "Fixtures.h"
+
+using namespace Audio;
+
+namespace
+{
+	constexpr uint32_t kFrames = 5000;
+
+	std::shared_ptr<const SeekIndex> BuildIndex(const Test::Mp3Track& InTrack, bool InMapped = false)
+	{
+		Test::MemorySource source(InTrack.Bytes, InMapped);
+		Mp3Stream          stream(source);
+		if (!stream.Open())
+			return nullptr;
+		return SeekIndex::Build(stream, [] { return true; });
+	}
+
+	// Waits for a background build, or gives up after a while.
+	std::shared_ptr<const SeekIndex> WaitFor(const SeekIndexRequest& InRequest)
+	{
+		for (int i = 0; i < 500; ++i) {
+			if (auto index = InRequest.Result.load())
+				return index;
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return nullptr;
+	}
+}
+
+TEST(SeekIndex, IndexesEveryIntervalFrame)
+{
+	const auto track = Test::MakeMp3(kFrames, { .Id3Bytes = 100, .Vbr = true });
+	for (const bool mapped : { false, true }) {
+		const auto index = BuildIndex(track, mapped);
+		CHECK(index != nullptr);
+		CHECK(index->GetTotalFrames() == kFrames);
+
+		uint32_t wrong = 0;
+		for (uint32_t frame = 0; frame < kFrames; frame += 7) {
+			uint32_t   indexed = 0;
+			const auto offset = index->GetOffset(frame, indexed);
+			wrong += indexed != frame / SeekIndex::kIntervalFrames * SeekIndex::kIntervalFrames || offset != track.FrameOffsets[indexed];
+		}
+		CHECK(wrong == 0);
+
+		// Past the last frame: the last indexed point.
+		uint32_t indexed = 0;
+		index->GetOffset(kFrames * 2, indexed);
+		CHECK(indexed == (kFrames - 1) / SeekIndex::kIntervalFrames * SeekIndex::kIntervalFrames);
+	}
+}
+
+TEST(SeekIndex, SkipsTheXingFrame)
+{
+	const auto track = Test::MakeMp3(kFrames, { .Vbr = true, .Xing = true });
+	const auto index = BuildIndex(track);
+	CHECK(index && index->GetTotalFrames() == kFrames);
+
+	uint32_t indexed = 0;
+	CHECK(index->GetOffset(0, indexed) == track.FrameOffsets[0]);
+}
+
+TEST(SeekIndex, SeeksAreSampleAccurate)
+{
+	// The stream lands a couple of frames early for the decoder to prime; the frames and
+	// samples to drop add up to exactly the target.
+	const auto         track = Test::MakeMp3(kFrames, { .Vbr = true });
+	Test::MemorySource source(track.Bytes);
+	Mp3Stream          stream(source);
+	CHECK(stream.Open());
+	stream.SetSeekIndex(BuildIndex(track));
+	CHECK(stream.HasSeekIndex());
+
+	for (const uint32_t ms : { 0u, 1u, 26u, 1000u, 33'333u, 60'000u, 123'456u, 130'000u }) {
+		CHECK(stream.SeekToMs(ms));
+		const uint32_t first = Test::GetFrameNumber(stream.NextFrame());
+
+		const uint64_t target = uint64_t(ms) * 44100 / 1000;
+		const uint64_t landed = uint64_t(first) * 1152 + stream.GetSeekDiscard();
+		CHECK(landed == target);
+		CHECK(stream.GetSeekDiscard() <= 3 * 1152);
+	}
+
+	// Beyond the end: the start of the last frame.
+	CHECK(stream.SeekToMs(10'000'000));
+	const uint32_t last = Test::GetFrameNumber(stream.NextFrame());
+	CHECK(uint64_t(last) * 1152 + stream.GetSeekDiscard() == uint64_t(kFrames - 1) * 1152);
+}
+
+TEST(SeekIndex, BuildStopsWhenNotWanted)
+{
+	const auto         track = Test::MakeMp3(kFrames);
+	Test::MemorySource source(track.Bytes);
+	Mp3Stream          stream(source);
+	CHECK(stream.Open());
+
+	int checks = 0;
+	CHECK(SeekIndex::Build(stream, [&] { return ++checks < 2; }) == nullptr);
+	CHECK(checks == 2);
+}
+
+TEST(SeekIndex, SaveAndLoad)
+{
+	const Test::TempDirectory directory("seekindex");
+	const auto                path = directory / "track.seek";
+	const auto                track = Test::MakeMp3(kFrames, { .Vbr = true });
+	const auto                index = BuildIndex(track);
+	CHECK(index->Save(path, 1234, 5678));
+
+	const auto loaded = SeekIndex::Load(path, 1234, 5678);
+	CHECK(loaded && loaded->GetTotalFrames() == kFrames);
+	uint32_t wrong = 0;
+	for (uint32_t frame = 0; frame < kFrames; frame += SeekIndex::kIntervalFrames) {
+		uint32_t a = 0;
+		uint32_t b = 0;
+		wrong += index->GetOffset(frame, a) != loaded->GetOffset(frame, b) || a != b;
+	}
+	CHECK(wrong == 0);
+
+	// A track that changed since has to be scanned again.
+	CHECK(SeekIndex::Load(path, 1235, 5678) == nullptr);
+	CHECK(SeekIndex::Load(path, 1234, 5679) == nullptr);
+	CHECK(SeekIndex::Load(directory / "missing.seek", 1234, 5678) == nullptr);
+
+	// Cut short or not an index at all.
+	const auto size = std::filesystem::file_size(path);
+	std::filesystem::resize_file(path, size - 8);
+	CHECK(SeekIndex::Load(path, 1234, 5678) == nullptr);
+	Test::WriteFile(path, "not a seek index, just some text that is long enough");
+	CHECK(SeekIndex::Load(path, 1234, 5678) == nullptr);
+}
+
+TEST(SeekIndex, IndexerBuildsOnceAndKeepsIt)
+{
+	const Test::TempDirectory directory("seekindexer");
+	const auto                trackPath = directory / "track.mp3";
+	const auto                track = Test::MakeMp3(kFrames, { .Vbr = true });
+	Test::WriteFile(trackPath, track.Bytes);
+
+	std::atomic<int> opens = 0;
+	const auto       openSource = [&](std::string_view InPath) -> std::unique_ptr<ByteSource> {
+		++opens;
+		auto source = std::make_unique<FileSource>();
+		if (!source->Open(std::filesystem::path(InPath)))
+			return nullptr;
+		return source;
+	};
+
+	const std::string path = trackPath.string();
+	{
+		SeekIndexer indexer(openSource, directory / "index");
+		const auto  request = indexer.Request(path);
+		const auto  index = WaitFor(*request);
+		CHECK(index && index->GetTotalFrames() == kFrames);
+		CHECK(opens == 1);
+	}
+
+	// A new indexer, as on the next launch, finds it on disk.
+	{
+		SeekIndexer indexer(openSource, directory / "index");
+		const auto  request = indexer.Request(path);
+		const auto  index = WaitFor(*request);
+		CHECK(index && index->GetTotalFrames() == kFrames);
+		CHECK(opens == 1);
+	}
+
+	// Nobody waiting: the request is dropped unopened.
+	{
+		SeekIndexer indexer(openSource, directory / "other");
+		indexer.Request(path).reset();
+	}
+	CHECK(opens <= 2);
+}
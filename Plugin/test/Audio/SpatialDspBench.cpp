@@ -0,0 +1,52 @@
+#include "Audio/SpatialDsp.h"
+
+#include "Bench.h"
+#include "Check.h"
+#include "Wav.h"
+
+using namespace Audio;
+
+// Share of one core the chain takes per preset, at the sink's block size. RADIO_BENCH_WAV runs
+// a WAV file of your own instead of noise, and writes what each preset makes of it next to it.
+TEST(SpatialDspBench, ShareOfACore)
+{
+	Test::Wav input{ std::vector<float>(48000 * 2), 2, 48000 };
+	std::mt19937                          random(1);
+	std::uniform_real_distribution<float> sample(-0.5f, 0.5f);
+	for (auto& value : input.Samples)
+		value = sample(random);
+
+	const char* path = std::getenv("RADIO_BENCH_WAV");
+	if (path) {
+		if (const auto wav = Test::ReadWav(path); wav && wav->Channels <= 2)
+			input = *wav;
+		else
+			std::printf("cannot use %s, running noise\n", path);
+	}
+
+	constexpr std::size_t kBlockFrames = 480;
+	const std::size_t     block = kBlockFrames * input.Channels;
+	const double          blockSeconds = static_cast<double>(kBlockFrames) / input.SampleRate;
+
+	for (const auto preset : { SpatialPreset::Off, SpatialPreset::Cockpit, SpatialPreset::Outdoors, SpatialPreset::Interior }) {
+		SpatialChain chain;
+		chain.SetParams(GetSpatialParams(preset));
+
+		auto        output = input;
+		std::size_t offset = 0;
+		const double rate = Test::Measure(std::format("preset {}", static_cast<uint32_t>(preset)), 1, "blocks", [&] {
+			if (offset + block > output.Samples.size()) {
+				if (path)
+					return;
+				offset = 0;
+			}
+			chain.Process(std::span(output.Samples).subspan(offset, block), input.Channels, input.SampleRate);
+			offset += block;
+		});
+		std::printf("  preset %u: %.3f %% of a core\n", static_cast<uint32_t>(preset), 100.0 / (rate * blockSeconds));
+		CHECK(100.0 / (rate * blockSeconds) < 1.0);
+
+		if (path)
+			Test::WriteWav(std::format("{}.preset{}.wav", path, static_cast<uint32_t>(preset)), output);
+	}
+}
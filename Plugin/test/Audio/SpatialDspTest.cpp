@@ -0,0 +1,276 @@
+#include "Audio/SpatialDsp.h"
+
+#include "Check.h"
+#include "Fixtures.h"
+#include "Wav.h"
+
+using namespace Audio;
+
+namespace
+{
+	constexpr uint32_t    kSampleRate = 48000;
+	constexpr std::size_t kBlockFrames = 480;
+
+	Test::Wav Sine(float InHz, float InSeconds, uint32_t InChannels = 2, float InLevel = 0.5f)
+	{
+		Test::Wav wav{ {}, InChannels, kSampleRate };
+		const auto frames = static_cast<std::size_t>(InSeconds * kSampleRate);
+		wav.Samples.resize(frames * InChannels);
+		for (std::size_t frame = 0; frame < frames; ++frame) {
+			const float sample = InLevel * std::sin(2.0f * std::numbers::pi_v<float> * InHz * static_cast<float>(frame) / kSampleRate);
+			for (uint32_t channel = 0; channel < InChannels; ++channel)
+				wav.Samples[frame * InChannels + channel] = sample;
+		}
+		return wav;
+	}
+
+	Test::Wav Noise(float InSeconds, uint32_t InSeed)
+	{
+		Test::Wav                             wav{ std::vector<float>(static_cast<std::size_t>(InSeconds * kSampleRate) * 2), 2, kSampleRate };
+		std::mt19937                          random(InSeed);
+		std::uniform_real_distribution<float> sample(-0.5f, 0.5f);
+		for (auto& value : wav.Samples)
+			value = sample(random);
+		return wav;
+	}
+
+	// Block by block, as the render thread would.
+	void Process(SpatialChain& InOutChain, Test::Wav& InOutWav)
+	{
+		const std::size_t block = kBlockFrames * InOutWav.Channels;
+		for (std::size_t offset = 0; offset < InOutWav.Samples.size(); offset += block)
+			InOutChain.Process(std::span(InOutWav.Samples).subspan(offset, std::min(block, InOutWav.Samples.size() - offset)), InOutWav.Channels, InOutWav.SampleRate);
+	}
+
+	// RMS of one channel over the second half, once smoothing has settled.
+	float SettledRms(const Test::Wav& InWav, uint32_t InChannel)
+	{
+		double            sum = 0.0;
+		const std::size_t first = InWav.GetFrames() / 2;
+		for (std::size_t frame = first; frame < InWav.GetFrames(); ++frame) {
+			const double sample = InWav.Samples[frame * InWav.Channels + InChannel];
+			sum += sample * sample;
+		}
+		return static_cast<float>(std::sqrt(sum / static_cast<double>(InWav.GetFrames() - first)));
+	}
+
+	float ToDb(float InRatio)
+	{
+		return 20.0f * std::log10(std::max(InRatio, 1e-9f));
+	}
+
+	float MaxStep(const Test::Wav& InWav, uint32_t InChannel)
+	{
+		float step = 0.0f;
+		for (std::size_t frame = 1; frame < InWav.GetFrames(); ++frame)
+			step = std::max(step, std::abs(InWav.Samples[frame * InWav.Channels + InChannel] - InWav.Samples[(frame - 1) * InWav.Channels + InChannel]));
+		return step;
+	}
+}
+
+TEST(SpatialDsp, OffIsBypassed)
+{
+	// Bit for bit, in mono and stereo.
+	for (const uint32_t channels : { 1u, 2u }) {
+		SpatialChain chain;
+		auto         wav = Sine(440.0f, 0.5f, channels);
+		const auto   input = wav.Samples;
+		Process(chain, wav);
+		CHECK(wav.Samples == input);
+	}
+}
+
+TEST(SpatialDsp, LowpassMuffles)
+{
+	// 12 dB/octave from 1 kHz: a 100 Hz tone passes, an 8 kHz one is well down.
+	SpatialParams params;
+	params.LowpassHz = 1000.0f;
+
+	for (const auto& [hz, lowDb, highDb] : { std::tuple(100.0f, -1.0f, 0.1f), std::tuple(8000.0f, -60.0f, -25.0f) }) {
+		SpatialChain chain;
+		chain.SetParams(params);
+		auto wav = Sine(hz, 1.0f);
+		Process(chain, wav);
+
+		const float gainDb = ToDb(SettledRms(wav, 0) / (0.5f / std::numbers::sqrt2_v<float>));
+		if (!CHECK(gainDb >= lowDb && gainDb <= highDb))
+			std::fprintf(stderr, "  %.0f Hz: %.1f dB\n", hz, gainDb);
+	}
+}
+
+TEST(SpatialDsp, PanIsConstantPower)
+{
+	for (const float pan : { -1.0f, -0.5f, 0.0f, 0.3f, 1.0f }) {
+		SpatialChain chain;
+		chain.SetParams({ .Pan = pan });
+		auto wav = Sine(440.0f, 1.0f);
+		Process(chain, wav);
+
+		// Centre leaves both sides at unity; total power stays that of the centre.
+		const float input = 0.5f / std::numbers::sqrt2_v<float>;
+		const float left = SettledRms(wav, 0) / input;
+		const float right = SettledRms(wav, 1) / input;
+		CHECK(std::abs(left * left + right * right - 2.0f) < 0.01f);
+		CHECK(pan > 0.0f ? right > left : pan < 0.0f ? left > right : std::abs(left - right) < 1e-3f);
+	}
+
+	SpatialChain hardLeft;
+	hardLeft.SetParams({ .Pan = -1.0f });
+	auto wav = Sine(440.0f, 1.0f);
+	Process(hardLeft, wav);
+	CHECK(SettledRms(wav, 1) < 1e-4f);
+}
+
+TEST(SpatialDsp, ReverbTailDecays)
+{
+	// An impulse into the Interior room: a tail follows, and a bigger room rings longer.
+	const auto tailEnergy = [](float InDecay) {
+		SpatialChain chain;
+		chain.SetParams({ .ReverbSend = 1.0f, .ReverbDecay = InDecay });
+		Test::Wav settle = Test::Wav{ std::vector<float>(kSampleRate / 2 * 2, 0.0f), 2, kSampleRate };
+		Process(chain, settle);
+
+		Test::Wav impulse{ std::vector<float>(kSampleRate * 2 * 2, 0.0f), 2, kSampleRate };
+		impulse.Samples[0] = impulse.Samples[1] = 1.0f;
+		Process(chain, impulse);
+
+		// Energy in the second half-second, against the first.
+		double early = 0.0;
+		double late = 0.0;
+		for (std::size_t frame = 0; frame < kSampleRate; ++frame) {
+			const double sample = impulse.Samples[frame * 2];
+			(frame < kSampleRate / 2 ? early : late) += sample * sample;
+		}
+		return std::pair(early, late);
+	};
+
+	const auto [smallEarly, smallLate] = tailEnergy(0.2f);
+	const auto [largeEarly, largeLate] = tailEnergy(0.9f);
+	CHECK(smallEarly > 0.0);
+	CHECK(smallLate < smallEarly);
+	CHECK(largeLate / largeEarly > smallLate / smallEarly);
+}
+
+TEST(SpatialDsp, ReturnsToBypassAfterTheTail)
+{
+	SpatialChain chain;
+	chain.SetParams(GetSpatialParams(SpatialPreset::Interior));
+	auto noise = Noise(1.0f, 1);
+	Process(chain, noise);
+
+	// Off again: the tail rings out, then the input passes untouched.
+	chain.SetParams(GetSpatialParams(SpatialPreset::Off));
+	auto silence = Test::Wav{ std::vector<float>(kSampleRate * 4 * 2, 0.0f), 2, kSampleRate };
+	Process(chain, silence);
+
+	auto       after = Noise(0.5f, 2);
+	const auto input = after.Samples;
+	Process(chain, after);
+	CHECK(after.Samples == input);
+}
+
+TEST(SpatialDsp, ChangesAreSmoothed)
+{
+	// Every preset change on a steady tone, back to back, without a click: no sample moves
+	// further than the tone itself can in one frame plus a little.
+	const float toneStep = 0.5f * 2.0f * std::numbers::pi_v<float> * 440.0f / kSampleRate;
+
+	SpatialChain chain;
+	auto         wav = Sine(440.0f, 2.0f);
+	const auto   block = kBlockFrames * 2;
+	const SpatialPreset presets[] = { SpatialPreset::Cockpit, SpatialPreset::Outdoors, SpatialPreset::Interior, SpatialPreset::Off };
+	for (std::size_t offset = 0, index = 0; offset < wav.Samples.size(); offset += block, ++index) {
+		if (index % 25 == 0)
+			chain.SetParams(GetSpatialParams(presets[(index / 25) % std::size(presets)]));
+		if (index % 40 == 7)
+			chain.SetParams({ .Pan = index % 80 == 7 ? -1.0f : 1.0f });
+		chain.Process(std::span(wav.Samples).subspan(offset, std::min(block, wav.Samples.size() - offset)), 2, kSampleRate);
+	}
+
+	CHECK(MaxStep(wav, 0) < toneStep * 1.5f + 0.01f);
+	CHECK(MaxStep(wav, 1) < toneStep * 1.5f + 0.01f);
+}
+
+TEST(SpatialDsp, StaysFiniteAndBounded)
+{
+	// Minutes of loud noise through the largest room, in mono and stereo, at 44.1 and 48 kHz.
+	for (const uint32_t channels : { 1u, 2u }) {
+		for (const uint32_t rate : { 44100u, 48000u }) {
+			SpatialChain chain;
+			chain.SetParams({ 3000.0f, 1.0f, 1.0f, 0.0f, 1.0f });
+
+			std::mt19937                          random(rate + channels);
+			std::uniform_real_distribution<float> sample(-1.0f, 1.0f);
+			std::vector<float>                    block(kBlockFrames * channels);
+			float                                 peak = 0.0f;
+			bool                                  finite = true;
+			for (int i = 0; i < 60 * 100; ++i) {
+				for (auto& value : block)
+					value = sample(random);
+				chain.Process(block, channels, rate);
+				for (const float value : block) {
+					finite = finite && std::isfinite(value);
+					peak = std::max(peak, std::abs(value));
+				}
+			}
+			CHECK(finite);
+			CHECK(peak < 4.0f);
+		}
+	}
+}
+
+TEST(SpatialDsp, WavFixtures)
+{
+	// The regression fixtures: a tone sweep and noise, written as WAV, read back and run
+	// through every preset. Each preset lands in its expected loudness band.
+	const Test::TempDirectory directory("spatial");
+
+	Test::Wav sweep{ {}, 2, kSampleRate };
+	for (std::size_t frame = 0; frame < kSampleRate * 2; ++frame) {
+		const float t = static_cast<float>(frame) / kSampleRate;
+		const float sample = 0.4f * std::sin(2.0f * std::numbers::pi_v<float> * (50.0f * t + 2500.0f * t * t));
+		sweep.Samples.push_back(sample);
+		sweep.Samples.push_back(sample);
+	}
+	CHECK(Test::WriteWav(directory / "sweep.wav", sweep));
+	CHECK(Test::WriteWav(directory / "noise.wav", Noise(2.0f, 7)));
+
+	// Measured when the chain was last tuned; a change here is a change in how the radio sounds.
+	struct Expected
+	{
+		const char*   Fixture;
+		SpatialPreset Preset;
+		float         Db;
+	};
+	constexpr Expected kExpected[] = {
+		{ "sweep.wav", SpatialPreset::Off, 0.0f },
+		{ "sweep.wav", SpatialPreset::Cockpit, -6.64f },
+		{ "sweep.wav", SpatialPreset::Outdoors, -11.66f },
+		{ "sweep.wav", SpatialPreset::Interior, -5.75f },
+		{ "noise.wav", SpatialPreset::Off, 0.0f },
+		{ "noise.wav", SpatialPreset::Cockpit, -6.85f },
+		{ "noise.wav", SpatialPreset::Outdoors, -9.48f },
+		{ "noise.wav", SpatialPreset::Interior, -6.62f },
+	};
+
+	for (const auto& expected : kExpected) {
+		const auto input = Test::ReadWav(directory / expected.Fixture);
+		CHECK(input.has_value());
+		if (!input)
+			continue;
+
+		auto         output = *input;
+		SpatialChain chain;
+		chain.SetParams(GetSpatialParams(expected.Preset));
+		Process(chain, output);
+
+		const auto file = directory / std::format("{}.{}.wav", expected.Fixture, static_cast<uint32_t>(expected.Preset));
+		CHECK(Test::WriteWav(file, output));
+		const auto reread = Test::ReadWav(file);
+		CHECK(reread && reread->Samples == output.Samples);
+
+		const float db = ToDb(SettledRms(output, 0) / SettledRms(*input, 0));
+		if (!CHECK(std::abs(db - expected.Db) < 0.5f))
+			std::fprintf(stderr, "  %s, preset %u: %.2f dB\n", expected.Fixture, static_cast<uint32_t>(expected.Preset), db);
+	}
+}
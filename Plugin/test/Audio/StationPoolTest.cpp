@@ -0,0 +1,326 @@
+#include "Audio/StationPool.h"
+#include "Config/StationTable.h"
+
+#include "Check.h"
+#include "Fixtures.h"
+#include "HttpServer.h"
+
+using namespace Audio;
+
+// Every allocation in this executable goes through here, so a test can see that a stretch of
+// code made none. Only the calling thread's are counted; the pool's worker allocates as it
+// opens stations.
+namespace
+{
+	thread_local std::size_t Allocations = 0;
+}
+
+void* operator new(std::size_t InBytes)
+{
+	++Allocations;
+	if (void* memory = std::malloc(InBytes > 0 ? InBytes : 1))
+		return memory;
+	throw std::bad_alloc();
+}
+
+// Out of line, or GCC sees free() meet a pointer from operator new and warns of a mismatch.
+#ifdef _MSC_VER
+#	define RADIO_NOINLINE __declspec(noinline)
+#else
+#	define RADIO_NOINLINE [[gnu::noinline]]
+#endif
+
+RADIO_NOINLINE void operator delete(void* InMemory) noexcept
+{
+	std::free(InMemory);
+}
+
+RADIO_NOINLINE void operator delete(void* InMemory, std::size_t) noexcept
+{
+	std::free(InMemory);
+}
+
+namespace
+{
+	// A connection that delivers nothing until let through, or until cancelled, when it ends.
+	class HeldSource final : public Test::MemorySource
+	{
+	public:
+		using MemorySource::MemorySource;
+
+		std::size_t Read(std::span<uint8_t> OutBytes) override
+		{
+			{
+				std::unique_lock lock(Mutex);
+				Wake.wait(lock, [this] { return Released || Cancelled; });
+				if (Cancelled)
+					return 0;
+			}
+			return MemorySource::Read(OutBytes);
+		}
+
+		void Release() { Set(Released); }
+		void Cancel() override { Set(Cancelled); }
+
+	private:
+		void Set(bool& OutFlag)
+		{
+			{
+				std::lock_guard lock(Mutex);
+				OutFlag = true;
+			}
+			Wake.notify_all();
+		}
+
+		std::mutex              Mutex;
+		std::condition_variable Wake;
+		bool                    Released = false;
+		bool                    Cancelled = false;
+	};
+
+	// Hands the pool held sources and keeps track of them, so a test can tell when an open
+	// has started and let it go on.
+	struct Opener
+	{
+		std::unique_ptr<ByteSource> Open(std::string_view)
+		{
+			auto source = std::make_unique<HeldSource>(Test::MakeMp3(50).Bytes);
+			{
+				std::lock_guard lock(Mutex);
+				Sources.push_back(source.get());
+			}
+			Changed.notify_all();
+			return source;
+		}
+
+		// The source of the InCount-th open, once it has been asked for.
+		HeldSource* WaitForOpen(std::size_t InCount)
+		{
+			std::unique_lock lock(Mutex);
+			Changed.wait_for(lock, 5s, [&] { return Sources.size() >= InCount; });
+			return Sources.size() >= InCount ? Sources[InCount - 1] : nullptr;
+		}
+
+		std::mutex               Mutex;
+		std::condition_variable  Changed;
+		std::vector<HeldSource*> Sources;  // only used while the pool is still opening them
+	};
+
+	std::unique_ptr<StationPool> MakePool(Opener& InOpener)
+	{
+		return std::make_unique<StationPool>(
+			[&InOpener](std::string_view InSource) { return InOpener.Open(InSource); },
+			[] { return std::make_unique<SilentDecoder>(); });
+	}
+
+	std::unique_ptr<PreparedStream> MakeStream(std::string_view InKey)
+	{
+		return PrepareStream(
+			InKey,
+			[](std::string_view) { return std::make_unique<Test::MemorySource>(Test::MakeMp3(50).Bytes); },
+			[] { return std::make_unique<SilentDecoder>(); });
+	}
+
+	// Opens stations from loopback servers, keyed by port, with the test client in place of
+	// WinHTTP.
+	std::unique_ptr<StationPool> MakeHttpPool()
+	{
+		return std::make_unique<StationPool>(
+			[](std::string_view InKey) -> std::unique_ptr<ByteSource> {
+				auto connection = std::make_unique<Test::HttpClient>();
+				if (!connection->Open(static_cast<uint16_t>(std::stoi(std::string(InKey)))))
+					return nullptr;
+				return connection;
+			},
+			[] { return std::make_unique<SilentDecoder>(); });
+	}
+
+	std::string GetKey(const Test::HttpServer& InServer)
+	{
+		return std::to_string(InServer.GetPort());
+	}
+
+	bool WaitUntil(const std::function<bool()>& InCondition)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + 5s;
+		while (!InCondition()) {
+			if (std::chrono::steady_clock::now() > deadline)
+				return false;
+			std::this_thread::sleep_for(5ms);
+		}
+		return true;
+	}
+
+	// The stream plays on from where the pool left it: whole frames, in order.
+	bool PlaysOn(PreparedStream& InStream)
+	{
+		uint32_t previous = UINT32_MAX;
+		for (int i = 0; i < 10; ++i) {
+			const auto frame = InStream.Stream->NextFrame();
+			const auto number = Test::GetFrameNumber(frame);
+			if (frame.empty() || (previous != UINT32_MAX && number != previous + 1))
+				return false;
+			previous = number;
+		}
+		return true;
+	}
+
+	constexpr std::size_t kBudget = 64 * 1024 * 1024;
+}
+
+TEST(StationPool, OpensWantedStations)
+{
+	Opener     opener;
+	const auto pool = MakePool(opener);
+
+	const std::string_view wanted[] = { "a" };
+	pool->SetWanted(wanted, kBudget);
+	if (const auto source = opener.WaitForOpen(1); CHECK(source))
+		source->Release();
+
+	const auto stream = pool->Take("a");
+	CHECK(stream && stream->Key == "a" && stream->FrameDecoder);
+	CHECK(!pool->Take("a"));
+	CHECK(!pool->Take("b"));
+}
+
+TEST(StationPool, DestructionCancelsAnOpen)
+{
+	// The station's header never arrives; going away must not wait for it.
+	Opener opener;
+	auto   pool = MakePool(opener);
+
+	const std::string_view wanted[] = { "a" };
+	pool->SetWanted(wanted, kBudget);
+	CHECK(opener.WaitForOpen(1));
+
+	const auto start = std::chrono::steady_clock::now();
+	pool.reset();
+	CHECK(std::chrono::steady_clock::now() - start < 2s);
+}
+
+TEST(StationPool, PutWhileOpeningKeepsOneStream)
+{
+	// The station comes back from playing while the pool is still opening its own copy: the
+	// pool keeps one stream for it, not two under one key.
+	Opener     opener;
+	const auto pool = MakePool(opener);
+
+	const std::string_view wanted[] = { "a" };
+	pool->SetWanted(wanted, kBudget);
+	const auto source = opener.WaitForOpen(1);
+	CHECK(source);
+
+	pool->Put(MakeStream("a"));
+	if (source)
+		source->Release();
+
+	CHECK(pool->Take("a"));
+	CHECK(!pool->Take("a"));
+}
+
+TEST(StationPool, PutReplacesAnIdleStream)
+{
+	Opener     opener;
+	const auto pool = MakePool(opener);
+
+	const std::string_view wanted[] = { "a", "b" };
+	pool->SetWanted(wanted, kBudget);
+	for (std::size_t open = 1; open <= 2; ++open) {
+		if (const auto source = opener.WaitForOpen(open); CHECK(source))
+			source->Release();
+	}
+
+	auto        returned = MakeStream("a");
+	const auto* expected = returned.get();
+	pool->Put(std::move(returned));
+
+	const auto taken = pool->Take("a");
+	CHECK(taken.get() == expected);
+	CHECK(!pool->Take("a"));
+	CHECK(pool->Take("b"));
+}
+
+TEST(StationPool, WarmsAndSwitchesOverHttp)
+{
+	// Both stations connect once, in the background; switching between them reuses those
+	// connections instead of opening new ones. A third keeps something wanted throughout, as
+	// the neighbours of whatever plays are.
+	const auto       track = Test::MakeMp3(400);
+	Test::HttpServer first(track.Bytes);
+	Test::HttpServer second(track.Bytes);
+	Test::HttpServer third(track.Bytes);
+	const auto       pool = MakeHttpPool();
+
+	const auto             firstKey = GetKey(first);
+	const auto             secondKey = GetKey(second);
+	const auto             thirdKey = GetKey(third);
+	const std::string_view wanted[] = { firstKey, secondKey, thirdKey };
+	pool->SetWanted(wanted, kBudget);
+	CHECK(WaitUntil([&] { return first.GetConnections() == 1 && second.GetConnections() == 1; }));
+
+	auto playing = pool->Take(firstKey);
+	CHECK(playing && playing->Key == firstKey && PlaysOn(*playing));
+
+	// Flip to the other station and back.
+	auto next = pool->Take(secondKey);
+	CHECK(next && PlaysOn(*next));
+	pool->Put(std::move(playing));
+	playing = pool->Take(firstKey);
+	CHECK(playing && PlaysOn(*playing));
+
+	CHECK(first.GetConnections() == 1 && second.GetConnections() == 1);
+}
+
+TEST(StationPool, DestructionCancelsAConnect)
+{
+	// The server takes its time to answer: the pool going away must not wait for it, even
+	// though the source has not been handed to the pool yet.
+	Test::HttpServer server(Test::MakeMp3(50).Bytes, { .Latency = 30s });
+	auto             pool = MakeHttpPool();
+
+	const auto             key = GetKey(server);
+	const std::string_view wanted[] = { key };
+	pool->SetWanted(wanted, kBudget);
+	CHECK(WaitUntil([&] { return server.GetConnections() == 1; }));
+
+	const auto start = std::chrono::steady_clock::now();
+	pool.reset();
+	CHECK(std::chrono::steady_clock::now() - start < 2s);
+}
+
+TEST(StationPool, SwitchingAllocatesNothing)
+{
+	std::vector<std::string> playlist;
+	for (int i = 0; i < 50; ++i)
+		playlist.push_back(i % 5 ? std::format("Station {}|http://example.com/station/{}.mp3", i, i) : std::format("Folder {}|music/{}/", i, i));
+	const StationTable table(playlist);
+	CHECK(table.size() == 50);
+
+	// Nothing opens, so nothing is ever warm: what is measured is the select and prefetch
+	// bookkeeping, not a stream changing hands.
+	StationPool pool([](std::string_view) { return std::unique_ptr<ByteSource>(); }, [] { return std::make_unique<SilentDecoder>(); });
+
+	// The counter sees allocations at all, or the check below would prove nothing.
+	const std::size_t before = Allocations;
+	const auto        allocated = std::make_unique<std::string>(100, 'x');
+	CHECK(Allocations > before);
+
+	// What a switch does: step the index, look the station up by key as a restored session
+	// does, take its warm stream from the pool, and keep its neighbours warm instead.
+	const std::size_t start = Allocations;
+	const int         count = static_cast<int>(table.size());
+	int               index = 0;
+	std::size_t       taken = 0;
+	for (int step = 0; step < 1000; ++step) {
+		index = ((index + (step % 7 ? 1 : -3)) % count + count) % count;
+		const Station& current = table[table.Find(table[index].Key)];
+		taken += pool.Take(current.Source) != nullptr;
+
+		std::array<std::string_view, StationPool::kMaxWanted> sources;
+		const auto                                            wanted = table.GatherNeighbors(index, 3, sources);
+		pool.SetWanted(std::span(sources).first(wanted), kBudget);
+	}
+	CHECK(Allocations == start);
+	CHECK(taken == 0);
+}
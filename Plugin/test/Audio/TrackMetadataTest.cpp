@@ -0,0 +1,137 @@
+#include "Audio/TrackMetadata.h"
+
+#include "Check.h"
+#include "Fixtures.h"
+
+using namespace Audio;
+
+namespace
+{
+	struct Frame
+	{
+		const char*          Id;
+		std::vector<uint8_t> Body;  // encoding byte and text
+	};
+
+	// An ID3v2 tag of InFrames. Version 4 writes synchsafe frame sizes, 3 plain ones.
+	std::vector<uint8_t> MakeTag(uint8_t InVersion, const std::vector<Frame>& InFrames, uint8_t InFlags = 0)
+	{
+		std::vector<uint8_t> tag;
+		for (const auto& frame : InFrames) {
+			const auto size = static_cast<uint32_t>(frame.Body.size());
+			tag.insert(tag.end(), frame.Id, frame.Id + 4);
+			if (InVersion == 4)
+				tag.insert(tag.end(), { uint8_t((size >> 21) & 0x7F), uint8_t((size >> 14) & 0x7F), uint8_t((size >> 7) & 0x7F), uint8_t(size & 0x7F) });
+			else
+				tag.insert(tag.end(), { uint8_t(size >> 24), uint8_t(size >> 16), uint8_t(size >> 8), uint8_t(size) });
+			tag.insert(tag.end(), { 0, 0 });
+			tag.insert(tag.end(), frame.Body.begin(), frame.Body.end());
+		}
+		tag.resize(tag.size() + 16, 0);  // padding
+
+		const auto size = tag.size();
+		tag.insert(tag.begin(), { 'I', 'D', '3', InVersion, 0, InFlags, uint8_t((size >> 21) & 0x7F), uint8_t((size >> 14) & 0x7F), uint8_t((size >> 7) & 0x7F), uint8_t(size & 0x7F) });
+		return tag;
+	}
+
+	std::vector<uint8_t> Text(uint8_t InEncoding, std::span<const uint8_t> InBytes)
+	{
+		std::vector<uint8_t> body(1 + InBytes.size(), InEncoding);
+		std::ranges::copy(InBytes, body.begin() + 1);
+		return body;
+	}
+
+	std::vector<uint8_t> Text(uint8_t InEncoding, std::initializer_list<uint8_t> InBytes)
+	{
+		return Text(InEncoding, std::span(InBytes.begin(), InBytes.size()));
+	}
+
+	std::vector<uint8_t> Text(uint8_t InEncoding, std::string_view InText)
+	{
+		return Text(InEncoding, std::span(reinterpret_cast<const uint8_t*>(InText.data()), InText.size()));
+	}
+
+	TrackMetadata Parse(const std::vector<uint8_t>& InTag)
+	{
+		TrackMetadata metadata;
+		ParseId3v2Tags(InTag, metadata);
+		return metadata;
+	}
+
+	TrackMetadata Read(std::vector<uint8_t> InBytes, bool* OutRead = nullptr)
+	{
+		Test::MemorySource source(std::move(InBytes));
+		TrackMetadata      metadata;
+		const bool         read = ReadTrackMetadata(source, metadata);
+		if (OutRead)
+			*OutRead = read;
+		return metadata;
+	}
+
+	bool Near(uint32_t InValue, uint32_t InExpected)
+	{
+		return std::abs(static_cast<int>(InValue) - static_cast<int>(InExpected)) <= 30;
+	}
+}
+
+TEST(TrackMetadata, ReadsTextInEveryEncoding)
+{
+	// Latin-1 widens to UTF-8; UTF-8 is kept; a terminator ends the text.
+	auto metadata = Parse(MakeTag(3, { { "TIT2", Text(0, { 'C', 'a', 'f', 0xE9 }) }, { "TPE1", Text(3, "Bj\xC3\xB6rk\0ignored"sv) } }));
+	CHECK(metadata.Title == "Caf\xC3\xA9" && metadata.Artist == "Bj\xC3\xB6rk");
+
+	// UTF-16 with either byte order mark, and big-endian without one; surrogate pairs combine.
+	metadata = Parse(MakeTag(3, { { "TIT2", Text(1, { 0xFF, 0xFE, 'H', 0, 'i', 0, 0x3D, 0xD8, 0xB5, 0xDC }) }, { "TPE1", Text(1, { 0xFE, 0xFF, 0, 'A', 0x20, 0xAC }) } }));
+	CHECK(metadata.Title == "Hi\xF0\x9F\x92\xB5" && metadata.Artist == "A\xE2\x82\xAC");
+	metadata = Parse(MakeTag(4, { { "TIT2", Text(2, { 0, 'O', 0, 'k' }) } }));
+	CHECK(metadata.Title == "Ok" && metadata.Artist.empty());
+}
+
+TEST(TrackMetadata, ReadsVersionFourSizes)
+{
+	// A frame past 127 bytes has a different size synchsafe than plain; only the right reading
+	// finds the artist after it.
+	const std::string long_title(200, 't');
+	const auto        metadata = Parse(MakeTag(4, { { "TIT2", Text(3, long_title) }, { "COMM", Text(0, "comment") }, { "TPE1", Text(3, "After") } }));
+	CHECK(metadata.Title == long_title && metadata.Artist == "After");
+}
+
+TEST(TrackMetadata, IgnoresTagsItCannotRead)
+{
+	const std::vector<Frame> frames = { { "TIT2", Text(3, "Title") } };
+	CHECK(Parse(MakeTag(3, frames, 0x80)).Title.empty());  // unsynchronised
+	CHECK(Parse(MakeTag(3, frames, 0x40)).Title.empty());  // extended header
+	CHECK(Parse(MakeTag(2, frames)).Title.empty());        // ID3v2.2 frame layout
+	CHECK(Parse(std::vector<uint8_t>{ 'I', 'D', '3' }).Title.empty());
+
+	// A frame claiming more than the tag holds ends the parse without reading past it.
+	auto tag = MakeTag(3, { { "TPE1", Text(3, "Kept") }, { "TIT2", Text(3, "Cut") } });
+	tag.resize(tag.size() - 16 - 2);
+	tag[9] = static_cast<uint8_t>(tag.size() - 10);
+	const auto metadata = Parse(tag);
+	CHECK(metadata.Artist == "Kept" && metadata.Title.empty());
+}
+
+TEST(TrackMetadata, ReadsStreamInfo)
+{
+	// CBR behind a tag: length from the file size, the tag not counted.
+	auto bytes = MakeTag(3, { { "TIT2", Text(3, "Tagged") } });
+	const auto track = Test::MakeMp3(100);
+	bytes.insert(bytes.end(), track.Bytes.begin(), track.Bytes.end());
+
+	bool read = false;
+	auto metadata = Read(bytes, &read);
+	CHECK(read && metadata.Title == "Tagged");
+	CHECK(Near(metadata.DurationMs, 2612));  // 100 frames of 1152 samples at 44.1 kHz
+	CHECK(metadata.SampleRate == 44100 && metadata.Channels == 2 && metadata.Bitrate == 128);
+
+	// VBR with a Xing frame: length from its frame count, bitrate averaged.
+	metadata = Read(Test::MakeMp3(300, { .Vbr = true, .Xing = true, .SampleRate = 1, .Mono = true }).Bytes, &read);
+	CHECK(read && metadata.Title.empty());
+	CHECK(Near(metadata.DurationMs, 7200));  // 300 frames at 48 kHz
+	CHECK(metadata.SampleRate == 48000 && metadata.Channels == 1);
+	CHECK(metadata.Bitrate > 32 && metadata.Bitrate < 320);
+
+	metadata = Read({ 'n', 'o', 't', ' ', 'a', 'n', ' ', 'm', 'p', '3' }, &read);
+	CHECK(!read && metadata.DurationMs == 0);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+#include <utility>
+
+// Timing for the benchmark cases: runs InBody until InMinTime has passed and reports how many
+// InUnits one call covers, per second. Run the benchmark executables from an optimised build;
+// ctest only checks that they still run.
+namespace Test
+{
+	template <class Body>
+	double Measure(std::string_view InName, double InUnitsPerCall, std::string_view InUnits, Body&& InBody, std::chrono::milliseconds InMinTime = std::chrono::milliseconds(200))
+	{
+		using Clock = std::chrono::steady_clock;
+
+		InBody();  // warm up
+
+		uint64_t   calls = 0;
+		const auto start = Clock::now();
+		auto       elapsed = Clock::duration::zero();
+		do {
+			for (int i = 0; i < 16; ++i)
+				InBody();
+			calls += 16;
+			elapsed = Clock::now() - start;
+		} while (elapsed < InMinTime);
+
+		const double seconds = std::chrono::duration<double>(elapsed).count();
+		const double rate = InUnitsPerCall * static_cast<double>(calls) / seconds;
+		const auto [scale, prefix] = rate >= 1e6 ? std::pair(1e6, "M") : rate >= 1e3 ? std::pair(1e3, "k") : std::pair(1.0, "");
+		std::printf("  %-40.*s %10.1f %s%.*s/s  %10.1f ns/call\n", static_cast<int>(InName.size()), InName.data(), rate / scale, prefix,
+			static_cast<int>(InUnits.size()), InUnits.data(), seconds * 1e9 / static_cast<double>(calls));
+		return rate;
+	}
+
+	// Keeps the optimiser from dropping work whose result is never read.
+	template <class T>
+	void KeepAlive(const T& InValue)
+	{
+		[[maybe_unused]] volatile auto sink = InValue;
+	}
+}
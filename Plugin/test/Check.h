@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+// A few dozen lines instead of a test framework, so the tests build wherever the sources do.
+// TEST(Group, Name) registers a case with the executable's main (Main.cpp); a failed CHECK
+// reports where and lets the case carry on, and the exit status says whether any failed.
+namespace Test
+{
+	struct Case
+	{
+		std::string_view Name;
+		void (*Body)();
+	};
+
+	inline std::vector<Case>& GetCases()
+	{
+		static std::vector<Case> cases;
+		return cases;
+	}
+
+	inline int& GetFailures()
+	{
+		static int failures = 0;
+		return failures;
+	}
+
+	struct Registrar
+	{
+		Registrar(std::string_view InName, void (*InBody)()) { GetCases().push_back({ InName, InBody }); }
+	};
+
+	inline bool Check(bool InPassed, const char* InExpression, const char* InFile, int InLine)
+	{
+		if (!InPassed) {
+			std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", InFile, InLine, InExpression);
+			++GetFailures();
+		}
+		return InPassed;
+	}
+}
+
+#define TEST(InGroup, InName)                                                                              \
+	static void                  InGroup##_##InName();                                                   \
+	static const Test::Registrar InGroup##_##InName##_Registrar(#InGroup "." #InName, &InGroup##_##InName); \
+	static void                  InGroup##_##InName()
+
+#define CHECK(...) Test::Check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
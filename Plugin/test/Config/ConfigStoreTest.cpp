@@ -0,0 +1,129 @@
+#include "Config/ConfigStore.h"
+
+#include "Check.h"
+
+namespace
+{
+	Config MakeConfig(int InStations)
+	{
+		Config config;
+		for (int i = 0; i < InStations; ++i)
+			config.playlist.push_back(std::format("Station {}|http://example.com/{}.mp3", i, i));
+		config.prefetchStations = InStations;
+		return config;
+	}
+
+	// A snapshot whose parts all come from the same Publish.
+	bool IsWhole(const ConfigSnapshot& InSnapshot)
+	{
+		const auto& stations = InSnapshot.Stations;
+		if (stations.size() != InSnapshot.Settings.playlist.size() || static_cast<int>(stations.size()) != InSnapshot.Settings.prefetchStations)
+			return false;
+		for (std::size_t i = 0; i < stations.size(); ++i) {
+			if (stations[i].Name != std::format("Station {}", i) || stations[i].Source != std::format("http://example.com/{}.mp3", i))
+				return false;
+		}
+		return true;
+	}
+}
+
+TEST(ConfigStore, ReadersSeeWhatWasPublished)
+{
+	ConfigStore         store;
+	ConfigStore::Reader reader(store);
+	CHECK(reader.Get().Generation == 1);
+	CHECK(reader.Get().Stations.empty());
+
+	store.Publish(MakeConfig(3));
+	const auto& snapshot = reader.Get();
+	CHECK(snapshot.Generation == 2 && IsWhole(snapshot));
+	CHECK(store.Current() == &snapshot);
+}
+
+TEST(ConfigStore, HeldSnapshotsOutliveNewOnes)
+{
+	// What a reader holds stays whole however many publishes go by, until its next Get.
+	ConfigStore         store;
+	ConfigStore::Reader holder(store);
+	ConfigStore::Reader other(store);
+	store.Publish(MakeConfig(5));
+	const auto& held = holder.Get();
+
+	for (int i = 0; i < 50; ++i) {
+		store.Publish(MakeConfig(i % 7));
+		CHECK(IsWhole(other.Get()));
+	}
+	CHECK(held.Generation == 2 && IsWhole(held));
+	CHECK(holder.Get().Generation == 52);
+}
+
+TEST(ConfigStore, ReadersPastTheSlotsGetCopies)
+{
+	// Every slot taken, and more readers still: they read copies rather than nothing.
+	ConfigStore                                       store;
+	std::vector<std::unique_ptr<ConfigStore::Reader>> readers;
+	for (std::size_t i = 0; i < ConfigStore::kMaxReaders + 2; ++i)
+		readers.push_back(std::make_unique<ConfigStore::Reader>(store));
+
+	store.Publish(MakeConfig(4));
+	for (auto& reader : readers) {
+		const auto& snapshot = reader->Get();
+		CHECK(snapshot.Generation == 2 && IsWhole(snapshot));
+	}
+
+	// The copy follows later publishes, and is the same one while nothing changed.
+	auto&       extra = *readers.back();
+	const auto* first = &extra.Get();
+	CHECK(&extra.Get() == first);
+	CHECK(first != store.Current());
+	store.Publish(MakeConfig(6));
+	CHECK(extra.Get().Generation == 3 && IsWhole(extra.Get()));
+
+	// A slot given back goes to the next reader.
+	readers.front().reset();
+	ConfigStore::Reader late(store);
+	CHECK(&late.Get() == store.Current());
+}
+
+TEST(ConfigStore, ReadsWhilePublishing)
+{
+	// Readers on their own threads, slotted and not, while the configuration keeps changing:
+	// every snapshot is whole and generations never go back. Publishing waits for every reader
+	// to be running, and goes on until each has read some of it.
+	constexpr std::size_t kThreads = ConfigStore::kMaxReaders + 1;
+
+	ConfigStore       store;
+	std::latch        running(kThreads);
+	std::atomic<bool> done = false;
+	std::atomic<int>  torn = 0;
+	std::atomic<int>  reading = 0;  // readers that have seen a publish
+	{
+		std::vector<std::jthread> threads;
+		for (std::size_t thread = 0; thread < kThreads; ++thread) {
+			threads.emplace_back([&] {
+				ConfigStore::Reader reader(store);
+				uint64_t            last = 0;
+				bool                counted = false;
+				running.count_down();
+				while (!done) {
+					const auto& snapshot = reader.Get();
+					if (snapshot.Generation < last || (snapshot.Generation > 1 && !IsWhole(snapshot)))
+						++torn;
+					last = snapshot.Generation;
+					if (!counted && snapshot.Generation > 1) {
+						counted = true;
+						++reading;
+					}
+				}
+			});
+		}
+
+		running.wait();
+		const auto deadline = std::chrono::steady_clock::now() + 5s;
+		for (int i = 0; i < 2000 || (reading < static_cast<int>(kThreads) && std::chrono::steady_clock::now() < deadline); ++i)
+			store.Publish(MakeConfig(i % 9));
+		done = true;
+	}
+	CHECK(torn == 0);
+	CHECK(reading == static_cast<int>(kThreads));
+}
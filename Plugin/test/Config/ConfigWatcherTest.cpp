@@ -0,0 +1,112 @@
+#include "Config/ConfigWatcher.h"
+
+#include "Check.h"
+#include "Fixtures.h"
+
+namespace
+{
+	// Stands in for the running player: reads the store on its own thread the way the radio
+	// worker and the key dispatcher do, and keeps the station names and toggle key of every
+	// generation it sees.
+	struct Player
+	{
+		struct Seen
+		{
+			uint64_t                 Generation;
+			std::vector<std::string> Stations;
+			int                      ToggleKey;
+		};
+
+		explicit Player(ConfigStore& InStore) :
+			Thread([this, &InStore](std::stop_token InStop) {
+				ConfigStore::Reader reader(InStore);
+				uint64_t            generation = 0;
+				while (!InStop.stop_requested()) {
+					const auto& snapshot = reader.Get();
+					if (snapshot.Generation != generation) {
+						generation = snapshot.Generation;
+						Seen seen{ generation, {}, snapshot.Settings.toggleRadioKey };
+						for (const auto& station : snapshot.Stations)
+							seen.Stations.emplace_back(station.Name);
+						std::lock_guard lock(Mutex);
+						History.push_back(std::move(seen));
+					}
+					std::this_thread::sleep_for(1ms);
+				}
+			})
+		{
+		}
+
+		// The latest generation seen once it is at least InGeneration, or after a few seconds.
+		std::optional<Seen> WaitFor(uint64_t InGeneration)
+		{
+			const auto deadline = std::chrono::steady_clock::now() + 5s;
+			while (std::chrono::steady_clock::now() < deadline) {
+				{
+					std::lock_guard lock(Mutex);
+					if (!History.empty() && History.back().Generation >= InGeneration)
+						return History.back();
+				}
+				std::this_thread::sleep_for(5ms);
+			}
+			return std::nullopt;
+		}
+
+		std::mutex        Mutex;
+		std::vector<Seen> History;
+		std::jthread      Thread;  // last, so it stops before the rest goes
+	};
+
+	void Save(const std::filesystem::path& InPath, std::string_view InText, std::filesystem::file_time_type InTime)
+	{
+		Test::WriteFile(InPath, InText);
+		std::filesystem::last_write_time(InPath, InTime);
+	}
+}
+
+TEST(ConfigWatcher, PublishesEditsToTheRunningPlayer)
+{
+	const Test::TempDirectory directory("watcher");
+	const auto                path = directory / "radio.toml";
+	const auto                time = std::filesystem::last_write_time(directory.Get());
+	std::filesystem::create_directories(directory / "radio");
+	Save(path, "ToggleRadioKey = 0x60\nPlaylist = [\"Jazz|http://jazz\", \"Rock|http://rock\"]\n", time);
+
+	Config config;
+	loadConfig(config, path);
+	ConfigStore store;
+	store.Publish(config);
+
+	Player                   player(store);
+	std::mutex               mutex;
+	std::vector<std::size_t> reloads;
+	ConfigWatcher            watcher;
+	CHECK(watcher.Start(store, [&](const Config& InConfig) {
+		std::lock_guard lock(mutex);
+		reloads.push_back(InConfig.playlist.size());
+	}, path));
+
+	const auto first = player.WaitFor(2);
+	CHECK(first && first->Stations == std::vector<std::string>{ "Jazz", "Rock" } && first->ToggleKey == 0x60);
+
+	// Saved from an editor: new stations and a new binding reach the player without a restart.
+	Save(path, "ToggleRadioKey = 0x61\nPlaylist = [\"Rock|http://rock\", \"News|http://news\", \"Chill|Chill/\"]\n", time + 1s);
+	const auto edited = player.WaitFor(3);
+	CHECK(edited && edited->Stations == std::vector<std::string>{ "Rock", "News", "Chill" });
+	CHECK(edited && edited->ToggleKey == 0x61);
+	{
+		std::lock_guard lock(mutex);
+		CHECK(reloads == std::vector<std::size_t>{ 3 });
+	}
+
+	// Another file in the folder changing is not a reload.
+	Test::WriteFile(directory / "other.toml", "x = 1\n"sv);
+	std::this_thread::sleep_for(700ms);
+	CHECK(store.Current()->Generation == 3);
+
+	// Stopped, it publishes nothing more.
+	watcher.Stop();
+	Save(path, "ToggleRadioKey = 0x62\n", time + 2s);
+	std::this_thread::sleep_for(700ms);
+	CHECK(store.Current()->Generation == 3);
+}
@@ -0,0 +1,81 @@
+#include "Config/RadioConfig.h"
+
+#include "Bench.h"
+#include "Check.h"
+#include "Fixtures.h"
+
+namespace
+{
+	constexpr std::size_t kStations = 10'000;
+
+	// Every option, then a playlist mixing internet stations, folders and single tracks, with
+	// the comments and spacing a hand-kept file has.
+	std::string MakeConfig()
+	{
+		std::string text = "# Starfield Galactic Radio\nAutoStartRadio = true\nRandomizeStartTime = false\n"
+		                   "ToggleRadioKey = 0x60\nStatsKey = \"0x6E\"\nPrefetchStations = 2\nCrossfadeMs = 1_500\n\n"
+		                   "Playlist = [\n";
+		for (std::size_t i = 0; i < kStations; ++i) {
+			if (i % 100 == 0)
+				text += std::format("  # block {}\n", i / 100);
+			switch (i % 3) {
+			case 0:
+				text += std::format("  \"Station {} | https://stream{}.example.com:8000/live.mp3\",\n", i, i);
+				break;
+			case 1:
+				text += std::format("  'Folder {}|Music\\Genre {}\\'  ,\n", i, i % 40);
+				break;
+			default:
+				text += std::format("  \"Track {}|tracks/album {}/track {:02}.mp3\",\n", i, i / 12, i % 12);
+				break;
+			}
+		}
+		return text + "]\n";
+	}
+}
+
+TEST(RadioConfigBench, TenThousandStations)
+{
+	const auto text = MakeConfig();
+	std::printf("  %zu stations, %.1f KB of TOML\n", kStations, static_cast<double>(text.size()) / 1024);
+
+	Config parsed;
+	parseConfig(text, parsed);
+	CHECK(parsed.playlist.size() == kStations && parsed.prefetchStations == 2 && parsed.crossfadeMs == 1500);
+
+	Test::Measure("parse", static_cast<double>(kStations), "stations", [&] {
+		Config config;
+		parseConfig(text, config);
+		Test::KeepAlive(config.playlist.size());
+	});
+
+	// Through the file: parsed and cached when it changed, the cache alone when it did not,
+	// and a hash of the text when it was saved without edits.
+	const Test::TempDirectory directory("config-bench");
+	const auto                path = directory / "radio.toml";
+	std::filesystem::create_directories(directory / "radio");
+	Test::WriteFile(path, text);
+
+	auto time = std::filesystem::last_write_time(path);
+	Test::Measure("load, changed file", static_cast<double>(kStations), "stations", [&] {
+		std::filesystem::last_write_time(path, time += 1s);
+		std::filesystem::remove(directory / "radio" / "config.cache");
+		Config config;
+		loadConfig(config, path);
+		Test::KeepAlive(config.playlist.size());
+	});
+
+	Test::Measure("load, touched but unchanged", static_cast<double>(kStations), "stations", [&] {
+		std::filesystem::last_write_time(path, time += 1s);
+		Config config;
+		loadConfig(config, path);
+		Test::KeepAlive(config.playlist.size());
+	});
+
+	Config cached;
+	Test::Measure("load, cached", static_cast<double>(kStations), "stations", [&] {
+		cached = {};
+		loadConfig(cached, path);
+	});
+	CHECK(cached.playlist == parsed.playlist && cached.statsKey == 0x6E);
+}
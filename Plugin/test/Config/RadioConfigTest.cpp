@@ -0,0 +1,137 @@
+#include "Config/RadioConfig.h"
+
+#include "Check.h"
+#include "Fixtures.h"
+
+namespace
+{
+	using FileTime = std::filesystem::file_time_type;
+
+	// A configuration file and the folder its cache goes in. CrossfadeMs is never in the file and
+	// each load starts it at a new value, so a parse leaves that value while a cache hit brings
+	// back the one from the load that wrote the cache.
+	struct ConfigFile
+	{
+		ConfigFile()
+		{
+			std::filesystem::create_directories(Directory / "radio");
+		}
+
+		void Write(std::string_view InText, FileTime InTime)
+		{
+			Test::WriteFile(Path, InText);
+			std::filesystem::last_write_time(Path, InTime);
+		}
+
+		Config Load()
+		{
+			Config config;
+			config.crossfadeMs = ++Loads;
+			loadConfig(config, Path);
+			return config;
+		}
+
+		bool IsParsed(const Config& InConfig) const { return InConfig.crossfadeMs == Loads; }
+
+		std::filesystem::path GetCache() const { return Directory / "radio" / "config.cache"; }
+
+		Test::TempDirectory   Directory{ "config" };
+		std::filesystem::path Path = Directory / "radio.toml";
+		int                   Loads = 0;
+	};
+
+	// Same length, so only the time or the contents tell them apart.
+	constexpr auto kFirst = "StatsKey = 0x70\nPlaylist = [\"A|http://a\"]\n"sv;
+	constexpr auto kSecond = "StatsKey = 0x71\nPlaylist = [\"B|http://b\"]\n"sv;
+
+	const FileTime kTime = FileTime::clock::now() - std::chrono::hours(1);
+}
+
+TEST(RadioConfig, CacheIsUsedWhileTheFileIsUntouched)
+{
+	ConfigFile file;
+	file.Write(kFirst, kTime);
+
+	const auto parsed = file.Load();
+	CHECK(file.IsParsed(parsed));
+	CHECK(parsed.statsKey == 0x70 && parsed.playlist == std::vector<std::string>{ "A|http://a" });
+	CHECK(std::filesystem::exists(file.GetCache()));
+
+	// Same size and time: the file is not read at all, so even new contents go unseen.
+	const auto cached = file.Load();
+	CHECK(!file.IsParsed(cached) && cached.crossfadeMs == parsed.crossfadeMs);
+	CHECK(cached.statsKey == 0x70 && cached.playlist == parsed.playlist);
+
+	file.Write(kSecond, kTime);
+	CHECK(file.Load().statsKey == 0x70);
+}
+
+TEST(RadioConfig, ChangesInvalidateTheCache)
+{
+	ConfigFile file;
+	file.Write(kFirst, kTime);
+	file.Load();
+
+	// New time, same size.
+	file.Write(kSecond, kTime + 1s);
+	auto config = file.Load();
+	CHECK(file.IsParsed(config));
+	CHECK(config.statsKey == 0x71 && config.playlist == std::vector<std::string>{ "B|http://b" });
+
+	// Same time, new size.
+	file.Write("StatsKey = 0x72\n", kTime + 1s);
+	config = file.Load();
+	CHECK(file.IsParsed(config) && config.statsKey == 0x72);
+
+	// The cache was written again each time: untouched now, it hits.
+	CHECK(!file.IsParsed(file.Load()));
+}
+
+TEST(RadioConfig, TouchedButUnchangedKeepsTheCache)
+{
+	ConfigFile file;
+	file.Write(kFirst, kTime);
+	const auto first = file.Load();
+
+	// Saved again without edits: the contents hash the same, so the cache is used and only its
+	// time is brought up to date.
+	file.Write(kFirst, kTime + 2s);
+	const auto touched = file.Load();
+	CHECK(!file.IsParsed(touched) && touched.crossfadeMs == first.crossfadeMs);
+	CHECK(touched.statsKey == 0x70 && touched.playlist == std::vector<std::string>{ "A|http://a" });
+
+	// Which the next load goes by, without reading the file.
+	file.Write(kSecond, kTime + 2s);
+	const auto next = file.Load();
+	CHECK(!file.IsParsed(next) && next.statsKey == 0x70);
+}
+
+TEST(RadioConfig, BrokenCacheIsIgnored)
+{
+	ConfigFile file;
+	file.Write(kFirst, kTime);
+	file.Load();
+
+	// Cut short, or not a cache at all: parsed from the file and written again.
+	const auto size = std::filesystem::file_size(file.GetCache());
+	std::filesystem::resize_file(file.GetCache(), size - 3);
+	CHECK(file.IsParsed(file.Load()));
+	CHECK(std::filesystem::file_size(file.GetCache()) == size);
+
+	Test::WriteFile(file.GetCache(), "not a cache"sv);
+	CHECK(file.IsParsed(file.Load()));
+	CHECK(!file.IsParsed(file.Load()));
+
+	// Without a folder for the cache, every load parses.
+	std::filesystem::remove_all(file.Directory / "radio");
+	CHECK(file.IsParsed(file.Load()));
+	const auto again = file.Load();
+	CHECK(file.IsParsed(again) && again.statsKey == 0x70);
+
+	// A missing file leaves the config as it was.
+	std::filesystem::remove(file.Path);
+	Config config;
+	config.statsKey = 0x10;
+	loadConfig(config, file.Path);
+	CHECK(config.statsKey == 0x10);
+}
@@ -0,0 +1,107 @@
+#include "Config/StationTable.h"
+
+#include "Config/Hash.h"
+
+#include "Check.h"
+
+TEST(StationTable, CompilesEntries)
+{
+	const std::vector<std::string> playlist = {
+		"  Jazz | http://example.com/jazz.mp3  ",
+		"http://example.com/unnamed",
+		"Chill|Chill/",
+		"Live|Rock/**/Live*.mp3",
+		"Single|song.mp3",
+		"Nothing|  ",
+	};
+	const StationTable table(playlist);
+	CHECK(table.size() == 5);
+	if (table.size() != 5)
+		return;
+
+	CHECK(table[0].Name == "Jazz" && table[0].Source == "http://example.com/jazz.mp3" && table[0].IsRemote && !table[0].IsFolder);
+	CHECK(table[1].Name.empty() && table[1].Source == "http://example.com/unnamed" && table[1].IsRemote);
+
+	// Local entries resolve below the tracks directory; a bare folder plays every MP3 in it.
+	CHECK(table[2].IsFolder && !table[2].IsRemote && table[2].Source.find("tracks") != std::string_view::npos);
+	CHECK(table[2].Source.ends_with("Chill/**/*.mp3") || table[2].Source.ends_with("Chill\\**\\*.mp3"));
+	CHECK(table[3].IsFolder && table[3].Source.ends_with("Live*.mp3"));
+	CHECK(!table[4].IsFolder && !table[4].IsRemote && table[4].Source.ends_with("song.mp3"));
+
+	// Keys hash the trimmed entry, so a reload finds the same station wherever it moved.
+	CHECK(table[0].Key == Fnv1a64("Jazz | http://example.com/jazz.mp3"));
+	CHECK(table.Find(table[3].Key) == 3);
+	CHECK(table.Find(12345) == -1);
+
+	const StationTable moved(std::vector<std::string>{ "Single|song.mp3", "New|http://new", "  Jazz | http://example.com/jazz.mp3" });
+	CHECK(moved.Find(table[0].Key) == 2);
+	CHECK(moved.Find(table[4].Key) == 0);
+}
+
+TEST(StationTable, KeysAreUnique)
+{
+	// The same entry listed again, even spaced differently, is one station; the first stays.
+	const std::vector<std::string> playlist = {
+		"A|http://a",
+		"B|http://b",
+		"A|http://a",
+		"  B|http://b ",
+		"A|http://a/",
+		"Other name|http://a",
+	};
+	const StationTable table(playlist);
+	CHECK(table.size() == 4);
+
+	std::vector<uint64_t> keys;
+	for (const auto& station : table)
+		keys.push_back(station.Key);
+	std::ranges::sort(keys);
+	CHECK(std::ranges::adjacent_find(keys) == keys.end());
+	for (std::size_t i = 0; i < table.size(); ++i)
+		CHECK(table.Find(table[i].Key) == static_cast<int>(i));
+	CHECK(table.size() == 4 && table[2].Source == "http://a/" && table[3].Name == "Other name");
+}
+
+TEST(StationTable, ViewsSurviveMoves)
+{
+	// Names and sources live in the table's arena, not in the playlist or a moved-from table.
+	auto playlist = std::make_unique<std::vector<std::string>>(std::vector<std::string>{ "Short|http://s", std::string(300, 'x') + "|http://long" });
+	StationTable table(*playlist);
+	playlist.reset();
+
+	StationTable moved = std::move(table);
+	CHECK(moved.size() == 2 && moved[0].Name == "Short" && moved[1].Name == std::string(300, 'x') && moved[1].Source == "http://long");
+
+	const StationTable empty(std::vector<std::string>{});
+	CHECK(empty.empty() && empty.Find(0) == -1);
+}
+
+TEST(StationTable, GathersNeighbors)
+{
+	const std::vector<std::string> playlist = {
+		"A|http://a",
+		"B|http://b",
+		"Chill|Chill/",
+		"D|http://d",
+		"Again|http://a",
+		"F|http://f",
+	};
+	const StationTable table(playlist);
+	CHECK(table.size() == 6);
+
+	// Nearest first, alternating sides and wrapping around; the folder and the second entry
+	// for http://a are left out.
+	std::array<std::string_view, 7> sources;
+	auto                            count = table.GatherNeighbors(1, 3, sources);
+	CHECK(std::vector(sources.begin(), sources.begin() + count) == std::vector<std::string_view>{ "http://a", "http://d", "http://f" });
+
+	// After what is already listed, and no further than there is room for.
+	sources[0] = "next track";
+	count = table.GatherNeighbors(3, 3, std::span(sources).first(3), 1);
+	CHECK(count == 3 && sources[0] == "next track" && sources[1] == "http://a" && sources[2] == "http://f");
+
+	// The station itself is not its own neighbour, however far the radius reaches.
+	const StationTable single(std::vector<std::string>{ "Only|http://only" });
+	CHECK(single.GatherNeighbors(0, 3, sources) == 0);
+	CHECK(StationTable().GatherNeighbors(0, 3, sources) == 0);
+}
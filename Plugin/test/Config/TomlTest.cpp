@@ -0,0 +1,162 @@
+#include "Config/RadioConfig.h"
+#include "Config/Toml.h"
+
+#include "Check.h"
+
+namespace
+{
+	struct Item
+	{
+		std::string Table;
+		std::string Key;
+		Toml::Type  Type;
+		std::string Text;  // decoded strings, raw tokens otherwise
+		bool        IsArrayItem;
+
+		bool operator==(const Item&) const = default;
+	};
+
+	std::vector<Item> ParseAll(std::string_view InText, std::size_t* OutErrors = nullptr)
+	{
+		Toml::Parser      parser(InText);
+		Toml::Entry       entry;
+		std::vector<Item> items;
+		while (parser.Next(entry))
+			items.push_back({ std::string(entry.Table), std::string(entry.Key), entry.Value.Type, entry.Value.Type == Toml::Type::String ? entry.Value.AsString() : std::string(entry.Value.Text), entry.IsArrayItem });
+		if (OutErrors)
+			*OutErrors = parser.GetErrorCount();
+		return items;
+	}
+
+	Toml::Value ParseOne(std::string_view InText)
+	{
+		Toml::Parser parser(InText);
+		Toml::Entry  entry;
+		return parser.Next(entry) ? entry.Value : Toml::Value{};
+	}
+}
+
+TEST(Toml, ScalarsAndTables)
+{
+	const auto items = ParseAll(
+		"\xEF\xBB\xBF# settings\n"
+		"Name = \"Radio\" # trailing comment\n"
+		"\n"
+		"[Keys]\r\n"
+		"Toggle = 0x60\r\n"
+		"\"quoted key\" = 'literal \\n'\n"
+		"[[Stations]]\n"
+		"dotted.key = true\n");
+	CHECK(items == std::vector<Item>{
+		{ "", "Name", Toml::Type::String, "Radio", false },
+		{ "Keys", "Toggle", Toml::Type::Integer, "0x60", false },
+		{ "Keys", "quoted key", Toml::Type::String, "literal \\n", false },
+		{ "Stations", "dotted.key", Toml::Type::Boolean, "true", false },
+	});
+}
+
+TEST(Toml, Numbers)
+{
+	CHECK(ParseOne("a = 42").Integer == 42);
+	CHECK(ParseOne("a = -17").Integer == -17);
+	CHECK(ParseOne("a = +5").Integer == 5);
+	CHECK(ParseOne("a = 1_000_000").Integer == 1'000'000);
+	CHECK(ParseOne("a = 0xFF").Integer == 255);
+	CHECK(ParseOne("a = 0o17").Integer == 15);
+	CHECK(ParseOne("a = 0b101").Integer == 5);
+	CHECK(ParseOne("a = 0").Integer == 0 && ParseOne("a = 0").Type == Toml::Type::Integer);
+
+	const auto real = ParseOne("a = 2.5e3");
+	CHECK(real.Type == Toml::Type::Float && real.Float == 2500.0);
+	CHECK(ParseOne("a = -0.25").Float == -0.25);
+	CHECK(ParseOne("a = false").Type == Toml::Type::Boolean && !ParseOne("a = false").Boolean);
+}
+
+TEST(Toml, Strings)
+{
+	CHECK(ParseOne(R"(a = "tab\there \"quoted\" back\\slash")").AsString() == "tab\there \"quoted\" back\\slash");
+	CHECK(ParseOne(R"(a = "caf\u00E9 \U0001F4FB")").AsString() == "caf\xC3\xA9 \xF0\x9F\x93\xBB");
+	CHECK(ParseOne(R"(a = 'C:\Music\*.mp3')").AsString() == R"(C:\Music\*.mp3)");
+	CHECK(ParseOne("a = \"\"\"\nfirst\nsecond\"\"\"").AsString() == "first\nsecond");
+	CHECK(ParseOne("a = \"\"\"one \\\n    two\"\"\"").AsString() == "one two");
+	CHECK(ParseOne("a = '''\nraw \\n \"x\"'''").AsString() == "raw \\n \"x\"");
+	CHECK(ParseOne("a = \"\"\"ends in quotes\"\"\"\"\"").AsString() == "ends in quotes\"\"");
+
+	// Views into the source: nothing escaped, nothing copied.
+	const std::string_view text = "a = \"plain\"";
+	const auto             value = ParseOne(text);
+	CHECK(!value.Escaped && value.Text.data() == text.data() + 5);
+}
+
+TEST(Toml, Arrays)
+{
+	// Arrays over several lines, with comments, trailing commas, nested arrays flattened and
+	// inline tables skipped.
+	const auto items = ParseAll(
+		"Playlist = [\n"
+		"  \"One|http://a\",  # first\n"
+		"  'Two|C:\\x',\n"
+		"  [\"nested\", 3],\n"
+		"  { skipped = 1 },\n"
+		"]\n"
+		"After = 1\n");
+	CHECK(items == std::vector<Item>{
+		{ "", "Playlist", Toml::Type::Array, "", false },
+		{ "", "Playlist", Toml::Type::String, "One|http://a", true },
+		{ "", "Playlist", Toml::Type::String, "Two|C:\\x", true },
+		{ "", "Playlist", Toml::Type::String, "nested", true },
+		{ "", "Playlist", Toml::Type::Integer, "3", true },
+		{ "", "After", Toml::Type::Integer, "1", false },
+	});
+}
+
+TEST(Toml, SkipsMalformedLines)
+{
+	// A bad line costs only itself; the first one is reported with its line number.
+	std::size_t errors = 0;
+	const auto  items = ParseAll(
+		"Good = 1\n"
+		"no equals sign\n"
+		"Bad = \"unterminated\n"
+		"[broken header\n"
+		"Also = 2 trailing\n"
+		"Last = 3\n",
+		&errors);
+	CHECK(errors == 4);
+	CHECK(items.size() == 3);
+	CHECK(items.size() == 3 && items[0].Key == "Good" && items[1].Key == "Also" && items[2].Key == "Last");
+
+	Toml::Parser parser("a = 1\n\nb c\n");
+	Toml::Entry  entry;
+	while (parser.Next(entry)) {}
+	CHECK(parser.GetErrorCount() == 1 && parser.GetFirstErrorLine() == 3 && parser.GetFirstError() == "expected key = value");
+
+	Toml::Parser open("a = [1, 2\n");
+	while (open.Next(entry)) {}
+	CHECK(open.GetErrorCount() == 1 && open.GetFirstError() == "unterminated array");
+}
+
+TEST(Toml, ParsesTheRadioConfig)
+{
+	Config config;
+	config.playlist = { "stale" };
+	parseConfig(
+		"AutoStartRadio = false\n"
+		"RandomizeStartTime = 0\n"
+		"ToggleRadioKey = \"0x61\"\n"
+		"StatsKey = 0x70\n"
+		"CrossfadeMs = 250\n"
+		"SpatialPreset = \"not a number\"\n"
+		"Playlist = [\"A|http://a\", \"B|Chill/\", 7]\n",
+		config);
+
+	CHECK(!config.autoStartRadio && !config.randomizeStartTime);
+	CHECK(config.toggleRadioKey == 0x61 && config.statsKey == 0x70);
+	CHECK(config.crossfadeMs == 250);
+	CHECK(config.spatialPreset == Config{}.spatialPreset);
+	CHECK(config.playlist == std::vector<std::string>{ "A|http://a", "B|Chill/" });
+
+	// Keys that are missing keep what was there.
+	parseConfig("CrossfadeMs = 0\n", config);
+	CHECK(config.crossfadeMs == 0 && config.toggleRadioKey == 0x61 && config.playlist.size() == 2);
+}
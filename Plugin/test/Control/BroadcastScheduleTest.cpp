@@ -0,0 +1,122 @@
+#include "Control/BroadcastSchedule.h"
+
+#include "Check.h"
+
+using namespace Control;
+
+namespace
+{
+	constexpr uint64_t kSeed = 0x5EED;
+	constexpr uint64_t kJazz = 0x1A2B3C;
+	constexpr uint64_t kRock = 0x4D5E6F;
+	constexpr uint64_t kLive = 0x777;
+
+	// A clock that only moves when told to.
+	struct FakeClock
+	{
+		BroadcastSchedule::Clock Get()
+		{
+			return [this] { return NowMs; };
+		}
+
+		uint64_t NowMs = 0;
+	};
+}
+
+TEST(BroadcastSchedule, PositionWrapsAround)
+{
+	FakeClock         clock{ 1'000'000 };
+	BroadcastSchedule schedule(kSeed, clock.Get());
+	schedule.SetDurationMs(kJazz, 10'000);
+	schedule.SetDurationMs(kRock, 10'000);
+
+	// Stations start at different places, and the same seed puts them there every time.
+	const uint32_t start = schedule.GetPositionMs(kJazz);
+	CHECK(start < 10'000);
+	CHECK(schedule.GetPositionMs(kRock) != start);
+	BroadcastSchedule again(kSeed, clock.Get());
+	again.SetDurationMs(kJazz, 10'000);
+	CHECK(again.GetPositionMs(kJazz) == start);
+
+	// Up to the end of the track, then from its start again.
+	clock.NowMs += 9'999 - start;
+	CHECK(schedule.GetPositionMs(kJazz) == 9'999);
+	clock.NowMs += 1;
+	CHECK(schedule.GetPositionMs(kJazz) == 0);
+	clock.NowMs += 1;
+	CHECK(schedule.GetPositionMs(kJazz) == 1);
+
+	// Whole laps later it is in the same place.
+	clock.NowMs += 1'000 * 10'000ull;
+	CHECK(schedule.GetPositionMs(kJazz) == 1);
+}
+
+TEST(BroadcastSchedule, ResumesWhereASessionStopped)
+{
+	FakeClock         first{ 50'000 };
+	BroadcastSchedule before(kSeed, first.Get());
+	before.SetDurationMs(kJazz, 180'000);
+	first.NowMs += 123'456;
+
+	const uint64_t saved = before.GetElapsedMs();
+	const uint32_t position = before.GetPositionMs(kJazz);
+	CHECK(saved == 123'456);
+
+	// The game stayed paused for an hour before the next session: the broadcast carries on
+	// from the save, not from the wall clock. The new clock is also younger than the broadcast.
+	FakeClock         second{ 700 };
+	BroadcastSchedule after(kSeed, second.Get());
+	after.SetDurationMs(kJazz, 180'000);
+	after.Resume(saved);
+	CHECK(after.GetElapsedMs() == saved);
+	CHECK(after.GetPositionMs(kJazz) == position);
+
+	second.NowMs += 2'000;
+	CHECK(after.GetElapsedMs() == saved + 2'000);
+	CHECK(after.GetPositionMs(kJazz) == (position + 2'000) % 180'000);
+}
+
+TEST(BroadcastSchedule, LiveStationsHaveNoPosition)
+{
+	FakeClock         clock{ 42 };
+	BroadcastSchedule schedule(kSeed, clock.Get());
+	schedule.SetDurationMs(kLive, 0);
+	clock.NowMs += 90'000;
+
+	// Live streams and stations never measured have no length to be part way through.
+	CHECK(schedule.GetDurationMs(kLive) == 0 && schedule.GetPositionMs(kLive) == 0);
+	CHECK(schedule.GetDurationMs(kRock) == 0 && schedule.GetPositionMs(kRock) == 0);
+	CHECK(schedule.GetStationTimeMs(kLive) == schedule.GetElapsedMs());
+
+	// A length learned later gives it one.
+	schedule.SetDurationMs(kLive, 60'000);
+	CHECK(schedule.GetDurationMs(kLive) == 60'000);
+	CHECK(schedule.GetPositionMs(kLive) == schedule.GetStationTimeMs(kLive) % 60'000);
+}
+
+TEST(BroadcastSchedule, StationTimeFollowsClockJumps)
+{
+	FakeClock         clock{ 10'000 };
+	BroadcastSchedule schedule(kSeed, clock.Get());
+	schedule.SetDurationMs(kJazz, 240'000);
+
+	const uint64_t start = schedule.GetStationTimeMs(kJazz);
+	CHECK(schedule.GetPositionMs(kJazz) == start % 240'000);
+
+	// A suspended machine wakes three days later: station time moves by exactly the gap.
+	constexpr uint64_t kJump = 3 * 24 * 3'600'000ull;
+	clock.NowMs += kJump;
+	CHECK(schedule.GetStationTimeMs(kJazz) == start + kJump);
+	CHECK(schedule.GetPositionMs(kJazz) == (start + kJump) % 240'000);
+
+	// The clock starting over below the broadcast's age, as after a reboot, does not move it
+	// back once the session is resumed.
+	const uint64_t elapsed = schedule.GetElapsedMs();
+	const uint64_t before = schedule.GetStationTimeMs(kJazz);
+	clock.NowMs = 5;
+	schedule.Resume(elapsed);
+	CHECK(schedule.GetStationTimeMs(kJazz) == before);
+	clock.NowMs += 1'000;
+	CHECK(schedule.GetStationTimeMs(kJazz) == before + 1'000);
+	CHECK(schedule.GetPositionMs(kJazz) == (before + 1'000) % 240'000);
+}
@@ -0,0 +1,189 @@
+#include "Control/CommandQueue.h"
+
+#include "Check.h"
+
+using namespace Control;
+
+namespace
+{
+	using Commands = std::vector<std::pair<RadioAction, int32_t>>;
+
+	Commands Coalesce(std::vector<RadioCommand> InCommands)
+	{
+		InCommands.resize(CoalesceCommands(InCommands));
+		Commands out;
+		for (const auto& command : InCommands)
+			out.emplace_back(command.Action, command.Amount);
+		return out;
+	}
+
+	int32_t Sum(const Commands& InCommands, RadioAction InAction)
+	{
+		int32_t sum = 0;
+		for (const auto& [action, amount] : InCommands)
+			sum += action == InAction ? amount : 0;
+		return sum;
+	}
+
+	auto AtLeast(std::size_t InCount)
+	{
+		return [InCount](const Commands& InRan) { return InRan.size() >= InCount; };
+	}
+
+	// Runs commands on a worker and keeps what it ran.
+	struct Recorder
+	{
+		Recorder()
+		{
+			Worker.Start({}, [this](const RadioCommand& InCommand) {
+				std::lock_guard lock(Mutex);
+				Ran.emplace_back(InCommand.Action, InCommand.Amount);
+			});
+		}
+
+		// What ran once InDone holds for it, or after a few seconds.
+		template <class Predicate>
+		Commands WaitUntil(Predicate InDone)
+		{
+			const auto deadline = std::chrono::steady_clock::now() + 5s;
+			while (std::chrono::steady_clock::now() < deadline) {
+				{
+					std::lock_guard lock(Mutex);
+					if (InDone(Ran))
+						return Ran;
+				}
+				std::this_thread::sleep_for(1ms);
+			}
+			std::lock_guard lock(Mutex);
+			return Ran;
+		}
+
+		std::mutex    Mutex;
+		Commands      Ran;
+		CommandWorker Worker;  // last, so it stops before the rest goes
+	};
+}
+
+TEST(CommandQueue, CoalescesBursts)
+{
+	using enum RadioAction;
+	CHECK(Coalesce({}).empty());
+	CHECK(Coalesce({ { Station, 1 }, { Station, 1 }, { Station, 1 }, { Volume, -1 }, { Station, 1 } }) == Commands{ { Station, 3 }, { Volume, -1 }, { Station, 1 } });
+	CHECK(Coalesce({ { Station, 1 }, { Station, -1 }, { Volume, 2 } }) == Commands{ { Volume, 2 } });
+	CHECK(Coalesce({ { TogglePlayer, 1 }, { TogglePlayer, 1 } }).empty());
+	CHECK(Coalesce({ { TogglePlayer, 1 }, { TogglePlayer, 1 }, { TogglePlayer, 1 }, { ToggleMode, 1 } }) == Commands{ { TogglePlayer, 1 }, { ToggleMode, 1 } });
+	CHECK(Coalesce({ { Seek, 10 }, { Seek, -30 }, { ShowStats, 1 } }) == Commands{ { Seek, -20 }, { ShowStats, 1 } });
+}
+
+TEST(CommandQueue, RunsPostedCommandsInOrder)
+{
+	Recorder recorder;
+	for (int32_t i = 1; i <= 20; ++i) {
+		CHECK(recorder.Worker.Post({ i % 2 ? RadioAction::Volume : RadioAction::Seek, i }));
+		std::this_thread::sleep_for(1ms);
+	}
+
+	// However they were batched, nothing is lost and the first to come runs first.
+	const auto ran = recorder.WaitUntil([](const Commands& InRan) { return Sum(InRan, RadioAction::Volume) == 100 && Sum(InRan, RadioAction::Seek) == 110; });
+	CHECK(Sum(ran, RadioAction::Volume) == 100 && Sum(ran, RadioAction::Seek) == 110);
+	CHECK(!ran.empty() && ran[0] == std::pair(RadioAction::Volume, 1));
+}
+
+TEST(CommandQueue, RaisedActionsRunOnce)
+{
+	Recorder recorder;
+	recorder.Worker.Post({ RadioAction::Station, 1 });
+	for (int i = 0; i < 10; ++i)
+		recorder.Worker.Raise(RadioAction::TrackEnded);
+
+	const auto ran = recorder.WaitUntil(AtLeast(2));
+	CHECK(ran.size() >= 2);
+	CHECK(std::ranges::count(ran, std::pair(RadioAction::TrackEnded, 1)) >= 1);
+	CHECK(std::ranges::count(ran, std::pair(RadioAction::TrackEnded, 1)) <= 2);
+}
+
+TEST(CommandQueue, TicksUntilStopped)
+{
+	Recorder recorder;
+	recorder.Worker.RaiseEvery(RadioAction::Tick, 20ms);
+	const auto ran = recorder.WaitUntil(AtLeast(5));
+	CHECK(ran.size() >= 5 && std::ranges::all_of(ran, [](const auto& InCommand) { return InCommand == std::pair(RadioAction::Tick, 1); }));
+
+	// Stop ends the ticks at once rather than after an interval.
+	const auto start = std::chrono::steady_clock::now();
+	recorder.Worker.RaiseEvery(RadioAction::Tick, 1h);
+	recorder.Worker.Stop();
+	CHECK(std::chrono::steady_clock::now() - start < 1s);
+
+	const auto stopped = recorder.WaitUntil(AtLeast(0)).size();
+	std::this_thread::sleep_for(60ms);
+	CHECK(recorder.WaitUntil(AtLeast(0)).size() == stopped);
+}
+
+TEST(CommandQueue, SlowOpensDoNotHoldUpInput)
+{
+	// A fake backend whose station opens take as long as a stream connecting does. Presses
+	// during one must still be taken at once, and answered as soon as it is over.
+	using Clock = std::chrono::steady_clock;
+	constexpr auto kOpen = 200ms;
+
+	struct Ack
+	{
+		RadioAction       Action;
+		int32_t           Amount;
+		Clock::time_point At;
+	};
+
+	std::mutex       mutex;
+	std::vector<Ack> acks;
+	std::atomic<int> opening = 0;
+	CommandWorker    worker;
+	worker.Start({}, [&](const RadioCommand& InCommand) {
+		if (InCommand.Action == RadioAction::Station) {
+			++opening;
+			std::this_thread::sleep_for(kOpen);
+		}
+		std::lock_guard lock(mutex);
+		acks.push_back({ InCommand.Action, InCommand.Amount, Clock::now() });
+	});
+
+	CHECK(worker.Post({ RadioAction::Station, 1 }));
+	while (opening == 0)
+		std::this_thread::sleep_for(1ms);
+
+	// Three volume presses, then five station presses, while the first open is under way.
+	Clock::duration slowestPost{};
+	const auto      pressed = Clock::now();
+	for (const auto action : { RadioAction::Volume, RadioAction::Station }) {
+		for (int i = 0; i < (action == RadioAction::Volume ? 3 : 5); ++i) {
+			const auto start = Clock::now();
+			CHECK(worker.Post({ action, 1 }));
+			slowestPost = std::max(slowestPost, Clock::now() - start);
+			std::this_thread::sleep_for(2ms);
+		}
+	}
+	CHECK(slowestPost < 20ms);  // far short of an open, with room for a busy machine
+
+	const auto deadline = Clock::now() + 5s;
+	for (;;) {
+		{
+			std::lock_guard lock(mutex);
+			if (acks.size() >= 3 || Clock::now() > deadline)
+				break;
+		}
+		std::this_thread::sleep_for(1ms);
+	}
+
+	// The volume change waits out the open in progress and no more; the five presses become
+	// one open of the station they end on.
+	worker.Stop();
+	std::lock_guard lock(mutex);
+	CHECK(acks.size() == 3);
+	CHECK(opening == 2);
+	if (acks.size() == 3) {
+		CHECK(acks[1].Action == RadioAction::Volume && acks[1].Amount == 3);
+		CHECK(acks[1].At - pressed < kOpen + 100ms);
+		CHECK(acks[2].Action == RadioAction::Station && acks[2].Amount == 5);
+		CHECK(acks[2].At - pressed < 2 * kOpen + 100ms);
+	}
+}
@@ -0,0 +1,162 @@
+#include "Control/KeyBindings.h"
+
+#include "Check.h"
+
+using namespace Control;
+
+namespace
+{
+	using Actions = std::vector<std::pair<RadioAction, int32_t>>;
+
+	constexpr int kShift = 0x10;
+	constexpr int kControl = 0x11;
+	constexpr int kGamepadA = 0xC3;
+
+	// The default keys from RadioConfig, numpad throughout.
+	KeyBindingTable MakeBindings()
+	{
+		return { {
+			{ 0x60, RadioAction::TogglePlayer, 1 },
+			{ 0x6D, RadioAction::ToggleMode, 1 },
+			{ 0x69, RadioAction::Volume, 1 },
+			{ 0x66, RadioAction::Volume, -1 },
+			{ 0x68, RadioAction::Station, 1 },
+			{ 0x67, RadioAction::Station, -1 },
+			{ 0x6A, RadioAction::Seek, 10 },
+			{ 0x6F, RadioAction::Seek, -10 },
+			{ 0x6E, RadioAction::ShowStats, 1 },
+		} };
+	}
+
+	// Stands in for the keyboard hook: plays key transitions into a dispatcher and keeps what
+	// it fired.
+	struct Keyboard
+	{
+		Keyboard() :
+			Dispatcher(MakeBindings(), [this](RadioAction InAction, int32_t InAmount) { Fired.emplace_back(InAction, InAmount); })
+		{
+		}
+
+		bool Down(int InKey) { return Dispatcher.OnKey(InKey, true); }
+		bool Up(int InKey) { return Dispatcher.OnKey(InKey, false); }
+
+		void Press(int InKey)
+		{
+			Down(InKey);
+			Up(InKey);
+		}
+
+		Actions       Fired;
+		KeyDispatcher Dispatcher;
+	};
+}
+
+TEST(KeyBindings, FiresOnThePressEdgeOnly)
+{
+	Keyboard keyboard;
+	CHECK(keyboard.Down(0x68));
+
+	// Auto-repeat sends more downs while the key is held; none of them is a new press.
+	for (int i = 0; i < 5; ++i)
+		CHECK(keyboard.Down(0x68));
+	CHECK(keyboard.Fired == Actions{ { RadioAction::Station, 1 } });
+
+	// Nor is the release.
+	CHECK(keyboard.Up(0x68));
+	CHECK(keyboard.Fired.size() == 1);
+
+	keyboard.Press(0x68);
+	keyboard.Press(0x66);
+	CHECK(keyboard.Fired == Actions{ { RadioAction::Station, 1 }, { RadioAction::Station, 1 }, { RadioAction::Volume, -1 } });
+
+	// A release without a press fires nothing; unbound keys are not claimed.
+	CHECK(keyboard.Up(0x6A));
+	CHECK(!keyboard.Down(0x41) && !keyboard.Up(0x41));
+	CHECK(keyboard.Fired.size() == 3);
+}
+
+TEST(KeyBindings, RefreshKeepsHeldKeys)
+{
+	Keyboard keyboard;
+	bool     changed = false;
+	auto     bindings = MakeBindings();
+	keyboard.Dispatcher.SetBindingSource([&](KeyBindingTable& OutBindings) {
+		if (!std::exchange(changed, false))
+			return false;
+		OutBindings = bindings;
+		return true;
+	});
+
+	keyboard.Down(0x68);
+	keyboard.Down(0x69);
+	CHECK(keyboard.Fired.size() == 2);
+
+	// A reload moves next station to another key and leaves volume up where it was. Volume up
+	// is still down, so its repeats stay quiet; the new next-station key starts released.
+	bindings[4].VirtualKey = 0x6B;
+	changed = true;
+	CHECK(keyboard.Down(0x69));
+	CHECK(keyboard.Fired.size() == 2);
+	CHECK(keyboard.Down(0x6B));
+	CHECK(keyboard.Fired.size() == 3 && keyboard.Fired.back() == std::pair(RadioAction::Station, 1));
+
+	// The old key is no longer bound, down or not.
+	CHECK(!keyboard.Down(0x68) && !keyboard.Up(0x68));
+	CHECK(keyboard.Fired.size() == 3);
+
+	// A refresh with nothing new changes nothing.
+	keyboard.Dispatcher.Refresh();
+	CHECK(keyboard.Dispatcher.GetBindings()[4].VirtualKey == 0x6B && keyboard.Dispatcher.GetBindings()[4].Held);
+}
+
+TEST(KeyBindings, GamepadKeysNeedPolling)
+{
+	Keyboard keyboard;
+	CHECK(!keyboard.Dispatcher.NeedsPolling());
+
+	// The hook never sees gamepad keys, so binding one means falling back to polling.
+	auto bindings = MakeBindings();
+	bindings[0].VirtualKey = kGamepadA;
+	keyboard.Dispatcher.SetBindingSource([&](KeyBindingTable& OutBindings) {
+		OutBindings = bindings;
+		return true;
+	});
+	keyboard.Dispatcher.Refresh();
+	CHECK(keyboard.Dispatcher.NeedsPolling());
+
+	CHECK(IsGamepadKey(0xC3) && IsGamepadKey(0xDA));
+	CHECK(!IsGamepadKey(0xC2) && !IsGamepadKey(0xDB) && !IsGamepadKey(0x60));
+}
+
+TEST(KeyBindings, ModifierCombos)
+{
+	Keyboard keyboard;
+
+	// Modifiers are not bound: the hook passes them to the game, and a bound key pressed with
+	// one held still fires, once.
+	CHECK(!keyboard.Down(kShift) && !keyboard.Down(kControl));
+	keyboard.Press(0x69);
+	CHECK(!keyboard.Up(kControl) && !keyboard.Up(kShift));
+	CHECK(keyboard.Fired == Actions{ { RadioAction::Volume, 1 } });
+
+	// Two bound keys held together each fire on their own press, whichever goes up first.
+	keyboard.Fired.clear();
+	keyboard.Down(0x6A);
+	keyboard.Down(0x68);
+	keyboard.Down(0x6A);
+	keyboard.Up(0x6A);
+	keyboard.Down(0x68);
+	keyboard.Up(0x68);
+	CHECK(keyboard.Fired == Actions{ { RadioAction::Seek, 10 }, { RadioAction::Station, 1 } });
+
+	// One key bound to two actions fires both on one press.
+	auto bindings = MakeBindings();
+	bindings[8].VirtualKey = 0x60;
+	keyboard.Dispatcher.SetBindingSource([&](KeyBindingTable& OutBindings) {
+		OutBindings = bindings;
+		return true;
+	});
+	keyboard.Fired.clear();
+	keyboard.Press(0x60);
+	CHECK(keyboard.Fired == Actions{ { RadioAction::TogglePlayer, 1 }, { RadioAction::ShowStats, 1 } });
+}
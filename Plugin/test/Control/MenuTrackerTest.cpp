@@ -0,0 +1,106 @@
+#include "Control/MenuTracker.h"
+
+#include "Check.h"
+
+using namespace Control;
+using Audio::GameState;
+
+namespace
+{
+	// Plays a sequence of menu events, as the game's event sink would, and returns the state
+	// after each one.
+	std::vector<GameState> Play(MenuTracker& InTracker, std::initializer_list<std::pair<std::string_view, bool>> InEvents)
+	{
+		std::vector<GameState> states;
+		for (const auto& [menu, opening] : InEvents) {
+			InTracker.OnMenu(menu, opening);
+			states.push_back(InTracker.GetState());
+		}
+		return states;
+	}
+
+	constexpr bool kOpen = true;
+	constexpr bool kClose = false;
+}
+
+TEST(MenuTracker, NestedMenus)
+{
+	MenuTracker tracker;
+	CHECK(tracker.GetState() == GameState::Playing);
+
+	// The inventory opened from the data menu, closed back to it, then the data menu closed.
+	CHECK(Play(tracker, {
+		                    { "DataMenu", kOpen },
+		                    { "InventoryMenu", kOpen },
+		                    { "InventoryMenu", kClose },
+		                    { "DataMenu", kClose },
+		                }) == std::vector{ GameState::Menu, GameState::Menu, GameState::Menu, GameState::Playing });
+
+	// Menus that close in another order than they opened.
+	CHECK(Play(tracker, {
+		                    { "DataMenu", kOpen },
+		                    { "SkillsMenu", kOpen },
+		                    { "DataMenu", kClose },
+		                    { "SkillsMenu", kClose },
+		                }) == std::vector{ GameState::Menu, GameState::Menu, GameState::Menu, GameState::Playing });
+
+	// HUD and other overlays do not count, and report no change.
+	CHECK(!tracker.OnMenu("HUDMenu", kOpen));
+	CHECK(!tracker.OnMenu("CursorMenu", kOpen));
+	CHECK(tracker.GetState() == GameState::Playing);
+}
+
+TEST(MenuTracker, LoadingBeatsPausedBeatsMenu)
+{
+	MenuTracker tracker;
+
+	// Pausing from a menu, then loading a save from the pause menu: each step takes over, and
+	// closing the load screen falls back to whatever is still open underneath.
+	CHECK(Play(tracker, {
+		                    { "InventoryMenu", kOpen },
+		                    { "PauseMenu", kOpen },
+		                    { "LoadingMenu", kOpen },
+		                    { "InventoryMenu", kClose },
+		                    { "PauseMenu", kClose },
+		                    { "LoadingMenu", kClose },
+		                }) == std::vector{ GameState::Menu, GameState::Paused, GameState::Loading, GameState::Loading, GameState::Loading, GameState::Playing });
+
+	CHECK(Play(tracker, {
+		                    { "LoadingMenu", kOpen },
+		                    { "DataMenu", kOpen },
+		                    { "LoadingMenu", kClose },
+		                    { "MainMenu", kOpen },
+		                    { "MainMenu", kClose },
+		                    { "DataMenu", kClose },
+		                }) == std::vector{ GameState::Loading, GameState::Loading, GameState::Menu, GameState::Paused, GameState::Menu, GameState::Playing });
+}
+
+TEST(MenuTracker, ReportsOnlyChanges)
+{
+	MenuTracker tracker;
+	CHECK(tracker.OnMenu("DataMenu", kOpen));
+	CHECK(!tracker.OnMenu("InventoryMenu", kOpen));
+	CHECK(tracker.OnMenu("PauseMenu", kOpen));
+	CHECK(tracker.OnMenu("PauseMenu", kClose));
+	CHECK(!tracker.OnMenu("InventoryMenu", kClose));
+	CHECK(tracker.OnMenu("DataMenu", kClose));
+}
+
+TEST(MenuTracker, UnmatchedCloseDoesNotUnderflow)
+{
+	// The plugin loaded with the main menu up, so its close arrives without an open. It must
+	// not leave a debt that swallows the next open.
+	MenuTracker tracker;
+	CHECK(!tracker.OnMenu("MainMenu", kClose));
+	CHECK(!tracker.OnMenu("LoadingMenu", kClose));
+	CHECK(!tracker.OnMenu("LoadingMenu", kClose));
+	CHECK(tracker.GetState() == GameState::Playing);
+
+	CHECK(Play(tracker, {
+		                    { "LoadingMenu", kOpen },
+		                    { "LoadingMenu", kClose },
+		                    { "PauseMenu", kOpen },
+		                    { "DataMenu", kClose },
+		                    { "PauseMenu", kClose },
+		                }) == std::vector{ GameState::Loading, GameState::Playing, GameState::Paused, GameState::Paused, GameState::Playing });
+}
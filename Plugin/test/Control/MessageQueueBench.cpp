@@ -0,0 +1,108 @@
+#include "Control/MessageQueue.h"
+
+#include "Bench.h"
+#include "Check.h"
+#include "Fixtures.h"
+
+#if defined(RADIO_HAVE_SPDLOG)
+#	include <spdlog/sinks/basic_file_sink.h>
+#	include <spdlog/spdlog.h>
+#endif
+
+using namespace Control;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Posts come in bursts of half the ring, each timed on its own, with the drain catching up
+	// in between: the cost of a post that is taken, not of one dropped by a full ring.
+	template <class Body>
+	void MeasurePosts(std::string_view InName, MessageQueue& InQueue, const std::atomic<uint64_t>& InHandled, Body&& InPost)
+	{
+		constexpr int kBurst = MessageQueue::kCapacity / 2;
+
+		uint64_t   posts = 0;
+		auto       posting = Clock::duration::zero();
+		const auto start = Clock::now();
+		while (Clock::now() - start < 200ms) {
+			const auto burst = Clock::now();
+			for (int i = 0; i < kBurst; ++i)
+				InPost();
+			posting += Clock::now() - burst;
+			posts += kBurst;
+
+			// Delivered, folded or suppressed; a notification held back is one short.
+			const auto wait = Clock::now();
+			while (InHandled + InQueue.GetStats().Coalesced + InQueue.GetStats().Suppressed + 1 < InQueue.GetStats().Posted && Clock::now() - wait < 1s)
+				std::this_thread::yield();
+		}
+
+		std::printf("  %-40.*s %10.1f ns/call\n", static_cast<int>(InName.size()), InName.data(), std::chrono::duration<double, std::nano>(posting).count() / static_cast<double>(posts));
+	}
+}
+
+// What a hot path pays per line: posting to the queue, against writing the line where it is
+// logged as INFO did before, through synchronous spdlog to a file. The drain thread writes to
+// a file too, on its own thread.
+TEST(MessageQueueBench, PerCallCost)
+{
+	const Test::TempDirectory directory("messages-bench");
+
+	std::FILE* log = std::fopen((directory / "queue.log").string().c_str(), "wb");
+	CHECK(log != nullptr);
+	if (!log)
+		return;
+
+	uint32_t line = 0;
+	for (const auto category : { MessageCategory::Log, MessageCategory::Volume }) {
+		MessageQueue          queue;
+		std::atomic<uint64_t> handled = 0;
+		std::jthread          drain([&](std::stop_token InStop) {
+			queue.Run(InStop, [&](MessageCategory, std::string_view InText) {
+				std::fwrite(InText.data(), 1, InText.size(), log);
+				std::fputc('\n', log);
+				++handled;
+			});
+		});
+
+		if (category == MessageCategory::Log) {
+			MeasurePosts("MessageQueue::Post, distinct lines", queue, handled, [&] {
+				++line;
+				Test::KeepAlive(queue.Post(MessageCategory::Log, "{} - Station {} opened in {} ms", Plugin::NAME, line, line % 977));
+			});
+			MeasurePosts("MessageQueue::Post, repeated line", queue, handled, [&] {
+				Test::KeepAlive(queue.Post(MessageCategory::Log, "{} - Station {} opened in {} ms", Plugin::NAME, 7, 42));
+			});
+		} else {
+			MeasurePosts("MessageQueue::Post, volume notification", queue, handled, [&] {
+				++line;
+				Test::KeepAlive(queue.Post(MessageCategory::Volume, "Volume {}", (line % 40) * 25));
+			});
+		}
+
+		drain.request_stop();
+		drain.join();
+		CHECK(queue.GetStats().Dropped == 0);
+	}
+	std::fclose(log);
+
+#if defined(RADIO_HAVE_SPDLOG)
+	auto logger = spdlog::basic_logger_mt("bench", (directory / "spdlog.log").string(), true);
+	logger->set_level(spdlog::level::info);
+	logger->flush_on(spdlog::level::info);
+	Test::Measure("spdlog, file sink, flushed per line", 1, "lines", [&] {
+		++line;
+		logger->info("{} - Station {} opened in {} ms", Plugin::NAME, line, line % 977);
+	});
+
+	logger->flush_on(spdlog::level::off);
+	Test::Measure("spdlog, file sink, buffered", 1, "lines", [&] {
+		++line;
+		logger->info("{} - Station {} opened in {} ms", Plugin::NAME, line, line % 977);
+	});
+	spdlog::drop_all();
+#else
+	std::printf("  spdlog not found; built without the comparison\n");
+#endif
+}
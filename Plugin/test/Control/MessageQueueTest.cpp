@@ -0,0 +1,236 @@
+#include "Control/MessageQueue.h"
+
+#include "Check.h"
+
+using namespace Control;
+
+namespace
+{
+	using Delivered = std::vector<std::pair<MessageCategory, std::string>>;
+
+	// Runs the drain thread of a queue and keeps what it delivered.
+	struct Drainer
+	{
+		explicit Drainer(MessageQueue& InQueue) :
+			Thread([this, &InQueue](std::stop_token InStop) {
+				InQueue.Run(InStop, [this](MessageCategory InCategory, std::string_view InText) {
+					std::lock_guard lock(Mutex);
+					Messages.emplace_back(InCategory, InText);
+				});
+			})
+		{
+		}
+
+		// What was delivered once InDone holds for it, or after a few seconds.
+		template <class Predicate>
+		Delivered WaitUntil(Predicate InDone)
+		{
+			const auto deadline = std::chrono::steady_clock::now() + 5s;
+			while (std::chrono::steady_clock::now() < deadline) {
+				{
+					std::lock_guard lock(Mutex);
+					if (InDone(Messages))
+						return Messages;
+				}
+				std::this_thread::sleep_for(1ms);
+			}
+			std::lock_guard lock(Mutex);
+			return Messages;
+		}
+
+		Delivered Stop()
+		{
+			Thread.request_stop();
+			Thread.join();
+			return Messages;
+		}
+
+		std::mutex   Mutex;
+		Delivered    Messages;
+		std::jthread Thread;  // last, so it stops before the rest goes
+	};
+
+	auto AtLeast(std::size_t InCount)
+	{
+		return [InCount](const Delivered& InMessages) { return InMessages.size() >= InCount; };
+	}
+
+	bool IsUtf8(std::string_view InText)
+	{
+		for (std::size_t i = 0; i < InText.size();) {
+			const auto        lead = static_cast<uint8_t>(InText[i]);
+			const std::size_t length = lead < 0x80 ? 1 : lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 0;
+			if (length == 0 || i + length > InText.size())
+				return false;
+			for (std::size_t j = 1; j < length; ++j) {
+				if ((static_cast<uint8_t>(InText[i + j]) & 0xC0) != 0x80)
+					return false;
+			}
+			i += length;
+		}
+		return true;
+	}
+}
+
+TEST(MessageQueue, TrimsPartialCodePoints)
+{
+	CHECK(TrimPartialCodePoint("") == 0);
+	CHECK(TrimPartialCodePoint("abc") == 3);
+	CHECK(TrimPartialCodePoint("ab\xC3\xA9") == 4);
+	CHECK(TrimPartialCodePoint("ab\xC3") == 2);
+	CHECK(TrimPartialCodePoint("a\xE2\x82\xAC") == 4);
+	CHECK(TrimPartialCodePoint("a\xE2\x82") == 1);
+	CHECK(TrimPartialCodePoint("a\xE2") == 1);
+	CHECK(TrimPartialCodePoint("a\xF0\x9F\x93\xBB") == 5);
+	CHECK(TrimPartialCodePoint("a\xF0\x9F\x93") == 1);
+	CHECK(TrimPartialCodePoint("a\xF0") == 1);
+
+	// Not UTF-8 to begin with: stray continuation bytes stay. A Latin-1 letter at the end
+	// reads as a cut lead byte and goes, which Post only asks for once it cut the text anyway.
+	CHECK(TrimPartialCodePoint("\x80\x80") == 2);
+	CHECK(TrimPartialCodePoint("Caf\xE9") == 3);
+}
+
+TEST(MessageQueue, CutsLongMessagesBetweenCharacters)
+{
+	// Every width of character, landing on every byte of it at the cut.
+	for (const std::string_view character : { "\xC3\xA9"sv, "\xE2\x82\xAC"sv, "\xF0\x9F\x93\xBB"sv }) {
+		MessageQueue queue;
+		Drainer      drainer(queue);
+
+		std::vector<std::string> posted;
+		for (std::size_t padding = 0; padding < character.size(); ++padding) {
+			std::string text(padding, 'x');
+			while (text.size() < MessageQueue::kMaxText + 8)
+				text += character;
+			CHECK(queue.Post(MessageCategory::Log, text));
+			posted.push_back(std::move(text));
+		}
+
+		const auto delivered = drainer.WaitUntil(AtLeast(posted.size()));
+		CHECK(delivered.size() == posted.size());
+		for (std::size_t i = 0; i < std::min(delivered.size(), posted.size()); ++i) {
+			const auto& text = delivered[i].second;
+			CHECK(IsUtf8(text));
+			CHECK(text.size() <= MessageQueue::kMaxText && text.size() > MessageQueue::kMaxText - character.size());
+			CHECK(posted[i].starts_with(text));
+		}
+	}
+
+	// Short messages and exact fits pass whole.
+	MessageQueue queue;
+	Drainer      drainer(queue);
+	const auto   exact = std::string(MessageQueue::kMaxText - 2, 'y') + "\xC3\xA9";
+	queue.Post(MessageCategory::Log, "Now Playing - {} \xE2\x80\x94 {}", "Sigur R\xC3\xB3s", "Hopp\xC3\xADpolla");
+	queue.Post(MessageCategory::Log, exact);
+	const auto delivered = drainer.WaitUntil(AtLeast(2));
+	CHECK(delivered.size() == 2 && delivered[0].second == "Now Playing - Sigur R\xC3\xB3s \xE2\x80\x94 Hopp\xC3\xADpolla");
+	CHECK(delivered.size() == 2 && delivered[1].second == exact);
+}
+
+TEST(MessageQueue, FoldsRepeatedLogLines)
+{
+	MessageQueue queue;
+	for (int i = 0; i < 10; ++i)
+		queue.Post(MessageCategory::Log, "Station lost");
+	queue.Post(MessageCategory::Log, "Station back");
+
+	Drainer    drainer(queue);
+	const auto delivered = drainer.WaitUntil(AtLeast(3));
+	CHECK(delivered.size() == 3);
+	CHECK(delivered.size() == 3 && delivered[0].second == "Station lost");
+	CHECK(delivered.size() == 3 && delivered[1].second == std::format("{} - Last line repeated 9 more time(s)", Plugin::NAME));
+	CHECK(delivered.size() == 3 && delivered[2].second == "Station back");
+	CHECK(queue.GetStats().Coalesced == 9);
+}
+
+TEST(MessageQueue, RateLimitsLogLines)
+{
+	// Past the limit, the rest of the second is one line saying how many were left out.
+	MessageQueue queue;
+	Drainer      drainer(queue);
+	for (uint32_t i = 0; i < MessageQueue::kMaxLogsPerSecond + 70; ++i)
+		queue.Post(MessageCategory::Log, "Line {}", i);
+
+	const auto delivered = drainer.WaitUntil(AtLeast(MessageQueue::kMaxLogsPerSecond + 1));
+	CHECK(delivered.size() == MessageQueue::kMaxLogsPerSecond + 1);
+	CHECK(!delivered.empty() && delivered.back().second == std::format("{} - 70 log line(s) suppressed", Plugin::NAME));
+	CHECK(queue.GetStats().Suppressed == 70);
+}
+
+TEST(MessageQueue, NotificationsKeepTheNewest)
+{
+	// Holding a key: only the value it stopped at is shown, once the presses stop.
+	MessageQueue queue;
+	Drainer      drainer(queue);
+	for (int volume = 25; volume <= 500; volume += 25) {
+		queue.Post(MessageCategory::Volume, "Volume {}", volume);
+		std::this_thread::sleep_for(5ms);
+	}
+	queue.Post(MessageCategory::Status, "Radio on");
+	queue.Post(MessageCategory::Status, "Radio on");
+
+	const auto delivered = drainer.WaitUntil(AtLeast(2));
+	std::this_thread::sleep_for(400ms);
+	const auto settled = drainer.Stop();
+	CHECK(std::ranges::count(settled, std::pair(MessageCategory::Volume, "Volume 500"s)) == 1);
+	CHECK(std::ranges::count_if(settled, [](const auto& InMessage) { return InMessage.first == MessageCategory::Volume; }) == 1);
+	CHECK(std::ranges::count(settled, std::pair(MessageCategory::Status, "Radio on"s)) == 1);
+	CHECK(delivered.size() == 2);
+	CHECK(queue.GetStats().Coalesced == 19 + 1);
+}
+
+TEST(MessageQueue, DropsWhenFull)
+{
+	// Nothing drains: the ring fills, and the rest is dropped and counted, never waited on.
+	MessageQueue queue;
+	for (std::size_t i = 0; i < MessageQueue::kCapacity; ++i)
+		CHECK(queue.Post(MessageCategory::Title, "Title {}", i));
+	for (int i = 0; i < 10; ++i)
+		CHECK(!queue.Post(MessageCategory::Title, "Dropped"));
+
+	const auto stats = queue.GetStats();
+	CHECK(stats.Posted == MessageQueue::kCapacity + 10);
+	CHECK(stats.Dropped == 10);
+
+	// Drained, the ring takes messages again.
+	Drainer drainer(queue);
+	drainer.WaitUntil(AtLeast(1));
+	std::this_thread::sleep_for(50ms);
+	CHECK(queue.Post(MessageCategory::Title, "After"));
+}
+
+TEST(MessageQueue, ManyProducers)
+{
+	// Every message posted is delivered, folded, suppressed or dropped, and none comes torn.
+	constexpr int kThreads = 4;
+	constexpr int kPerThread = 2000;
+
+	MessageQueue queue;
+	Drainer      drainer(queue);
+	{
+		std::vector<std::jthread> producers;
+		for (int thread = 0; thread < kThreads; ++thread) {
+			producers.emplace_back([&queue, thread] {
+				for (int i = 0; i < kPerThread; ++i)
+					queue.Post(i % 3 ? MessageCategory::Log : MessageCategory::Title, "Producer {} message {} \xE2\x80\x94 {}", thread, i, std::string(static_cast<std::size_t>(i % 40), '.'));
+			});
+		}
+	}
+	std::this_thread::sleep_for(100ms);
+	const auto delivered = drainer.Stop();
+	const auto stats = queue.GetStats();
+
+	uint64_t ours = 0;
+	for (const auto& [category, text] : delivered) {
+		if (text.starts_with("Producer ")) {
+			++ours;
+			CHECK(IsUtf8(text) && text.find("message") != std::string::npos);
+		}
+	}
+
+	// Title notifications still held back when the drain stopped were let go uncounted.
+	CHECK(stats.Posted == kThreads * kPerThread);
+	CHECK(ours + stats.Coalesced + stats.Suppressed + stats.Dropped <= stats.Posted);
+	CHECK(ours + stats.Coalesced + stats.Suppressed + stats.Dropped + 1 >= stats.Posted);
+}
@@ -0,0 +1,262 @@
+#include "Control/Rotation.h"
+
+#include "Check.h"
+
+using namespace Control;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	std::vector<uint32_t> Deal(Rotation& InOutRotation, std::size_t InCount)
+	{
+		std::vector<uint32_t> tracks(InCount);
+		for (auto& track : tracks)
+			track = InOutRotation.Next();
+		return tracks;
+	}
+
+	// A folder of InCount songs of 2-6 minutes, and InAds ads of 30 s after them.
+	struct Folder
+	{
+		Folder(uint32_t InCount, uint32_t InAds = 0)
+		{
+			for (uint32_t i = 0; i < InCount; ++i) {
+				LengthsMs.push_back(120'000 + i * 7919 % 240'000);
+				Categories.push_back(TrackCategory::Music);
+			}
+			for (uint32_t i = 0; i < InAds; ++i) {
+				LengthsMs.push_back(30'000);
+				Categories.push_back(TrackCategory::Ad);
+			}
+		}
+
+		RotationClock MakeClock(uint64_t InSeed, const RotationWeights& InWeights = { 1, 1, 1, 1 }) const
+		{
+			return RotationClock(InSeed, LengthsMs, Categories, InWeights);
+		}
+
+		std::vector<uint32_t>      LengthsMs;
+		std::vector<TrackCategory> Categories;
+	};
+
+	bool SameSlot(const RotationClock::Slot& InLeft, const RotationClock::Slot& InRight)
+	{
+		return InLeft.Track == InRight.Track && InLeft.PositionMs == InRight.PositionMs;
+	}
+}
+
+TEST(Rotation, RandomIsXoshiro256StarStar)
+{
+	// Reference values from the published algorithm, seeded through SplitMix64.
+	Random random(42);
+	CHECK(random.Next() == 0x15780b2e0c2ec716ull);
+	CHECK(random.Next() == 0x6104d9866d113a7eull);
+	CHECK(random.Next() == 0xae17533239e499a1ull);
+	CHECK(random.Next() == 0xecb8ad4703b360a1ull);
+}
+
+TEST(Rotation, BelowIsUniform)
+{
+	Random random(7);
+	CHECK(random.Below(0) == 0);
+	CHECK(random.Below(1) == 0);
+
+	// A bound that does not divide 2^32 evenly: every value within a few percent of its share.
+	constexpr uint32_t    kBound = 6;
+	constexpr int         kDraws = 600'000;
+	std::array<int, kBound> counts{};
+	for (int i = 0; i < kDraws; ++i) {
+		const auto value = random.Below(kBound);
+		CHECK(value < kBound);
+		if (value < kBound)
+			++counts[value];
+	}
+	for (const auto count : counts)
+		CHECK(std::abs(count - kDraws / static_cast<int>(kBound)) < kDraws / static_cast<int>(kBound) / 50);
+}
+
+TEST(Rotation, SameSeedSameOrder)
+{
+	const std::vector<TrackCategory> tracks(40, TrackCategory::Music);
+	Rotation                         first(1234, tracks, { 1, 1, 1, 1 });
+	Rotation                         second(1234, tracks, { 1, 1, 1, 1 });
+	Rotation                         other(1235, tracks, { 1, 1, 1, 1 });
+
+	const auto dealt = Deal(first, 1000);
+	CHECK(dealt == Deal(second, 1000));
+	CHECK(dealt != Deal(other, 1000));
+}
+
+TEST(Rotation, EveryTrackOncePerDeck)
+{
+	for (const uint32_t count : { 1u, 2u, 3u, 17u, 40u, 250u }) {
+		const std::vector<TrackCategory> tracks(count, TrackCategory::Music);
+		Rotation                         rotation(count, tracks, { 1, 1, 1, 1 });
+		for (int deck = 0; deck < 5; ++deck) {
+			auto dealt = Deal(rotation, count);
+			std::ranges::sort(dealt);
+			std::vector<uint32_t> all(count);
+			std::iota(all.begin(), all.end(), 0u);
+			CHECK(dealt == all);
+		}
+	}
+}
+
+TEST(Rotation, ReshuffleKeepsRecentTracksAway)
+{
+	// The last tracks of a deck stay off the top of the next: min(count / 2, 16) of them.
+	for (const uint32_t count : { 4u, 10u, 33u, 100u }) {
+		const std::size_t                window = std::min<std::size_t>(count / 2, 16);
+		const std::vector<TrackCategory> tracks(count, TrackCategory::Music);
+		for (uint64_t seed = 0; seed < 50; ++seed) {
+			Rotation rotation(seed, tracks, { 1, 1, 1, 1 });
+			auto     previous = Deal(rotation, count);
+			for (int deck = 0; deck < 10; ++deck) {
+				const auto next = Deal(rotation, count);
+				for (std::size_t i = 0; i < window; ++i)
+					CHECK(std::find(previous.end() - static_cast<std::ptrdiff_t>(window), previous.end(), next[i]) == previous.end());
+				previous = next;
+			}
+		}
+	}
+}
+
+TEST(Rotation, WeightsSpreadCategories)
+{
+	// 8 songs to an ad: every ninth slot an ad, never two together.
+	std::vector<TrackCategory> tracks(30, TrackCategory::Music);
+	tracks.insert(tracks.end(), 5, TrackCategory::Ad);
+	Rotation rotation(99, tracks, { 8, 0, 1, 0 });
+
+	const auto dealt = Deal(rotation, 9 * 100);
+	int        ads = 0;
+	for (std::size_t i = 0; i < dealt.size(); ++i) {
+		const bool ad = tracks[dealt[i]] == TrackCategory::Ad;
+		ads += ad;
+		if (ad && i > 0)
+			CHECK(tracks[dealt[i - 1]] != TrackCategory::Ad);
+		if (i % 9 == 8)
+			CHECK(ads == static_cast<int>(i / 9) + 1);
+	}
+}
+
+TEST(Rotation, ZeroWeightsStillPlay)
+{
+	// Weighting every category with tracks to 0 plays them evenly rather than nothing; a
+	// category weighted 0 beside one that is not never plays.
+	std::vector<TrackCategory> tracks(6, TrackCategory::Music);
+	tracks.insert(tracks.end(), 6, TrackCategory::Jingle);
+
+	Rotation   even(5, tracks, { 0, 0, 0, 0 });
+	const auto dealt = Deal(even, 120);
+	CHECK(std::ranges::count_if(dealt, [&](uint32_t InTrack) { return tracks[InTrack] == TrackCategory::Jingle; }) == 60);
+
+	Rotation   musicOnly(5, tracks, { 1, 0, 0, 0 });
+	const auto music = Deal(musicOnly, 120);
+	CHECK(std::ranges::all_of(music, [&](uint32_t InTrack) { return tracks[InTrack] == TrackCategory::Music; }));
+
+	Rotation none(5, {}, { 1, 1, 1, 1 });
+	CHECK(none.empty());
+}
+
+TEST(Rotation, CategoriesFromFolders)
+{
+	CHECK(GetTrackCategory("song.mp3") == TrackCategory::Music);
+	CHECK(GetTrackCategory("Rock/song.mp3") == TrackCategory::Music);
+	CHECK(GetTrackCategory("Jingles\\id.mp3") == TrackCategory::Jingle);
+	CHECK(GetTrackCategory("jingle/id.mp3") == TrackCategory::Jingle);
+	CHECK(GetTrackCategory("ADS/spot.mp3") == TrackCategory::Ad);
+	CHECK(GetTrackCategory("Commercials/x/spot.mp3") == TrackCategory::Ad);
+	CHECK(GetTrackCategory("News/bulletin.mp3") == TrackCategory::News);
+	CHECK(GetTrackCategory("Music/News/bulletin.mp3") == TrackCategory::Music);
+	CHECK(GetTrackCategory("Newsletter/a.mp3") == TrackCategory::Music);
+}
+
+TEST(RotationClock, SameSeedSameBroadcast)
+{
+	// Two players tuned to the same station hear the same thing at the same time, however
+	// each one got there.
+	const Folder folder(25, 4);
+	auto         steady = folder.MakeClock(77, { 8, 0, 1, 0 });
+	auto         jumpy = folder.MakeClock(77, { 8, 0, 1, 0 });
+	auto         other = folder.MakeClock(78, { 8, 0, 1, 0 });
+
+	int differences = 0;
+	for (uint64_t t = 0; t < 48ull * 3600 * 1000; t += 10'000) {
+		const auto slot = steady.Find(t);
+		CHECK(slot.PositionMs < folder.LengthsMs[slot.Track]);
+		if (t % 3'600'000 == 0)
+			CHECK(SameSlot(jumpy.Find(t), slot));
+		differences += !SameSlot(other.Find(t), slot);
+	}
+	CHECK(differences > 0);
+}
+
+TEST(RotationClock, UpcomingIsWhatComesNext)
+{
+	const Folder folder(12);
+	auto         clock = folder.MakeClock(3);
+	uint64_t     t = 5 * 3600 * 1000;
+	auto         slot = clock.Find(t);
+	for (int i = 0; i < 200; ++i) {
+		const auto next = clock.GetUpcoming(3);
+		CHECK(next.size() == 3);
+		const uint32_t expected = next[0];
+
+		t += clock.GetLengthMs(slot.Track) - slot.PositionMs;
+		slot = clock.Find(t);
+		CHECK(slot.Track == expected && slot.PositionMs == 0);
+	}
+}
+
+TEST(RotationClock, GoesBackFromCheckpoints)
+{
+	// Backward jumps, near and far, land where a fresh clock does.
+	const Folder folder(30, 3);
+	auto         clock = folder.MakeClock(11, { 6, 0, 1, 0 });
+	clock.Find(20ull * 3600 * 1000);
+	for (const uint64_t t : { 19ull * 3600 * 1000 + 12'345, 15ull * 3600 * 1000, 14ull * 3600 * 1000 - 1, 3'600'000ull, 1ull, 0ull, 30ull * 3600 * 1000, 29ull * 3600 * 1000 }) {
+		auto fresh = folder.MakeClock(11, { 6, 0, 1, 0 });
+		CHECK(SameSlot(clock.Find(t), fresh.Find(t)));
+		CHECK(std::ranges::equal(clock.GetUpcoming(4), fresh.GetUpcoming(4)));
+	}
+}
+
+TEST(RotationClock, MatchesItsInputs)
+{
+	const Folder folder(10, 2);
+	const auto   clock = folder.MakeClock(5, { 4, 0, 1, 0 });
+	CHECK(clock.Matches(5, folder.LengthsMs, folder.Categories, { 4, 0, 1, 0 }));
+	CHECK(!clock.Matches(6, folder.LengthsMs, folder.Categories, { 4, 0, 1, 0 }));
+	CHECK(!clock.Matches(5, folder.LengthsMs, folder.Categories, { 4, 0, 2, 0 }));
+
+	auto lengths = folder.LengthsMs;
+	lengths[3] += 1;
+	CHECK(!clock.Matches(5, lengths, folder.Categories, { 4, 0, 1, 0 }));
+
+	auto categories = folder.Categories;
+	categories[0] = TrackCategory::Jingle;
+	CHECK(!clock.Matches(5, folder.LengthsMs, categories, { 4, 0, 1, 0 }));
+}
+
+TEST(RotationClock, FirstLookupCost)
+{
+	// A clock built now walks from the start of the broadcast once; after that a lookup costs
+	// the tracks since the last one, and going back a checkpoint's worth at most.
+	const Folder folder(200, 10);
+	auto         clock = folder.MakeClock(1, { 8, 0, 1, 0 });
+
+	constexpr uint64_t kYearMs = 365ull * 24 * 3600 * 1000;
+	auto               start = Clock::now();
+	const auto         slot = clock.Find(kYearMs);
+	const double       first = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	start = Clock::now();
+	for (uint64_t t = kYearMs - 1000; t > kYearMs - 3'600'000; t -= 60'000)
+		clock.Find(t);
+	const double back = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	CHECK(SameSlot(clock.Find(kYearMs), slot));
+	std::printf("  a year of station time: %.1f ms first lookup, %.2f ms for 60 lookups an hour back\n", first, back);
+}
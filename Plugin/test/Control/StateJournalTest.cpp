@@ -0,0 +1,201 @@
+#include "Control/StateJournal.h"
+
+#include "Check.h"
+#include "Fixtures.h"
+
+#if !defined(_WIN32)
+#	include <sys/wait.h>
+#	include <unistd.h>
+#endif
+
+using namespace Control;
+
+namespace
+{
+	constexpr std::size_t kHeaderBytes = 8;
+	constexpr std::size_t kRecordBytes = 48;
+
+	ListeningState MakeState(uint64_t InStation, uint64_t InElapsedMs = 0)
+	{
+		return { InStation, 500.0f + static_cast<float>(InStation), static_cast<int32_t>(InStation % 2), 0xC0FFEE, InElapsedMs };
+	}
+
+	std::string ReadFile(const std::filesystem::path& InPath)
+	{
+		std::ifstream file(InPath, std::ios::binary);
+		return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+	}
+
+	std::optional<ListeningState> LoadFrom(const std::filesystem::path& InPath)
+	{
+		StateJournal journal(InPath);
+		return journal.Load();
+	}
+}
+
+TEST(StateJournal, RestoresTheLastState)
+{
+	const Test::TempDirectory directory("journal");
+	const auto                path = directory / "state/state.journal";
+	{
+		StateJournal journal(path);
+		CHECK(!journal.Load().has_value());
+		for (uint64_t station = 1; station <= 5; ++station)
+			journal.Record(MakeState(station));
+	}
+	CHECK(std::filesystem::file_size(path) == kHeaderBytes + 5 * kRecordBytes);
+	CHECK(LoadFrom(path) == MakeState(5));
+
+	// A session that records nothing keeps what was there.
+	CHECK(LoadFrom(path) == MakeState(5));
+}
+
+TEST(StateJournal, SkipsStatesThatOnlyAgedALittle)
+{
+	// Broadcast time moving is not worth a record until it moved a step; anything else is.
+	const Test::TempDirectory directory("journal");
+	const auto                path = directory / "state.journal";
+	constexpr uint64_t        kStepMs = std::chrono::milliseconds(StateJournal::kElapsedStep).count();
+
+	StateJournal journal(path);
+	journal.Load();
+	journal.Record(MakeState(1, 1000));
+	for (uint64_t ms = 1000; ms < 1000 + kStepMs; ms += 250)
+		journal.Record(MakeState(1, ms));
+	CHECK(std::filesystem::file_size(path) == kHeaderBytes + kRecordBytes);
+
+	journal.Record(MakeState(1, 1000 + kStepMs));
+	CHECK(std::filesystem::file_size(path) == kHeaderBytes + 2 * kRecordBytes);
+
+	auto louder = MakeState(1, 1000 + kStepMs + 10);
+	louder.Volume += 25.0f;
+	journal.Record(louder);
+	journal.Record(louder);
+	CHECK(std::filesystem::file_size(path) == kHeaderBytes + 3 * kRecordBytes);
+
+	auto other = louder;
+	other.Mode ^= 1;
+	journal.Record(other);
+	other.StationKey = 99;
+	journal.Record(other);
+	CHECK(std::filesystem::file_size(path) == kHeaderBytes + 5 * kRecordBytes);
+
+	// Time going back a step (a new schedule) is recorded too.
+	other.ElapsedMs = 0;
+	journal.Record(other);
+	journal.Flush();
+	CHECK(std::filesystem::file_size(path) == kHeaderBytes + 6 * kRecordBytes);
+}
+
+TEST(StateJournal, CutsOffATornTail)
+{
+	// A crash in the middle of a write leaves part of a record: wherever it stops, the record
+	// before it is restored, and the journal is rewritten so later records follow it.
+	const Test::TempDirectory directory("journal");
+	const auto                path = directory / "state.journal";
+	{
+		StateJournal journal(path);
+		journal.Load();
+		for (uint64_t station = 1; station <= 3; ++station)
+			journal.Record(MakeState(station));
+	}
+	const auto whole = ReadFile(path);
+	CHECK(whole.size() == kHeaderBytes + 3 * kRecordBytes);
+
+	for (std::size_t keep = kHeaderBytes + 2 * kRecordBytes + 1; keep < whole.size(); ++keep) {
+		Test::WriteFile(path, std::string_view(whole).substr(0, keep));
+		{
+			StateJournal journal(path);
+			CHECK(journal.Load() == MakeState(2));
+			CHECK(std::filesystem::file_size(path) == kHeaderBytes + kRecordBytes);
+			CHECK(!std::filesystem::exists(directory / "state.journal.tmp"));
+			journal.Record(MakeState(7));
+		}
+		CHECK(LoadFrom(path) == MakeState(7));
+	}
+
+	// Cut inside the header or the first record: nothing to restore, and a fresh journal.
+	for (const std::size_t keep : { std::size_t(0), std::size_t(5), kHeaderBytes, kHeaderBytes + kRecordBytes - 1 }) {
+		Test::WriteFile(path, std::string_view(whole).substr(0, keep));
+		CHECK(!LoadFrom(path).has_value());
+		CHECK(std::filesystem::file_size(path) == kHeaderBytes);
+	}
+}
+
+TEST(StateJournal, StopsAtACorruptRecord)
+{
+	// A flipped byte fails the record's checksum; nothing after it counts either.
+	const Test::TempDirectory directory("journal");
+	const auto                path = directory / "state.journal";
+	{
+		StateJournal journal(path);
+		journal.Load();
+		for (uint64_t station = 1; station <= 4; ++station)
+			journal.Record(MakeState(station));
+	}
+	const auto whole = ReadFile(path);
+
+	for (std::size_t offset = kHeaderBytes + 2 * kRecordBytes; offset < kHeaderBytes + 3 * kRecordBytes; offset += 5) {
+		auto bytes = whole;
+		bytes[offset] ^= 0x20;
+		Test::WriteFile(path, bytes);
+		CHECK(LoadFrom(path) == MakeState(2));
+	}
+
+	// Records out of sequence are not the same journal any more.
+	auto bytes = whole;
+	std::copy_n(whole.begin() + kHeaderBytes, kRecordBytes, bytes.begin() + kHeaderBytes + 2 * kRecordBytes);
+	Test::WriteFile(path, bytes);
+	CHECK(LoadFrom(path) == MakeState(2));
+
+	Test::WriteFile(path, "not a journal at all, just some text long enough to hold records"sv);
+	CHECK(!LoadFrom(path).has_value());
+}
+
+TEST(StateJournal, CompactsWhenLong)
+{
+	const Test::TempDirectory directory("journal");
+	const auto                path = directory / "state.journal";
+	{
+		StateJournal journal(path);
+		journal.Load();
+		for (uint64_t station = 1; station <= 5000; ++station) {
+			journal.Record(MakeState(station));
+			CHECK(std::filesystem::file_size(path) <= 64 * 1024);
+		}
+	}
+	CHECK(LoadFrom(path) == MakeState(5000));
+
+	StateJournal journal(path);
+	journal.Load();
+	journal.Compact(MakeState(6000));
+	CHECK(std::filesystem::file_size(path) == kHeaderBytes + kRecordBytes);
+	CHECK(!std::filesystem::exists(directory / "state.journal.tmp"));
+	journal.Record(MakeState(6001));
+	CHECK(LoadFrom(path) == MakeState(6001));
+}
+
+#if !defined(_WIN32)
+TEST(StateJournal, SurvivesTheProcessDying)
+{
+	// The game crashing runs no destructors: a child records and dies on the spot, and what it
+	// recorded is already with the OS.
+	const Test::TempDirectory directory("journal");
+	const auto                path = directory / "state.journal";
+
+	for (uint64_t crash = 1; crash <= 3; ++crash) {
+		const pid_t child = fork();
+		if (child == 0) {
+			auto* journal = new StateJournal(path);
+			journal->Load();
+			for (uint64_t station = 1; station <= crash * 10; ++station)
+				journal->Record(MakeState(station));
+			_exit(0);
+		}
+
+		int status = 0;
+		CHECK(child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status));
+		CHECK(LoadFrom(path) == MakeState(crash * 10));
+	}
+}
+#endif
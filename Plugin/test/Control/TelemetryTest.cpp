@@ -0,0 +1,237 @@
+#include "Control/Telemetry.h"
+
+#include "Check.h"
+#include "Fixtures.h"
+
+using namespace Control;
+
+namespace
+{
+	using Histogram = LatencyHistogram;
+
+	// Just enough of a JSON parser to tell whether the dump is well-formed.
+	class JsonChecker
+	{
+	public:
+		explicit JsonChecker(std::string_view InText) :
+			Text(InText)
+		{
+		}
+
+		bool IsValid()
+		{
+			return Value() && (Skip(), Position == Text.size());
+		}
+
+	private:
+		void Skip()
+		{
+			while (Position < Text.size() && std::isspace(static_cast<unsigned char>(Text[Position])))
+				++Position;
+		}
+
+		bool Take(char InChar)
+		{
+			Skip();
+			if (Position < Text.size() && Text[Position] == InChar) {
+				++Position;
+				return true;
+			}
+			return false;
+		}
+
+		bool Value()
+		{
+			Skip();
+			if (Position >= Text.size())
+				return false;
+			if (Text[Position] == '{')
+				return List('{', '}', true);
+			if (Text[Position] == '[')
+				return List('[', ']', false);
+			if (Text[Position] == '"')
+				return String();
+
+			const std::size_t start = Position;
+			while (Position < Text.size() && (std::isdigit(static_cast<unsigned char>(Text[Position])) || Text[Position] == '-'))
+				++Position;
+			return Position > start;
+		}
+
+		bool String()
+		{
+			if (!Take('"'))
+				return false;
+			while (Position < Text.size() && Text[Position] != '"') {
+				if (Text[Position] == '\\')
+					++Position;
+				++Position;
+			}
+			return Take('"');
+		}
+
+		bool List(char InOpen, char InClose, bool InKeyed)
+		{
+			Take(InOpen);
+			if (Take(InClose))
+				return true;
+			do {
+				if (InKeyed && !(String() && Take(':')))
+					return false;
+				if (!Value())
+					return false;
+			} while (Take(','));
+			return Take(InClose);
+		}
+
+		std::string_view Text;
+		std::size_t      Position = 0;
+	};
+}
+
+TEST(Telemetry, BucketsTileTheRange)
+{
+	// Next to each other with no gap, each one at most 1/16 of its values wide.
+	CHECK(Histogram::GetBucketLow(0) == 0);
+	CHECK(Histogram::GetBucketHigh(Histogram::kBucketCount - 1) == Histogram::kMaxValue);
+	for (std::size_t bucket = 0; bucket < Histogram::kBucketCount; ++bucket) {
+		const uint64_t low = Histogram::GetBucketLow(bucket);
+		const uint64_t high = Histogram::GetBucketHigh(bucket);
+		CHECK(low <= high);
+		CHECK(Histogram::GetBucket(low) == bucket);
+		CHECK(Histogram::GetBucket(high) == bucket);
+		CHECK(high - low + 1 <= std::max<uint64_t>(low / Histogram::kSubBuckets, 1));
+		if (bucket + 1 < Histogram::kBucketCount)
+			CHECK(Histogram::GetBucketLow(bucket + 1) == high + 1);
+	}
+
+	// Every value lands in the bucket that spans it; past the top, in the last one.
+	for (uint64_t value = 0; value < (1 << 20); ++value) {
+		const auto bucket = Histogram::GetBucket(value);
+		if (!CHECK(Histogram::GetBucketLow(bucket) <= value && value <= Histogram::GetBucketHigh(bucket)))
+			break;
+	}
+	CHECK(Histogram::GetBucket(Histogram::kMaxValue + 1) == Histogram::kBucketCount - 1);
+	CHECK(Histogram::GetBucket(UINT64_MAX) == Histogram::kBucketCount - 1);
+}
+
+TEST(Telemetry, Percentiles)
+{
+	Histogram empty;
+	const auto none = empty.Summarize();
+	CHECK(none.Count == 0 && none.MeanUs == 0 && none.P50Us == 0 && none.MaxUs == 0);
+
+	// One sample: every percentile is that sample, not the top of its bucket.
+	Histogram single;
+	single.Record(1234);
+	const auto one = single.Summarize();
+	CHECK(one.Count == 1 && one.MeanUs == 1234 && one.P50Us == 1234 && one.P999Us == 1234 && one.MaxUs == 1234);
+
+	// 1..10000 us: each percentile is the top of the bucket holding its exact value, so at
+	// most 1/16 above it.
+	Histogram uniform;
+	for (uint64_t value = 1; value <= 10'000; ++value)
+		uniform.Record(value);
+	const auto summary = uniform.Summarize();
+	const auto near = [](uint64_t InReported, uint64_t InExact) {
+		return InReported >= InExact && InReported <= InExact + InExact / 16;
+	};
+	CHECK(summary.Count == 10'000);
+	CHECK(summary.MeanUs == 5000);
+	CHECK(near(summary.P50Us, 5000));
+	CHECK(near(summary.P90Us, 9000));
+	CHECK(near(summary.P99Us, 9900));
+	CHECK(near(summary.P999Us, 9990));
+	CHECK(summary.MaxUs == 10'000 && summary.P999Us <= summary.MaxUs);
+
+	// A long tail: the median stays put, the top percentiles find the outliers.
+	Histogram tail;
+	for (int i = 0; i < 990; ++i)
+		tail.Record(100);
+	for (int i = 0; i < 10; ++i)
+		tail.Record(2'000'000);
+	const auto skewed = tail.Summarize();
+	CHECK(near(skewed.P50Us, 100) && skewed.P90Us == skewed.P50Us && skewed.P99Us == skewed.P50Us);
+	CHECK(near(skewed.P999Us, 2'000'000) && skewed.MaxUs == 2'000'000);
+}
+
+TEST(Telemetry, RecordsFromManyThreads)
+{
+	constexpr int      kThreads = 4;
+	constexpr uint64_t kPerThread = 200'000;
+
+	Histogram histogram;
+	{
+		std::vector<std::jthread> threads;
+		for (int thread = 0; thread < kThreads; ++thread) {
+			threads.emplace_back([&histogram, thread] {
+				for (uint64_t i = 0; i < kPerThread; ++i)
+					histogram.Record(i % 1000 + static_cast<uint64_t>(thread) * 1000);
+			});
+		}
+	}
+
+	const auto summary = histogram.Summarize();
+	const auto counts = histogram.GetCounts();
+	CHECK(summary.Count == kThreads * kPerThread);
+	CHECK(std::accumulate(counts.begin(), counts.end(), uint64_t(0)) == kThreads * kPerThread);
+	CHECK(summary.MaxUs == kThreads * 1000 - 1);
+	CHECK(summary.MeanUs == (kThreads * 1000 - 1) / 2);
+}
+
+TEST(Telemetry, AudioClocks)
+{
+	// Operations that end when audio starts; a cancelled one is not recorded.
+	CHECK(!IsExpectingAudio());
+	ExpectAudio(Operation::Switch);
+	ExpectAudio(Operation::Seek);
+	CancelAudio(Operation::Seek);
+	CHECK(IsExpectingAudio());
+	std::this_thread::sleep_for(20ms);
+	OnAudioStarted();
+	CHECK(!IsExpectingAudio());
+
+	// Audio again with nothing expected records nothing.
+	OnAudioStarted();
+
+	const auto json = FormatTelemetry({});
+	CHECK(json.find("\"switch\": { \"count\": 1,") != std::string::npos);
+	CHECK(json.find("\"seek\": { \"count\": 0,") != std::string::npos);
+}
+
+TEST(Telemetry, DumpsJson)
+{
+	RecordLatency(Operation::Reload, 1500us);
+	RecordLatency(Operation::Reload, 3ms);
+	CountEvent(Counter::FramesDecoded, 41);
+	CountEvent(Counter::FramesDecoded);
+	{
+		ScopedTimer timer(Operation::Decode);
+	}
+
+	const std::pair<std::string_view, uint64_t> fields[] = { { "underruns", 7 }, { "stationsOpened", 3 } };
+	const auto                                  json = FormatTelemetry(fields);
+	CHECK(JsonChecker(json).IsValid());
+
+	for (const auto name : { "\"open\"", "\"firstAudio\"", "\"seek\"", "\"switch\"", "\"reload\"", "\"decode\"", "\"emptyFrames\": 0" })
+		CHECK(json.find(name) != std::string::npos);
+	CHECK(json.find(std::format("\"plugin\": \"{}\"", Plugin::NAME)) != std::string::npos);
+	CHECK(json.find("\"framesDecoded\": 42") != std::string::npos);
+	CHECK(json.find("\"underruns\": 7,\n\t\t\"stationsOpened\": 3\n") != std::string::npos);
+	CHECK(json.find("\"decode\": { \"count\": 1,") != std::string::npos);
+
+	// Buckets as [low, high, count]: 1500 us falls in 1472-1535, 3000 us in 2944-3071.
+	CHECK(json.find("\"reload\": { \"count\": 2, \"meanUs\": 2250,") != std::string::npos);
+	CHECK(json.find("\"buckets\": [[1472, 1535, 1], [2944, 3071, 1]] }") != std::string::npos);
+
+	const Test::TempDirectory directory("telemetry");
+	const auto                file = directory / "dump/telemetry.json";
+	CHECK(WriteTelemetry(file, fields));
+	std::ifstream written(file, std::ios::binary);
+	const auto    text = std::string(std::istreambuf_iterator<char>(written), std::istreambuf_iterator<char>());
+	CHECK(JsonChecker(text).IsValid());
+	CHECK(text.find("\"underruns\": 7") != std::string::npos);
+
+	CHECK(!JsonChecker("{ \"a\": [1, 2 }").IsValid());
+	CHECK(!JsonChecker("{ \"a\": 1, }").IsValid());
+}
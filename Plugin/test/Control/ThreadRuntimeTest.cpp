@@ -0,0 +1,118 @@
+#include "Control/ThreadRuntime.h"
+
+#include "Check.h"
+
+using namespace Control;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	bool WaitUntil(const std::function<bool()>& InCondition)
+	{
+		const auto deadline = Clock::now() + 5s;
+		while (!InCondition()) {
+			if (Clock::now() > deadline)
+				return false;
+			std::this_thread::sleep_for(1ms);
+		}
+		return true;
+	}
+}
+
+TEST(ThreadRuntime, ThreadsHonourTheStopToken)
+{
+	std::atomic<int> running = 0;
+	std::atomic<int> stopped = 0;
+	ThreadRuntime    runtime;
+
+	// One polls the token, one sleeps on it as the workers do.
+	CHECK(runtime.Start("Polling", ThreadRole::Io, [&](std::stop_token InStop) {
+		++running;
+		while (!InStop.stop_requested())
+			std::this_thread::sleep_for(1ms);
+		++stopped;
+	}));
+	CHECK(runtime.Start("Waiting", ThreadRole::Audio, [&](std::stop_token InStop) {
+		++running;
+		std::mutex                  mutex;
+		std::condition_variable_any changed;
+		std::unique_lock            lock(mutex);
+		changed.wait(lock, InStop, [] { return false; });
+		++stopped;
+	}));
+	CHECK(WaitUntil([&] { return running == 2; }));
+	CHECK(stopped == 0 && !runtime.IsStopping());
+
+	const auto start = Clock::now();
+	CHECK(runtime.Shutdown(1s));
+	CHECK(Clock::now() - start < 500ms);
+	CHECK(stopped == 2 && runtime.IsStopping());
+}
+
+TEST(ThreadRuntime, ShutdownIsBounded)
+{
+	// The stuck thread ignores its token, as one blocked in a connect would. State it touches
+	// after being left behind is shared, so it outlives the test's frame.
+	struct Stuck
+	{
+		std::atomic<bool> Release = false;
+		std::atomic<bool> Finished = false;
+	};
+	const auto stuck = std::make_shared<Stuck>();
+
+	std::atomic<bool> politeStopped = false;
+	ThreadRuntime     runtime;
+	CHECK(runtime.Start("Polite", ThreadRole::Input, [&](std::stop_token InStop) {
+		while (!InStop.stop_requested())
+			std::this_thread::sleep_for(1ms);
+		politeStopped = true;
+	}));
+	CHECK(runtime.Start("Stuck", ThreadRole::Io, [stuck](std::stop_token) {
+		while (!stuck->Release)
+			std::this_thread::sleep_for(1ms);
+		stuck->Finished = true;
+	}));
+
+	const auto start = Clock::now();
+	CHECK(!runtime.Shutdown(100ms));
+	const auto took = Clock::now() - start;
+	CHECK(took >= 100ms && took < 1s);
+	CHECK(politeStopped);
+
+	// Detached, not gone: it still runs, and finishes once let go.
+	CHECK(!stuck->Finished);
+	stuck->Release = true;
+	CHECK(WaitUntil([&] { return stuck->Finished.load(); }));
+
+	// Nothing is left to wait for the second time.
+	CHECK(runtime.Shutdown(100ms));
+}
+
+TEST(ThreadRuntime, StartAfterShutdownIsRefused)
+{
+	ThreadRuntime runtime;
+	CHECK(runtime.Shutdown(100ms));
+	CHECK(runtime.IsStopping());
+
+	std::atomic<bool> ran = false;
+	CHECK(!runtime.Start("Late", ThreadRole::Io, [&](std::stop_token) { ran = true; }));
+	std::this_thread::sleep_for(20ms);
+	CHECK(!ran);
+}
+
+TEST(ThreadRuntime, DestructorStopsThreads)
+{
+	std::atomic<int> stopped = 0;
+	{
+		ThreadRuntime runtime;
+		for (int i = 0; i < 4; ++i) {
+			runtime.Start(std::format("Worker {}", i), ThreadRole::Io, [&](std::stop_token InStop) {
+				while (!InStop.stop_requested())
+					std::this_thread::sleep_for(1ms);
+				++stopped;
+			});
+		}
+	}
+	CHECK(stopped == 4);
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "Audio/ByteSource.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+// Synthetic inputs for the tests: in-memory byte sources, MP3 tracks built frame by frame, and
+// scratch directories. Only headers and framing are real in the MP3s; nothing here decodes
+// audio, so the payload is free to carry each frame's number.
+namespace Test
+{
+	// A ByteSource over a vector. Mapped, it hands out the vector the way a memory-mapped file
+	// does; MaxRead caps each Read, like a network source returning whatever has arrived.
+	class MemorySource : public Audio::ByteSource
+	{
+	public:
+		explicit MemorySource(std::vector<uint8_t> InBytes, bool InMapped = false, std::size_t InMaxRead = SIZE_MAX) :
+			Bytes(std::move(InBytes)),
+			Mapped(InMapped),
+			MaxRead(InMaxRead)
+		{
+		}
+
+		std::size_t Read(std::span<uint8_t> OutBytes) override
+		{
+			const auto count = std::min({ OutBytes.size(), static_cast<std::size_t>(Bytes.size() - Position), MaxRead });
+			std::memcpy(OutBytes.data(), Bytes.data() + Position, count);
+			Position += count;
+			++Reads;
+			return count;
+		}
+
+		bool Seek(uint64_t InOffset) override
+		{
+			if (InOffset > Bytes.size())
+				return false;
+			Position = InOffset;
+			++Seeks;
+			return true;
+		}
+
+		uint64_t Tell() const override { return Position; }
+		uint64_t Size() const override { return Bytes.size(); }
+
+		std::span<const uint8_t> GetMapping() const override
+		{
+			return Mapped ? std::span<const uint8_t>(Bytes) : std::span<const uint8_t>();
+		}
+
+		std::vector<uint8_t> Bytes;
+		bool                 Mapped;
+		std::size_t          MaxRead;
+		uint64_t             Position = 0;
+		uint32_t             Reads = 0;
+		uint32_t             Seeks = 0;
+	};
+
+	struct Mp3Options
+	{
+		std::size_t Id3Bytes = 0;      // ID3v2 tag in front, header included
+		bool        Vbr = false;       // bitrate changes from frame to frame
+		bool        Xing = false;      // a Xing frame with frame count and TOC in front
+		std::size_t JunkEvery = 0;     // garbage bytes between frames every this many frames
+		uint8_t     SampleRate = 0;    // index: 0 = 44.1 kHz, 1 = 48 kHz, 2 = 32 kHz
+		bool        Mono = false;
+	};
+
+	struct Mp3Track
+	{
+		std::vector<uint8_t>  Bytes;
+		std::vector<uint64_t> FrameOffsets;  // audio frames only, not the Xing frame
+		uint64_t              DataOffset = 0;  // first frame, the Xing frame if there is one
+	};
+
+	inline constexpr uint32_t kMp3SampleRates[3] = { 44100, 48000, 32000 };
+
+	// Bytes of an MPEG-1 Layer III frame.
+	inline std::size_t GetMp3FrameBytes(uint32_t InBitrateKbps, uint8_t InSampleRate, bool InPadding)
+	{
+		return 144 * InBitrateKbps * 1000 / kMp3SampleRates[InSampleRate] + (InPadding ? 1 : 0);
+	}
+
+	// Number stamped into a frame's side information by MakeMp3.
+	inline uint32_t GetFrameNumber(std::span<const uint8_t> InFrame)
+	{
+		if (InFrame.size() < 8)
+			return UINT32_MAX;
+		return (uint32_t(InFrame[4]) << 24) | (uint32_t(InFrame[5]) << 16) | (uint32_t(InFrame[6]) << 8) | uint32_t(InFrame[7]);
+	}
+
+	// InFrames MPEG-1 Layer III frames, each carrying its number (GetFrameNumber).
+	inline Mp3Track MakeMp3(uint32_t InFrames, const Mp3Options& InOptions = {})
+	{
+		// Bitrate indexes; 9 is 128 kbps, used for every frame of a CBR track.
+		constexpr uint8_t  kVbrIndexes[] = { 9, 11, 5, 14, 9, 7 };
+		constexpr uint16_t kBitrates[16] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 };
+
+		Mp3Track track;
+		auto&    bytes = track.Bytes;
+
+		if (InOptions.Id3Bytes >= 10) {
+			const std::size_t size = InOptions.Id3Bytes - 10;
+			bytes = { 'I', 'D', '3', 4, 0, 0, uint8_t((size >> 21) & 0x7F), uint8_t((size >> 14) & 0x7F), uint8_t((size >> 7) & 0x7F), uint8_t(size & 0x7F) };
+			// Tag data that looks like a frame sync, to keep Open honest about skipping it.
+			bytes.resize(InOptions.Id3Bytes, 0xFF);
+		}
+
+		const auto appendFrame = [&](uint8_t InBitrateIndex, bool InPadding) {
+			const std::size_t start = bytes.size();
+			bytes.resize(start + GetMp3FrameBytes(kBitrates[InBitrateIndex], InOptions.SampleRate, InPadding), 0);
+			bytes[start] = 0xFF;
+			bytes[start + 1] = 0xFB;  // MPEG-1, Layer III, no CRC
+			bytes[start + 2] = uint8_t(InBitrateIndex << 4 | InOptions.SampleRate << 2 | (InPadding ? 2 : 0));
+			bytes[start + 3] = InOptions.Mono ? 0xC0 : 0x00;
+			return start;
+		};
+
+		track.DataOffset = bytes.size();
+		std::size_t xing = 0;
+		if (InOptions.Xing)
+			xing = appendFrame(9, false);
+
+		std::mt19937 random(InFrames);
+		for (uint32_t frame = 0; frame < InFrames; ++frame) {
+			if (InOptions.JunkEvery > 0 && frame > 0 && frame % InOptions.JunkEvery == 0)
+				bytes.insert(bytes.end(), { 0xFF, 0xE0, 0x00, 0x12, 0x34 });
+
+			const uint8_t index = InOptions.Vbr ? kVbrIndexes[random() % std::size(kVbrIndexes)] : 9;
+			const auto    start = appendFrame(index, frame % 3 == 1);
+			bytes[start + 4] = uint8_t(frame >> 24);
+			bytes[start + 5] = uint8_t(frame >> 16);
+			bytes[start + 6] = uint8_t(frame >> 8);
+			bytes[start + 7] = uint8_t(frame);
+			track.FrameOffsets.push_back(start);
+		}
+
+		if (InOptions.Xing) {
+			// Frame count, byte count and TOC, after the side information.
+			const std::size_t sideInfo = InOptions.Mono ? 17 : 32;
+			uint8_t*          tag = bytes.data() + xing + 4 + sideInfo;
+			std::memcpy(tag, "Xing\0\0\0\x07", 8);
+			tag[8] = uint8_t(InFrames >> 24);
+			tag[9] = uint8_t(InFrames >> 16);
+			tag[10] = uint8_t(InFrames >> 8);
+			tag[11] = uint8_t(InFrames);
+
+			const uint64_t dataBytes = bytes.size() - track.DataOffset;
+			for (std::size_t percent = 0; percent < 100 && InFrames > 0; ++percent) {
+				const uint64_t offset = track.FrameOffsets[percent * InFrames / 100] - track.DataOffset;
+				tag[16 + percent] = static_cast<uint8_t>(offset * 256 / dataBytes);
+			}
+		}
+		return track;
+	}
+
+	// A directory of its own under the system temp directory, removed with everything in it.
+	class TempDirectory
+	{
+	public:
+		explicit TempDirectory(std::string_view InName)
+		{
+			std::random_device random;
+			Path = std::filesystem::temp_directory_path() / std::format("radio-test-{}-{:08x}", InName, random());
+			std::filesystem::create_directories(Path);
+		}
+
+		~TempDirectory()
+		{
+			std::error_code ec;
+			std::filesystem::remove_all(Path, ec);
+		}
+
+		TempDirectory(const TempDirectory&) = delete;
+		TempDirectory& operator=(const TempDirectory&) = delete;
+
+		const std::filesystem::path& Get() const { return Path; }
+		std::filesystem::path        operator/(std::string_view InName) const { return Path / InName; }
+
+	private:
+		std::filesystem::path Path;
+	};
+
+	inline void WriteFile(const std::filesystem::path& InPath, std::span<const uint8_t> InBytes)
+	{
+		std::filesystem::create_directories(InPath.parent_path());
+		std::ofstream file(InPath, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(InBytes.data()), static_cast<std::streamsize>(InBytes.size()));
+	}
+
+	inline void WriteFile(const std::filesystem::path& InPath, std::string_view InText)
+	{
+		WriteFile(InPath, { reinterpret_cast<const uint8_t*>(InText.data()), InText.size() });
+	}
+}
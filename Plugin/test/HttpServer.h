@@ -0,0 +1,461 @@
+#pragma once
+
+#include "Audio/ByteSource.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#	include <winsock2.h>
+#	include <ws2tcpip.h>
+#else
+#	include <arpa/inet.h>
+#	include <netinet/in.h>
+#	include <sys/socket.h>
+#	include <unistd.h>
+#endif
+
+// A loopback HTTP server that misbehaves on request, and a plain HTTP client to read it with,
+// so the network sources can be tested without the internet or WinHTTP. The server serves one
+// body, honours Range requests the way a file host does, or streams it as a live Icecast
+// station with interleaved ICY metadata; the faults drop connections, refuse them and add
+// latency, all at set points so the outcome is repeatable.
+namespace Test
+{
+	namespace Sockets
+	{
+#ifdef _WIN32
+		using Socket = SOCKET;
+		inline constexpr Socket kNone = INVALID_SOCKET;
+		inline constexpr int    kShutdownSend = SD_SEND;
+		inline constexpr int    kShutdownBoth = SD_BOTH;
+		inline constexpr int    kSendFlags = 0;
+
+		inline void Close(Socket InSocket) { closesocket(InSocket); }
+
+		inline void Startup()
+		{
+			static const bool started = [] {
+				WSADATA data;
+				return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+			}();
+			(void)started;
+		}
+#else
+		using Socket = int;
+		inline constexpr Socket kNone = -1;
+		inline constexpr int    kShutdownSend = SHUT_WR;
+		inline constexpr int    kShutdownBoth = SHUT_RDWR;
+		inline constexpr int    kSendFlags = MSG_NOSIGNAL;  // a client that hung up is not a crash
+
+		inline void Close(Socket InSocket) { ::close(InSocket); }
+		inline void Startup() {}
+#endif
+
+		inline bool SendAll(Socket InSocket, std::span<const uint8_t> InBytes)
+		{
+			while (!InBytes.empty()) {
+				const auto sent = ::send(InSocket, reinterpret_cast<const char*>(InBytes.data()), static_cast<int>(InBytes.size()), kSendFlags);
+				if (sent <= 0)
+					return false;
+				InBytes = InBytes.subspan(static_cast<std::size_t>(sent));
+			}
+			return true;
+		}
+
+		inline bool SendAll(Socket InSocket, std::string_view InText)
+		{
+			return SendAll(InSocket, { reinterpret_cast<const uint8_t*>(InText.data()), InText.size() });
+		}
+
+		inline Socket Connect(uint16_t InPort)
+		{
+			Startup();
+			const Socket socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+			if (socket == kNone)
+				return kNone;
+
+			sockaddr_in address{};
+			address.sin_family = AF_INET;
+			address.sin_port = htons(InPort);
+			address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			if (::connect(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+				Close(socket);
+				return kNone;
+			}
+			return socket;
+		}
+
+		// The value of a header line in InHeaders, case-insensitively, or empty.
+		inline std::string_view FindHeader(std::string_view InHeaders, std::string_view InName)
+		{
+			for (std::size_t start = 0; start < InHeaders.size();) {
+				auto end = InHeaders.find("\r\n", start);
+				if (end == std::string_view::npos)
+					end = InHeaders.size();
+				const auto line = InHeaders.substr(start, end - start);
+				start = end + 2;
+
+				if (line.size() <= InName.size() || line[InName.size()] != ':')
+					continue;
+				const bool same = std::ranges::equal(line.substr(0, InName.size()), InName, [](char a, char b) {
+					return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+				});
+				if (!same)
+					continue;
+
+				auto value = line.substr(InName.size() + 1);
+				while (!value.empty() && value.front() == ' ')
+					value.remove_prefix(1);
+				return value;
+			}
+			return {};
+		}
+
+		inline uint64_t ToNumber(std::string_view InText)
+		{
+			uint64_t value = 0;
+			std::from_chars(InText.data(), InText.data() + InText.size(), value);
+			return value;
+		}
+	}
+
+	struct HttpFaults
+	{
+		std::size_t               DropEvery = 0;    // close each connection after this many body bytes
+		uint32_t                  RefuseFrom = 0;   // connections RefuseFrom.. are closed unanswered,
+		uint32_t                  RefuseCount = 0;  // RefuseCount of them, counting from 0
+		std::chrono::milliseconds Latency{ 0 };     // before the response
+		std::size_t               ChunkBytes = 16 * 1024;
+		std::chrono::milliseconds ChunkDelay{ 0 };  // between chunks of the body
+	};
+
+	struct IcyStream
+	{
+		uint32_t                 MetaInterval = 0;  // audio bytes between metadata blocks; 0 is a file host
+		std::vector<std::string> Blocks;            // metadata block contents in turn, "" for an empty block
+	};
+
+	// InAudio as an ICY body: MetaInterval audio bytes, a length byte in 16-byte units, the next
+	// block padded with zeros, and again; whatever audio is left over after the last block ends it.
+	inline std::vector<uint8_t> InterleaveIcy(std::span<const uint8_t> InAudio, const IcyStream& InStream)
+	{
+		std::vector<uint8_t> wire;
+		std::size_t          block = 0;
+		for (std::size_t start = 0; start < InAudio.size(); start += InStream.MetaInterval) {
+			const auto audio = InAudio.subspan(start, std::min<std::size_t>(InStream.MetaInterval, InAudio.size() - start));
+			wire.insert(wire.end(), audio.begin(), audio.end());
+			if (audio.size() < InStream.MetaInterval)
+				break;
+
+			const auto& text = InStream.Blocks.empty() ? std::string() : InStream.Blocks[block++ % InStream.Blocks.size()];
+			const auto  units = (text.size() + 15) / 16;
+			wire.push_back(static_cast<uint8_t>(units));
+			wire.insert(wire.end(), text.begin(), text.end());
+			wire.resize(wire.size() + units * 16 - text.size(), 0);
+		}
+		return wire;
+	}
+
+	class HttpServer
+	{
+	public:
+		explicit HttpServer(std::vector<uint8_t> InBody, HttpFaults InFaults = {}, std::optional<IcyStream> InLive = std::nullopt) :
+			Body(std::move(InBody)),
+			Faults(InFaults),
+			Live(std::move(InLive))
+		{
+			Sockets::Startup();
+			Listener = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+			sockaddr_in address{};
+			address.sin_family = AF_INET;
+			address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			socklen_t length = sizeof(address);
+			::bind(Listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+			::listen(Listener, 16);
+			::getsockname(Listener, reinterpret_cast<sockaddr*>(&address), &length);
+			Port = ntohs(address.sin_port);
+
+			Acceptor = std::thread([this] { Accept(); });
+		}
+
+		~HttpServer()
+		{
+			{
+				std::lock_guard lock(Mutex);
+				Stopping = true;
+				for (const auto socket : Open)
+					::shutdown(socket, Sockets::kShutdownBoth);
+			}
+			Changed.notify_all();
+
+			// accept() does not notice the listener closing everywhere; a last connection wakes it.
+			if (const auto wake = Sockets::Connect(Port); wake != Sockets::kNone)
+				Sockets::Close(wake);
+			Acceptor.join();
+			for (auto& handler : Handlers)
+				handler.join();
+			Sockets::Close(Listener);
+		}
+
+		uint16_t GetPort() const { return Port; }
+
+		// Where each answered request asked to start, in order: the Range offset, 0 without one.
+		std::vector<uint64_t> GetRequests() const
+		{
+			std::lock_guard lock(Mutex);
+			return Requests;
+		}
+
+		uint32_t GetConnections() const
+		{
+			std::lock_guard lock(Mutex);
+			return Connections;
+		}
+
+	private:
+		void Accept()
+		{
+			for (;;) {
+				const auto socket = ::accept(Listener, nullptr, nullptr);
+				std::lock_guard lock(Mutex);
+				if (Stopping) {
+					if (socket != Sockets::kNone)
+						Sockets::Close(socket);
+					return;
+				}
+				if (socket == Sockets::kNone)
+					continue;
+
+				const uint32_t index = Connections++;
+				Open.push_back(socket);
+				Handlers.emplace_back([this, socket, index] {
+					Serve(socket, index);
+					std::lock_guard lock(Mutex);
+					std::erase(Open, socket);
+					::shutdown(socket, Sockets::kShutdownSend);
+					Sockets::Close(socket);
+				});
+			}
+		}
+
+		// Waits InDelay unless the server stops first; false once it has.
+		bool Wait(std::chrono::milliseconds InDelay)
+		{
+			std::unique_lock lock(Mutex);
+			return !Changed.wait_for(lock, InDelay, [this] { return Stopping; });
+		}
+
+		void Serve(Sockets::Socket InSocket, uint32_t InIndex)
+		{
+			std::string request;
+			char        buffer[1024];
+			while (!request.contains("\r\n\r\n")) {
+				const auto count = ::recv(InSocket, buffer, sizeof(buffer), 0);
+				if (count <= 0)
+					return;
+				request.append(buffer, static_cast<std::size_t>(count));
+			}
+
+			if (InIndex >= Faults.RefuseFrom && InIndex - Faults.RefuseFrom < Faults.RefuseCount)
+				return;
+			if (!Wait(Faults.Latency))
+				return;
+
+			uint64_t offset = 0;
+			if (const auto range = Sockets::FindHeader(request, "Range"); range.starts_with("bytes="))
+				offset = Sockets::ToNumber(range.substr(6));
+
+			{
+				std::lock_guard lock(Mutex);
+				Requests.push_back(offset);
+			}
+
+			if (Live)
+				ServeLive(InSocket, !Sockets::FindHeader(request, "Icy-MetaData").empty());
+			else
+				ServeFile(InSocket, offset);
+		}
+
+		void ServeFile(Sockets::Socket InSocket, uint64_t InOffset)
+		{
+			if (InOffset > Body.size()) {
+				Sockets::SendAll(InSocket, "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Length: 0\r\n\r\n"sv);
+				return;
+			}
+
+			const std::string headers = InOffset > 0 ?
+			                                std::format("HTTP/1.1 206 Partial Content\r\nContent-Length: {}\r\nContent-Range: bytes {}-{}/{}\r\nConnection: close\r\n\r\n", Body.size() - InOffset, InOffset, Body.size() - 1, Body.size()) :
+			                                std::format("HTTP/1.1 200 OK\r\nContent-Length: {}\r\nAccept-Ranges: bytes\r\nConnection: close\r\n\r\n", Body.size());
+			if (!Sockets::SendAll(InSocket, headers))
+				return;
+			SendBody(InSocket, std::span(Body).subspan(static_cast<std::size_t>(InOffset)));
+		}
+
+		// A live station: no length, no ranges, and every listener joins at the start of Body.
+		void ServeLive(Sockets::Socket InSocket, bool InWantsMetadata)
+		{
+			const uint32_t interval = InWantsMetadata ? Live->MetaInterval : 0;
+			const auto     headers = interval > 0 ?
+			                             std::format("ICY 200 OK\r\nicy-name: Test Station\r\nicy-metaint: {}\r\n\r\n", interval) :
+			                             "ICY 200 OK\r\nicy-name: Test Station\r\n\r\n"s;
+			if (!Sockets::SendAll(InSocket, headers))
+				return;
+
+			if (interval == 0) {
+				SendBody(InSocket, Body);
+				return;
+			}
+
+			SendBody(InSocket, InterleaveIcy(Body, *Live));
+		}
+
+		void SendBody(Sockets::Socket InSocket, std::span<const uint8_t> InBytes)
+		{
+			const std::size_t limit = Faults.DropEvery > 0 ? std::min(Faults.DropEvery, InBytes.size()) : InBytes.size();
+			for (std::size_t sent = 0; sent < limit;) {
+				const auto chunk = InBytes.subspan(sent, std::min(Faults.ChunkBytes, limit - sent));
+				if (!Sockets::SendAll(InSocket, chunk))
+					return;
+				sent += chunk.size();
+				if (Faults.ChunkDelay.count() > 0 && sent < limit && !Wait(Faults.ChunkDelay))
+					return;
+			}
+		}
+
+		std::vector<uint8_t>     Body;
+		HttpFaults               Faults;
+		std::optional<IcyStream> Live;
+
+		Sockets::Socket Listener = Sockets::kNone;
+		uint16_t        Port = 0;
+		std::thread     Acceptor;
+
+		mutable std::mutex           Mutex;
+		std::condition_variable      Changed;
+		std::vector<std::thread>     Handlers;
+		std::vector<Sockets::Socket> Open;
+		std::vector<uint64_t>        Requests;
+		uint32_t                     Connections = 0;
+		bool                         Stopping = false;
+	};
+
+	// HTTP/1.1 GET against the loopback server as a ByteSource, standing in for HttpSource:
+	// Range when starting past 0, Icy-MetaData when asked, and Cancel that unblocks a Read.
+	class HttpClient final : public Audio::ByteSource
+	{
+	public:
+		~HttpClient() override
+		{
+			if (Socket != Sockets::kNone)
+				Sockets::Close(Socket);
+		}
+
+		bool Open(uint16_t InPort, uint64_t InOffset = 0, bool InIcy = false)
+		{
+			// Joins the opener's group while waiting for the response, like HttpSource.
+			const Audio::ConnectGroup::Member member(*this);
+			if (member.IsCancelled())
+				return false;
+
+			const auto socket = Sockets::Connect(InPort);
+			if (socket == Sockets::kNone)
+				return false;
+			{
+				std::lock_guard lock(Mutex);
+				Socket = socket;
+				if (Cancelled)
+					return false;
+			}
+
+			std::string request = "GET /station HTTP/1.1\r\nHost: 127.0.0.1\r\n";
+			if (InOffset > 0)
+				request += std::format("Range: bytes={}-\r\n", InOffset);
+			if (InIcy)
+				request += "Icy-MetaData: 1\r\n";
+			request += "\r\n";
+			if (!Sockets::SendAll(Socket, request))
+				return false;
+
+			std::string response;
+			char        buffer[4096];
+			std::size_t end = std::string::npos;
+			while ((end = response.find("\r\n\r\n")) == std::string::npos) {
+				const auto count = ::recv(Socket, buffer, sizeof(buffer), 0);
+				if (count <= 0)
+					return false;
+				response.append(buffer, static_cast<std::size_t>(count));
+			}
+
+			const std::string_view headers(response.data(), end + 2);
+			const bool             partial = headers.starts_with("HTTP/1.1 206");
+			if (!partial && !headers.starts_with("HTTP/1.1 200") && !headers.starts_with("ICY 200"))
+				return false;
+
+			if (const auto range = Sockets::FindHeader(headers, "Content-Range"); partial && range.contains('/'))
+				TotalSize = Sockets::ToNumber(range.substr(range.find('/') + 1));
+			else if (const auto length = Sockets::FindHeader(headers, "Content-Length"); !length.empty())
+				TotalSize = Sockets::ToNumber(length);
+			MetaInterval = static_cast<uint32_t>(Sockets::ToNumber(Sockets::FindHeader(headers, "icy-metaint")));
+
+			Position = partial ? InOffset : 0;
+			Pending.assign(response.begin() + static_cast<std::ptrdiff_t>(end + 4), response.end());
+			return true;
+		}
+
+		std::size_t Read(std::span<uint8_t> OutBytes) override
+		{
+			if (OutBytes.empty())
+				return 0;
+
+			std::size_t count = 0;
+			if (PendingStart < Pending.size()) {
+				count = std::min(OutBytes.size(), Pending.size() - PendingStart);
+				std::copy_n(Pending.data() + PendingStart, count, OutBytes.data());
+				PendingStart += count;
+			} else {
+				const auto received = ::recv(Socket, reinterpret_cast<char*>(OutBytes.data()), static_cast<int>(std::min<std::size_t>(OutBytes.size(), INT32_MAX)), 0);
+				count = received > 0 ? static_cast<std::size_t>(received) : 0;
+			}
+			Position += count;
+			return count;
+		}
+
+		bool     Seek(uint64_t InOffset) override { return InOffset == Position; }
+		uint64_t Tell() const override { return Position; }
+		uint64_t Size() const override { return TotalSize; }
+		bool     IsRemote() const override { return true; }
+
+		void Cancel() override
+		{
+			std::lock_guard lock(Mutex);
+			Cancelled = true;
+			if (Socket != Sockets::kNone)
+				::shutdown(Socket, Sockets::kShutdownBoth);
+		}
+
+		uint32_t GetMetaInterval() const { return MetaInterval; }
+
+	private:
+		std::mutex           Mutex;  // Socket and Cancelled, between Open and Cancel
+		bool                 Cancelled = false;
+		Sockets::Socket      Socket = Sockets::kNone;
+		std::vector<uint8_t> Pending;  // body bytes that arrived with the headers
+		std::size_t          PendingStart = 0;
+		uint64_t             Position = 0;
+		uint64_t             TotalSize = 0;
+		uint32_t             MetaInterval = 0;
+	};
+}
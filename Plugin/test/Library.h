@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Audio/ByteSource.h"
+#include "Audio/MetadataStore.h"
+
+#include "Fixtures.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Track libraries on disk for the MetadataStore tests and benchmark: tagged MP3 files, and a
+// store whose scans can be waited for.
+namespace Test
+{
+	inline std::string ToUtf8(const std::filesystem::path& InPath)
+	{
+		const auto text = InPath.u8string();
+		return std::string(reinterpret_cast<const char*>(text.data()), text.size());
+	}
+
+	// ID3v2.3 tag with Latin-1 TIT2 and TPE1 frames.
+	inline std::vector<uint8_t> MakeId3(std::string_view InTitle, std::string_view InArtist)
+	{
+		std::vector<uint8_t> frames;
+		const auto           addFrame = [&](const char* InId, std::string_view InText) {
+			if (InText.empty())
+				return;
+			const auto size = static_cast<uint32_t>(InText.size() + 1);
+			frames.insert(frames.end(), InId, InId + 4);
+			frames.insert(frames.end(), { uint8_t(size >> 24), uint8_t(size >> 16), uint8_t(size >> 8), uint8_t(size), 0, 0, 0 });
+			frames.insert(frames.end(), InText.begin(), InText.end());
+		};
+		addFrame("TIT2", InTitle);
+		addFrame("TPE1", InArtist);
+
+		const auto           size = frames.size();
+		std::vector<uint8_t> tag = { 'I', 'D', '3', 3, 0, 0, uint8_t((size >> 21) & 0x7F), uint8_t((size >> 14) & 0x7F), uint8_t((size >> 7) & 0x7F), uint8_t(size & 0x7F) };
+		tag.resize(10 + size);
+		std::ranges::copy(frames, tag.begin() + 10);
+		return tag;
+	}
+
+	// A CBR track of InFrames frames at 44.1 kHz, tagged when a title or artist is given.
+	inline void WriteTrack(const std::filesystem::path& InPath, uint32_t InFrames, std::string_view InTitle = {}, std::string_view InArtist = {})
+	{
+		auto bytes = InTitle.empty() && InArtist.empty() ? std::vector<uint8_t>() : MakeId3(InTitle, InArtist);
+		const auto track = MakeMp3(InFrames);
+		bytes.insert(bytes.end(), track.Bytes.begin(), track.Bytes.end());
+		WriteFile(InPath, bytes);
+	}
+
+	// A MetadataStore over plain files that counts what it opens.
+	struct Library
+	{
+		explicit Library(std::filesystem::path InFile) :
+			Directory(InFile.parent_path()),
+			Store([this](std::string_view InSource) -> std::unique_ptr<Audio::ByteSource> {
+				++Opens;
+				auto source = std::make_unique<Audio::FileSource>();
+				if (!source->Open(std::filesystem::path(std::u8string_view(reinterpret_cast<const char8_t*>(InSource.data()), InSource.size()))))
+					return nullptr;
+				return source;
+			}, InFile)
+		{
+		}
+
+		// Scans and waits for the result. A scan that changes nothing publishes no table, so a
+		// track of its own rides along with each one (and counts as one open); its table is the
+		// one this scan made. nullptr if it does not come within InTimeout.
+		std::shared_ptr<const Audio::MetadataTable> Scan(std::vector<std::string> InTracks, const std::vector<std::string>& InFolders, std::chrono::seconds InTimeout = std::chrono::seconds(60))
+		{
+			static std::atomic<uint32_t> scans = 0;  // unique across stores sharing a directory
+			const auto                   path = Directory / "sentinel" / std::format("{}.mp3", ++scans);
+			const auto sentinel = ToUtf8(path);
+			WriteTrack(path, 4);
+			InTracks.push_back(sentinel);
+
+			const std::vector<std::string_view> tracks(InTracks.begin(), InTracks.end());
+			const std::vector<std::string_view> folders(InFolders.begin(), InFolders.end());
+			Store.Scan(tracks, folders);
+
+			const auto deadline = std::chrono::steady_clock::now() + InTimeout;
+			while (std::chrono::steady_clock::now() < deadline) {
+				if (auto table = Store.GetTable(); table->Find(sentinel))
+					return table;
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			return nullptr;
+		}
+
+		std::filesystem::path Directory;
+		std::atomic<uint32_t> Opens = 0;
+		Audio::MetadataStore  Store;  // last, so its worker stops before the rest goes
+	};
+}
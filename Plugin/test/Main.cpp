@@ -0,0 +1,21 @@
+#include "Check.h"
+
+// Runs every case, or those whose name contains the first argument.
+int main(int InArgc, char** InArgv)
+{
+	const std::string_view filter = InArgc > 1 ? InArgv[1] : "";
+
+	int ran = 0;
+	for (const auto& [name, body] : Test::GetCases()) {
+		if (!name.contains(filter))
+			continue;
+
+		const int before = Test::GetFailures();
+		body();
+		std::printf("%s %.*s\n", Test::GetFailures() == before ? "ok  " : "FAIL", static_cast<int>(name.size()), name.data());
+		++ran;
+	}
+
+	std::printf("%d case(s), %d failed check(s)\n", ran, Test::GetFailures());
+	return Test::GetFailures() == 0 && ran > 0 ? 0 : 1;
+}
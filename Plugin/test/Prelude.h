@@ -0,0 +1,76 @@
+#pragma once
+
+// Stands in for PCH.h in the portable tests: the standard library as the plugin sees it, the
+// project constants from Plugin.h, and the DKUtil logging macros, which format and discard.
+
+// c
+#include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <cfloat>
+#include <cinttypes>
+#include <climits>
+#include <cmath>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+// cxx
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <compare>
+#include <concepts>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <latch>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numbers>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <set>
+#include <shared_mutex>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+using namespace std::literals;
+
+namespace Plugin
+{
+	inline constexpr auto NAME = "StarfieldRadio"sv;
+	inline constexpr auto AUTHOR = "ChairGraveyard"sv;
+	inline constexpr auto Version = 1u * 10000 + 0u * 100 + 0u;
+}
+
+#define INFO(...) { [[maybe_unused]] const auto formatted = std::format(__VA_ARGS__); }
+#define DEBUG(...) { [[maybe_unused]] const auto formatted = std::format(__VA_ARGS__); }
+#define ENABLE_DEBUG
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <vector>
+
+// 32-bit float and 16-bit PCM WAV files, for the DSP fixtures: tests write their inputs and
+// outputs through these, so a failing case can be listened to.
+namespace Test
+{
+	struct Wav
+	{
+		std::vector<float> Samples;  // interleaved
+		uint32_t           Channels = 2;
+		uint32_t           SampleRate = 48000;
+
+		std::size_t GetFrames() const { return Samples.size() / Channels; }
+	};
+
+	inline bool WriteWav(const std::filesystem::path& InPath, const Wav& InWav)
+	{
+		const auto put = [](std::ofstream& InOutFile, auto InValue) {
+			InOutFile.write(reinterpret_cast<const char*>(&InValue), sizeof(InValue));
+		};
+
+		const auto dataBytes = static_cast<uint32_t>(InWav.Samples.size() * sizeof(float));
+		std::ofstream file(InPath, std::ios::binary | std::ios::trunc);
+		file.write("RIFF", 4);
+		put(file, uint32_t(36 + dataBytes));
+		file.write("WAVEfmt ", 8);
+		put(file, uint32_t(16));
+		put(file, uint16_t(3));  // IEEE float
+		put(file, uint16_t(InWav.Channels));
+		put(file, InWav.SampleRate);
+		put(file, uint32_t(InWav.SampleRate * InWav.Channels * sizeof(float)));
+		put(file, uint16_t(InWav.Channels * sizeof(float)));
+		put(file, uint16_t(32));
+		file.write("data", 4);
+		put(file, dataBytes);
+		file.write(reinterpret_cast<const char*>(InWav.Samples.data()), dataBytes);
+		return file.good();
+	}
+
+	// Float or 16-bit PCM; chunks other than fmt and data are skipped.
+	inline std::optional<Wav> ReadWav(const std::filesystem::path& InPath)
+	{
+		std::ifstream file(InPath, std::ios::binary);
+		char          riff[12];
+		if (!file.read(riff, sizeof(riff)) || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0)
+			return std::nullopt;
+
+		Wav      wav;
+		uint16_t format = 0;
+		uint16_t bits = 0;
+		for (;;) {
+			char     id[4];
+			uint32_t size = 0;
+			if (!file.read(id, 4) || !file.read(reinterpret_cast<char*>(&size), 4))
+				return std::nullopt;
+
+			std::vector<char> chunk(size + (size & 1));
+			if (!file.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) && std::memcmp(id, "data", 4) != 0)
+				return std::nullopt;
+
+			if (std::memcmp(id, "fmt ", 4) == 0 && size >= 16) {
+				uint16_t channels = 0;
+				std::memcpy(&format, chunk.data(), 2);
+				std::memcpy(&channels, chunk.data() + 2, 2);
+				std::memcpy(&wav.SampleRate, chunk.data() + 4, 4);
+				std::memcpy(&bits, chunk.data() + 14, 2);
+				wav.Channels = channels;
+			} else if (std::memcmp(id, "data", 4) == 0) {
+				if (format == 3 && bits == 32) {
+					wav.Samples.resize(size / sizeof(float));
+					std::memcpy(wav.Samples.data(), chunk.data(), wav.Samples.size() * sizeof(float));
+				} else if (format == 1 && bits == 16) {
+					wav.Samples.resize(size / sizeof(int16_t));
+					for (std::size_t i = 0; i < wav.Samples.size(); ++i) {
+						int16_t sample = 0;
+						std::memcpy(&sample, chunk.data() + i * 2, 2);
+						wav.Samples[i] = static_cast<float>(sample) / 32768.0f;
+					}
+				} else {
+					return std::nullopt;
+				}
+				if (wav.Channels == 0 || wav.SampleRate == 0)
+					return std::nullopt;
+				return wav;
+			}
+		}
+	}
+}